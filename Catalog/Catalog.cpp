@@ -66,6 +66,7 @@
 #include "MigrationMgr/MigrationMgr.h"
 #include "Parser/ParserNode.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
 #include "QueryEngine/TableOptimizer.h"
 #include "RefreshTimeCalculator.h"
 #include "Shared/DateTimeParser.h"
@@ -289,6 +290,11 @@ void Catalog::updateTableDescriptorSchema() {
       string queryString("ALTER TABLE mapd_tables ADD is_system_table BOOLEAN DEFAULT 0");
       sqliteConnector_.query(queryString);
     }
+    if (std::find(cols.begin(), cols.end(), std::string("eviction_priority")) ==
+        cols.end()) {
+      string queryString("ALTER TABLE mapd_tables ADD eviction_priority INT DEFAULT 0");
+      sqliteConnector_.query(queryString);
+    }
   } catch (std::exception& e) {
     sqliteConnector_.query("ROLLBACK TRANSACTION");
     throw;
@@ -974,8 +980,8 @@ void Catalog::buildMaps() {
       "SELECT tableid, name, ncolumns, isview, fragments, frag_type, max_frag_rows, "
       "max_chunk_size, frag_page_size, "
       "max_rows, partitions, shard_column_id, shard, num_shards, key_metainfo, userid, "
-      "sort_column_id, storage_type, max_rollback_epochs, is_system_table "
-      "from mapd_tables");
+      "sort_column_id, storage_type, max_rollback_epochs, is_system_table, "
+      "eviction_priority from mapd_tables");
   sqliteConnector_.query(tableQuery);
   numRows = sqliteConnector_.getNumRows();
   for (size_t r = 0; r < numRows; ++r) {
@@ -1021,6 +1027,11 @@ void Catalog::buildMaps() {
     }
     td->maxRollbackEpochs = sqliteConnector_.getData<int>(r, 18);
     td->is_system_table = sqliteConnector_.getData<bool>(r, 19);
+    td->evictionPriority = sqliteConnector_.getData<int>(r, 20);
+    if (td->evictionPriority != 0) {
+      dataMgr_->setTableEvictionPriority(
+          currentDB_.dbId, td->tableId, td->evictionPriority);
+    }
     td->hasDeletedCol = false;
 
     tableDescriptorMap_[to_upper(td->tableName)] = td;
@@ -2972,6 +2983,8 @@ void Catalog::setTableEpoch(const int db_id, const int table_id, int new_epoch)
     removeChunksUnlocked(table_id);
     dataMgr_->getGlobalFileMgr()->setFileMgrParams(db_id, table_id, file_mgr_params);
   }
+  // the epochs the table goes through next no longer identify the data cached before
+  UpdateTriggeredCacheInvalidator::invalidateCaches();
 }
 
 void Catalog::alterPhysicalTableMetadata(
@@ -2999,6 +3012,14 @@ void Catalog::alterPhysicalTableMetadata(
                                  std::to_string(td->tableId)});
     mutable_td->maxRows = table_update_params.max_rows;
   }
+
+  if (td->evictionPriority != table_update_params.eviction_priority) {
+    sqliteConnector_.query_with_text_params(
+        "UPDATE mapd_tables SET eviction_priority = ? WHERE tableid = ?",
+        std::vector<std::string>{std::to_string(table_update_params.eviction_priority),
+                                 std::to_string(td->tableId)});
+    mutable_td->evictionPriority = table_update_params.eviction_priority;
+  }
 }
 
 void Catalog::alterTableMetadata(const TableDescriptor* td,
@@ -3074,6 +3095,24 @@ void Catalog::setMaxRows(const int32_t table_id, const int64_t max_rows) {
   td->fragmenter->dropFragmentsToSize(max_rows);
 }
 
+void Catalog::setEvictionPriority(const int32_t table_id,
+                                  const int32_t eviction_priority) {
+  const auto td = getMetadataForTable(table_id);
+  CHECK(td);
+  TableDescriptorUpdateParams table_update_params(td);
+  table_update_params.eviction_priority = eviction_priority;
+  if (table_update_params == td) {
+    LOG(INFO) << "Eviction priority value of " << eviction_priority
+              << " is the same as the existing value. Skipping update.";
+    return;
+  }
+  alterTableMetadata(td, table_update_params);
+  for (const auto physical_td : getPhysicalTablesDescriptors(td)) {
+    dataMgr_->setTableEvictionPriority(
+        currentDB_.dbId, physical_td->tableId, eviction_priority);
+  }
+}
+
 // For testing purposes only
 void Catalog::setUncappedTableEpoch(const std::string& table_name) {
   cat_write_lock write_lock(this);
@@ -3169,6 +3208,7 @@ void Catalog::setTableEpochs(const int32_t db_id,
               << ", table id: " << table_epoch_info.table_id
               << ", back to epoch: " << table_epoch_info.table_epoch;
   }
+  UpdateTriggeredCacheInvalidator::invalidateCaches();
 }
 
 namespace {
@@ -4333,6 +4373,7 @@ void Catalog::eraseTablePhysicalData(const TableDescriptor* td) {
     dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::CPU_LEVEL);
     dataMgr_->deleteChunksWithPrefix(chunkKeyPrefix, MemoryLevel::GPU_LEVEL);
   }
+  dataMgr_->setTableEvictionPriority(currentDB_.dbId, tableId, 0);
   if (!td->isView) {
     INJECT_TIMER(Remove_Table);
     dataMgr_->removeTableRelatedDS(currentDB_.dbId, tableId);
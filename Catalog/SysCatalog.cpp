@@ -1235,7 +1235,7 @@ void SysCatalog::createDatabase(const string& name, int owner) {
         "max_rows bigint, partitions text, shard_column_id integer, shard integer, "
         "sort_column_id integer default 0, storage_type text default '', "
         "max_rollback_epochs integer default -1, "
-        "is_system_table boolean default 0, "
+        "is_system_table boolean default 0, eviction_priority integer default 0, "
         "num_shards integer, key_metainfo TEXT, version_num "
         "BIGINT DEFAULT 1) ");
     dbConn->query(
@@ -76,6 +76,8 @@ struct TableDescriptor {
 
   int32_t maxRollbackEpochs;
   bool is_system_table;
+  // priority of the chunks of the table in the buffer pools, higher ones are evicted last
+  int32_t evictionPriority;
 
   // write mutex, only to be used inside catalog package
   std::shared_ptr<std::mutex> mutex_;
@@ -90,6 +92,7 @@ struct TableDescriptor {
       , hasDeletedCol(true)
       , maxRollbackEpochs(DEFAULT_MAX_ROLLBACK_EPOCHS)
       , is_system_table(false)
+      , evictionPriority(0)
       , mutex_(std::make_shared<std::mutex>()) {}
 
   virtual ~TableDescriptor() = default;
@@ -117,9 +120,12 @@ inline bool table_is_temporary(const TableDescriptor* const td) {
 struct TableDescriptorUpdateParams {
   int32_t max_rollback_epochs;
   int64_t max_rows;
+  int32_t eviction_priority;
 
   TableDescriptorUpdateParams(const TableDescriptor* td)
-      : max_rollback_epochs(td->maxRollbackEpochs), max_rows(td->maxRows) {}
+      : max_rollback_epochs(td->maxRollbackEpochs)
+      , max_rows(td->maxRows)
+      , eviction_priority(td->evictionPriority) {}
 
   bool operator==(const TableDescriptor* td) {
     if (max_rollback_epochs != td->maxRollbackEpochs) {
@@ -128,6 +134,9 @@ struct TableDescriptorUpdateParams {
     if (max_rows != td->maxRows) {
       return false;
     }
+    if (eviction_priority != td->evictionPriority) {
+      return false;
+    }
     // Add more tests for additional params as needed
     return true;
   }
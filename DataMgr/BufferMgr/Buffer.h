@@ -21,6 +21,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <mutex>
 
@@ -123,18 +124,18 @@ class Buffer : public AbstractBuffer {
   /// Returns the size in bytes of each page in the buffer.
   inline size_t pageSize() const override { return page_size_; }
 
-  inline int pin() override {
-    std::lock_guard<std::mutex> pin_lock(pin_mutex_);
-    return (++pin_count_);
-  }
+  inline int pin() override { return (++pin_count_); }
 
-  inline int unPin() override {
-    std::lock_guard<std::mutex> pin_lock(pin_mutex_);
-    return (--pin_count_);
-  }
-  inline int getPinCount() override {
-    std::lock_guard<std::mutex> pin_lock(pin_mutex_);
-    return (pin_count_);
+  inline int unPin() override { return (--pin_count_); }
+  inline int getPinCount() override { return (pin_count_); }
+
+  // Bytes of the buffer which were completely loaded, encoder included, and may be read
+  // by lookups which don't take the global lock of the BufferMgr. They are published
+  // with release semantics once a load finishes, so that a lookup which sees them also
+  // sees the data and the metadata.
+  size_t getLoadedSize() const { return loaded_size_.load(std::memory_order_acquire); }
+  void setLoadedSize(const size_t num_bytes) {
+    loaded_size_.store(num_bytes, std::memory_order_release);
   }
 
   // Added for testing.
@@ -163,8 +164,8 @@ class Buffer : public AbstractBuffer {
   size_t num_pages_;
   int epoch_;  /// indicates when the buffer was last flushed
   std::vector<bool> page_dirty_flags_;
-  int pin_count_;
-  std::mutex pin_mutex_;
+  std::atomic<int> pin_count_;
+  std::atomic<size_t> loaded_size_{0};
 };
 
 }  // namespace Buffer_Namespace
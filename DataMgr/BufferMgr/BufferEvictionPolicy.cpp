@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "DataMgr/BufferMgr/BufferEvictionPolicy.h"
+
+#include <stdexcept>
+
+namespace Buffer_Namespace {
+
+std::unique_ptr<BufferEvictionPolicy> BufferEvictionPolicy::create(
+    const std::string& name,
+    const unsigned int correlated_period,
+    const unsigned int retained_period) {
+  if (name == "lru") {
+    return std::make_unique<LRUBufferEvictionPolicy>();
+  }
+  if (name == "lru2") {
+    return std::make_unique<LRU2BufferEvictionPolicy>(correlated_period,
+                                                      retained_period);
+  }
+  throw std::runtime_error("Unknown buffer pool eviction policy " + name +
+                           ", must be lru or lru2.");
+}
+
+void LRUBufferEvictionPolicy::touchSegment(BufferSeg& seg,
+                                           const unsigned int epoch,
+                                           const bool new_reference) const {
+  seg.last_touched = epoch;
+}
+
+uint64_t LRUBufferEvictionPolicy::getScore(const BufferSeg& seg,
+                                          const unsigned int epoch) const {
+  return seg.last_touched;
+}
+
+void LRU2BufferEvictionPolicy::touchSegment(BufferSeg& seg,
+                                            const unsigned int epoch,
+                                            const bool new_reference) const {
+  const unsigned int last_touched = seg.last_touched;
+  if (new_reference && epoch - last_touched > correlated_period_) {
+    seg.previous_touched = last_touched;
+  }
+  seg.last_touched = epoch;
+}
+
+uint64_t LRU2BufferEvictionPolicy::getScore(const BufferSeg& seg,
+                                            const unsigned int epoch) const {
+  // Buffers without a previous reference within the retained period go first, the last
+  // touch breaks the ties.
+  unsigned int previous_touched = seg.previous_touched;
+  if (epoch - previous_touched > retained_period_) {
+    previous_touched = 0;
+  }
+  return (static_cast<uint64_t>(previous_touched) << 32) |
+         static_cast<unsigned int>(seg.last_touched);
+}
+
+}  // namespace Buffer_Namespace
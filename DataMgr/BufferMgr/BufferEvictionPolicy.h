@@ -0,0 +1,90 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file BufferEvictionPolicy.h
+ *
+ * This file includes the class specification for the eviction policies of the BufferMgr.
+ * The BufferMgr evicts runs of contiguous segments of a slab, so a policy does not order
+ * the buffers itself, it scores the segments instead. When it runs out of free pages, the
+ * BufferMgr evicts the run of unpinned segments with the lowest score, the score of a
+ * run being the highest score of its segments.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "DataMgr/BufferMgr/BufferSeg.h"
+
+namespace Buffer_Namespace {
+
+class BufferEvictionPolicy {
+ public:
+  virtual ~BufferEvictionPolicy() {}
+  // Records an access to the segment at `epoch`. Accesses to a buffer which is already
+  // pinned by another user are not new references, as they are usually part of the same
+  // query.
+  virtual void touchSegment(BufferSeg& seg,
+                            const unsigned int epoch,
+                            const bool new_reference) const = 0;
+  // Returns the score of the segment when the buffer pool is at `epoch`.
+  virtual uint64_t getScore(const BufferSeg& seg, const unsigned int epoch) const = 0;
+
+  // Returns the policy with the given name, "lru" or "lru2", see
+  // LRU2BufferEvictionPolicy for the periods.
+  static std::unique_ptr<BufferEvictionPolicy> create(
+      const std::string& name,
+      const unsigned int correlated_period,
+      const unsigned int retained_period);
+};
+
+// Evicts the least recently used buffers first.
+class LRUBufferEvictionPolicy : public BufferEvictionPolicy {
+ public:
+  void touchSegment(BufferSeg& seg,
+                    const unsigned int epoch,
+                    const bool new_reference) const override;
+  uint64_t getScore(const BufferSeg& seg, const unsigned int epoch) const override;
+};
+
+// Evicts the buffers by the time of their second to last reference (LRU-K with K = 2),
+// so buffers which were referenced once, e.g. by a scan of a large table, are evicted
+// before the buffers which are referenced again and again, in least recently used order.
+// Periods are counted in buffer pool epochs, i.e. buffer accesses. A reference within
+// `correlated_period` of the last one, e.g. by the next step of the same query, is
+// correlated with it and doesn't count as a second reference. A second reference older
+// than `retained_period` is forgotten, so buffers which were popular once but aren't used
+// anymore age out like the buffers referenced once.
+class LRU2BufferEvictionPolicy : public BufferEvictionPolicy {
+ public:
+  LRU2BufferEvictionPolicy(const unsigned int correlated_period,
+                           const unsigned int retained_period)
+      : correlated_period_(correlated_period), retained_period_(retained_period) {}
+
+  void touchSegment(BufferSeg& seg,
+                    const unsigned int epoch,
+                    const bool new_reference) const override;
+  uint64_t getScore(const BufferSeg& seg, const unsigned int epoch) const override;
+
+ private:
+  const unsigned int correlated_period_;
+  const unsigned int retained_period_;
+};
+
+}  // namespace Buffer_Namespace
@@ -32,6 +32,12 @@
 
 using namespace std;
 
+std::string g_buffer_pool_eviction_policy{"lru"};
+// A chunk referenced again within 100 buffer accesses is usually referenced by the same
+// query, and chunk references are forgotten after 16M buffer accesses.
+size_t g_buffer_pool_correlated_period{100};
+size_t g_buffer_pool_retained_period{size_t(1) << 24};
+
 namespace Buffer_Namespace {
 
 std::string BufferMgr::keyToString(const ChunkKey& key) {
@@ -60,7 +66,13 @@ BufferMgr::BufferMgr(const int device_id,
     , allocations_capped_(false)
     , parent_mgr_(parent_mgr)
     , max_buffer_id_(0)
-    , buffer_epoch_(0) {
+    , buffer_epoch_(1)
+    , eviction_policy_(BufferEvictionPolicy::create(g_buffer_pool_eviction_policy,
+                                                     g_buffer_pool_correlated_period,
+                                                     g_buffer_pool_retained_period))
+    , num_hits_(0)
+    , num_misses_(0)
+    , num_evicted_buffers_(0) {
   CHECK(max_buffer_pool_size_ > 0);
   CHECK(page_size_ > 0);
   // TODO change checks on run-time configurable slab size variables to exceptions
@@ -93,7 +105,7 @@ void BufferMgr::reinit() {
 
 void BufferMgr::clear() {
   std::lock_guard<std::mutex> sized_segs_lock(sized_segs_mutex_);
-  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   std::lock_guard<std::mutex> unsized_segs_lock(unsized_segs_mutex_);
 
   for (auto& buf : chunk_index_) {
@@ -104,7 +116,7 @@ void BufferMgr::clear() {
   slabs_.clear();
   slab_segments_.clear();
   unsized_segs_.clear();
-  buffer_epoch_ = 0;
+  buffer_epoch_ = 1;
 }
 
 /// Throws a runtime_error if the Chunk already exists
@@ -119,7 +131,7 @@ AbstractBuffer* BufferMgr::createBuffer(const ChunkKey& chunk_key,
 
   // chunk_page_size is just for recording dirty pages
   {
-    std::lock_guard<std::mutex> lock(chunk_index_mutex_);
+    mapd_unique_lock<mapd_shared_mutex> lock(chunk_index_mutex_);
     CHECK(chunk_index_.find(chunk_key) == chunk_index_.end());
     BufferSeg buffer_seg(BufferSeg(-1, 0, USED));
     buffer_seg.chunk_key = chunk_key;
@@ -146,7 +158,7 @@ AbstractBuffer* BufferMgr::createBuffer(const ChunkKey& chunk_key,
   }
   CHECK(initial_size == 0 || chunk_index_[chunk_key]->buffer->getMemoryPtr());
   // chunk_index_[chunk_key]->buffer->pin();
-  std::lock_guard<std::mutex> lock(chunk_index_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> lock(chunk_index_mutex_);
   return chunk_index_[chunk_key]->buffer;
 }
 
@@ -166,6 +178,7 @@ BufferList::iterator BufferMgr::evict(BufferList::iterator& evict_start,
     num_pages += evict_it->num_pages;
     if (evict_it->mem_status == USED && evict_it->chunk_key.size() > 0) {
       chunk_index_.erase(evict_it->chunk_key);
+      ++num_evicted_buffers_;
     }
     if (evict_it->buffer != nullptr) {
       // If we don't delete buffers here then we lose reference to them later and cause a
@@ -228,6 +241,7 @@ BufferList::iterator BufferMgr::reserveBuffer(
   // Below should be in copy constructor for BufferSeg?
   new_seg_it->buffer = seg_it->buffer;
   new_seg_it->chunk_key = seg_it->chunk_key;
+  new_seg_it->previous_touched = seg_it->previous_touched;
   int8_t* old_mem = new_seg_it->buffer->mem_;
   new_seg_it->buffer->mem_ =
       slabs_[new_seg_it->slab_num] + new_seg_it->start_page * page_size_;
@@ -241,12 +255,14 @@ BufferList::iterator BufferMgr::reserveBuffer(
                                   new_seg_it->buffer->getType(),
                                   device_id_);
   }
-  // Decrement pin count to reverse effect above
-  removeSegment(seg_it);
+  // Point the chunk index to the new segment before removing the old one, which
+  // lookups of the chunk may still be reading.
   {
-    std::lock_guard<std::mutex> lock(chunk_index_mutex_);
+    mapd_unique_lock<mapd_shared_mutex> lock(chunk_index_mutex_);
     chunk_index_[new_seg_it->chunk_key] = new_seg_it;
   }
+  // Decrement pin count to reverse effect above
+  removeSegment(seg_it);
 
   return new_seg_it;
 }
@@ -262,6 +278,7 @@ BufferList::iterator BufferMgr::findFreeBufferInSlab(const size_t slab_num,
       buffer_it->num_pages = num_pages_requested;
       buffer_it->mem_status = USED;
       buffer_it->last_touched = buffer_epoch_++;
+      buffer_it->previous_touched = 0;
       buffer_it->slab_num = slab_num;
       if (excess_pages > 0) {
         BufferSeg free_seg(
@@ -350,13 +367,29 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
   }
 
   // If here then we can't add a slab - so we need to evict
-
-  size_t min_score = std::numeric_limits<size_t>::max();
+  // Lookups pin buffers under the shared lock of the chunk index, so pin counts can only
+  // go down while the exclusive lock is held.
+  mapd_unique_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
+
+  // The score of a run is the highest eviction priority of the tables of its chunks,
+  // then the highest score the eviction policy gives its chunks.
+  using EvictionScore = std::pair<int, uint64_t>;
+  EvictionScore min_score{std::numeric_limits<int>::max(),
+                          std::numeric_limits<uint64_t>::max()};
+  std::lock_guard<std::mutex> eviction_priorities_lock(eviction_priorities_mutex_);
+  const auto get_priority = [this](const ChunkKey& chunk_key) {
+    if (chunk_key.size() < 2 || table_eviction_priorities_.empty()) {
+      return 0;
+    }
+    const auto it = table_eviction_priorities_.find({chunk_key[0], chunk_key[1]});
+    return it == table_eviction_priorities_.end() ? 0 : it->second;
+  };
   // We're going for lowest score here, like golf
   // This is because score is the sum of the lastTouched score for all pages evicted.
   // Evicting fewer pages and older pages will lower the score
   BufferList::iterator best_eviction_start = slab_segments_[0].end();
   int best_eviction_start_slab = -1;
+  const unsigned int epoch = buffer_epoch_;
   int slab_num = 0;
 
   for (auto slab_it = slab_segments_.begin(); slab_it != slab_segments_.end();
@@ -370,7 +403,7 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
 
       // if (buffer_it->mem_status == FREE || buffer_it->buffer->getPinCount() == 0) {
       size_t page_count = 0;
-      size_t score = 0;
+      EvictionScore score{std::numeric_limits<int>::min(), 0};
       bool solution_found = false;
       auto evict_it = buffer_it;
       for (; evict_it != slab_segments_[slab_num].end(); ++evict_it) {
@@ -389,7 +422,9 @@ BufferList::iterator BufferMgr::findFreeBuffer(size_t num_bytes) {
           // chunk score was larger than one large chunk so it always would evict a large
           // chunk so under memory pressure a query would evict its own current chunks and
           // cause reloads rather than evict several smaller unused older chunks.
-          score = std::max(score, static_cast<size_t>(evict_it->last_touched));
+          score.first = std::max(score.first, get_priority(evict_it->chunk_key));
+          score.second =
+              std::max(score.second, eviction_policy_->getScore(*evict_it, epoch));
         }
         if (page_count >= num_pages_requested) {
           solution_found = true;
@@ -550,7 +585,7 @@ std::string BufferMgr::printMap() {
   tss << std::endl
       << "Map Contents: "
       << " " << getStringMgrType() << ":" << device_id_ << std::endl;
-  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   for (auto seg_it = chunk_index_.begin(); seg_it != chunk_index_.end();
        ++seg_it, ++seg_num) {
     //    tss << "Map Entry " << seg_num << ": ";
@@ -586,7 +621,7 @@ void BufferMgr::printSegs() {
 }
 
 bool BufferMgr::isBufferOnDevice(const ChunkKey& key) {
-  std::lock_guard<std::mutex> chunkIndexLock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexLock(chunk_index_mutex_);
   if (chunk_index_.find(key) == chunk_index_.end()) {
     return false;
   } else {
@@ -597,7 +632,7 @@ bool BufferMgr::isBufferOnDevice(const ChunkKey& key) {
 /// This method throws a runtime_error when deleting a Chunk that does not exist.
 void BufferMgr::deleteBuffer(const ChunkKey& key, const bool) {
   // Note: purge is unused
-  std::unique_lock<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
 
   // lookup the buffer for the Chunk in chunk_index_
   auto buffer_it = chunk_index_.find(key);
@@ -620,7 +655,7 @@ void BufferMgr::deleteBuffersWithPrefix(const ChunkKey& key_prefix, const bool)
       sized_segs_mutex_);  // Take this lock early to prevent deadlock with
                            // reserveBuffer which needs segs_mutex_ and then
                            // chunk_index_mutex_
-  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_unique_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   auto startChunkIt = chunk_index_.lower_bound(key_prefix);
   if (startChunkIt == chunk_index_.end()) {
     return;
@@ -681,7 +716,7 @@ void BufferMgr::removeSegment(BufferList::iterator& seg_it) {
 
 void BufferMgr::checkpoint() {
   std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
-  std::lock_guard<std::mutex> chunkIndexLock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunkIndexLock(chunk_index_mutex_);
 
   for (auto& chunk_itr : chunk_index_) {
     // checks that buffer is actual chunk (not just buffer) and is dirty
@@ -695,7 +730,7 @@ void BufferMgr::checkpoint() {
 
 void BufferMgr::checkpoint(const int db_id, const int tb_id) {
   std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
-  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
 
   ChunkKey key_prefix;
   key_prefix.push_back(db_id);
@@ -725,27 +760,49 @@ void BufferMgr::checkpoint(const int db_id, const int tb_id) {
 /// Returns a pointer to the Buffer holding the chunk, if it exists; otherwise,
 /// throws a runtime_error.
 AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes) {
+  // Chunks which are in the pool with all the requested bytes loaded are pinned under
+  // the shared lock of the chunk index only. Eviction holds the exclusive lock, so a
+  // buffer can't be pinned while eviction picks the buffers to evict. The loaded size is
+  // only published once a load under the global lock has finished, buffers which are
+  // still loading or short of the requested bytes take the slow path.
+  if (num_bytes > 0) {
+    mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
+    auto buffer_it = chunk_index_.find(key);
+    if (buffer_it != chunk_index_.end() && buffer_it->second->buffer &&
+        buffer_it->second->buffer->getLoadedSize() >= num_bytes) {
+      auto buffer = buffer_it->second->buffer;
+      const bool new_reference = buffer->pin() == 1;
+      eviction_policy_->touchSegment(*buffer_it->second, buffer_epoch_++, new_reference);
+      ++num_hits_;
+      return buffer;
+    }
+  }
+
   std::lock_guard<std::mutex> lock(global_mutex_);  // granular lock
 
   std::unique_lock<std::mutex> sized_segs_lock(sized_segs_mutex_);
-  std::unique_lock<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   auto buffer_it = chunk_index_.find(key);
   bool found_buffer = buffer_it != chunk_index_.end();
   chunk_index_lock.unlock();
   if (found_buffer) {
     CHECK(buffer_it->second->buffer);
-    buffer_it->second->buffer->pin();
+    const bool new_reference = buffer_it->second->buffer->pin() == 1;
     sized_segs_lock.unlock();
 
-    buffer_it->second->last_touched = buffer_epoch_++;  // race
+    eviction_policy_->touchSegment(*buffer_it->second, buffer_epoch_++, new_reference);
+    ++num_hits_;
 
-    if (buffer_it->second->buffer->size() < num_bytes) {
+    auto buffer = buffer_it->second->buffer;
+    if (buffer->size() < num_bytes) {
       // need to fetch part of buffer we don't have - up to numBytes
-      parent_mgr_->fetchBuffer(key, buffer_it->second->buffer, num_bytes);
+      parent_mgr_->fetchBuffer(key, buffer, num_bytes);
     }
-    return buffer_it->second->buffer;
+    buffer->setLoadedSize(buffer->size());
+    return buffer;
   } else {  // If wasn't in pool then we need to fetch it
     sized_segs_lock.unlock();
+    ++num_misses_;
     // createChunk pins for us
     AbstractBuffer* buffer = createBuffer(key, page_size_, num_bytes);
     try {
@@ -760,6 +817,7 @@ AbstractBuffer* BufferMgr::getBuffer(const ChunkKey& key, const size_t num_bytes
       LOG(FATAL) << "Get chunk - Could not find chunk " << keyToString(key)
                  << " in buffer pool or parent buffer pools. Error was " << error.what();
     }
+    static_cast<Buffer*>(buffer)->setLoadedSize(buffer->size());
     return buffer;
   }
 }
@@ -769,7 +827,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
                             const size_t num_bytes) {
   std::unique_lock<std::mutex> lock(global_mutex_);  // granular lock
   std::unique_lock<std::mutex> sized_segs_lock(sized_segs_mutex_);
-  std::unique_lock<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
 
   auto buffer_it = chunk_index_.find(key);
   bool found_buffer = buffer_it != chunk_index_.end();
@@ -777,6 +835,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
   AbstractBuffer* buffer;
   if (!found_buffer) {
     sized_segs_lock.unlock();
+    ++num_misses_;
     CHECK(parent_mgr_ != 0);
     buffer = createBuffer(key, page_size_, num_bytes);  // will pin buffer
     try {
@@ -784,15 +843,18 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
     } catch (std::runtime_error& error) {
       LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
     }
+    static_cast<Buffer*>(buffer)->setLoadedSize(buffer->size());
   } else {
     buffer = buffer_it->second->buffer;
     buffer->pin();
+    ++num_hits_;
     if (num_bytes > buffer->size()) {
       try {
         parent_mgr_->fetchBuffer(key, buffer, num_bytes);
       } catch (std::runtime_error& error) {
         LOG(FATAL) << "Could not fetch parent buffer " << keyToString(key);
       }
+      static_cast<Buffer*>(buffer)->setLoadedSize(buffer->size());
     }
     sized_segs_lock.unlock();
   }
@@ -804,7 +866,7 @@ void BufferMgr::fetchBuffer(const ChunkKey& key,
 AbstractBuffer* BufferMgr::putBuffer(const ChunkKey& key,
                                      AbstractBuffer* src_buffer,
                                      const size_t num_bytes) {
-  std::unique_lock<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   auto buffer_it = chunk_index_.find(key);
   bool found_buffer = buffer_it != chunk_index_.end();
   chunk_index_lock.unlock();
@@ -862,7 +924,7 @@ void BufferMgr::free(AbstractBuffer* buffer) {
 }
 
 size_t BufferMgr::getNumChunks() {
-  std::lock_guard<std::mutex> chunk_index_lock(chunk_index_mutex_);
+  mapd_shared_lock<mapd_shared_mutex> chunk_index_lock(chunk_index_mutex_);
   return chunk_index_.size();
 }
 
@@ -887,6 +949,31 @@ const std::vector<BufferList>& BufferMgr::getSlabSegments() {
   return slab_segments_;
 }
 
+BufferPoolStats BufferMgr::getStats() const {
+  BufferPoolStats stats;
+  stats.num_hits = num_hits_;
+  stats.num_misses = num_misses_;
+  stats.num_evicted_buffers = num_evicted_buffers_;
+  return stats;
+}
+
+void BufferMgr::setTableEvictionPriority(const int db_id,
+                                         const int table_id,
+                                         const int priority) {
+  std::lock_guard<std::mutex> eviction_priorities_lock(eviction_priorities_mutex_);
+  if (priority == 0) {
+    table_eviction_priorities_.erase({db_id, table_id});
+  } else {
+    table_eviction_priorities_[{db_id, table_id}] = priority;
+  }
+}
+
+int BufferMgr::getTableEvictionPriority(const int db_id, const int table_id) {
+  std::lock_guard<std::mutex> eviction_priorities_lock(eviction_priorities_mutex_);
+  const auto it = table_eviction_priorities_.find({db_id, table_id});
+  return it == table_eviction_priorities_.end() ? 0 : it->second;
+}
+
 void BufferMgr::removeTableRelatedDS(const int db_id, const int table_id) {
   UNREACHABLE();
 }
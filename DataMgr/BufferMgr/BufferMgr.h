@@ -26,6 +26,7 @@
 
 #define BOOST_STACKTRACE_GNU_SOURCE_NOT_REQUIRED 1
 
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <map>
@@ -33,8 +34,10 @@
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/AbstractBufferMgr.h"
+#include "DataMgr/BufferMgr/BufferEvictionPolicy.h"
 #include "DataMgr/BufferMgr/BufferSeg.h"
 #include "Shared/boost_stacktrace.hpp"
+#include "Shared/mapd_shared_mutex.h"
 #include "Shared/types.h"
 
 class OutOfMemory : public std::runtime_error {
@@ -86,6 +89,12 @@ using namespace Data_Namespace;
 
 namespace Buffer_Namespace {
 
+struct BufferPoolStats {
+  size_t num_hits{0};    /// chunk lookups which found the chunk in the pool
+  size_t num_misses{0};  /// chunk lookups which had to fetch the chunk from the parent
+  size_t num_evicted_buffers{0};
+};
+
 /**
  * @class   BufferMgr
  * @brief
@@ -124,6 +133,15 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   size_t getPageSize();
   bool isAllocationCapped() override;
   const std::vector<BufferList>& getSlabSegments();
+  BufferPoolStats getStats() const;
+
+  /**
+   * Sets the eviction priority of the chunks of a table. Chunks are evicted in order of
+   * priority, so chunks with a higher priority are only evicted when no run of chunks
+   * with lower priorities frees enough pages. Tables have priority 0 by default.
+   */
+  void setTableEvictionPriority(const int db_id, const int table_id, const int priority);
+  int getTableEvictionPriority(const int db_id, const int table_id);
 
   /// Creates a chunk with the specified key and page size.
   AbstractBuffer* createBuffer(const ChunkKey& key,
@@ -194,7 +212,7 @@ class BufferMgr : public AbstractBufferMgr {  // implements
                               const size_t num_bytes) = 0;
   void clear();
 
-  std::mutex chunk_index_mutex_;
+  mapd_shared_mutex chunk_index_mutex_;  // shared for lookups, exclusive for changes
   std::mutex sized_segs_mutex_;
   std::mutex unsized_segs_mutex_;
   std::mutex buffer_id_mutex_;
@@ -209,7 +227,15 @@ class BufferMgr : public AbstractBufferMgr {  // implements
   bool allocations_capped_;
   AbstractBufferMgr* parent_mgr_;
   int max_buffer_id_;
-  unsigned int buffer_epoch_;
+  std::atomic<unsigned int> buffer_epoch_;  // starts at 1, touch 0 meaning never touched
+  std::unique_ptr<BufferEvictionPolicy> eviction_policy_;
+
+  std::mutex eviction_priorities_mutex_;
+  std::map<std::pair<int, int>, int> table_eviction_priorities_;
+
+  std::atomic<size_t> num_hits_;
+  std::atomic<size_t> num_misses_;
+  std::atomic<size_t> num_evicted_buffers_;
 
   BufferList unsized_segs_;
 
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 
 #include "Shared/types.h"
@@ -27,6 +28,30 @@ class Buffer;  // forward declaration
 // Memory Pages types in buffer pool
 enum MemStatus { FREE, USED };
 
+// A buffer pool epoch of a segment. Lookups touch segments under the shared lock of the
+// chunk index, concurrently with each other, so the epochs are atomic. Eviction only
+// needs an approximate order, so relaxed accesses are enough, and a touch racing another
+// touch of the same segment may keep either epoch.
+class SegmentEpoch {
+ public:
+  explicit SegmentEpoch(const unsigned int epoch) : epoch_(epoch) {}
+  SegmentEpoch(const SegmentEpoch& other) : epoch_(other) {}
+
+  SegmentEpoch& operator=(const SegmentEpoch& other) {
+    return *this = static_cast<unsigned int>(other);
+  }
+
+  SegmentEpoch& operator=(const unsigned int epoch) {
+    epoch_.store(epoch, std::memory_order_relaxed);
+    return *this;
+  }
+
+  operator unsigned int() const { return epoch_.load(std::memory_order_relaxed); }
+
+ private:
+  std::atomic<unsigned int> epoch_;
+};
+
 struct BufferSeg {
   int start_page;
   size_t num_pages;
@@ -35,10 +60,16 @@ struct BufferSeg {
   ChunkKey chunk_key;
   unsigned int pin_count;
   int slab_num;
-  unsigned int last_touched;
+  SegmentEpoch last_touched;
+  SegmentEpoch previous_touched;  // last touch before the latest reference, for LRU-2
 
   BufferSeg()
-      : mem_status(FREE), buffer(0), pin_count(0), slab_num(-1), last_touched(0) {}
+      : mem_status(FREE)
+      , buffer(0)
+      , pin_count(0)
+      , slab_num(-1)
+      , last_touched(0)
+      , previous_touched(0) {}
   BufferSeg(const int start_page, const size_t num_pages)
       : start_page(start_page)
       , num_pages(num_pages)
@@ -46,7 +77,8 @@ struct BufferSeg {
       , buffer(0)
       , pin_count(0)
       , slab_num(-1)
-      , last_touched(0) {}
+      , last_touched(0)
+      , previous_touched(0) {}
   BufferSeg(const int start_page, const size_t num_pages, const MemStatus mem_status)
       : start_page(start_page)
       , num_pages(num_pages)
@@ -54,7 +86,8 @@ struct BufferSeg {
       , buffer(0)
       , pin_count(0)
       , slab_num(-1)
-      , last_touched(0) {}
+      , last_touched(0)
+      , previous_touched(0) {}
   BufferSeg(const int start_page,
             const size_t num_pages,
             const MemStatus mem_status,
@@ -65,7 +98,8 @@ struct BufferSeg {
       , buffer(0)
       , pin_count(0)
       , slab_num(-1)
-      , last_touched(last_touched) {}
+      , last_touched(last_touched)
+      , previous_touched(0) {}
 };
 
 using BufferList = std::list<BufferSeg>;
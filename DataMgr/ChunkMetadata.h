@@ -16,7 +16,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <memory>
+#include <vector>
 #include "../Shared/sqltypes.h"
 #include "Shared/types.h"
 
@@ -28,11 +32,150 @@ struct ChunkStats {
   bool has_nulls;
 };
 
+// Min and max of each block of `block_rows` consecutive rows of a chunk, which lets the
+// executor skip the row ranges of a fragment its filters can't match. Values are the
+// ones stored in the chunk, nulls are left out of the min and max.
+struct ZoneMap {
+  struct Block {
+    int64_t min;
+    int64_t max;
+    bool has_nulls;
+
+    // A block of nulls only has no min and max.
+    bool hasValues() const { return min <= max; }
+  };
+
+  size_t block_rows;
+  // Number of rows covered, the last block may be partial.
+  size_t num_rows;
+  std::vector<Block> blocks;
+};
+
+// Bloom filter over the values of a chunk, which lets the executor skip the fragments an
+// equality or IN predicate can't match. Values are the ones stored in the chunk, i.e.
+// string ids for dictionary encoded strings, nulls are left out.
+//
+// The number of distinct values of a chunk is only known once it is written, so the
+// filter grows with them: it is made of slices sized for a number of values at a false
+// positive rate, and a full slice is followed by one with four times the capacity and
+// half the false positive rate. With the first slice at half the target rate, the false
+// positive rate of the whole filter stays under the target.
+struct BloomFilter {
+  struct Slice {
+    size_t num_bits;
+    size_t num_hashes;
+    // Number of distinct values the slice is sized for, and inserted so far.
+    size_t capacity;
+    size_t count;
+    std::vector<uint64_t> words;
+  };
+
+  static constexpr size_t kInitialCapacity{1024};
+  static constexpr size_t kGrowthFactor{4};
+
+  BloomFilter(const double target_fp_rate = 0.01) : fp_rate(target_fp_rate) {}
+
+  // Number of rows covered.
+  size_t num_rows{0};
+  double fp_rate;
+  std::vector<Slice> slices;
+
+  // Returns true if the value wasn't in the filter yet, which may only start a new slice.
+  bool insert(const int64_t value) {
+    const auto hash = mix(value);
+    if (mayContainHash(hash)) {
+      return false;
+    }
+    if (slices.empty() || slices.back().count >= slices.back().capacity) {
+      addSlice();
+    }
+    auto& slice = slices.back();
+    forEachBit(hash, slice, [&slice](const size_t bit) {
+      slice.words[bit / 64] |= uint64_t(1) << (bit % 64);
+    });
+    ++slice.count;
+    return true;
+  }
+
+  bool mayContain(const int64_t value) const { return mayContainHash(mix(value)); }
+
+  size_t numBytes() const {
+    size_t num_bytes{0};
+    for (const auto& slice : slices) {
+      num_bytes += slice.words.size() * sizeof(uint64_t);
+    }
+    return num_bytes;
+  }
+
+  // Size of a slice for `capacity` distinct values at a false positive rate of `p`, with
+  // the optimal number of hashes.
+  static Slice makeSlice(const size_t capacity, const double p) {
+    const double ln2 = std::log(2.0);
+    const auto num_bits =
+        static_cast<size_t>(std::ceil(capacity * std::log(1 / p) / (ln2 * ln2)));
+    const auto num_hashes = static_cast<size_t>(std::ceil(std::log2(1 / p)));
+    const size_t num_words = (num_bits + 63) / 64;
+    return {num_words * 64,
+            std::max(num_hashes, size_t(1)),
+            capacity,
+            0,
+            std::vector<uint64_t>(num_words)};
+  }
+
+ private:
+  void addSlice() {
+    size_t capacity{kInitialCapacity};
+    double p = fp_rate / 2;
+    for (size_t i = 0; i < slices.size(); ++i) {
+      capacity *= kGrowthFactor;
+      p /= 2;
+    }
+    slices.push_back(makeSlice(capacity, p));
+  }
+
+  bool mayContainHash(const uint64_t hash) const {
+    for (const auto& slice : slices) {
+      bool all_set{true};
+      forEachBit(hash, slice, [&](const size_t bit) {
+        all_set = all_set && (slice.words[bit / 64] & (uint64_t(1) << (bit % 64)));
+      });
+      if (all_set) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  static uint64_t mix(const int64_t value) {
+    uint64_t x = static_cast<uint64_t>(value);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+  }
+
+  // Double hashing on the halves of the mixed value.
+  template <typename F>
+  static void forEachBit(const uint64_t hash, const Slice& slice, F f) {
+    const uint64_t h1 = hash & 0xffffffff;
+    const uint64_t h2 = (hash >> 32) | 1;
+    for (size_t i = 0; i < slice.num_hashes; ++i) {
+      f(static_cast<size_t>((h1 + i * h2) % slice.num_bits));
+    }
+  }
+};
+
 struct ChunkMetadata {
   SQLTypeInfo sqlType;
   size_t numBytes;
   size_t numElements;
   ChunkStats chunkStats;
+  // Only set for chunks of integer and time columns whose values weren't updated in
+  // place, not part of the comparison of chunk metadata.
+  std::shared_ptr<const ZoneMap> zoneMap;
+  // Only set for chunks of integer, time and dictionary encoded string columns whose
+  // filter stays under the size limit, not part of the comparison of chunk metadata
+  // either.
+  std::shared_ptr<const BloomFilter> bloomFilter;
 
   std::string dump() const {
     auto type = sqlType.is_array() ? sqlType.get_elem_type() : sqlType;
@@ -40,6 +40,7 @@
 extern bool g_enable_fsi;
 bool g_enable_tiered_cpu_mem{false};
 size_t g_pmem_size{0};
+double g_chunk_prefetch_mem_fraction{0.25};
 
 namespace Data_Namespace {
 
@@ -350,6 +351,7 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
     mi.maxNumPages = cpu_buffer->getMaxSize() / mi.pageSize;
     mi.isAllocationCapped = cpu_buffer->isAllocationCapped();
     mi.numPageAllocated = cpu_buffer->getAllocated() / mi.pageSize;
+    mi.bufferPoolStats = cpu_buffer->getStats();
 
     const auto& slab_segments = cpu_buffer->getSlabSegments();
     for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -379,6 +381,7 @@ std::vector<MemoryInfo> DataMgr::getMemoryInfo(const MemoryLevel memLevel) {
       mi.maxNumPages = gpu_buffer->getMaxSize() / mi.pageSize;
       mi.isAllocationCapped = gpu_buffer->isAllocationCapped();
       mi.numPageAllocated = gpu_buffer->getAllocated() / mi.pageSize;
+      mi.bufferPoolStats = gpu_buffer->getStats();
 
       const auto& slab_segments = gpu_buffer->getSlabSegments();
       for (size_t slab_num = 0; slab_num < slab_segments.size(); ++slab_num) {
@@ -416,6 +419,69 @@ std::string DataMgr::dumpLevel(const MemoryLevel memLevel) {
   }
 }
 
+void DataMgr::setTableEvictionPriority(const int db_id,
+                                       const int tb_id,
+                                       const int priority) {
+  std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
+  for (size_t level = MemoryLevel::CPU_LEVEL; level < bufferMgrs_.size(); ++level) {
+    for (auto buffer_mgr : bufferMgrs_[level]) {
+      auto buffer_pool = dynamic_cast<Buffer_Namespace::BufferMgr*>(buffer_mgr);
+      CHECK(buffer_pool);
+      buffer_pool->setTableEvictionPriority(db_id, tb_id, priority);
+    }
+  }
+}
+
+int DataMgr::getTableEvictionPriority(const int db_id, const int tb_id) {
+  return getCpuBufferMgr()->getTableEvictionPriority(db_id, tb_id);
+}
+
+bool DataMgr::reservePrefetchMemory(const size_t num_bytes) {
+  const size_t budget =
+      getCpuBufferMgr()->getMaxSize() * std::max(g_chunk_prefetch_mem_fraction, 0.0);
+  std::lock_guard<std::mutex> lock(prefetch_mutex_);
+  if (prefetch_reserved_bytes_ + num_bytes > budget) {
+    return false;
+  }
+  prefetch_reserved_bytes_ += num_bytes;
+  return true;
+}
+
+bool DataMgr::waitForPrefetchMemory(const size_t num_bytes,
+                                    const std::function<bool()>& cancelled) {
+  const size_t budget =
+      getCpuBufferMgr()->getMaxSize() * std::max(g_chunk_prefetch_mem_fraction, 0.0);
+  if (num_bytes > budget) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(prefetch_mutex_);
+  prefetch_cv_.wait(lock, [&] {
+    return cancelled() || prefetch_reserved_bytes_ + num_bytes <= budget;
+  });
+  if (cancelled()) {
+    return false;
+  }
+  prefetch_reserved_bytes_ += num_bytes;
+  return true;
+}
+
+void DataMgr::releasePrefetchMemory(const size_t num_bytes) {
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    CHECK_GE(prefetch_reserved_bytes_, num_bytes);
+    prefetch_reserved_bytes_ -= num_bytes;
+  }
+  prefetch_cv_.notify_all();
+}
+
+void DataMgr::wakePrefetchWaiters() {
+  // Taking the lock orders the wakeup after the check of a waiter which is about to wait.
+  {
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+  }
+  prefetch_cv_.notify_all();
+}
+
 void DataMgr::clearMemory(const MemoryLevel memLevel) {
   std::lock_guard<std::mutex> buffer_lock(buffer_access_mutex_);
 
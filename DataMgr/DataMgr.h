@@ -30,9 +30,12 @@
 #include "MemoryLevel.h"
 #include "PersistentStorageMgr/PersistentStorageMgr.h"
 
+#include <condition_variable>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -67,6 +70,7 @@ struct MemoryInfo {
   size_t numPageAllocated;
   bool isAllocationCapped;
   std::vector<MemoryData> nodeMemoryData;
+  Buffer_Namespace::BufferPoolStats bufferPoolStats;
 };
 
 //! Parse /proc/meminfo into key/value pairs.
@@ -197,6 +201,21 @@ class DataMgr {
   std::vector<MemoryInfo> getMemoryInfo(const MemoryLevel memLevel);
   std::string dumpLevel(const MemoryLevel memLevel);
   void clearMemory(const MemoryLevel memLevel);
+  // Sets the eviction priority of the chunks of the table in the CPU and GPU buffer
+  // pools, see BufferMgr::setTableEvictionPriority.
+  void setTableEvictionPriority(const int db_id, const int tb_id, const int priority);
+  int getTableEvictionPriority(const int db_id, const int tb_id);
+  // Chunks loaded into the CPU buffer pool ahead of the queries which use them take from
+  // a budget of g_chunk_prefetch_mem_fraction of the pool, so they don't evict each other
+  // before they're used. Returns false if the bytes don't fit in the budget.
+  bool reservePrefetchMemory(const size_t num_bytes);
+  // Blocks until the bytes fit in the budget and reserves them. Returns false, without
+  // reserving, once cancelled() holds or if the bytes can never fit. cancelled() is
+  // checked again on every release and on wakePrefetchWaiters().
+  bool waitForPrefetchMemory(const size_t num_bytes,
+                             const std::function<bool()>& cancelled);
+  void releasePrefetchMemory(const size_t num_bytes);
+  void wakePrefetchWaiters();
 
   const std::map<ChunkKey, File_Namespace::FileBuffer*>& getChunkMap();
   void checkpoint(const int db_id,
@@ -257,6 +276,9 @@ class DataMgr {
   bool hasGpus_;
   size_t reservedGpuMem_;
   std::mutex buffer_access_mutex_;
+  std::mutex prefetch_mutex_;
+  std::condition_variable prefetch_cv_;
+  size_t prefetch_reserved_bytes_{0};
 };
 
 std::ostream& operator<<(std::ostream& os, const DataMgr::SystemMemoryUsage&);
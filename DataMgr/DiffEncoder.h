@@ -0,0 +1,168 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef DIFF_ENCODER_H
+#define DIFF_ENCODER_H
+
+#include "IntegerSequenceEncoder.h"
+
+#include "Shared/SequenceEncoding.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Stores every value as its difference to the previous non null value of the chunk, on
+// the narrowest width fitting all of them. See Shared/SequenceEncoding.h for the layout.
+template <typename T>
+class DiffEncoder : public IntegerSequenceEncoder<T> {
+ public:
+  DiffEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : IntegerSequenceEncoder<T>(buffer) {}
+
+ protected:
+  void encodeAndAppend(const T* values, const size_t count) override {
+    for (size_t i = 0; i < count; ++i) {
+      this->validateDataAndUpdateStats(values[i]);
+    }
+    if (!this->num_elems_) {
+      writeSlots(makeHeader(values, count), values, count);
+      return;
+    }
+    Header header;
+    this->buffer_->read(reinterpret_cast<int8_t*>(&header), sizeof(Header), 0);
+    if (slotWidth(header.last, values, count) <= header.slot_width) {
+      writeSlots(header, values, count);
+    } else {
+      // The new differences don't fit the current width, encode the whole chunk again.
+      // The width only grows, so this happens at most three times per chunk.
+      auto chunk_values = decode(header);
+      chunk_values.insert(chunk_values.end(), values, values + count);
+      this->num_elems_ = 0;
+      writeSlots(makeHeader(chunk_values.data(), chunk_values.size()),
+                 chunk_values.data(),
+                 chunk_values.size());
+    }
+  }
+
+  std::vector<T> decode() override {
+    if (!this->num_elems_) {
+      return {};
+    }
+    Header header;
+    this->buffer_->read(reinterpret_cast<int8_t*>(&header), sizeof(Header), 0);
+    return decode(header);
+  }
+
+ private:
+  struct Header {
+    int64_t first;
+    int64_t last;
+    int32_t slot_width;
+    int32_t unused;
+  };
+  static_assert(sizeof(Header) == sequence_encoding::kDiffHeaderBytes);
+
+  // Computes `value - prev`, returning false if it overflows.
+  static bool difference(const int64_t value, const int64_t prev, int64_t& diff) {
+    diff = static_cast<int64_t>(static_cast<uint64_t>(value) -
+                                static_cast<uint64_t>(prev));
+    return ((value ^ prev) & (value ^ diff)) >= 0;
+  }
+
+  // The null marker, the smallest value of the slot type, is left out.
+  static bool fitsSlot(const int64_t diff, const int32_t slot_width) {
+    const auto bound = int64_t(1) << (8 * slot_width - 1);
+    return diff > -bound && diff < bound;
+  }
+
+  // The narrowest slot width for the differences between the consecutive non null
+  // values, starting from `prev`, or 8 if they need the full 64 bits.
+  static int32_t slotWidth(int64_t prev, const T* values, const size_t count) {
+    int32_t slot_width = 1;
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i] == inline_int_null_value<T>()) {
+        continue;
+      }
+      int64_t diff;
+      if (!difference(values[i], prev, diff)) {
+        return 8;
+      }
+      while (slot_width < 8 && !fitsSlot(diff, slot_width)) {
+        slot_width *= 2;
+      }
+      if (slot_width == 8) {
+        return 8;
+      }
+      prev = values[i];
+    }
+    return slot_width;
+  }
+
+  static Header makeHeader(const T* values, const size_t count) {
+    const auto first_it = std::find_if(values, values + count, [](const T value) {
+      return value != inline_int_null_value<T>();
+    });
+    const int64_t first = first_it == values + count ? 0 : *first_it;
+    return {first, first, slotWidth(first, values, count), 0};
+  }
+
+  void writeSlots(Header header, const T* values, const size_t count) {
+    const auto null_slot = sequence_encoding::diff_null_slot(header.slot_width);
+    std::vector<int8_t> slots(count * header.slot_width);
+    for (size_t i = 0; i < count; ++i) {
+      int64_t slot = null_slot;
+      if (values[i] != inline_int_null_value<T>()) {
+        const int64_t value = values[i];
+        slot = header.slot_width == 8 ? value : value - header.last;
+        header.last = value;
+      }
+      // Little endian: the low order bytes of the difference are the slot.
+      std::memcpy(&slots[i * header.slot_width], &slot, header.slot_width);
+    }
+    const auto slots_offset =
+        sequence_encoding::kDiffHeaderBytes + this->num_elems_ * header.slot_width;
+    this->buffer_->write(reinterpret_cast<int8_t*>(&header), sizeof(Header), 0);
+    if (!slots.empty()) {
+      this->buffer_->write(slots.data(), slots.size(), slots_offset);
+    }
+    this->num_elems_ += count;
+    this->truncateBuffer(slots_offset + slots.size());
+  }
+
+  std::vector<T> decode(const Header& header) {
+    std::vector<int8_t> slots(this->num_elems_ * header.slot_width);
+    if (!slots.empty()) {
+      this->buffer_->read(
+          slots.data(), slots.size(), sequence_encoding::kDiffHeaderBytes);
+    }
+    const auto null_slot = sequence_encoding::diff_null_slot(header.slot_width);
+    std::vector<T> values(this->num_elems_);
+    int64_t prev = header.first;
+    for (size_t i = 0; i < values.size(); ++i) {
+      const auto slot =
+          sequence_encoding::read_slot(&slots[i * header.slot_width], header.slot_width);
+      if (slot == null_slot) {
+        values[i] = inline_int_null_value<T>();
+        continue;
+      }
+      prev = header.slot_width == 8 ? slot : prev + slot;
+      values[i] = static_cast<T>(prev);
+    }
+    return values;
+  }
+};  // DiffEncoder
+
+#endif  // DIFF_ENCODER_H
@@ -17,12 +17,43 @@
 #include "Encoder.h"
 #include "ArrayNoneEncoder.h"
 #include "DateDaysEncoder.h"
+#include "DiffEncoder.h"
 #include "FixedLengthArrayNoneEncoder.h"
 #include "FixedLengthEncoder.h"
 #include "Logger/Logger.h"
 #include "NoneEncoder.h"
+#include "RunLengthEncoder.h"
 #include "StringNoneEncoder.h"
 
+double g_bloom_filter_fp_rate{0.01};
+size_t g_bloom_filter_max_bytes{256 * 1024};
+
+namespace {
+
+template <template <typename> class SEQUENCE_ENCODER>
+Encoder* create_sequence_encoder(Data_Namespace::AbstractBuffer* buffer,
+                                 const SQLTypeInfo& sql_type) {
+  switch (sql_type.get_type()) {
+    case kTINYINT:
+      return new SEQUENCE_ENCODER<int8_t>(buffer);
+    case kSMALLINT:
+      return new SEQUENCE_ENCODER<int16_t>(buffer);
+    case kINT:
+      return new SEQUENCE_ENCODER<int32_t>(buffer);
+    case kBIGINT:
+    case kNUMERIC:
+    case kDECIMAL:
+    case kTIME:
+    case kTIMESTAMP:
+    case kDATE:
+      return new SEQUENCE_ENCODER<int64_t>(buffer);
+    default:
+      return 0;
+  }
+}
+
+}  // namespace
+
 Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
                          const SQLTypeInfo sqlType) {
   switch (sqlType.get_compression()) {
@@ -197,6 +228,10 @@ Encoder* Encoder::Create(Data_Namespace::AbstractBuffer* buffer,
       }
       break;
     }
+    case kENCODING_RL:
+      return create_sequence_encoder<RunLengthEncoder>(buffer, sqlType);
+    case kENCODING_DIFF:
+      return create_sequence_encoder<DiffEncoder>(buffer, sqlType);
     case kENCODING_GEOINT: {
       switch (sqlType.get_type()) {
         case kPOINT:
@@ -228,4 +263,147 @@ void Encoder::getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) {
   chunkMetadata->sqlType = buffer_->getSqlType();
   chunkMetadata->numBytes = buffer_->size();
   chunkMetadata->numElements = num_elems_;
+  chunkMetadata->zoneMap =
+      zone_map_builder_ ? zone_map_builder_->getZoneMap(num_elems_) : nullptr;
+  chunkMetadata->bloomFilter =
+      bloom_filter_builder_ ? bloom_filter_builder_->getBloomFilter(num_elems_) : nullptr;
+}
+
+void Encoder::initZoneMap() {
+  const auto sql_type = buffer_ ? buffer_->getSqlType() : SQLTypeInfo();
+  if (sql_type.is_integer() || sql_type.is_time()) {
+    zone_map_builder_.emplace();
+  }
+}
+
+void Encoder::initBloomFilter() {
+  const auto sql_type = buffer_ ? buffer_->getSqlType() : SQLTypeInfo();
+  if (sql_type.is_integer() || sql_type.is_time() || sql_type.is_dict_encoded_string()) {
+    bloom_filter_builder_.emplace();
+  }
+}
+
+void ZoneMapBuilder::write(FILE* f) const {
+  const uint32_t block_count = zone_map_.blocks.size();
+  fwrite((int8_t*)&valid_, sizeof(bool), 1, f);
+  fwrite((int8_t*)&zone_map_.block_rows, sizeof(size_t), 1, f);
+  fwrite((int8_t*)&zone_map_.num_rows, sizeof(size_t), 1, f);
+  fwrite((int8_t*)&block_count, sizeof(uint32_t), 1, f);
+  for (const auto& block : zone_map_.blocks) {
+    fwrite((int8_t*)&block.min, sizeof(int64_t), 1, f);
+    fwrite((int8_t*)&block.max, sizeof(int64_t), 1, f);
+    fwrite((int8_t*)&block.has_nulls, sizeof(bool), 1, f);
+  }
+}
+
+void ZoneMapBuilder::read(FILE* f) {
+  uint32_t block_count{0};
+  fread((int8_t*)&valid_, sizeof(bool), 1, f);
+  fread((int8_t*)&zone_map_.block_rows, sizeof(size_t), 1, f);
+  fread((int8_t*)&zone_map_.num_rows, sizeof(size_t), 1, f);
+  fread((int8_t*)&block_count, sizeof(uint32_t), 1, f);
+  if (!valid_ || block_count > kMaxBlockCount || zone_map_.block_rows < kMinBlockRows) {
+    invalidate();
+    return;
+  }
+  zone_map_.blocks.resize(block_count);
+  for (auto& block : zone_map_.blocks) {
+    fread((int8_t*)&block.min, sizeof(int64_t), 1, f);
+    fread((int8_t*)&block.max, sizeof(int64_t), 1, f);
+    fread((int8_t*)&block.has_nulls, sizeof(bool), 1, f);
+  }
+}
+
+void Encoder::writeZoneMap(FILE* f) const {
+  if (zone_map_builder_) {
+    zone_map_builder_->write(f);
+  } else {
+    ZoneMapBuilder().write(f);
+  }
+}
+
+void Encoder::readZoneMap(FILE* f, const bool has_zone_map) {
+  if (!zone_map_builder_) {
+    return;
+  }
+  if (has_zone_map) {
+    zone_map_builder_->read(f);
+  } else {
+    zone_map_builder_->invalidate();
+  }
+}
+
+void BloomFilterBuilder::reset() {
+  bloom_filter_ = BloomFilter{g_bloom_filter_fp_rate};
+  num_slices_ = 0;
+  max_bytes_ = g_bloom_filter_max_bytes;
+  valid_ = true;
+}
+
+void BloomFilterBuilder::invalidate() {
+  bloom_filter_ = BloomFilter{g_bloom_filter_fp_rate};
+  num_slices_ = 0;
+  valid_ = false;
+}
+
+void BloomFilterBuilder::write(FILE* f) const {
+  CHECK(valid_);
+  const uint32_t slice_count = bloom_filter_.slices.size();
+  fwrite((int8_t*)&bloom_filter_.num_rows, sizeof(size_t), 1, f);
+  fwrite((int8_t*)&bloom_filter_.fp_rate, sizeof(double), 1, f);
+  fwrite((int8_t*)&slice_count, sizeof(uint32_t), 1, f);
+  for (const auto& slice : bloom_filter_.slices) {
+    fwrite((int8_t*)&slice.num_hashes, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&slice.capacity, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&slice.count, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&slice.num_bits, sizeof(size_t), 1, f);
+    fwrite((int8_t*)slice.words.data(), sizeof(uint64_t), slice.words.size(), f);
+  }
+}
+
+bool BloomFilterBuilder::read(FILE* f) {
+  reset();
+  uint32_t slice_count{0};
+  bool ok = fread((int8_t*)&bloom_filter_.num_rows, sizeof(size_t), 1, f) == 1 &&
+            fread((int8_t*)&bloom_filter_.fp_rate, sizeof(double), 1, f) == 1 &&
+            fread((int8_t*)&slice_count, sizeof(uint32_t), 1, f) == 1 &&
+            bloom_filter_.fp_rate > 0 && bloom_filter_.fp_rate < 1;
+  size_t num_bytes{0};
+  for (uint32_t i = 0; ok && i < slice_count; ++i) {
+    BloomFilter::Slice slice;
+    ok = fread((int8_t*)&slice.num_hashes, sizeof(size_t), 1, f) == 1 &&
+         fread((int8_t*)&slice.capacity, sizeof(size_t), 1, f) == 1 &&
+         fread((int8_t*)&slice.count, sizeof(size_t), 1, f) == 1 &&
+         fread((int8_t*)&slice.num_bits, sizeof(size_t), 1, f) == 1 &&
+         slice.num_bits > 0 && slice.num_bits % 64 == 0;
+    num_bytes += ok ? slice.num_bits / 8 : 0;
+    // A filter larger than the current limit is dropped like one which grew past it.
+    ok = ok && num_bytes <= max_bytes_;
+    if (ok) {
+      slice.words.resize(slice.num_bits / 64);
+      ok = fread((int8_t*)slice.words.data(), sizeof(uint64_t), slice.words.size(), f) ==
+           slice.words.size();
+      bloom_filter_.slices.push_back(std::move(slice));
+    }
+  }
+  if (!ok) {
+    invalidate();
+    return false;
+  }
+  num_slices_ = bloom_filter_.slices.size();
+  return true;
+}
+
+void Encoder::writeBloomFilter(FILE* f) const {
+  CHECK(hasBloomFilter());
+  bloom_filter_builder_->write(f);
+}
+
+void Encoder::readBloomFilter(FILE* f) {
+  if (!bloom_filter_builder_) {
+    return;
+  }
+  if (!f || !bloom_filter_builder_->read(f)) {
+    bloom_filter_builder_->invalidate();
+  }
 }
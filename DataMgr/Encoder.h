@@ -22,9 +22,11 @@
 #include "../Shared/types.h"
 #include "ChunkMetadata.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <limits>
+#include <optional>
 #include <stdexcept>
 #include <vector>
 
@@ -143,6 +145,144 @@ class DateDaysOverflowValidator {
   int64_t min_;
 };
 
+// Builds the zone map of a chunk as values get appended to it. Blocks start at
+// kMinBlockRows rows, whenever the chunk outgrows kMaxBlockCount blocks pairs of blocks
+// are merged and the block size doubles, so that the zone map fits in the metadata page
+// of the chunk.
+class ZoneMapBuilder {
+ public:
+  ZoneMapBuilder() { reset(); }
+
+  template <typename T>
+  void append(const T* values, const size_t count, const T null_value) {
+    if (!valid_) {
+      return;
+    }
+    size_t i = 0;
+    while (i < count) {
+      if (zone_map_.num_rows == zone_map_.block_rows * zone_map_.blocks.size()) {
+        if (zone_map_.blocks.size() == kMaxBlockCount) {
+          mergeBlocks();
+        }
+        zone_map_.blocks.push_back(kEmptyBlock);
+      }
+      auto& block = zone_map_.blocks.back();
+      const size_t block_end = zone_map_.block_rows * zone_map_.blocks.size();
+      const size_t block_count = std::min(count - i, block_end - zone_map_.num_rows);
+      for (const size_t end = i + block_count; i < end; ++i) {
+        if (values[i] == null_value) {
+          block.has_nulls = true;
+        } else {
+          block.min = std::min(block.min, static_cast<int64_t>(values[i]));
+          block.max = std::max(block.max, static_cast<int64_t>(values[i]));
+        }
+      }
+      zone_map_.num_rows += block_count;
+    }
+  }
+
+  // Starts over on an empty chunk.
+  void reset() {
+    zone_map_ = ZoneMap{kMinBlockRows, 0, {}};
+    valid_ = true;
+  }
+
+  // The values of the chunk changed in a way the zone map can't follow, the chunk won't
+  // have a zone map until it is rewritten.
+  void invalidate() {
+    zone_map_ = ZoneMap{kMinBlockRows, 0, {}};
+    valid_ = false;
+  }
+
+  // Returns the zone map if it covers the `num_rows` rows of the chunk.
+  std::shared_ptr<const ZoneMap> getZoneMap(const size_t num_rows) const {
+    if (!valid_ || zone_map_.num_rows != num_rows || zone_map_.blocks.empty()) {
+      return nullptr;
+    }
+    return std::make_shared<const ZoneMap>(zone_map_);
+  }
+
+  void write(FILE* f) const;
+  void read(FILE* f);
+
+ private:
+  static constexpr size_t kMinBlockRows{1 << 16};
+  static constexpr size_t kMaxBlockCount{128};
+  static constexpr ZoneMap::Block kEmptyBlock{std::numeric_limits<int64_t>::max(),
+                                              std::numeric_limits<int64_t>::min(),
+                                              false};
+
+  void mergeBlocks() {
+    auto& blocks = zone_map_.blocks;
+    for (size_t i = 0; i < blocks.size() / 2; ++i) {
+      const auto& lhs = blocks[2 * i];
+      const auto& rhs = blocks[2 * i + 1];
+      blocks[i] = ZoneMap::Block{std::min(lhs.min, rhs.min),
+                                 std::max(lhs.max, rhs.max),
+                                 lhs.has_nulls || rhs.has_nulls};
+    }
+    blocks.resize(blocks.size() / 2);
+    zone_map_.block_rows *= 2;
+  }
+
+  ZoneMap zone_map_;
+  bool valid_;
+};
+
+// Builds the Bloom filter of a chunk as values get appended to it. The filter grows with
+// the distinct values of the chunk at the false positive rate of --bloom-filter-fp-rate,
+// it is dropped once it gets larger than --bloom-filter-max-bytes.
+class BloomFilterBuilder {
+ public:
+  BloomFilterBuilder() { reset(); }
+
+  template <typename T>
+  void append(const T* values, const size_t count, const T null_value) {
+    if (!valid_) {
+      return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      if (values[i] != null_value &&
+          bloom_filter_.insert(static_cast<int64_t>(values[i])) &&
+          bloom_filter_.slices.size() != num_slices_) {
+        num_slices_ = bloom_filter_.slices.size();
+        if (bloom_filter_.numBytes() > max_bytes_) {
+          invalidate();
+          return;
+        }
+      }
+    }
+    bloom_filter_.num_rows += count;
+  }
+
+  // Starts over on an empty chunk.
+  void reset();
+
+  // The values of the chunk changed in a way the filter can't follow, or there are too
+  // many of them. The chunk won't have a Bloom filter until it is rewritten.
+  void invalidate();
+
+  bool isValid() const { return valid_; }
+
+  // Returns the Bloom filter if it covers the `num_rows` rows of the chunk.
+  std::shared_ptr<const BloomFilter> getBloomFilter(const size_t num_rows) const {
+    if (!valid_ || bloom_filter_.num_rows != num_rows || num_rows == 0) {
+      return nullptr;
+    }
+    return std::make_shared<const BloomFilter>(bloom_filter_);
+  }
+
+  void write(FILE* f) const;
+  // Returns false, and invalidates the builder, if the file has no usable filter.
+  bool read(FILE* f);
+
+ private:
+  BloomFilter bloom_filter_;
+  size_t num_slices_;
+  size_t max_bytes_;
+  bool valid_;
+};
+
 class Encoder {
  public:
   static Encoder* Create(Data_Namespace::AbstractBuffer* buffer,
@@ -233,13 +373,124 @@ class Encoder {
   size_t getNumElems() const { return num_elems_; }
   void setNumElems(const size_t num_elems) { num_elems_ = num_elems; }
 
+  //! Persist the zone map of the chunk after the rest of its metadata. Encoders without
+  //! zone maps write an empty one.
+  void writeZoneMap(FILE* f) const;
+  //! Read the zone map written by writeZoneMap, `has_zone_map` is false for metadata
+  //! written before zone maps existed.
+  void readZoneMap(FILE* f, const bool has_zone_map);
+  //! Whether the chunk has a Bloom filter to persist.
+  bool hasBloomFilter() const {
+    return bloom_filter_builder_ && bloom_filter_builder_->isValid();
+  }
+  //! Persist the Bloom filter of the chunk. Unlike the zone map, it doesn't fit in the
+  //! metadata page and goes to a file of its own, see FileBuffer::writeBloomFilter.
+  void writeBloomFilter(FILE* f) const;
+  //! Read the Bloom filter written by writeBloomFilter, `f` is null when there is no
+  //! usable filter for the chunk.
+  void readBloomFilter(FILE* f);
+
+  /**
+   * Add values appended to the chunk outside of appendData, e.g. by the metadata scan of
+   * a foreign table, to the Bloom filter of the chunk. The filter is only kept if every
+   * value of the chunk gets added this way.
+   *
+   * @param src_data - the unencoded values, as passed to updateStats
+   * @param num_elements - the number of values
+   */
+  virtual void addToBloomFilter(const int8_t* const src_data,
+                                const size_t num_elements) {}
+
  protected:
+  //! Keep the zone map up to date with `count` values written at `offset`, see
+  //! appendData. Must be called before updating the number of elements.
+  template <typename T>
+  void updateZoneMap(const T* values,
+                     const size_t count,
+                     const T null_value,
+                     const int64_t offset) {
+    if (!zone_map_builder_) {
+      return;
+    }
+    if (offset == 0 && count >= num_elems_) {
+      zone_map_builder_->reset();
+    } else if (offset != -1) {
+      zone_map_builder_->invalidate();
+      return;
+    }
+    zone_map_builder_->append(values, count, null_value);
+  }
+
+  void invalidateZoneMap() {
+    if (zone_map_builder_) {
+      zone_map_builder_->invalidate();
+    }
+  }
+
+  //! Reset the zone map along with the chunk stats. Unlike the stats, the zone map of a
+  //! chunk which still has rows can't be recomputed through updateStats.
+  void resetZoneMap() {
+    if (zone_map_builder_) {
+      if (num_elems_ == 0) {
+        zone_map_builder_->reset();
+      } else {
+        zone_map_builder_->invalidate();
+      }
+    }
+  }
+
+  //! Give chunks of integer and time columns a zone map.
+  void initZoneMap();
+
+  //! Keep the Bloom filter up to date with `count` values written at `offset`, see
+  //! appendData. Must be called before updating the number of elements.
+  template <typename T>
+  void updateBloomFilter(const T* values,
+                         const size_t count,
+                         const T null_value,
+                         const int64_t offset) {
+    if (!bloom_filter_builder_) {
+      return;
+    }
+    if (offset == 0 && count >= num_elems_) {
+      bloom_filter_builder_->reset();
+    } else if (offset != -1) {
+      bloom_filter_builder_->invalidate();
+      return;
+    }
+    bloom_filter_builder_->append(values, count, null_value);
+  }
+
+  void invalidateBloomFilter() {
+    if (bloom_filter_builder_) {
+      bloom_filter_builder_->invalidate();
+    }
+  }
+
+  //! Reset the Bloom filter along with the chunk stats, see resetZoneMap.
+  void resetBloomFilter() {
+    if (bloom_filter_builder_) {
+      if (num_elems_ == 0) {
+        bloom_filter_builder_->reset();
+      } else {
+        bloom_filter_builder_->invalidate();
+      }
+    }
+  }
+
+  //! Give chunks of integer, time and dictionary encoded string columns a Bloom filter.
+  void initBloomFilter();
+
   size_t num_elems_;
 
   Data_Namespace::AbstractBuffer* buffer_;
 
   DecimalOverflowValidator decimal_overflow_validator_;
   DateDaysOverflowValidator date_days_overflow_validator_;
+  // Only set by the encoders of integer and time columns.
+  std::optional<ZoneMapBuilder> zone_map_builder_;
+  // Only set by the encoders of integer, time and dictionary encoded string columns.
+  std::optional<BloomFilterBuilder> bloom_filter_builder_;
 };
 
 #endif  // Encoder_h
@@ -22,6 +22,7 @@
 
 #include "DataMgr/FileMgr/FileBuffer.h"
 
+#include <boost/filesystem.hpp>
 #include <future>
 #include <map>
 #include <thread>
@@ -169,6 +170,7 @@ size_t FileBuffer::freeMetadataPages() {
   while (metadataPages_.pageVersions.size() > 0) {
     metadataPages_.pop();
   }
+  removeBloomFilter();
   return num_pages_freed;
 }
 
@@ -247,33 +249,40 @@ static size_t readForThread(FileBuffer* fileBuffer, const readThreadDS threadDS)
   size_t totalBytesRead = 0;
   bool isFirstPage = threadDS.t_isFirstPage;
 
-  // Traverse the logical pages
-  for (size_t pageNum = startPage; pageNum < endPage; ++pageNum) {
+  // Traverse the logical pages, reading the runs of pages which are next to each other
+  // in the same file with one read
+  size_t pageNum = startPage;
+  while (pageNum < endPage && bytesLeft > 0) {
     CHECK(threadDS.multiPages[pageNum].pageSize == fileBuffer->pageSize());
     Page page = threadDS.multiPages[pageNum].current().page;
 
     FileInfo* fileInfo = threadDS.t_fm->getFileInfoForFileId(page.fileId);
     CHECK(fileInfo);
 
-    // Read the page into the destination (dst) buffer at its
-    // current (cur) location
-    size_t bytesRead = 0;
-    if (isFirstPage) {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + threadDS.t_startPageOffset +
-              fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize() - threadDS.t_startPageOffset, bytesLeft),
-          curPtr);
-      isFirstPage = false;
-    } else {
-      bytesRead = fileInfo->read(
-          page.pageNum * fileBuffer->pageSize() + fileBuffer->reservedHeaderSize(),
-          min(fileBuffer->pageDataSize(), bytesLeft),
-          curPtr);
+    const size_t pageOffset = isFirstPage ? threadDS.t_startPageOffset : 0;
+    isFirstPage = false;
+    size_t runBytes = min(fileBuffer->pageDataSize() - pageOffset, bytesLeft);
+    size_t runEndPage = pageNum + 1;
+    while (runEndPage < endPage && runBytes < bytesLeft) {
+      CHECK(threadDS.multiPages[runEndPage].pageSize == fileBuffer->pageSize());
+      const Page& nextPage = threadDS.multiPages[runEndPage].current().page;
+      if (nextPage.fileId != page.fileId ||
+          nextPage.pageNum != page.pageNum + (runEndPage - pageNum)) {
+        break;
+      }
+      runBytes = min(runBytes + fileBuffer->pageDataSize(), bytesLeft);
+      ++runEndPage;
     }
+
+    // Read the pages into the destination (dst) buffer at its
+    // current (cur) location
+    size_t bytesRead = fileInfo->readPageData(
+        page.pageNum, fileBuffer->reservedHeaderSize(), pageOffset, runBytes, curPtr);
+    CHECK_EQ(bytesRead, runBytes);
     curPtr += bytesRead;
     bytesLeft -= bytesRead;
     totalBytesRead += bytesRead;
+    pageNum = runEndPage;
   }
   CHECK(bytesLeft == 0);
 
@@ -440,7 +449,7 @@ void FileBuffer::readMetadata(const Page& page) {
                       // encodingType, encodingBits all as int
   fread((int8_t*)&(typeData[0]), sizeof(int32_t), typeData.size(), f);
   int32_t version = typeData[0];
-  CHECK(version == METADATA_VERSION);  // add backward compatibility code here
+  CHECK(version >= 0 && version <= METADATA_VERSION);
   bool has_encoder = static_cast<bool>(typeData[1]);
   if (has_encoder) {
     sql_type_.set_type(static_cast<SQLTypes>(typeData[2]));
@@ -453,6 +462,7 @@ void FileBuffer::readMetadata(const Page& page) {
     sql_type_.set_size(typeData[9]);
     initEncoder(sql_type_);
     encoder_->readMetadata(f);
+    encoder_->readZoneMap(f, version >= 1);
   }
 }
 
@@ -483,8 +493,73 @@ void FileBuffer::writeMetadata(const int32_t epoch) {
   fwrite((int8_t*)&(typeData[0]), sizeof(int32_t), typeData.size(), f);
   if (hasEncoder()) {  // redundant
     encoder_->writeMetadata(f);
+    encoder_->writeZoneMap(f);
   }
+  // Positional reads of the file, as when compacting it, don't see buffered writes.
+  fm_->getFileInfoForFileId(page.fileId)->flush();
   metadataPages_.push(page, epoch);
+  if (hasEncoder()) {
+    writeBloomFilter(epoch);
+  }
+}
+
+// Bloom filters can be much larger than the metadata page, each one goes to a file of its
+// own in the directory of the file manager. The file is tagged with the epoch of the
+// metadata page it goes with, and a filter whose epoch doesn't match the current metadata
+// page of the chunk, e.g. after a rollback, is ignored.
+std::string FileBuffer::getBloomFilterPath() const {
+  std::string file_name;
+  for (const auto key : chunkKey_) {
+    file_name += (file_name.empty() ? "" : "_") + std::to_string(key);
+  }
+  return (fm_->getFilePath(FileMgr::BLOOM_FILTER_DIR_NAME) / file_name).string();
+}
+
+void FileBuffer::writeBloomFilter(const int32_t epoch) const {
+  if (!encoder_->hasBloomFilter()) {
+    removeBloomFilter();
+    return;
+  }
+  const auto path = getBloomFilterPath();
+  boost::filesystem::create_directories(boost::filesystem::path(path).parent_path());
+  // Written next to the filter it replaces and renamed over it, so that the file always
+  // holds a whole filter.
+  const auto tmp_path = path + ".tmp";
+  FILE* f = fopen(tmp_path.c_str(), "wb");
+  CHECK(f) << "Could not create Bloom filter file " << tmp_path;
+  fwrite((int8_t*)&epoch, sizeof(int32_t), 1, f);
+  encoder_->writeBloomFilter(f);
+  CHECK_EQ(fflush(f), 0) << "Could not write Bloom filter file " << tmp_path;
+#ifdef __APPLE__
+  const int32_t sync_result = fcntl(fileno(f), 51);
+#else
+  const int32_t sync_result = omnisci::fsync(fileno(f));
+#endif
+  CHECK_EQ(sync_result, 0) << "Could not sync Bloom filter file " << tmp_path;
+  fclose(f);
+  boost::filesystem::rename(tmp_path, path);
+}
+
+void FileBuffer::readBloomFilter(const int32_t epoch) {
+  if (!hasEncoder()) {
+    return;
+  }
+  FILE* f = fopen(getBloomFilterPath().c_str(), "rb");
+  int32_t file_epoch{-1};
+  if (f && fread((int8_t*)&file_epoch, sizeof(int32_t), 1, f) == 1 &&
+      file_epoch == epoch) {
+    encoder_->readBloomFilter(f);
+  } else {
+    encoder_->readBloomFilter(nullptr);
+  }
+  if (f) {
+    fclose(f);
+  }
+}
+
+void FileBuffer::removeBloomFilter() const {
+  boost::system::error_code ec;
+  boost::filesystem::remove(getBloomFilterPath(), ec);
 }
 
 void FileBuffer::append(int8_t* src,
@@ -637,6 +712,7 @@ std::string FileBuffer::dump() const {
 void FileBuffer::initMetadataAndPageDataSize() {
   CHECK(metadataPages_.current().page.fileId != -1);  // was initialized
   readMetadata(metadataPages_.current().page);
+  readBloomFilter(metadataPages_.current().epoch);
   pageDataSize_ = pageSize_ - reservedHeaderSize_;
 }
 
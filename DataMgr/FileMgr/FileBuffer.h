@@ -33,7 +33,9 @@
 using namespace Data_Namespace;
 
 #define NUM_METADATA 10
-#define METADATA_VERSION 0
+// Version 1 adds the zone map of the chunk after the encoder metadata. The Bloom filter
+// of the chunk isn't part of the metadata page, see FileBuffer::writeBloomFilter.
+#define METADATA_VERSION 1
 #define METADATA_PAGE_SIZE 4096
 
 namespace File_Namespace {
@@ -179,6 +181,10 @@ class FileBuffer : public AbstractBuffer {
                    const bool writeMetadata = false);
   void writeMetadata(const int32_t epoch);
   void readMetadata(const Page& page);
+  std::string getBloomFilterPath() const;
+  void writeBloomFilter(const int32_t epoch) const;
+  void readBloomFilter(const int32_t epoch);
+  void removeBloomFilter() const;
   void calcHeaderBuffer();
 
   void freePage(const Page& page, const bool isRolloff);
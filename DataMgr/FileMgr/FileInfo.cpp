@@ -20,6 +20,8 @@
 #include "FileMgr.h"
 #include "Page.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <utility>
 using namespace std;
 
@@ -54,18 +56,75 @@ void FileInfo::initNewFile() {
     File_Namespace::write(f, pageId * pageSize, sizeof(int32_t), headerSizePtr);
     freePages.insert(pageId);
   }
+  flush();
   isDirty = true;
 }
 
+// Reads don't go through the stream of the file, so writes are flushed for the reads to
+// see them.
+void FileInfo::flush() {
+  if (fflush(f) != 0) {
+    LOG(FATAL) << "Error trying to flush changes to file, the error was: "
+               << std::strerror(errno);
+  }
+}
+
 size_t FileInfo::write(const size_t offset, const size_t size, const int8_t* buf) {
   std::lock_guard<std::mutex> lock(readWriteMutex_);
   isDirty = true;
-  return File_Namespace::write(f, offset, size, buf);
+  const auto bytes_written = File_Namespace::write(f, offset, size, buf);
+  flush();
+  return bytes_written;
 }
 
+// Reads are positional, so they need no lock and reads of the same file run
+// concurrently.
 size_t FileInfo::read(const size_t offset, const size_t size, int8_t* buf) {
-  std::lock_guard<std::mutex> lock(readWriteMutex_);
-  return File_Namespace::read(f, offset, size, buf);
+  const auto bytes_read = omnisci::pread(fileno(f), buf, size, offset);
+  if (bytes_read < 0) {
+    LOG(FATAL) << "Error trying to read from file, the error was: "
+               << std::strerror(errno);
+  }
+  return bytes_read;
+}
+
+size_t FileInfo::readPageData(const size_t page_num,
+                              const size_t header_size,
+                              const size_t offset,
+                              const size_t size,
+                              int8_t* buf) {
+  CHECK_LT(offset, pageSize - header_size);
+  // The headers of the pages after the first one are read into a scratch buffer.
+  std::vector<int8_t> header(header_size);
+  std::vector<std::pair<int8_t*, size_t>> buffers;
+  size_t bytes_left = size;
+  size_t page_data_size = pageSize - header_size - offset;
+  while (bytes_left > 0) {
+    if (!buffers.empty()) {
+      buffers.emplace_back(header.data(), header_size);
+      page_data_size = pageSize - header_size;
+    }
+    const auto bytes_to_read = std::min(page_data_size, bytes_left);
+    buffers.emplace_back(buf + size - bytes_left, bytes_to_read);
+    bytes_left -= bytes_to_read;
+  }
+  const auto bytes_read =
+      omnisci::preadv(fileno(f), buffers, page_num * pageSize + header_size + offset);
+  if (bytes_read < 0) {
+    LOG(FATAL) << "Error trying to read from file, the error was: "
+               << std::strerror(errno);
+  }
+  // Only the page data counts, the buffers at odd positions are headers.
+  size_t data_bytes_read{0};
+  size_t bytes_to_count = bytes_read;
+  for (size_t i = 0; i < buffers.size() && bytes_to_count > 0; ++i) {
+    const auto buffer_bytes_read = std::min(buffers[i].second, bytes_to_count);
+    if (i % 2 == 0) {
+      data_bytes_read += buffer_bytes_read;
+    }
+    bytes_to_count -= buffer_bytes_read;
+  }
+  return data_bytes_read;
 }
 
 void FileInfo::openExistingFile(std::vector<HeaderInfo>& headerVec) {
@@ -185,6 +244,7 @@ void FileInfo::freePage(int pageId, const bool isRolloff, int32_t epoch) {
                         pageId * pageSize + sizeof(int32_t),
                         sizeof(epoch_freed_page),
                         reinterpret_cast<const int8_t*>(epoch_freed_page));
+  flush();
   fileMgr->free_page(std::make_pair(this, pageId));
   isDirty = true;
 
@@ -244,6 +304,7 @@ void FileInfo::freePageImmediate(int32_t page_num) {
     int32_t zero{0};
     File_Namespace::write(
         f, page_num * pageSize, sizeof(int32_t), reinterpret_cast<const int8_t*>(&zero));
+    flush();
     freePageDeferred(page_num);
   }
 }
@@ -258,6 +319,7 @@ void FileInfo::recoverPage(const ChunkKey& chunk_key, int32_t page_num) {
                           page_num * pageSize + sizeof(int32_t),
                           2 * sizeof(int32_t),
                           reinterpret_cast<const int8_t*>(chunk_key.data()));
+    flush();
   }
 }
 }  // namespace File_Namespace
@@ -61,7 +61,7 @@ struct FileInfo {
   bool isDirty{false};         // True if writes have occured since last sync
   std::set<size_t> freePages;  /// set of page numbers of free pages
   std::mutex freePagesMutex_;
-  std::mutex readWriteMutex_;
+  std::mutex readWriteMutex_;  /// serializes writes, reads don't take it
 
   /// Constructor
   FileInfo(FileMgr* fileMgr,
@@ -84,6 +84,18 @@ struct FileInfo {
   size_t write(const size_t offset, const size_t size, const int8_t* buf);
   size_t read(const size_t offset, const size_t size, int8_t* buf);
 
+  /**
+   * Reads `size` bytes of page data into `buf`, starting `offset` bytes into the data of
+   * page `page_num` and going on with the data of the next pages of the file. The data of
+   * a page starts `header_size` bytes into the page. The pages are read with one
+   * positional read.
+   */
+  size_t readPageData(const size_t page_num,
+                      const size_t header_size,
+                      const size_t offset,
+                      const size_t size,
+                      int8_t* buf);
+
   void openExistingFile(std::vector<HeaderInfo>& headerVec);
   /// Prints a summary of the file to stdout
   void print(bool pagesummary);
@@ -91,6 +103,9 @@ struct FileInfo {
   /// Returns the number of bytes used by the file
   inline size_t size() const { return pageSize * numPages; }
 
+  /// Flushes the writes buffered by the stream of the file
+  void flush();
+
   /// Syncs file to disk via a buffer flush and then a sync (fflush and fsync on posix
   /// systems)
   int32_t syncToDisk();
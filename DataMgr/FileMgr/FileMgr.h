@@ -376,6 +376,7 @@ class FileMgr : public AbstractBufferMgr {  // implements
   static constexpr char EPOCH_FILENAME[] = "epoch_metadata";
   static constexpr char DB_META_FILENAME[] = "dbmeta";
   static constexpr char FILE_MGR_VERSION_FILENAME[] = "filemgr_version";
+  static constexpr char BLOOM_FILTER_DIR_NAME[] = "bloom_filters";
   static constexpr int32_t INVALID_VERSION = -1;
 
  protected:
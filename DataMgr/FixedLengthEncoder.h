@@ -34,6 +34,8 @@ class FixedLengthEncoder : public Encoder {
  public:
   FixedLengthEncoder(Data_Namespace::AbstractBuffer* buffer) : Encoder(buffer) {
     resetChunkStats();
+    initZoneMap();
+    initBloomFilter();
   }
 
   std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
@@ -53,6 +55,14 @@ class FixedLengthEncoder : public Encoder {
       size_t ri = replicating ? 0 : i;
       encoded_data.get()[i] = encodeDataAndUpdateStats(unencoded_data[ri]);
     }
+    updateZoneMap(encoded_data.get(),
+                  num_elems_to_append,
+                  std::numeric_limits<V>::min(),
+                  offset);
+    updateBloomFilter(encoded_data.get(),
+                      num_elems_to_append,
+                      std::numeric_limits<V>::min(),
+                      offset);
 
     // assume always CPU_BUFFER?
     if (offset == -1) {
@@ -84,11 +94,16 @@ class FixedLengthEncoder : public Encoder {
   std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
     auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
     chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    if (bloom_filter_builder_) {
+      chunk_metadata->bloomFilter = bloom_filter_builder_->getBloomFilter(num_elems_);
+    }
     return chunk_metadata;
   }
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -100,6 +115,8 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -110,14 +127,28 @@ class FixedLengthEncoder : public Encoder {
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    // The values also have to go through addToBloomFilter for the chunk to keep its
+    // Bloom filter.
+    invalidateZoneMap();
     const T* unencoded_data = reinterpret_cast<const T*>(src_data);
     for (size_t i = 0; i < num_elements; ++i) {
       encodeDataAndUpdateStats(unencoded_data[i]);
     }
   }
 
+  void addToBloomFilter(const int8_t* const src_data,
+                        const size_t num_elements) override {
+    if (bloom_filter_builder_) {
+      bloom_filter_builder_->append(reinterpret_cast<const T*>(src_data),
+                                    num_elements,
+                                    std::numeric_limits<T>::min());
+    }
+  }
+
   void updateStatsEncoded(const int8_t* const dst_data,
                           const size_t num_elements) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     const V* data = reinterpret_cast<const V*>(dst_data);
 
     std::tie(dataMin, dataMax, has_nulls) = tbb::parallel_reduce(
@@ -159,6 +190,8 @@ class FixedLengthEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     const auto that_typed = static_cast<const FixedLengthEncoder<T, V>&>(that);
     if (that_typed.has_nulls) {
       has_nulls = true;
@@ -174,6 +207,8 @@ class FixedLengthEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    zone_map_builder_ = castedEncoder->zone_map_builder_;
+    bloom_filter_builder_ = castedEncoder->bloom_filter_builder_;
   }
 
   void writeMetadata(FILE* f) override {
@@ -210,6 +245,8 @@ class FixedLengthEncoder : public Encoder {
     dataMin = std::numeric_limits<T>::max();
     dataMax = std::numeric_limits<T>::lowest();
     has_nulls = false;
+    resetZoneMap();
+    resetBloomFilter();
   }
 
   T dataMin;
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    IntegerSequenceEncoder.h
+ * @brief   Common base of the run length (RL) and differential (DIFF) integer encoders.
+ *
+ * These encoders don't store one fixed width slot per row (see
+ * Shared/SequenceEncoding.h), so rows can't be overwritten in place; any write which
+ * isn't an append decodes the chunk and encodes it again. Nor can they be read by
+ * position, so the query engine reads the rows decoded by getDecodedRows().
+ */
+
+#ifndef INTEGER_SEQUENCE_ENCODER_H
+#define INTEGER_SEQUENCE_ENCODER_H
+
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "AbstractBuffer.h"
+#include "Encoder.h"
+
+#include <Shared/DatumFetchers.h>
+
+class SequenceEncoder : public Encoder {
+ public:
+  SequenceEncoder(Data_Namespace::AbstractBuffer* buffer) : Encoder(buffer) {}
+
+  // Rewrites the chunk without the rows at the given offsets, which must be sorted.
+  virtual void removeRows(const std::vector<uint64_t>& sorted_offsets) = 0;
+
+  // Copies the values of all the rows, unencoded and in row order, to `dst`.
+  virtual void copyDecodedRows(int8_t* dst) = 0;
+
+  // Returns the values of all the rows, unencoded and in row order. They are decoded on
+  // the first call and kept with the encoder, so with the chunk buffer, until the chunk
+  // changes. Note that the buffer pools don't account for their size.
+  virtual const int8_t* getDecodedRows() = 0;
+};
+
+template <typename T>
+class IntegerSequenceEncoder : public SequenceEncoder {
+ public:
+  IntegerSequenceEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : SequenceEncoder(buffer) {
+    resetChunkStats();
+  }
+
+  std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
+                                            const size_t num_elems_to_append,
+                                            const SQLTypeInfo&,
+                                            const bool replicating = false,
+                                            const int64_t offset = -1) override {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    std::vector<T> replicated_data;
+    if (replicating) {
+      replicated_data.assign(num_elems_to_append,
+                             num_elems_to_append ? unencoded_data[0] : T{});
+      unencoded_data = replicated_data.data();
+    }
+    clearDecodedRows();
+    if (offset == -1) {
+      encodeAndAppend(unencoded_data, num_elems_to_append);
+      if (!replicating) {
+        src_data += num_elems_to_append * sizeof(T);
+      }
+    } else {
+      CHECK(!replicating);
+      CHECK_GE(offset, 0);
+      auto values = offset > 0 ? decode() : std::vector<T>{};
+      CHECK_LE(static_cast<size_t>(offset), values.size());
+      values.resize(offset);
+      values.insert(values.end(), unencoded_data, unencoded_data + num_elems_to_append);
+      rewrite(values);
+    }
+    auto chunk_metadata = std::make_shared<ChunkMetadata>();
+    getMetadata(chunk_metadata);
+    return chunk_metadata;
+  }
+
+  void removeRows(const std::vector<uint64_t>& sorted_offsets) override {
+    clearDecodedRows();
+    const auto values = decode();
+    std::vector<T> kept_values;
+    kept_values.reserve(values.size());
+    auto offset_it = sorted_offsets.begin();
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (offset_it != sorted_offsets.end() && *offset_it == i) {
+        ++offset_it;
+        continue;
+      }
+      kept_values.push_back(values[i]);
+    }
+    rewrite(kept_values);
+  }
+
+  void copyDecodedRows(int8_t* dst) override {
+    const auto values = decode();
+    std::memcpy(dst, values.data(), values.size() * sizeof(T));
+  }
+
+  const int8_t* getDecodedRows() override {
+    std::lock_guard<std::mutex> lock(decoded_rows_mutex_);
+    if (decoded_rows_.size() != num_elems_) {
+      decoded_rows_ = decode();
+    }
+    return reinterpret_cast<const int8_t*>(decoded_rows_.data());
+  }
+
+  void getMetadata(const std::shared_ptr<ChunkMetadata>& chunkMetadata) override {
+    Encoder::getMetadata(chunkMetadata);  // call on parent class
+    chunkMetadata->fillChunkStats(dataMin, dataMax, has_nulls);
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
+    auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
+    chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    return chunk_metadata;
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const int64_t val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void updateStats(const double val, const bool is_null) override {
+    if (is_null) {
+      has_nulls = true;
+    } else {
+      const auto data = static_cast<T>(val);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+  }
+
+  void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    const T* unencoded_data = reinterpret_cast<const T*>(src_data);
+    for (size_t i = 0; i < num_elements; ++i) {
+      validateDataAndUpdateStats(unencoded_data[i]);
+    }
+  }
+
+  void updateStats(const std::vector<std::string>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  void updateStats(const std::vector<ArrayDatum>* const src_data,
+                   const size_t start_idx,
+                   const size_t num_elements) override {
+    UNREACHABLE();
+  }
+
+  // Only called from the executor for synthesized meta-information.
+  void reduceStats(const Encoder& that) override {
+    const auto& that_typed = static_cast<const IntegerSequenceEncoder<T>&>(that);
+    if (that_typed.has_nulls) {
+      has_nulls = true;
+    }
+    dataMin = std::min(dataMin, that_typed.dataMin);
+    dataMax = std::max(dataMax, that_typed.dataMax);
+  }
+
+  void copyMetadata(const Encoder* copyFromEncoder) override {
+    // Called when the chunk buffer is synced with another one.
+    clearDecodedRows();
+    num_elems_ = copyFromEncoder->getNumElems();
+    auto castedEncoder =
+        reinterpret_cast<const IntegerSequenceEncoder<T>*>(copyFromEncoder);
+    dataMin = castedEncoder->dataMin;
+    dataMax = castedEncoder->dataMax;
+    has_nulls = castedEncoder->has_nulls;
+  }
+
+  void writeMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fwrite((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fwrite((int8_t*)&dataMin, sizeof(T), 1, f);
+    fwrite((int8_t*)&dataMax, sizeof(T), 1, f);
+    fwrite((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  void readMetadata(FILE* f) override {
+    // assumes pointer is already in right place
+    fread((int8_t*)&num_elems_, sizeof(size_t), 1, f);
+    fread((int8_t*)&dataMin, sizeof(T), 1, f);
+    fread((int8_t*)&dataMax, sizeof(T), 1, f);
+    fread((int8_t*)&has_nulls, sizeof(bool), 1, f);
+  }
+
+  bool resetChunkStats(const ChunkStats& stats) override {
+    const auto new_min = DatumFetcher::getDatumVal<T>(stats.min);
+    const auto new_max = DatumFetcher::getDatumVal<T>(stats.max);
+
+    if (dataMin == new_min && dataMax == new_max && has_nulls == stats.has_nulls) {
+      return false;
+    }
+
+    dataMin = new_min;
+    dataMax = new_max;
+    has_nulls = stats.has_nulls;
+    return true;
+  }
+
+  void resetChunkStats() override {
+    dataMin = std::numeric_limits<T>::max();
+    dataMax = std::numeric_limits<T>::lowest();
+    has_nulls = false;
+  }
+
+  T dataMin;
+  T dataMax;
+  bool has_nulls;
+
+ protected:
+  // Appends `count` values after the `num_elems_` rows already in the chunk, updating
+  // the stats and `num_elems_`. Must lay out the chunk from scratch if `num_elems_` is 0.
+  virtual void encodeAndAppend(const T* values, const size_t count) = 0;
+
+  // Returns all the values in the chunk, in row order.
+  virtual std::vector<T> decode() = 0;
+
+  T validateDataAndUpdateStats(const T data) {
+    if (data == inline_int_null_value<T>()) {
+      has_nulls = true;
+    } else {
+      decimal_overflow_validator_.validate(data);
+      dataMin = std::min(dataMin, data);
+      dataMax = std::max(dataMax, data);
+    }
+    return data;
+  }
+
+  // Drops whatever follows the first `num_bytes` bytes of the buffer, left over from a
+  // previous, larger encoding of the chunk.
+  void truncateBuffer(const size_t num_bytes) {
+    if (buffer_->size() > num_bytes) {
+      buffer_->setSize(num_bytes);
+      buffer_->setUpdated();
+    }
+  }
+
+ private:
+  void rewrite(const std::vector<T>& values) {
+    num_elems_ = 0;
+    resetChunkStats();
+    encodeAndAppend(values.data(), values.size());
+  }
+
+  void clearDecodedRows() {
+    std::lock_guard<std::mutex> lock(decoded_rows_mutex_);
+    std::vector<T>().swap(decoded_rows_);
+  }
+
+  std::mutex decoded_rows_mutex_;
+  std::vector<T> decoded_rows_;
+};  // IntegerSequenceEncoder
+
+#endif  // INTEGER_SEQUENCE_ENCODER_H
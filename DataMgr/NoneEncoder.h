@@ -37,6 +37,10 @@ class NoneEncoder : public Encoder {
  public:
   NoneEncoder(Data_Namespace::AbstractBuffer* buffer) : Encoder(buffer) {
     resetChunkStats();
+    if (std::is_integral<T>::value) {
+      initZoneMap();
+      initBloomFilter();
+    }
   }
 
   std::shared_ptr<ChunkMetadata> appendData(int8_t*& src_data,
@@ -59,6 +63,16 @@ class NoneEncoder : public Encoder {
         encoded_data[i] = data;
       }
     }
+    if constexpr (std::is_integral<T>::value) {
+      updateZoneMap(replicating ? encoded_data.data() : unencodedData,
+                    num_elems_to_append,
+                    none_encoded_null_value<T>(),
+                    offset);
+      updateBloomFilter(replicating ? encoded_data.data() : unencodedData,
+                        num_elems_to_append,
+                        none_encoded_null_value<T>(),
+                        offset);
+    }
     if (offset == -1) {
       num_elems_ += num_elems_to_append;
       buffer_->append(
@@ -88,11 +102,16 @@ class NoneEncoder : public Encoder {
   std::shared_ptr<ChunkMetadata> getMetadata(const SQLTypeInfo& ti) override {
     auto chunk_metadata = std::make_shared<ChunkMetadata>(ti, 0, 0, ChunkStats{});
     chunk_metadata->fillChunkStats(dataMin, dataMax, has_nulls);
+    if (bloom_filter_builder_) {
+      chunk_metadata->bloomFilter = bloom_filter_builder_->getBloomFilter(num_elems_);
+    }
     return chunk_metadata;
   }
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const int64_t val, const bool is_null) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -104,6 +123,8 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void updateStats(const double val, const bool is_null) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     if (is_null) {
       has_nulls = true;
     } else {
@@ -114,14 +135,28 @@ class NoneEncoder : public Encoder {
   }
 
   void updateStats(const int8_t* const src_data, const size_t num_elements) override {
+    // The values also have to go through addToBloomFilter for the chunk to keep its
+    // Bloom filter.
+    invalidateZoneMap();
     const T* unencoded_data = reinterpret_cast<const T*>(src_data);
     for (size_t i = 0; i < num_elements; ++i) {
       validateDataAndUpdateStats(unencoded_data[i]);
     }
   }
 
+  void addToBloomFilter(const int8_t* const src_data,
+                        const size_t num_elements) override {
+    if (bloom_filter_builder_) {
+      bloom_filter_builder_->append(reinterpret_cast<const T*>(src_data),
+                                    num_elements,
+                                    none_encoded_null_value<T>());
+    }
+  }
+
   void updateStatsEncoded(const int8_t* const dst_data,
                           const size_t num_elements) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     const T* data = reinterpret_cast<const T*>(dst_data);
 
     std::tie(dataMin, dataMax, has_nulls) = tbb::parallel_reduce(
@@ -163,6 +198,8 @@ class NoneEncoder : public Encoder {
 
   // Only called from the executor for synthesized meta-information.
   void reduceStats(const Encoder& that) override {
+    invalidateZoneMap();
+    invalidateBloomFilter();
     const auto that_typed = static_cast<const NoneEncoder&>(that);
     if (that_typed.has_nulls) {
       has_nulls = true;
@@ -207,12 +244,16 @@ class NoneEncoder : public Encoder {
     dataMin = castedEncoder->dataMin;
     dataMax = castedEncoder->dataMax;
     has_nulls = castedEncoder->has_nulls;
+    zone_map_builder_ = castedEncoder->zone_map_builder_;
+    bloom_filter_builder_ = castedEncoder->bloom_filter_builder_;
   }
 
   void resetChunkStats() override {
     dataMin = std::numeric_limits<T>::max();
     dataMax = std::numeric_limits<T>::lowest();
     has_nulls = false;
+    resetZoneMap();
+    resetBloomFilter();
   }
 
   T dataMin;
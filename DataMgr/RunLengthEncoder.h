@@ -0,0 +1,110 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef RUN_LENGTH_ENCODER_H
+#define RUN_LENGTH_ENCODER_H
+
+#include "IntegerSequenceEncoder.h"
+
+#include "Shared/SequenceEncoding.h"
+
+#include <type_traits>
+
+// Stores a chunk as runs of equal values, see Shared/SequenceEncoding.h for the layout.
+template <typename T>
+class RunLengthEncoder : public IntegerSequenceEncoder<T> {
+ public:
+  RunLengthEncoder(Data_Namespace::AbstractBuffer* buffer)
+      : IntegerSequenceEncoder<T>(buffer) {}
+
+ protected:
+  void encodeAndAppend(const T* values, const size_t count) override {
+    std::vector<Run> runs;
+    int64_t run_count{0};
+    if (this->num_elems_) {
+      // The last run is extended in place if the first new value matches it.
+      run_count = readRunCount();
+      CHECK_GT(run_count, 0);
+      runs.emplace_back();
+      this->buffer_->read(reinterpret_cast<int8_t*>(&runs.back()),
+                          sizeof(Run),
+                          runOffset(run_count - 1));
+      --run_count;
+    }
+    auto row_count = this->num_elems_;
+    for (size_t i = 0; i < count; ++i) {
+      const auto value = static_cast<Slot>(this->validateDataAndUpdateStats(values[i]));
+      ++row_count;
+      if (!runs.empty() && runs.back().value == value) {
+        runs.back().end = row_count;
+      } else {
+        runs.push_back({value, static_cast<Slot>(row_count)});
+      }
+    }
+    CHECK_LE(row_count, static_cast<size_t>(std::numeric_limits<Slot>::max()));
+    this->num_elems_ = row_count;
+    run_count += runs.size();
+    this->buffer_->write(reinterpret_cast<int8_t*>(&run_count),
+                         sequence_encoding::kRunLengthHeaderBytes,
+                         0);
+    if (!runs.empty()) {
+      this->buffer_->write(reinterpret_cast<int8_t*>(runs.data()),
+                           runs.size() * sizeof(Run),
+                           runOffset(run_count - runs.size()));
+    }
+    this->truncateBuffer(runOffset(run_count));
+  }
+
+  std::vector<T> decode() override {
+    std::vector<T> values;
+    if (!this->num_elems_) {
+      return values;
+    }
+    values.reserve(this->num_elems_);
+    const auto run_count = readRunCount();
+    std::vector<Run> runs(run_count);
+    this->buffer_->read(
+        reinterpret_cast<int8_t*>(runs.data()), run_count * sizeof(Run), runOffset(0));
+    for (const auto& run : runs) {
+      values.resize(run.end, static_cast<T>(run.value));
+    }
+    CHECK_EQ(values.size(), this->num_elems_);
+    return values;
+  }
+
+ private:
+  // Matches sequence_encoding::run_length_slot_width().
+  using Slot = std::conditional_t<sizeof(T) <= 4, int32_t, int64_t>;
+
+  struct Run {
+    Slot value;
+    Slot end;
+  };
+
+  static size_t runOffset(const size_t run_idx) {
+    return sequence_encoding::kRunLengthHeaderBytes + run_idx * sizeof(Run);
+  }
+
+  int64_t readRunCount() {
+    int64_t run_count;
+    this->buffer_->read(reinterpret_cast<int8_t*>(&run_count),
+                        sequence_encoding::kRunLengthHeaderBytes,
+                        0);
+    return run_count;
+  }
+};  // RunLengthEncoder
+
+#endif  // RUN_LENGTH_ENCODER_H
@@ -231,6 +231,24 @@ class AbstractFragmenter {
   virtual const std::vector<uint64_t> getVacuumOffsets(
       const std::shared_ptr<Chunk_NS::Chunk>& chunk) = 0;
 
+  /**
+   * @brief Rewrites the rows of the given fragments into new fragments, ordered on the
+   * given columns, and deletes the rows of the fragments they came from
+   *
+   * No locks and checkpoints taken needs to be managed externally
+   */
+  virtual int clusterRows(const std::vector<int>& column_ids,
+                          const bool z_order,
+                          const std::vector<int>& fragment_ids,
+                          const int append_to_fragment_id) = 0;
+
+  /**
+   * @brief Drops the given fragments along with their chunks
+   *
+   * Unlike dropFragmentsToSize, no table lock is taken, it needs to be held by the caller
+   */
+  virtual void dropFragments(const std::vector<int>& fragment_ids) = 0;
+
   virtual void dropColumns(const std::vector<int>& columnIds) = 0;
 
   //! Iterates through chunk metadata to return whether any rows have been deleted.
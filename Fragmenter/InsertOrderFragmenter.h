@@ -173,6 +173,25 @@ class InsertOrderFragmenter : public AbstractFragmenter {
   const std::vector<uint64_t> getVacuumOffsets(
       const std::shared_ptr<Chunk_NS::Chunk>& chunk) override;
 
+  /**
+   * @brief Rewrites the rows of the fragments `fragment_ids`, except for the deleted
+   * ones, into full fragments and deletes all the rows of the fragments they came from.
+   *
+   * The rows are sorted on the columns `column_ids`, lexicographically or along a
+   * Z-order curve over the ranks of their values, which gives fragments with narrow and
+   * mostly disjoint ranges on those columns. All the rows of the fragments are read into
+   * memory at once. The rows go to new fragments, or to the end of the fragment
+   * `append_to_fragment_id` if it is still the last one, and the id of the last fragment
+   * written to is returned. Geo columns aren't supported, neither are array columns as
+   * clustering columns.
+   */
+  int clusterRows(const std::vector<int>& column_ids,
+                  const bool z_order,
+                  const std::vector<int>& fragment_ids,
+                  const int append_to_fragment_id) override;
+
+  void dropFragments(const std::vector<int>& fragment_ids) override;
+
   auto getChunksForAllColumns(const TableDescriptor* td,
                               const FragmentInfo& fragment,
                               const Data_Namespace::MemoryLevel memory_level);
@@ -0,0 +1,485 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    RowClustering.cpp
+ * @brief   Rewrites the rows of a table into new fragments, sorted on some columns.
+ *
+ * The chunks of every fragment are decoded into the values insertData takes, i.e. the
+ * logical values for fixed, days and sequence encoded columns, the string ids for
+ * dictionary encoded strings, so that the new chunks go through the encoders again and
+ * get fresh metadata.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+#include "DataMgr/FixedLengthArrayNoneEncoder.h"
+#include "DataMgr/IntegerSequenceEncoder.h"
+#include "Fragmenter/InsertOrderFragmenter.h"
+#include "Logger/Logger.h"
+#include "Shared/DateConverters.h"
+#include "Shared/TypedDataAccessors.h"
+#include "Shared/checked_alloc.h"
+#include "Shared/misc.h"
+#include "Shared/scope.h"
+
+namespace Fragmenter_Namespace {
+
+namespace {
+
+// The rows of one column of the table, in the form insertData takes them.
+struct ColumnRows {
+  const ColumnDescriptor* cd;
+  size_t element_size{0};
+  std::vector<int8_t> values;
+  std::vector<std::string> strings;
+  std::vector<ArrayDatum> arrays;
+};
+
+int64_t read_int(const int8_t* data, const size_t row, const size_t size) {
+  switch (size) {
+    case 1:
+      return data[row];
+    case 2:
+      return reinterpret_cast<const int16_t*>(data)[row];
+    case 4:
+      return reinterpret_cast<const int32_t*>(data)[row];
+    case 8:
+      return reinterpret_cast<const int64_t*>(data)[row];
+    default:
+      UNREACHABLE();
+  }
+  return 0;
+}
+
+void write_int(int8_t* data, const size_t row, const size_t size, const int64_t value) {
+  switch (size) {
+    case 1:
+      data[row] = value;
+      break;
+    case 2:
+      reinterpret_cast<int16_t*>(data)[row] = value;
+      break;
+    case 4:
+      reinterpret_cast<int32_t*>(data)[row] = value;
+      break;
+    case 8:
+      reinterpret_cast<int64_t*>(data)[row] = value;
+      break;
+    default:
+      UNREACHABLE();
+  }
+}
+
+void append_fixlen_rows(ColumnRows& rows,
+                        Chunk_NS::Chunk& chunk,
+                        const size_t num_rows,
+                        const std::vector<size_t>& kept_rows) {
+  const auto& ti = rows.cd->columnType;
+  const auto buffer = chunk.getBuffer();
+  const int8_t* data = buffer->getMemoryPtr();
+  std::vector<int8_t> decoded_data;
+  if (ti.is_sequence_encoded()) {
+    const auto encoder = dynamic_cast<SequenceEncoder*>(buffer->getEncoder());
+    CHECK(encoder);
+    decoded_data.resize(num_rows * rows.element_size);
+    encoder->copyDecodedRows(decoded_data.data());
+    data = decoded_data.data();
+  }
+  const size_t physical_size =
+      ti.is_sequence_encoded() ? rows.element_size : get_element_size(ti);
+  const size_t offset = rows.values.size();
+  rows.values.resize(offset + kept_rows.size() * rows.element_size);
+  int8_t* dst = rows.values.data() + offset;
+  if (ti.get_compression() == kENCODING_FIXED ||
+      ti.get_compression() == kENCODING_DATE_IN_DAYS) {
+    // Nulls are the smallest value of the encoded type, which the encoders take as is.
+    const int64_t null_value = -(int64_t(1) << (8 * physical_size - 1));
+    for (size_t i = 0; i < kept_rows.size(); ++i) {
+      auto value = read_int(data, kept_rows[i], physical_size);
+      if (ti.is_date_in_days() && value != null_value) {
+        value = DateConverters::get_epoch_seconds_from_days(value);
+      }
+      write_int(dst, i, rows.element_size, value);
+    }
+  } else {
+    CHECK_EQ(physical_size, rows.element_size);
+    for (size_t i = 0; i < kept_rows.size(); ++i) {
+      std::memcpy(dst + i * rows.element_size,
+                  data + kept_rows[i] * rows.element_size,
+                  rows.element_size);
+    }
+  }
+}
+
+void append_varlen_rows(ColumnRows& rows,
+                        Chunk_NS::Chunk& chunk,
+                        const std::vector<size_t>& kept_rows) {
+  const auto& ti = rows.cd->columnType;
+  const int8_t* data = chunk.getBuffer()->getMemoryPtr();
+  const auto index_buffer = chunk.getIndexBuf();
+  CHECK(index_buffer);
+  const auto offsets =
+      reinterpret_cast<const StringOffsetT*>(index_buffer->getMemoryPtr());
+  for (const auto row : kept_rows) {
+    // Variable length arrays encode null arrays as negative offsets.
+    const auto begin = std::abs(offsets[row]);
+    const auto end = std::abs(offsets[row + 1]);
+    if (ti.is_string()) {
+      rows.strings.emplace_back(reinterpret_cast<const char*>(data) + begin, end - begin);
+      continue;
+    }
+    const bool is_null = offsets[row + 1] < 0;
+    const size_t length = is_null ? 0 : end - begin;
+    int8_t* array = length ? reinterpret_cast<int8_t*>(checked_malloc(length)) : nullptr;
+    if (length) {
+      std::memcpy(array, data + begin, length);
+    }
+    rows.arrays.emplace_back(length, array, is_null);
+  }
+}
+
+void append_fixlen_array_rows(ColumnRows& rows,
+                              Chunk_NS::Chunk& chunk,
+                              const std::vector<size_t>& kept_rows) {
+  const auto& ti = rows.cd->columnType;
+  const int8_t* data = chunk.getBuffer()->getMemoryPtr();
+  const size_t length = ti.get_size();
+  for (const auto row : kept_rows) {
+    // Null arrays are stored filled with the null sentinels, which are appended as is.
+    auto array = reinterpret_cast<int8_t*>(checked_malloc(length));
+    std::memcpy(array, data + row * length, length);
+    rows.arrays.emplace_back(
+        length, array, FixedLengthArrayNoneEncoder::is_null(ti, array));
+  }
+}
+
+// Returns the rank of the value of each row in the order of the values of `rows`, equal
+// values getting equal ranks.
+std::vector<uint64_t> get_ranks(const ColumnRows& rows, const size_t num_rows) {
+  const auto& ti = rows.cd->columnType;
+  std::vector<size_t> indexes(num_rows);
+  std::iota(indexes.begin(), indexes.end(), 0);
+  std::function<bool(size_t, size_t)> less;
+  if (ti.is_string() && !ti.is_dict_encoded_string()) {
+    less = [&rows](const size_t a, const size_t b) {
+      return rows.strings[a] < rows.strings[b];
+    };
+  } else if (ti.is_fp()) {
+    less = [&rows, is_float = ti.get_type() == kFLOAT](const size_t a, const size_t b) {
+      if (is_float) {
+        const auto values = reinterpret_cast<const float*>(rows.values.data());
+        return values[a] < values[b];
+      }
+      const auto values = reinterpret_cast<const double*>(rows.values.data());
+      return values[a] < values[b];
+    };
+  } else if (ti.is_dict_encoded_string() && rows.element_size < sizeof(int32_t)) {
+    // Narrow string ids are unsigned.
+    less = [&rows](const size_t a, const size_t b) {
+      const auto values = rows.values.data();
+      return rows.element_size == 1
+                 ? reinterpret_cast<const uint8_t*>(values)[a] <
+                       reinterpret_cast<const uint8_t*>(values)[b]
+                 : reinterpret_cast<const uint16_t*>(values)[a] <
+                       reinterpret_cast<const uint16_t*>(values)[b];
+    };
+  } else {
+    less = [&rows](const size_t a, const size_t b) {
+      return read_int(rows.values.data(), a, rows.element_size) <
+             read_int(rows.values.data(), b, rows.element_size);
+    };
+  }
+  std::sort(indexes.begin(), indexes.end(), less);
+  std::vector<uint64_t> ranks(num_rows);
+  uint64_t rank = 0;
+  for (size_t i = 0; i < num_rows; ++i) {
+    if (i > 0 && less(indexes[i - 1], indexes[i])) {
+      ++rank;
+    }
+    ranks[indexes[i]] = rank;
+  }
+  return ranks;
+}
+
+// Interleaves the top `bits_per_rank` bits of the ranks, the first rank getting the most
+// significant bit, which orders the rows along a Z-order curve.
+uint64_t interleave_bits(const std::vector<uint64_t>& ranks, const size_t bits_per_rank) {
+  uint64_t z_value = 0;
+  for (size_t bit = bits_per_rank; bit-- > 0;) {
+    for (const auto rank : ranks) {
+      z_value = (z_value << 1) | ((rank >> bit) & 1);
+    }
+  }
+  return z_value;
+}
+
+std::vector<size_t> get_row_order(const std::vector<const ColumnRows*>& cluster_rows,
+                                  const size_t num_rows,
+                                  const bool z_order) {
+  std::vector<std::vector<uint64_t>> ranks;
+  for (const auto rows : cluster_rows) {
+    ranks.push_back(get_ranks(*rows, num_rows));
+  }
+  std::vector<size_t> order(num_rows);
+  std::iota(order.begin(), order.end(), 0);
+  if (!z_order || ranks.size() == 1 || num_rows == 0) {
+    std::stable_sort(
+        order.begin(), order.end(), [&ranks](const size_t a, const size_t b) {
+          for (const auto& column_ranks : ranks) {
+            if (column_ranks[a] != column_ranks[b]) {
+              return column_ranks[a] < column_ranks[b];
+            }
+          }
+          return false;
+        });
+    return order;
+  }
+  // Scale the ranks to the bits each column gets, so that columns with few distinct
+  // values still take part in the most significant bits.
+  const size_t bits_per_rank = 64 / ranks.size();
+  std::vector<size_t> rank_bits;
+  for (const auto& column_ranks : ranks) {
+    const auto max_rank = *std::max_element(column_ranks.begin(), column_ranks.end());
+    rank_bits.push_back(max_rank ? 64 - __builtin_clzll(max_rank) : 1);
+  }
+  std::vector<uint64_t> z_values(num_rows);
+  std::vector<uint64_t> row_ranks(ranks.size());
+  for (size_t row = 0; row < num_rows; ++row) {
+    for (size_t i = 0; i < ranks.size(); ++i) {
+      row_ranks[i] = rank_bits[i] > bits_per_rank
+                         ? ranks[i][row] >> (rank_bits[i] - bits_per_rank)
+                         : ranks[i][row] << (bits_per_rank - rank_bits[i]);
+    }
+    z_values[row] = interleave_bits(row_ranks, bits_per_rank);
+  }
+  std::stable_sort(
+      order.begin(), order.end(), [&z_values](const size_t a, const size_t b) {
+        return z_values[a] < z_values[b];
+      });
+  return order;
+}
+
+DataBlockPtr get_data_block(ColumnRows& rows,
+                            const std::vector<size_t>& order,
+                            const size_t begin,
+                            const size_t end,
+                            std::vector<int8_t>& values,
+                            std::vector<std::string>& strings,
+                            std::vector<ArrayDatum>& arrays) {
+  const auto& ti = rows.cd->columnType;
+  DataBlockPtr data_block;
+  if (ti.is_array()) {
+    arrays.clear();
+    for (size_t i = begin; i < end; ++i) {
+      arrays.push_back(rows.arrays[order[i]]);
+    }
+    data_block.arraysPtr = &arrays;
+  } else if (ti.is_string() && !ti.is_dict_encoded_string()) {
+    strings.clear();
+    for (size_t i = begin; i < end; ++i) {
+      strings.push_back(rows.strings[order[i]]);
+    }
+    data_block.stringsPtr = &strings;
+  } else {
+    values.resize((end - begin) * rows.element_size);
+    for (size_t i = begin; i < end; ++i) {
+      std::memcpy(values.data() + (i - begin) * rows.element_size,
+                  rows.values.data() + order[i] * rows.element_size,
+                  rows.element_size);
+    }
+    data_block.numbersPtr = values.data();
+  }
+  return data_block;
+}
+
+}  // namespace
+
+int InsertOrderFragmenter::clusterRows(const std::vector<int>& column_ids,
+                                       const bool z_order,
+                                       const std::vector<int>& fragment_ids,
+                                       const int append_to_fragment_id) {
+  mapd_unique_lock<mapd_shared_mutex> insert_lock(insertMutex_);
+  CHECK(!column_ids.empty());
+  std::vector<FragmentInfo*> fragments;
+  for (const auto& fragment : fragmentInfoVec_) {
+    if (shared::contains(fragment_ids, fragment->fragmentId)) {
+      fragments.push_back(fragment.get());
+    }
+  }
+  if (fragments.empty()) {
+    return append_to_fragment_id;
+  }
+
+  const ColumnDescriptor* deleted_cd{nullptr};
+  std::vector<ColumnRows> all_rows;
+  for (const auto& [column_id, chunk] : columnMap_) {
+    const auto cd = chunk.getColumnDesc();
+    CHECK(cd);
+    if (cd->columnType.is_geometry()) {
+      throw std::runtime_error("Clustering tables with geo columns is not supported.");
+    }
+    if (cd->isDeletedCol) {
+      deleted_cd = cd;
+    } else if (!cd->isVirtualCol) {
+      ColumnRows rows{cd};
+      if (!cd->columnType.is_varlen() && !cd->columnType.is_array()) {
+        rows.element_size = get_logical_type_info(cd->columnType).get_size();
+      }
+      all_rows.push_back(std::move(rows));
+    }
+  }
+  // The rows of the old fragments are only deleted here, see dropFragments.
+  CHECK(deleted_cd);
+  std::vector<const ColumnRows*> cluster_rows;
+  for (const auto column_id : column_ids) {
+    const auto it = std::find_if(all_rows.begin(), all_rows.end(), [&](const auto& rows) {
+      return rows.cd->columnId == column_id;
+    });
+    CHECK(it != all_rows.end());
+    if (it->cd->columnType.is_array()) {
+      throw std::runtime_error("Cannot cluster on array column " + it->cd->columnName +
+                               ".");
+    }
+    cluster_rows.push_back(&*it);
+  }
+
+  const auto get_chunk = [this](const ColumnDescriptor* cd,
+                                const FragmentInfo& fragment) {
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    const auto chunk_meta_it = chunk_metadata_map.find(cd->columnId);
+    CHECK(chunk_meta_it != chunk_metadata_map.end());
+    auto chunk_key = chunkKeyPrefix_;
+    chunk_key.push_back(cd->columnId);
+    chunk_key.push_back(fragment.fragmentId);
+    return Chunk_NS::Chunk::getChunk(cd,
+                                     dataMgr_,
+                                     chunk_key,
+                                     Data_Namespace::CPU_LEVEL,
+                                     0,
+                                     chunk_meta_it->second->numBytes,
+                                     chunk_meta_it->second->numElements);
+  };
+
+  // Read the rows which aren't deleted, fragment by fragment.
+  size_t num_rows{0};
+  for (const auto fragment : fragments) {
+    const auto fragment_num_rows = fragment->getPhysicalNumTuples();
+    std::vector<size_t> kept_rows;
+    {
+      const auto chunk = get_chunk(deleted_cd, *fragment);
+      const int8_t* deleted = chunk->getBuffer()->getMemoryPtr();
+      for (size_t row = 0; row < fragment_num_rows; ++row) {
+        if (!deleted[row]) {
+          kept_rows.push_back(row);
+        }
+      }
+    }
+    for (auto& rows : all_rows) {
+      const auto chunk = get_chunk(rows.cd, *fragment);
+      const auto& ti = rows.cd->columnType;
+      if (ti.is_fixlen_array()) {
+        append_fixlen_array_rows(rows, *chunk, kept_rows);
+      } else if (ti.is_varlen_indeed()) {
+        append_varlen_rows(rows, *chunk, kept_rows);
+      } else {
+        append_fixlen_rows(rows, *chunk, fragment_num_rows, kept_rows);
+      }
+    }
+    num_rows += kept_rows.size();
+  }
+
+  const auto order = get_row_order(cluster_rows, num_rows, z_order);
+
+  // Append the rows to new fragments, or to the last fragment of the previous batch,
+  // which has the rows just before them. The rows are in both the old and the new
+  // fragments until the old ones are dropped, which mustn't drop fragments for max_rows.
+  const auto max_rows = maxRows_;
+  ScopeGuard restore_max_rows = [this, max_rows] { maxRows_ = max_rows; };
+  maxRows_ = std::numeric_limits<size_t>::max();
+  if (num_rows &&
+      (fragmentInfoVec_.back()->fragmentId != append_to_fragment_id ||
+       shared::contains(fragment_ids, append_to_fragment_id))) {
+    createNewFragment(defaultInsertLevel_);
+    for (auto& var_len_col_info : varLenColInfo_) {
+      var_len_col_info.second = 0;
+    }
+  }
+  std::vector<std::vector<int8_t>> values(all_rows.size());
+  std::vector<std::vector<std::string>> strings(all_rows.size());
+  std::vector<std::vector<ArrayDatum>> arrays(all_rows.size());
+  for (size_t begin = 0; begin < num_rows; begin += maxFragmentRows_) {
+    const auto end = std::min(begin + maxFragmentRows_, num_rows);
+    InsertData insert_data;
+    insert_data.databaseId = chunkKeyPrefix_[0];
+    insert_data.tableId = chunkKeyPrefix_[1];
+    insert_data.numRows = end - begin;
+    for (size_t i = 0; i < all_rows.size(); ++i) {
+      insert_data.columnIds.push_back(all_rows[i].cd->columnId);
+      insert_data.data.push_back(get_data_block(
+          all_rows[i], order, begin, end, values[i], strings[i], arrays[i]));
+      insert_data.is_default.push_back(false);
+    }
+    insertDataImpl(insert_data);
+  }
+
+  // Delete all the rows of the old fragments, so that they can be dropped once the new
+  // fragments are checkpointed.
+  for (const auto fragment : fragments) {
+    const auto fragment_num_rows = fragment->getPhysicalNumTuples();
+    if (fragment_num_rows == 0) {
+      continue;
+    }
+    const auto chunk = get_chunk(deleted_cd, *fragment);
+    const auto buffer = chunk->getBuffer();
+    std::vector<int8_t> deleted(fragment_num_rows, 1);
+    auto deleted_ptr = deleted.data();
+    const auto chunk_metadata = buffer->getEncoder()->appendData(
+        deleted_ptr, fragment_num_rows, deleted_cd->columnType, false, 0);
+    mapd_unique_lock<mapd_shared_mutex> write_lock(fragmentInfoMutex_);
+    fragment->setChunkMetadata(deleted_cd->columnId, chunk_metadata);
+    fragment->shadowChunkMetadataMap = fragment->getChunkMetadataMapPhysicalCopy();
+  }
+  LOG(INFO) << "Clustered " << num_rows << " rows of table " << physicalTableId_
+            << " from " << fragments.size() << " fragments";
+  return num_rows ? fragmentInfoVec_.back()->fragmentId : append_to_fragment_id;
+}
+
+void InsertOrderFragmenter::dropFragments(const std::vector<int>& fragment_ids) {
+  mapd_unique_lock<mapd_shared_mutex> insert_lock(insertMutex_);
+  mapd_unique_lock<mapd_shared_mutex> write_lock(fragmentInfoMutex_);
+  for (auto it = fragmentInfoVec_.begin(); it != fragmentInfoVec_.end();) {
+    const auto& fragment = *it;
+    if (!shared::contains(fragment_ids, fragment->fragmentId)) {
+      ++it;
+      continue;
+    }
+    for (const auto& column : columnMap_) {
+      auto fragment_prefix = chunkKeyPrefix_;
+      fragment_prefix.push_back(column.first);
+      fragment_prefix.push_back(fragment->fragmentId);
+      dataMgr_->deleteChunksWithPrefix(fragment_prefix);
+    }
+    CHECK_GE(numTuples_, fragment->getPhysicalNumTuples());
+    numTuples_ -= fragment->getPhysicalNumTuples();
+    it = fragmentInfoVec_.erase(it);
+  }
+}
+
+}  // namespace Fragmenter_Namespace
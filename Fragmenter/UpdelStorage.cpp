@@ -24,6 +24,7 @@
 #include "Catalog/Catalog.h"
 #include "DataMgr/ArrayNoneEncoder.h"
 #include "DataMgr/FixedLengthArrayNoneEncoder.h"
+#include "DataMgr/IntegerSequenceEncoder.h"
 #include "Fragmenter/InsertOrderFragmenter.h"
 #include "LockMgr/LockMgr.h"
 #include "QueryEngine/Execute.h"
@@ -651,6 +652,11 @@ std::optional<ChunkUpdateStats> InsertOrderFragmenter::updateColumn(
     return {};
   }
   CHECK(nrow == n_rhs_values || 1 == n_rhs_values);
+  if (cd->columnType.is_sequence_encoded()) {
+    throw std::runtime_error("UPDATE of column " + cd->columnName + " with " +
+                             cd->columnType.get_compression_name() +
+                             " encoding is not supported.");
+  }
 
   auto fragment_ptr = getFragmentInfo(fragment_id);
   auto& fragment = *fragment_ptr;
@@ -1358,7 +1364,20 @@ void InsertOrderFragmenter::compactRows(const Catalog_Namespace::Catalog* catalo
       set_chunk_metadata(catalog, fragment, chunk, nrows_to_keep, updel_roll);
     };
 
-    if (is_varlen) {
+    // Run length and differential encoded chunks can't be compacted in place, the
+    // encoder rewrites them from the rows kept.
+    auto sequence_vacuum = [=, &updel_roll, &frag_offsets, &fragment] {
+      auto encoder = dynamic_cast<SequenceEncoder*>(data_buffer->getEncoder());
+      CHECK(encoder);
+      encoder->removeRows(frag_offsets);
+      data_buffer->setUpdated();
+
+      set_chunk_metadata(catalog, fragment, chunk, nrows_to_keep, updel_roll);
+    };
+
+    if (col_type.is_sequence_encoded()) {
+      threads.emplace_back(std::async(std::launch::async, sequence_vacuum));
+    } else if (is_varlen) {
       threads.emplace_back(std::async(std::launch::async, varlen_vacuum));
     } else {
       threads.emplace_back(std::async(std::launch::async, fixlen_vacuum));
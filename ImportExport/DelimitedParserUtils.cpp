@@ -22,13 +22,130 @@
 
 #include "ImportExport/DelimitedParserUtils.h"
 
+#include <array>
+#include <cstring>
 #include <string_view>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define DELIMITED_PARSER_USE_SSE2
+#if defined(__GNUC__)
+#define DELIMITED_PARSER_USE_AVX2
+#endif
+#endif
+
 #include "ImportExport/CopyParams.h"
 #include "Logger/Logger.h"
 #include "StringDictionary/StringDictionary.h"
 
 namespace {
+#ifdef DELIMITED_PARSER_USE_AVX2
+bool cpu_has_avx2() {
+  static const bool has_avx2 = [] {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }();
+  return has_avx2;
+}
+
+__attribute__((target("avx2"))) uint64_t match_64_avx2(const char* p,
+                                                        const char* chars,
+                                                        const size_t num_chars) {
+  const auto lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  const auto hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+  auto lo_eq = _mm256_setzero_si256();
+  auto hi_eq = _mm256_setzero_si256();
+  for (size_t i = 0; i < num_chars; ++i) {
+    const auto needle = _mm256_set1_epi8(chars[i]);
+    lo_eq = _mm256_or_si256(lo_eq, _mm256_cmpeq_epi8(lo, needle));
+    hi_eq = _mm256_or_si256(hi_eq, _mm256_cmpeq_epi8(hi, needle));
+  }
+  return static_cast<uint32_t>(_mm256_movemask_epi8(lo_eq)) |
+         static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(hi_eq))) << 32;
+}
+#endif
+
+/**
+ * A small set of the characters the parser has to stop at. Builds bitmaps of their
+ * positions in blocks of the buffer with SIMD compares, so that the runs of ordinary
+ * characters in between are skipped without looking at every byte.
+ */
+class StructuralChars {
+ public:
+  void add(const char c) {
+    if (contains(c)) {
+      return;
+    }
+    CHECK_LT(num_chars_, chars_.size());
+    chars_[num_chars_++] = c;
+  }
+
+  bool contains(const char c) const {
+    for (size_t i = 0; i < num_chars_; ++i) {
+      if (chars_[i] == c) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Bit i of the result is set if p[i] is one of the characters, for i < n <= 64.
+  uint64_t match(const char* p, const size_t n) const {
+    if (n == 64) {
+#ifdef DELIMITED_PARSER_USE_AVX2
+      if (cpu_has_avx2()) {
+        return match_64_avx2(p, chars_.data(), num_chars_);
+      }
+#endif
+#ifdef DELIMITED_PARSER_USE_SSE2
+      return static_cast<uint64_t>(match16(p)) |
+             static_cast<uint64_t>(match16(p + 16)) << 16 |
+             static_cast<uint64_t>(match16(p + 32)) << 32 |
+             static_cast<uint64_t>(match16(p + 48)) << 48;
+#endif
+    }
+    uint64_t result{0};
+    for (size_t i = 0; i < n; ++i) {
+      if (contains(p[i])) {
+        result |= uint64_t(1) << i;
+      }
+    }
+    return result;
+  }
+
+  // Returns the first position in [p, end) which holds one of the characters, or end.
+  const char* next(const char* p, const char* end) const {
+#ifdef DELIMITED_PARSER_USE_SSE2
+    while (end - p >= 16) {
+      const auto mask = match16(p);
+      if (mask) {
+        return p + __builtin_ctz(mask);
+      }
+      p += 16;
+    }
+#endif
+    while (p < end && !contains(*p)) {
+      ++p;
+    }
+    return p;
+  }
+
+ private:
+#ifdef DELIMITED_PARSER_USE_SSE2
+  uint32_t match16(const char* p) const {
+    const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    auto eq = _mm_setzero_si128();
+    for (size_t i = 0; i < num_chars_; ++i) {
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi8(block, _mm_set1_epi8(chars_[i])));
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(eq));
+  }
+#endif
+
+  std::array<char, 8> chars_;
+  size_t num_chars_{0};
+};
+
 inline bool is_eol(const char& c, const import_export::CopyParams& copy_params) {
   return c == copy_params.line_delim || c == '\n' || c == '\r';
 }
@@ -67,14 +184,10 @@ size_t find_beginning(const char* buffer,
   if (begin == 0 || (begin > 0 && buffer[begin - 1] == copy_params.line_delim)) {
     return 0;
   }
-  size_t i;
   const char* buf = buffer + begin;
-  for (i = 0; i < end - begin; i++) {
-    if (buf[i] == copy_params.line_delim) {
-      return i + 1;
-    }
-  }
-  return i;
+  const auto line_delim = static_cast<const char*>(
+      memchr(buf, static_cast<unsigned char>(copy_params.line_delim), end - begin));
+  return line_delim ? line_delim - buf + 1 : end - begin;
 }
 
 size_t find_end(const char* buffer,
@@ -86,37 +199,54 @@ size_t find_end(const char* buffer,
                 size_t offset) {
   size_t last_line_delim_pos = 0;
   const char* current = buffer + offset;
+  const char* buffer_end = buffer + size;
+  // Walks the buffer in blocks of 64 bytes and only visits the positions of the line
+  // delimiters and, for quoted input, of the quotes and escapes.
+  StructuralChars structural_chars;
+  structural_chars.add(copy_params.line_delim);
   if (copy_params.quoted) {
-    while (current < buffer + size) {
-      while (!in_quote && current < buffer + size) {
-        // We are outside of quotes. We have to find the last possible line delimiter.
-        if (*current == copy_params.line_delim) {
-          last_line_delim_pos = current - buffer;
-          ++num_rows_this_buffer;
-        } else if (*current == copy_params.quote) {
-          in_quote = true;
+    structural_chars.add(copy_params.quote);
+    structural_chars.add(copy_params.escape);
+    // An escaped quote inside a quoted field is skipped over as a whole.
+    const char* resume = current;
+    while (current < buffer_end) {
+      const size_t block_size = std::min<size_t>(64, buffer_end - current);
+      auto mask = structural_chars.match(current, block_size);
+      while (mask) {
+        const char* c = current + __builtin_ctzll(mask);
+        mask &= mask - 1;
+        if (c < resume) {
+          continue;
         }
-        ++current;
-      }
-
-      while (in_quote && current < buffer + size) {
-        // We are in a quoted field. We have to find the ending quote.
-        if ((*current == copy_params.escape) && (current < buffer + size - 1) &&
-            (*(current + 1) == copy_params.quote)) {
-          ++current;
-        } else if (*current == copy_params.quote) {
-          in_quote = false;
+        if (!in_quote) {
+          // We are outside of quotes. We have to find the last possible line delimiter.
+          if (*c == copy_params.line_delim) {
+            last_line_delim_pos = c - buffer;
+            ++num_rows_this_buffer;
+          } else if (*c == copy_params.quote) {
+            in_quote = true;
+          }
+        } else {
+          // We are in a quoted field. We have to find the ending quote.
+          if (*c == copy_params.escape && c < buffer_end - 1 &&
+              *(c + 1) == copy_params.quote) {
+            resume = c + 2;
+          } else if (*c == copy_params.quote) {
+            in_quote = false;
+          }
         }
-        ++current;
       }
+      current += block_size;
     }
   } else {
-    while (current < buffer + size) {
-      if (*current == copy_params.line_delim) {
-        last_line_delim_pos = current - buffer;
-        ++num_rows_this_buffer;
+    while (current < buffer_end) {
+      const size_t block_size = std::min<size_t>(64, buffer_end - current);
+      const auto mask = structural_chars.match(current, block_size);
+      if (mask) {
+        num_rows_this_buffer += __builtin_popcountll(mask);
+        last_line_delim_pos = current - buffer + 63 - __builtin_clzll(mask);
       }
-      ++current;
+      current += block_size;
     }
   }
 
@@ -201,7 +331,21 @@ const char* get_row(const char* buf,
   bool has_escape = false;
   bool strip_quotes = false;
   try_single_thread = false;
-  for (p = buf; p < entire_buf_end; ++p) {
+  // Only these characters can change the state of the parser, the runs of other
+  // characters in between are skipped.
+  StructuralChars structural_chars;
+  structural_chars.add(copy_params.escape);
+  structural_chars.add(copy_params.delimiter);
+  structural_chars.add(copy_params.line_delim);
+  structural_chars.add('\n');
+  structural_chars.add('\r');
+  if (copy_params.quoted) {
+    structural_chars.add(copy_params.quote);
+  }
+  if (is_array != nullptr) {
+    structural_chars.add(copy_params.array_begin);
+  }
+  for (p = buf; (p = structural_chars.next(p, entire_buf_end)) < entire_buf_end; ++p) {
     if (*p == copy_params.escape && p < entire_buf_end - 1 &&
         *(p + 1) == copy_params.quote) {
       p++;
@@ -34,6 +34,7 @@
 #include <csignal>
 #include <cstdio>
 #include <cstdlib>
+#include <deque>
 #include <fstream>
 #include <future>
 #include <iomanip>
@@ -2006,7 +2007,7 @@ int64_t explode_collections_step2(
 static ImportStatus import_thread_delimited(
     int thread_id,
     Importer* importer,
-    std::unique_ptr<char[]> scratch_buffer,
+    const char* buffer,
     size_t begin_pos,
     size_t end_pos,
     size_t total_size,
@@ -2018,8 +2019,7 @@ static ImportStatus import_thread_delimited(
   int64_t total_get_row_time_us = 0;
   int64_t total_str_to_val_time_us = 0;
   auto query_session = session_info ? session_info->get_session_id() : "";
-  CHECK(scratch_buffer);
-  auto buffer = scratch_buffer.get();
+  CHECK(buffer);
   auto load_ms = measure<>::execution([]() {});
 
   thread_import_status.thread_id = thread_id;
@@ -4344,6 +4344,100 @@ ImportStatus Importer::import(const Catalog_Namespace::SessionInfo* session_info
   return DataStreamSink::archivePlumber(session_info);
 }
 
+namespace {
+
+// A buffer of the input of a delimited import. Holds whole rows while it is parsed.
+struct DelimitedImportBlock {
+  std::unique_ptr<char[]> buffer;
+  size_t alloc_size{0};
+  size_t size{0};
+  size_t first_row_index{0};
+  ImportStatus import_status;
+  std::exception_ptr error;
+};
+
+/**
+ * Hands the blocks of a delimited import from the reading thread to a fixed set of
+ * parser threads and back. The reader recycles the blocks it gets back, so the number of
+ * blocks, and with it the memory used by the import, stays bounded and reading stalls
+ * whenever the parser threads fall behind.
+ */
+class DelimitedImportPipeline {
+ public:
+  // Queues a block for the parser threads.
+  void push(std::unique_ptr<DelimitedImportBlock> block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pending_blocks_.push_back(std::move(block));
+    }
+    pending_cv_.notify_one();
+  }
+
+  // Returns the next block to parse, or nullptr once the pipeline is closed.
+  std::unique_ptr<DelimitedImportBlock> pop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    pending_cv_.wait(lock, [this] { return !pending_blocks_.empty() || closed_; });
+    if (pending_blocks_.empty()) {
+      return nullptr;
+    }
+    auto block = std::move(pending_blocks_.front());
+    pending_blocks_.pop_front();
+    return block;
+  }
+
+  // Hands a parsed block back to the reader.
+  void finish(std::unique_ptr<DelimitedImportBlock> block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      finished_blocks_.push_back(std::move(block));
+    }
+    finished_cv_.notify_one();
+  }
+
+  // Waits for a parsed block.
+  std::unique_ptr<DelimitedImportBlock> waitFinished() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cv_.wait(lock, [this] { return !finished_blocks_.empty(); });
+    auto block = std::move(finished_blocks_.front());
+    finished_blocks_.pop_front();
+    return block;
+  }
+
+  // Returns a parsed block, or nullptr if there is none yet.
+  std::unique_ptr<DelimitedImportBlock> tryFinished() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (finished_blocks_.empty()) {
+      return nullptr;
+    }
+    auto block = std::move(finished_blocks_.front());
+    finished_blocks_.pop_front();
+    return block;
+  }
+
+  // Lets the parser threads exit once the queued blocks are parsed, or right away if
+  // `discard_pending` is set.
+  void close(const bool discard_pending) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+      if (discard_pending) {
+        pending_blocks_.clear();
+      }
+    }
+    pending_cv_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable pending_cv_;
+  std::condition_variable finished_cv_;
+  std::deque<std::unique_ptr<DelimitedImportBlock>> pending_blocks_;
+  std::deque<std::unique_ptr<DelimitedImportBlock>> finished_blocks_;
+  bool closed_{false};
+};
+
+}  // namespace
+
 ImportStatus Importer::importDelimited(
     const std::string& file_path,
     const bool decompressed,
@@ -4386,15 +4480,6 @@ ImportStatus Importer::importDelimited(
     }
   }
 
-  auto scratch_buffer = std::make_unique<char[]>(alloc_size);
-  size_t current_pos = 0;
-  size_t end_pos;
-  size_t begin_pos = 0;
-
-  (void)fseek(p_file, current_pos, SEEK_SET);
-  size_t size =
-      fread(reinterpret_cast<void*>(scratch_buffer.get()), 1, alloc_size, p_file);
-
   // make render group analyzers for each poly column
   ColumnIdToRenderGroupAnalyzerMapType columnIdToRenderGroupAnalyzerMap;
   if (copy_params.geo_assign_render_groups) {
@@ -4417,144 +4502,157 @@ ImportStatus Importer::importDelimited(
   auto table_epochs = loader->getTableEpochs();
   auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID).get();
   {
-    std::list<std::future<ImportStatus>> threads;
-
-    // use a stack to track thread_ids which must not overlap among threads
-    // because thread_id is used to index import_buffers_vec[]
-    std::stack<size_t> stack_thread_ids;
-    for (size_t i = 0; i < max_threads; i++) {
-      stack_thread_ids.push(i);
+    // the reader fills one block while each parser thread works on another one
+    const size_t max_blocks = max_threads + 1;
+    size_t num_blocks{0};
+    size_t current_pos = 0;
+    DelimitedImportPipeline pipeline;
+    std::vector<std::future<void>> parser_threads;
+    ScopeGuard stop_parser_threads = [&pipeline, &parser_threads] {
+      pipeline.close(true);
+      for (auto& parser_thread : parser_threads) {
+        parser_thread.wait();
+      }
+    };
+    // thread_id indexes import_buffers_vec[], so each parser thread keeps its own
+    for (size_t thread_id = 0; thread_id < max_threads; thread_id++) {
+      parser_threads.push_back(std::async(std::launch::async, [&, thread_id] {
+        while (auto block = pipeline.pop()) {
+          try {
+            block->import_status =
+                import_thread_delimited(thread_id,
+                                        this,
+                                        block->buffer.get(),
+                                        0,
+                                        block->size,
+                                        block->size,
+                                        columnIdToRenderGroupAnalyzerMap,
+                                        block->first_row_index,
+                                        session_info,
+                                        executor);
+          } catch (...) {
+            block->error = std::current_exception();
+          }
+          pipeline.finish(std::move(block));
+        }
+      }));
     }
+
+    auto collect_import_status = [&](DelimitedImportBlock& block) {
+      if (block.error) {
+        std::rethrow_exception(block.error);
+      }
+      {
+        mapd_lock_guard<mapd_shared_mutex> write_lock(import_mutex_);
+        import_status_ += block.import_status;
+        if (block.import_status.load_failed) {
+          set_import_status(import_id, import_status_);
+        }
+      }
+      // sum up current total file offsets
+      size_t total_file_offset{0};
+      if (decompressed) {
+        std::unique_lock<std::mutex> lock(file_offsets_mutex);
+        for (const auto file_offset : file_offsets) {
+          total_file_offset += file_offset;
+        }
+      }
+      // estimate number of rows per current total file offset
+      if (decompressed ? total_file_offset : current_pos) {
+        import_status_.rows_estimated =
+            (decompressed ? (float)total_file_size / total_file_offset
+                          : (float)file_size / current_pos) *
+            import_status_.rows_completed;
+      }
+      VLOG(3) << "rows_completed " << import_status_.rows_completed
+              << ", rows_estimated " << import_status_.rows_estimated
+              << ", total_file_size " << total_file_size << ", total_file_offset "
+              << total_file_offset;
+      set_import_status(import_id, import_status_);
+    };
+
+    // takes a new block while there are fewer than max_blocks, and otherwise waits for
+    // a parser thread to hand one back
+    auto next_block = [&]() {
+      std::unique_ptr<DelimitedImportBlock> block;
+      if (num_blocks < max_blocks) {
+        block = std::make_unique<DelimitedImportBlock>();
+        num_blocks++;
+      } else {
+        block = pipeline.waitFinished();
+        collect_import_status(*block);
+      }
+      if (block->alloc_size < alloc_size) {
+        block->buffer = std::make_unique<char[]>(alloc_size);
+        block->alloc_size = alloc_size;
+      }
+      return block;
+    };
+
+    auto block = next_block();
+    (void)fseek(p_file, current_pos, SEEK_SET);
+    block->size = fread(block->buffer.get(), 1, alloc_size, p_file);
+    // partial row at the end of a block, which starts the next block
+    std::vector<char> residual;
     // added for true row index on error
     size_t first_row_index_this_buffer = 0;
+    bool halted{false};
 
-    while (size > 0) {
+    while (block->size > 0) {
       unsigned int num_rows_this_buffer = 0;
-      CHECK(scratch_buffer);
-      end_pos = delimited_parser::find_row_end_pos(alloc_size,
-                                                   scratch_buffer,
-                                                   size,
-                                                   copy_params,
-                                                   first_row_index_this_buffer,
-                                                   num_rows_this_buffer,
-                                                   p_file);
+      const auto end_pos = delimited_parser::find_row_end_pos(alloc_size,
+                                                              block->buffer,
+                                                              block->size,
+                                                              copy_params,
+                                                              first_row_index_this_buffer,
+                                                              num_rows_this_buffer,
+                                                              p_file);
+      // the buffer is reallocated when it has to grow to hold a whole row
+      block->alloc_size = std::max(block->alloc_size, alloc_size);
 
       // unput residual
-      int nresidual = size - end_pos;
-      std::unique_ptr<char[]> unbuf;
-      if (nresidual > 0) {
-        unbuf = std::make_unique<char[]>(nresidual);
-        memcpy(unbuf.get(), scratch_buffer.get() + end_pos, nresidual);
-      }
-
-      // get a thread_id not in use
-      auto thread_id = stack_thread_ids.top();
-      stack_thread_ids.pop();
-      // LOG(INFO) << " stack_thread_ids.pop " << thread_id << std::endl;
-
-      threads.push_back(std::async(std::launch::async,
-                                   import_thread_delimited,
-                                   thread_id,
-                                   this,
-                                   std::move(scratch_buffer),
-                                   begin_pos,
-                                   end_pos,
-                                   end_pos,
-                                   columnIdToRenderGroupAnalyzerMap,
-                                   first_row_index_this_buffer,
-                                   session_info,
-                                   executor));
+      residual.assign(block->buffer.get() + end_pos, block->buffer.get() + block->size);
+      block->size = end_pos;
+      block->first_row_index = first_row_index_this_buffer;
+      pipeline.push(std::move(block));
 
       first_row_index_this_buffer += num_rows_this_buffer;
-
       current_pos += end_pos;
-      scratch_buffer = std::make_unique<char[]>(alloc_size);
-      CHECK(scratch_buffer);
-      memcpy(scratch_buffer.get(), unbuf.get(), nresidual);
-      size = nresidual +
-             fread(scratch_buffer.get() + nresidual, 1, alloc_size - nresidual, p_file);
-
-      begin_pos = 0;
-      while (threads.size() > 0) {
-        int nready = 0;
-        for (std::list<std::future<ImportStatus>>::iterator it = threads.begin();
-             it != threads.end();) {
-          auto& p = *it;
-          std::chrono::milliseconds span(0);
-          if (p.wait_for(span) == std::future_status::ready) {
-            auto ret_import_status = p.get();
-            {
-              mapd_lock_guard<mapd_shared_mutex> write_lock(import_mutex_);
-              import_status_ += ret_import_status;
-              if (ret_import_status.load_failed) {
-                set_import_status(import_id, import_status_);
-              }
-            }
-            // sum up current total file offsets
-            size_t total_file_offset{0};
-            if (decompressed) {
-              std::unique_lock<std::mutex> lock(file_offsets_mutex);
-              for (const auto file_offset : file_offsets) {
-                total_file_offset += file_offset;
-              }
-            }
-            // estimate number of rows per current total file offset
-            if (decompressed ? total_file_offset : current_pos) {
-              import_status_.rows_estimated =
-                  (decompressed ? (float)total_file_size / total_file_offset
-                                : (float)file_size / current_pos) *
-                  import_status_.rows_completed;
-            }
-            VLOG(3) << "rows_completed " << import_status_.rows_completed
-                    << ", rows_estimated " << import_status_.rows_estimated
-                    << ", total_file_size " << total_file_size << ", total_file_offset "
-                    << total_file_offset;
-            set_import_status(import_id, import_status_);
-            // recall thread_id for reuse
-            stack_thread_ids.push(ret_import_status.thread_id);
-            threads.erase(it++);
-            ++nready;
-          } else {
-            ++it;
-          }
-        }
-
-        if (nready == 0) {
-          std::this_thread::yield();
-        }
-
-        // on eof, wait all threads to finish
-        if (0 == size) {
-          continue;
-        }
 
-        // keep reading if any free thread slot
-        // this is one of the major difference from old threading model !!
-        if (threads.size() < max_threads) {
-          break;
-        }
-        mapd_shared_lock<mapd_shared_mutex> read_lock(import_mutex_);
-        if (import_status_.load_failed) {
-          break;
-        }
+      block = next_block();
+      if (!residual.empty()) {
+        memcpy(block->buffer.get(), residual.data(), residual.size());
       }
+      block->size =
+          residual.size() + fread(block->buffer.get() + residual.size(),
+                                  1,
+                                  alloc_size - residual.size(),
+                                  p_file);
+
       mapd_unique_lock<mapd_shared_mutex> write_lock(import_mutex_);
       if (import_status_.rows_rejected > copy_params.max_reject) {
         import_status_.load_failed = true;
         // todo use better message
         import_status_.load_msg = "Maximum rows rejected exceeded. Halting load";
         LOG(ERROR) << "Maximum rows rejected exceeded. Halting load";
+        halted = true;
         break;
       }
       if (import_status_.load_failed) {
         LOG(ERROR) << "Load failed, the issue was: " + import_status_.load_msg;
+        halted = true;
         break;
       }
     }
 
-    // join dangling threads in case of LOG(ERROR) above
-    for (auto& p : threads) {
-      p.wait();
+    // on eof, let the parser threads finish the queued blocks, and in case of
+    // LOG(ERROR) above, only the blocks they are already working on
+    pipeline.close(halted);
+    for (auto& parser_thread : parser_threads) {
+      parser_thread.wait();
+    }
+    while (auto finished_block = pipeline.tryFinished()) {
+      collect_import_status(*finished_block);
     }
   }
 
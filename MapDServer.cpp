@@ -61,6 +61,7 @@
 #include "Shared/file_delete.h"
 #include "Shared/scope.h"
 #include "ThriftHandler/ForeignTableRefreshScheduler.h"
+#include "ThriftHandler/TableClusteringScheduler.h"
 #if ENABLE_ITT
 #include <ittnotify.h>
 #endif
@@ -404,6 +405,7 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
     if (g_enable_fsi) {
       foreign_storage::ForeignTableRefreshScheduler::stop();
     }
+    TableClusteringScheduler::stop();
 
     Catalog_Namespace::SysCatalog::destroy();
 
@@ -484,6 +486,11 @@ int startMapdServer(CommandLineOptions& prog_config_opts, bool start_http_server
     foreign_storage::ForeignTableRefreshScheduler::start(g_running);
   }
 
+  if (g_table_clustering_interval > 0) {
+    TableClusteringScheduler::setWaitDuration(g_table_clustering_interval);
+    TableClusteringScheduler::start(g_running);
+  }
+
   // TCP port setup. We use Thrift both for a TCP socket and for an optional HTTP socket.
   std::shared_ptr<TServerSocket> tcp_socket;
   std::shared_ptr<TServerSocket> http_socket;
@@ -19,6 +19,12 @@
 #include <sys/fcntl.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
 
 #include "Logger/Logger.h"
 
@@ -61,6 +67,64 @@ int fsync(int fd) {
   return ::fsync(fd);
 }
 
+int64_t pread(const int fd, int8_t* buf, const size_t size, const size_t offset) {
+  size_t total_bytes_read{0};
+  while (total_bytes_read < size) {
+    const auto bytes_read = ::pread(
+        fd, buf + total_bytes_read, size - total_bytes_read, offset + total_bytes_read);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (bytes_read == 0) {
+      break;  // end of file
+    }
+    total_bytes_read += bytes_read;
+  }
+  return total_bytes_read;
+}
+
+int64_t preadv(const int fd,
+               const std::vector<std::pair<int8_t*, size_t>>& buffers,
+               const size_t offset) {
+  std::vector<iovec> iovs;
+  iovs.reserve(buffers.size());
+  for (const auto& [buf, size] : buffers) {
+    iovs.push_back({buf, size});
+  }
+  size_t total_bytes_read{0};
+  size_t first_iov{0};
+  while (first_iov < iovs.size()) {
+    const int num_iovs = std::min(iovs.size() - first_iov, static_cast<size_t>(IOV_MAX));
+    const auto bytes_read =
+        ::preadv(fd, &iovs[first_iov], num_iovs, offset + total_bytes_read);
+    if (bytes_read < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return -1;
+    }
+    if (bytes_read == 0) {
+      break;  // end of file
+    }
+    total_bytes_read += bytes_read;
+    // Skip the buffers which were filled, and the filled part of a partly filled one.
+    size_t bytes_left = bytes_read;
+    while (first_iov < iovs.size() && bytes_left >= iovs[first_iov].iov_len) {
+      bytes_left -= iovs[first_iov].iov_len;
+      ++first_iov;
+    }
+    if (bytes_left > 0) {
+      auto& iov = iovs[first_iov];
+      iov.iov_base = static_cast<int8_t*>(iov.iov_base) + bytes_left;
+      iov.iov_len -= bytes_left;
+    }
+  }
+  return total_bytes_read;
+}
+
 int open(const char* path, int flags, int mode) {
   return ::open(path, flags, mode);
 }
@@ -27,6 +27,8 @@
 
 #include <memoryapi.h>
 
+#include <algorithm>
+
 #include "Logger/Logger.h"
 
 namespace omnisci {
@@ -64,6 +66,49 @@ int fsync(int fd) {
   return fflush(file);
 }
 
+int64_t pread(const int fd, int8_t* buf, const size_t size, const size_t offset) {
+  auto handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  size_t total_bytes_read{0};
+  while (total_bytes_read < size) {
+    const auto read_offset = offset + total_bytes_read;
+    OVERLAPPED overlapped{};
+    overlapped.Offset = static_cast<DWORD>(read_offset);
+    overlapped.OffsetHigh = static_cast<DWORD>(read_offset >> 32);
+    const auto bytes_to_read =
+        static_cast<DWORD>(std::min(size - total_bytes_read, size_t(1) << 30));
+    DWORD bytes_read{0};
+    if (!ReadFile(
+            handle, buf + total_bytes_read, bytes_to_read, &bytes_read, &overlapped)) {
+      if (GetLastError() == ERROR_HANDLE_EOF) {
+        break;
+      }
+      return -1;
+    }
+    if (bytes_read == 0) {
+      break;  // end of file
+    }
+    total_bytes_read += bytes_read;
+  }
+  return total_bytes_read;
+}
+
+int64_t preadv(const int fd,
+               const std::vector<std::pair<int8_t*, size_t>>& buffers,
+               const size_t offset) {
+  size_t total_bytes_read{0};
+  for (const auto& [buf, size] : buffers) {
+    const auto bytes_read = pread(fd, buf, size, offset + total_bytes_read);
+    if (bytes_read < 0) {
+      return -1;
+    }
+    total_bytes_read += bytes_read;
+    if (static_cast<size_t>(bytes_read) < size) {
+      break;  // end of file
+    }
+  }
+  return total_bytes_read;
+}
+
 int open(const char* path, int flags, int mode) {
   return _open(path, flags, mode);
 }
@@ -17,8 +17,12 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
 
+#include <utility>
+#include <vector>
+
 namespace omnisci {
 
 size_t file_size(const int fd);
@@ -31,6 +35,21 @@ int msync(void* addr, size_t length, bool async);
 
 int fsync(int fd);
 
+/**
+ * Reads `size` bytes at `offset` of the file without moving the file offset, so reads of
+ * the file can run concurrently. Returns the number of bytes read, which is less than
+ * `size` at the end of the file, or -1 on error.
+ */
+int64_t pread(const int fd, int8_t* buf, const size_t size, const size_t offset);
+
+/**
+ * Like pread, but scatters the bytes read over `buffers`, given as pointers and sizes,
+ * with as few reads as the platform allows.
+ */
+int64_t preadv(const int fd,
+               const std::vector<std::pair<int8_t*, size_t>>& buffers,
+               const size_t offset);
+
 int open(const char* path, int flags, int mode);
 
 void close(const int fd);
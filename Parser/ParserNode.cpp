@@ -3931,6 +3931,55 @@ bool user_can_access_table(const Catalog_Namespace::SessionInfo& session_info,
 };
 }  // namespace
 
+const NameValueAssign* OptimizeTableStmt::getOption(const std::string& name) const {
+  for (const auto& e : options_) {
+    if (boost::iequals(*(e->get_name()), name)) {
+      return e.get();
+    }
+  }
+  return nullptr;
+}
+
+namespace {
+std::string get_optimize_option_string(const NameValueAssign* option) {
+  const auto str_literal = dynamic_cast<const StringLiteral*>(option->get_value());
+  if (!str_literal) {
+    throw std::runtime_error("The value of the OPTIMIZE option " + *option->get_name() +
+                             " must be a string.");
+  }
+  return *str_literal->get_stringval();
+}
+}  // namespace
+
+std::vector<std::string> OptimizeTableStmt::getClusterColumnNames() const {
+  const auto option = getOption("CLUSTER");
+  CHECK(option);
+  const auto value = get_optimize_option_string(option);
+  if (boost::iequals(value, "true")) {
+    return {};
+  }
+  std::vector<std::string> column_names;
+  boost::split(column_names, value, boost::is_any_of(","));
+  for (auto& column_name : column_names) {
+    boost::trim(column_name);
+    if (column_name.empty()) {
+      throw std::runtime_error("CLUSTER must be 'true' or a list of column names.");
+    }
+  }
+  return column_names;
+}
+
+bool OptimizeTableStmt::shouldClusterInZOrder() const {
+  const auto option = getOption("ZORDER");
+  if (!option) {
+    return false;
+  }
+  if (!shouldClusterRows()) {
+    throw std::runtime_error("ZORDER can only be given along with CLUSTER.");
+  }
+  return boost::iequals(get_optimize_option_string(option), "true");
+}
+
 void OptimizeTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   auto& catalog = session.getCatalog();
 
@@ -3952,6 +4001,9 @@ void OptimizeTableStmt::execute(const Catalog_Namespace::SessionInfo& session) {
   if (shouldVacuumDeletedRows()) {
     optimizer.vacuumDeletedRows();
   }
+  if (shouldClusterRows()) {
+    optimizer.clusterRows(getClusterColumnNames(), shouldClusterInZOrder());
+  }
   optimizer.recomputeMetadata();
 }
 
@@ -4539,11 +4591,12 @@ void RenameColumnStmt::execute(const Catalog_Namespace::SessionInfo& session) {
 }
 
 void AlterTableParamStmt::execute(const Catalog_Namespace::SessionInfo& session) {
-  enum TableParamType { MaxRollbackEpochs, Epoch, MaxRows };
+  enum TableParamType { MaxRollbackEpochs, Epoch, MaxRows, EvictionPriority };
   static const std::unordered_map<std::string, TableParamType> param_map = {
       {"max_rollback_epochs", TableParamType::MaxRollbackEpochs},
       {"epoch", TableParamType::Epoch},
-      {"max_rows", TableParamType::MaxRows}};
+      {"max_rows", TableParamType::MaxRows},
+      {"eviction_priority", TableParamType::EvictionPriority}};
   // Below is to ensure that executor is not currently executing on table when we might be
   // changing it's storage. Question: will/should catalog write lock take care of this?
   const auto execute_write_lock = mapd_unique_lock<mapd_shared_mutex>(
@@ -4592,6 +4645,14 @@ void AlterTableParamStmt::execute(const Catalog_Namespace::SessionInfo& session)
       catalog.setMaxRows(td->tableId, param_val);
       break;
     }
+    case EvictionPriority: {
+      if (param_val < std::numeric_limits<int32_t>::min() ||
+          param_val > std::numeric_limits<int32_t>::max()) {
+        throw std::runtime_error("Eviction priority is out of range.");
+      }
+      catalog.setEvictionPriority(td->tableId, param_val);
+      break;
+    }
     default: {
       UNREACHABLE() << "Unexpected TableParamType value: " << param_it->second
                     << ", key: " << param_it->first;
@@ -1250,9 +1250,19 @@ class OptimizeTableStmt : public DDLStmt {
     return false;
   }
 
+  bool shouldClusterRows() const { return getOption("CLUSTER") != nullptr; }
+
+  // CLUSTER='true' clusters on the sort column of the table, any other value is the
+  // comma separated list of the columns to cluster on.
+  std::vector<std::string> getClusterColumnNames() const;
+
+  bool shouldClusterInZOrder() const;
+
   void execute(const Catalog_Namespace::SessionInfo& session) override;
 
  private:
+  const NameValueAssign* getOption(const std::string& name) const;
+
   std::unique_ptr<std::string> table_;
   std::list<std::unique_ptr<NameValueAssign>> options_;
 };
@@ -292,6 +292,8 @@ extern "C" DEVICE RUNTIME_EXPORT int8_t* array_buff(int8_t* chunk_iter_,
 
 #include <set>
 
+#include "CountDistinctHashSet.h"
+
 extern "C" RUNTIME_EXPORT ALWAYS_INLINE int64_t elem_bitcast_int8_t(const int8_t val) {
   return val;
 }
@@ -317,8 +319,8 @@ extern "C" RUNTIME_EXPORT ALWAYS_INLINE int64_t elem_bitcast_double(const double
   return *reinterpret_cast<const int64_t*>(may_alias_ptr(&val));
 }
 
-#define COUNT_DISTINCT_ARRAY(type)                                                      \
-  extern "C" RUNTIME_EXPORT void agg_count_distinct_array_##type(                       \
+#define COUNT_DISTINCT_ARRAY(type, set_type, suffix)                                   \
+  extern "C" RUNTIME_EXPORT void agg_count_distinct_array_##suffix##type(              \
       int64_t* agg, int8_t* chunk_iter_, const uint64_t row_pos, const type null_val) { \
     ChunkIter* chunk_iter = reinterpret_cast<ChunkIter*>(chunk_iter_);                  \
     ArrayDatum ad;                                                                      \
@@ -328,17 +330,23 @@ extern "C" RUNTIME_EXPORT ALWAYS_INLINE int64_t elem_bitcast_double(const double
     for (size_t i = 0; i < elem_count; ++i) {                                           \
       const auto val = reinterpret_cast<type*>(ad.pointer)[i];                          \
       if (val != null_val) {                                                            \
-        reinterpret_cast<std::set<int64_t>*>(*agg)->insert(elem_bitcast_##type(val));   \
+        reinterpret_cast<set_type*>(*agg)->insert(elem_bitcast_##type(val));            \
       }                                                                                 \
     }                                                                                   \
   }
 
-COUNT_DISTINCT_ARRAY(int8_t)
-COUNT_DISTINCT_ARRAY(int16_t)
-COUNT_DISTINCT_ARRAY(int32_t)
-COUNT_DISTINCT_ARRAY(int64_t)
-COUNT_DISTINCT_ARRAY(float)
-COUNT_DISTINCT_ARRAY(double)
+COUNT_DISTINCT_ARRAY(int8_t, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(int16_t, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(int32_t, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(int64_t, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(float, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(double, std::set<int64_t>, )
+COUNT_DISTINCT_ARRAY(int8_t, CountDistinctHashSet, hash_set_)
+COUNT_DISTINCT_ARRAY(int16_t, CountDistinctHashSet, hash_set_)
+COUNT_DISTINCT_ARRAY(int32_t, CountDistinctHashSet, hash_set_)
+COUNT_DISTINCT_ARRAY(int64_t, CountDistinctHashSet, hash_set_)
+COUNT_DISTINCT_ARRAY(float, CountDistinctHashSet, hash_set_)
+COUNT_DISTINCT_ARRAY(double, CountDistinctHashSet, hash_set_)
 
 #undef COUNT_DISTINCT_ARRAY
 
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/ChunkPrefetcher.h"
+
+#include "Catalog/Catalog.h"
+#include "DataMgr/Chunk/Chunk.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+size_t g_chunk_prefetch_threads{4};
+
+namespace {
+
+// The I/O threads shared by the prefetchers of all the queries. The prefetchers take
+// turns one kernel at a time, so that a query with many kernels doesn't hold up the
+// prefetching for the others. A prefetcher is queued once for every thread it can keep
+// busy.
+class ChunkPrefetchPool {
+ public:
+  static ChunkPrefetchPool& instance() {
+    // never destroyed, its threads wait for work until the process exits
+    static auto chunk_prefetch_pool = new ChunkPrefetchPool();
+    return *chunk_prefetch_pool;
+  }
+
+  void add(ChunkPrefetcher* prefetcher, const size_t num_kernels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto num_threads = std::max(g_chunk_prefetch_threads, size_t(1));
+    while (threads_.size() < num_threads) {
+      threads_.emplace_back(&ChunkPrefetchPool::worker, this);
+    }
+    for (size_t i = 0; i < std::min(num_threads, num_kernels); ++i) {
+      queue_.push_back(prefetcher);
+    }
+    cv_.notify_all();
+  }
+
+  // Waits for the threads working for the prefetcher, which must have been stopped, and
+  // takes it off the queue.
+  void remove(ChunkPrefetcher* prefetcher) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this, prefetcher] { return !running_.count(prefetcher); });
+    queue_.erase(std::remove(queue_.begin(), queue_.end(), prefetcher), queue_.end());
+  }
+
+ private:
+  void worker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return !queue_.empty(); });
+      auto prefetcher = queue_.front();
+      queue_.pop_front();
+      running_.insert(prefetcher);
+      lock.unlock();
+      const bool has_more_kernels = prefetcher->prefetchNextKernel();
+      lock.lock();
+      running_.erase(running_.find(prefetcher));
+      if (has_more_kernels) {
+        queue_.push_back(prefetcher);
+      }
+      cv_.notify_all();
+    }
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<ChunkPrefetcher*> queue_;
+  std::multiset<ChunkPrefetcher*> running_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace
+
+ChunkPrefetcher::ChunkPrefetcher(
+    const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+    const std::vector<InputTableInfo>& query_infos,
+    const std::set<std::pair<int, int>>& columns_to_not_fetch,
+    const Catalog_Namespace::Catalog& cat)
+    : cat_(cat)
+    , kernel_started_(kernels.size(), false)
+    , kernel_finished_(kernels.size(), false)
+    , kernel_reserved_bytes_(kernels.size(), 0)
+    , kernel_pinned_chunks_(kernels.size()) {
+  std::map<int, const InputTableInfo*> query_info_by_table_id;
+  for (const auto& query_info : query_infos) {
+    query_info_by_table_id.emplace(query_info.table_id, &query_info);
+  }
+  for (const auto& kernel : kernels) {
+    column_fetchers_.push_back(&kernel->getColumnFetcher());
+    auto& chunks = kernel_chunks_.emplace_back();
+    for (const auto& fragments_per_table : kernel->getFragmentsList()) {
+      const auto table_id = fragments_per_table.table_id;
+      const auto query_info_it = query_info_by_table_id.find(table_id);
+      if (table_id <= 0 || query_info_it == query_info_by_table_id.end()) {
+        continue;
+      }
+      // Only the chunks of tables on disk are worth loading ahead, foreign tables are
+      // loaded in parallel by their own storage manager.
+      const auto td = cat.getMetadataForTable(table_id, false);
+      if (!td || td->isForeignTable() ||
+          td->persistenceLevel != Data_Namespace::MemoryLevel::DISK_LEVEL) {
+        continue;
+      }
+      const auto& fragments = query_info_it->second->info.fragments;
+      for (const auto frag_id : fragments_per_table.fragment_ids) {
+        CHECK_LT(frag_id, fragments.size());
+        const auto& fragment = fragments[frag_id];
+        if (fragment.isEmptyPhysicalFragment()) {
+          continue;
+        }
+        const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+        for (const auto& col_desc : kernel->ra_exe_unit_.input_col_descs) {
+          const auto col_id = col_desc->getColId();
+          // Lazily fetched columns are only read for the rows in the result.
+          if (col_desc->getScanDesc().getTableId() != table_id ||
+              columns_to_not_fetch.count({table_id, col_id})) {
+            continue;
+          }
+          const auto cd = cat.getMetadataForColumn(table_id, col_id);
+          const auto chunk_meta_it = chunk_metadata_map.find(col_id);
+          if (!cd || cd->isVirtualCol || chunk_meta_it == chunk_metadata_map.end()) {
+            continue;
+          }
+          chunks.push_back(
+              {cd,
+               {cat.getCurrentDB().dbId,
+                fragment.physicalTableId,
+                col_id,
+                fragment.fragmentId},
+               chunk_meta_it->second});
+        }
+      }
+    }
+  }
+  ChunkPrefetchPool::instance().add(this, kernels.size());
+}
+
+ChunkPrefetcher::~ChunkPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  auto& data_mgr = cat_.getDataMgr();
+  data_mgr.wakePrefetchWaiters();
+  ChunkPrefetchPool::instance().remove(this);
+  for (size_t kernel_idx = 0; kernel_idx < kernel_started_.size(); ++kernel_idx) {
+    kernelFinished(kernel_idx);
+  }
+}
+
+void ChunkPrefetcher::kernelStarted(const size_t kernel_idx) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(kernel_idx, kernel_started_.size());
+    kernel_started_[kernel_idx] = true;
+  }
+  cat_.getDataMgr().wakePrefetchWaiters();
+}
+
+void ChunkPrefetcher::kernelFinished(const size_t kernel_idx) {
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> pinned_chunks;
+  size_t reserved_bytes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CHECK_LT(kernel_idx, kernel_finished_.size());
+    kernel_started_[kernel_idx] = true;
+    kernel_finished_[kernel_idx] = true;
+    pinned_chunks.swap(kernel_pinned_chunks_[kernel_idx]);
+    reserved_bytes = kernel_reserved_bytes_[kernel_idx];
+    kernel_reserved_bytes_[kernel_idx] = 0;
+  }
+  // The chunks unpin their buffers as they go away, which leaves them in the pool.
+  pinned_chunks.clear();
+  if (reserved_bytes) {
+    cat_.getDataMgr().releasePrefetchMemory(reserved_bytes);
+  }
+}
+
+bool ChunkPrefetcher::prefetchNextKernel() {
+  size_t kernel_idx;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (next_kernel_idx_ < kernel_started_.size() &&
+           kernel_started_[next_kernel_idx_]) {
+      ++next_kernel_idx_;
+    }
+    if (stop_ || next_kernel_idx_ == kernel_started_.size()) {
+      return false;
+    }
+    kernel_idx = next_kernel_idx_++;
+  }
+  auto& data_mgr = cat_.getDataMgr();
+  for (const auto& chunk : kernel_chunks_[kernel_idx]) {
+    Chunk_NS::Chunk chunk_in_pool{chunk.cd};
+    if (chunk_in_pool.isChunkOnDevice(
+            &data_mgr, chunk.chunk_key, Data_Namespace::CPU_LEVEL, 0)) {
+      continue;
+    }
+    if (!reserveMemory(kernel_idx, chunk.chunk_meta->numBytes)) {
+      break;
+    }
+    std::shared_ptr<Chunk_NS::Chunk> pinned_chunk;
+    try {
+      pinned_chunk = column_fetchers_[kernel_idx]->prefetchTableColumnFragment(
+          chunk.cd, chunk.chunk_key, *chunk.chunk_meta);
+    } catch (const std::exception& e) {
+      // The kernel fetches the chunk itself and reports the error, if any.
+      VLOG(1) << "Stopped prefetching chunks: " << e.what();
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The budget of a kernel which finished meanwhile has been released already, along
+    // with the reservation for this chunk.
+    if (!kernel_finished_[kernel_idx]) {
+      kernel_pinned_chunks_[kernel_idx].push_back(std::move(pinned_chunk));
+    }
+  }
+  return true;
+}
+
+bool ChunkPrefetcher::reserveMemory(const size_t kernel_idx, const size_t num_bytes) {
+  auto& data_mgr = cat_.getDataMgr();
+  // The budget frees up as kernels finish, also the kernels of other queries.
+  const auto cancelled = [this, kernel_idx] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stop_ || kernel_started_[kernel_idx];
+  };
+  if (!data_mgr.waitForPrefetchMemory(num_bytes, cancelled)) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stop_ && !kernel_started_[kernel_idx]) {
+      kernel_reserved_bytes_[kernel_idx] += num_bytes;
+      return true;
+    }
+  }
+  data_mgr.releasePrefetchMemory(num_bytes);
+  return false;
+}
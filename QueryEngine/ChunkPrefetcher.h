@@ -0,0 +1,92 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    ChunkPrefetcher.h
+ * @brief   Loads the chunks of the kernels of a query into the CPU buffer pool ahead of
+ * the kernels.
+ *
+ * The kernels of a query are all launched at once, but only as many of them run at a time
+ * as there are threads, and each of them fetches its chunks before computing. The
+ * prefetcher loads the chunks of the kernels which didn't start yet in launch order, on
+ * I/O threads shared by the prefetchers of all the queries, so that their I/O overlaps
+ * the execution of the running kernels.
+ *
+ * The prefetched chunks stay pinned until their kernel is done, so they can't be evicted
+ * before they're used, and take from the prefetch budget of the DataMgr until then, which
+ * bounds how far ahead the prefetchers run. Since the kernel finds the chunks pinned, its
+ * own fetch doesn't count as another reference for the eviction policy: the load by the
+ * prefetcher stands for the reference of the kernel.
+ */
+
+#pragma once
+
+#include "QueryEngine/ExecutionKernel.h"
+
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+namespace Chunk_NS {
+class Chunk;
+}
+
+class ChunkPrefetcher {
+ public:
+  ChunkPrefetcher(const std::vector<std::unique_ptr<ExecutionKernel>>& kernels,
+                  const std::vector<InputTableInfo>& query_infos,
+                  const std::set<std::pair<int, int>>& columns_to_not_fetch,
+                  const Catalog_Namespace::Catalog& cat);
+
+  // Stops prefetching, unpins the chunks and releases the budget of all the kernels.
+  ~ChunkPrefetcher();
+
+  // The chunks of a kernel which started aren't prefetched anymore, it fetches them.
+  void kernelStarted(const size_t kernel_idx);
+
+  // Unpins the chunks prefetched for the kernel and releases their budget.
+  void kernelFinished(const size_t kernel_idx);
+
+  // Loads the chunks of the next kernel which didn't start. Called by the I/O threads,
+  // returns false once there's nothing left to prefetch.
+  bool prefetchNextKernel();
+
+ private:
+  struct PrefetchChunk {
+    const ColumnDescriptor* cd;
+    ChunkKey chunk_key;
+    std::shared_ptr<ChunkMetadata> chunk_meta;
+  };
+
+  bool reserveMemory(const size_t kernel_idx, const size_t num_bytes);
+
+  const Catalog_Namespace::Catalog& cat_;
+  std::vector<const ColumnFetcher*> column_fetchers_;
+  std::vector<std::vector<PrefetchChunk>> kernel_chunks_;
+
+  std::mutex mutex_;
+  std::vector<bool> kernel_started_;
+  std::vector<bool> kernel_finished_;
+  std::vector<size_t> kernel_reserved_bytes_;
+  std::vector<std::vector<std::shared_ptr<Chunk_NS::Chunk>>> kernel_pinned_chunks_;
+  size_t next_kernel_idx_{0};
+  bool stop_{false};
+};
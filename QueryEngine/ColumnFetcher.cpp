@@ -19,6 +19,7 @@
 #include <memory>
 
 #include "DataMgr/ArrayNoneEncoder.h"
+#include "DataMgr/IntegerSequenceEncoder.h"
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/Execute.h"
 #include "Shared/Intervals.h"
@@ -97,12 +98,15 @@ std::pair<const int8_t*, size_t> ColumnFetcher::getOneColumnFragment(
                        fragment.physicalTableId,
                        hash_col.get_column_id(),
                        fragment.fragmentId};
+    // Hash tables, window functions and table functions index the column by row.
+    const bool decode = cd->columnType.is_sequence_encoded();
+    const auto chunk_mem_lvl = decode ? Data_Namespace::CPU_LEVEL : effective_mem_lvl;
     const auto chunk = Chunk_NS::Chunk::getChunk(
         cd,
         &catalog.getDataMgr(),
         chunk_key,
-        effective_mem_lvl,
-        effective_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
+        chunk_mem_lvl,
+        chunk_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
         chunk_meta_it->second->numBytes,
         chunk_meta_it->second->numElements);
     chunks_owner.push_back(chunk);
@@ -110,6 +114,13 @@ std::pair<const int8_t*, size_t> ColumnFetcher::getOneColumnFragment(
     auto ab = chunk->getBuffer();
     CHECK(ab->getMemoryPtr());
     col_buff = reinterpret_cast<int8_t*>(ab->getMemoryPtr());
+    if (decode) {
+      col_buff = decodeSequenceChunk(ab,
+                                     cd->columnType,
+                                     fragment.getNumTuples(),
+                                     effective_mem_lvl,
+                                     device_allocator);
+    }
   } else {  // temporary table
     const ColumnarResults* col_frag{nullptr};
     {
@@ -244,6 +255,11 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
   const bool is_varlen =
       is_real_string ||
       col_type.is_array();  // TODO: should it be col_type.is_varlen_array() ?
+  // Run length and differential encoded chunks can't be read by position, the kernels
+  // get their decoded rows.
+  const bool is_sequence_encoded = col_type.is_sequence_encoded();
+  const auto chunk_mem_lvl =
+      is_sequence_encoded ? Data_Namespace::CPU_LEVEL : memory_level;
   {
     ChunkKey chunk_key{
         cat.getCurrentDB().dbId, fragment.physicalTableId, col_id, fragment.fragmentId};
@@ -255,8 +271,8 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
         cd,
         &cat.getDataMgr(),
         chunk_key,
-        memory_level,
-        memory_level == Data_Namespace::CPU_LEVEL ? 0 : device_id,
+        chunk_mem_lvl,
+        chunk_mem_lvl == Data_Namespace::CPU_LEVEL ? 0 : device_id,
         chunk_meta_it->second->numBytes,
         chunk_meta_it->second->numElements);
     std::lock_guard<std::mutex> chunk_list_lock(chunk_list_mutex_);
@@ -284,10 +300,35 @@ const int8_t* ColumnFetcher::getOneTableColumnFragment(
   } else {
     auto ab = chunk->getBuffer();
     CHECK(ab->getMemoryPtr());
+    if (is_sequence_encoded) {
+      return decodeSequenceChunk(
+          ab, col_type, fragment.getNumTuples(), memory_level, allocator);
+    }
     return ab->getMemoryPtr();  // @TODO(alex) change to use ChunkIter
   }
 }
 
+std::shared_ptr<Chunk_NS::Chunk> ColumnFetcher::prefetchTableColumnFragment(
+    const ColumnDescriptor* cd,
+    const ChunkKey& chunk_key,
+    const ChunkMetadata& chunk_meta) const {
+  const auto& col_type = cd->columnType;
+  const bool is_varlen = (col_type.is_string() &&
+                          col_type.get_compression() == kENCODING_NONE) ||
+                         col_type.is_array();
+  std::unique_ptr<std::lock_guard<std::mutex>> varlen_chunk_lock;
+  if (is_varlen) {
+    varlen_chunk_lock.reset(new std::lock_guard<std::mutex>(varlen_chunk_fetch_mutex_));
+  }
+  return Chunk_NS::Chunk::getChunk(cd,
+                                   &executor_->getCatalog()->getDataMgr(),
+                                   chunk_key,
+                                   Data_Namespace::CPU_LEVEL,
+                                   0,
+                                   chunk_meta.numBytes,
+                                   chunk_meta.numElements);
+}
+
 const int8_t* ColumnFetcher::getAllTableColumnFragments(
     const int table_id,
     const int col_id,
@@ -304,6 +345,7 @@ const int8_t* ColumnFetcher::getAllTableColumnFragments(
   const ColumnarResults* table_column = nullptr;
   const InputColDescriptor col_desc(col_id, table_id, int(0));
   CHECK(col_desc.getScanDesc().getSourceType() == InputSourceType::TABLE);
+  const auto cd = get_column_descriptor(col_id, table_id, *executor_->getCatalog());
   {
     std::lock_guard<std::mutex> columnar_conversion_guard(columnar_fetch_mutex_);
     auto column_it = columnarized_scan_table_cache_.find(col_desc);
@@ -990,6 +1032,29 @@ MergedChunk ColumnFetcher::linearizeFixedLenArrayColFrags(
   return {merged_data_buffer, nullptr};
 }
 
+const int8_t* ColumnFetcher::decodeSequenceChunk(
+    Data_Namespace::AbstractBuffer* chunk_buffer,
+    const SQLTypeInfo& ti,
+    const size_t row_count,
+    const Data_Namespace::MemoryLevel memory_level,
+    DeviceAllocator* device_allocator) {
+  CHECK(ti.is_sequence_encoded());
+  CHECK_EQ(Data_Namespace::CPU_LEVEL, chunk_buffer->getType());
+  auto encoder = dynamic_cast<SequenceEncoder*>(chunk_buffer->getEncoder());
+  CHECK(encoder);
+  CHECK_LE(row_count, encoder->getNumElems());
+  // Decoded once per chunk and reused by the following fetches until the chunk changes.
+  const auto decoded_buff = encoder->getDecodedRows();
+  if (memory_level == Data_Namespace::GPU_LEVEL) {
+    CHECK(device_allocator);
+    const auto num_bytes = row_count * ti.get_size();
+    auto gpu_buff = device_allocator->alloc(num_bytes);
+    device_allocator->copyToDevice(gpu_buff, decoded_buff, num_bytes);
+    return gpu_buff;
+  }
+  return decoded_buff;
+}
+
 const int8_t* ColumnFetcher::transferColumnIfNeeded(
     const ColumnarResults* columnar_results,
     const int col_id,
@@ -86,6 +86,13 @@ class ColumnFetcher {
       const int device_id,
       DeviceAllocator* device_allocator) const;
 
+  //! Loads one chunk into the CPU buffer pool for a kernel to find it there later. The
+  //! chunk keeps its buffers pinned until it goes away. See ChunkPrefetcher.
+  std::shared_ptr<Chunk_NS::Chunk> prefetchTableColumnFragment(
+      const ColumnDescriptor* cd,
+      const ChunkKey& chunk_key,
+      const ChunkMetadata& chunk_meta) const;
+
   const int8_t* getAllTableColumnFragments(
       const int table_id,
       const int col_id,
@@ -117,6 +124,15 @@ class ColumnFetcher {
   void freeLinearizedBuf();
 
  private:
+  // Returns the rows of a run length or differential encoded CPU chunk, which doesn't
+  // store one slot per row, as slots of the logical width of the column at
+  // `memory_level`.
+  static const int8_t* decodeSequenceChunk(Data_Namespace::AbstractBuffer* chunk_buffer,
+                                           const SQLTypeInfo& ti,
+                                           const size_t row_count,
+                                           const Data_Namespace::MemoryLevel memory_level,
+                                           DeviceAllocator* device_allocator);
+
   static const int8_t* transferColumnIfNeeded(
       const ColumnarResults* columnar_results,
       const int col_id,
@@ -73,6 +73,10 @@ std::shared_ptr<Decoder> get_col_decoder(const Analyzer::ColumnVar* col_var) {
       return col_var->get_comp_param() == 16 ? std::make_shared<FixedWidthSmallDate>(2)
                                              : std::make_shared<FixedWidthSmallDate>(4);
     }
+    case kENCODING_RL:
+    case kENCODING_DIFF:
+      // Decoded to one slot per row when the chunk is fetched.
+      return std::make_shared<FixedWidthInt>(ti.get_size());
     default:
       abort();
   }
@@ -63,6 +63,12 @@ class CpuCompilationContext : public CompilationContext {
   CpuCompilationContext(ExecutionEngineWrapper&& execution_engine)
       : execution_engine_(std::move(execution_engine)) {}
 
+  // For code compiled in an LLVM context of its own, which must outlive the engine.
+  CpuCompilationContext(ExecutionEngineWrapper&& execution_engine,
+                        std::unique_ptr<llvm::LLVMContext> llvm_context)
+      : llvm_context_(std::move(llvm_context))
+      , execution_engine_(std::move(execution_engine)) {}
+
   void setFunctionPointer(llvm::Function* function) {
     func_ = execution_engine_->getPointerToFunction(function);
     CHECK(func_);
@@ -72,5 +78,6 @@ class CpuCompilationContext : public CompilationContext {
 
  private:
   void* func_{nullptr};
+  std::unique_ptr<llvm::LLVMContext> llvm_context_;
   ExecutionEngineWrapper execution_engine_;
 };
@@ -21,7 +21,9 @@
 
 enum class ExecutorDeviceType { CPU, GPU };
 
-enum class ExecutorOptLevel { Default, LoopStrengthReduction, ReductionJIT };
+// Baseline code is generated with as few IR passes and as little machine code
+// optimization as possible, to start executing sooner.
+enum class ExecutorOptLevel { Default, LoopStrengthReduction, ReductionJIT, Baseline };
 
 enum class ExecutorExplainType { Default, Optimized };
 
@@ -0,0 +1,164 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    CountDistinctHashSet.h
+ * @brief   Set of 64-bit values for COUNT(DISTINCT) on arguments whose range is too
+ *wide for a bitmap.
+ *
+ * A set starts sparse, as a short unordered vector, since most groups of a high
+ * cardinality group by only see a handful of values. Past kMaxSparseSize values it is
+ * promoted to a dense open addressing (linear probing) table kept at most half full.
+ * Compared to a node based std::set this needs one allocation per set and 8 to 16 bytes
+ * per value instead of ~40, and merging sizes the table once for both sets.
+ */
+
+#ifndef QUERYENGINE_COUNTDISTINCTHASHSET_H
+#define QUERYENGINE_COUNTDISTINCTHASHSET_H
+
+#include "Logger/Logger.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+class CountDistinctHashSet {
+ public:
+  void insert(const int64_t val) {
+    if (!isDense()) {
+      if (std::find(sparse_values_.begin(), sparse_values_.end(), val) !=
+          sparse_values_.end()) {
+        return;
+      }
+      if (sparse_values_.size() < kMaxSparseSize) {
+        sparse_values_.push_back(val);
+        return;
+      }
+      reserve(2 * kMaxSparseSize);
+    }
+    if (val == kEmptySlot) {
+      has_empty_slot_value_ = true;
+      return;
+    }
+    if (2 * (dense_size_ + 1) > slots_.size()) {
+      rehash(2 * slots_.size());
+    }
+    if (insertIntoSlots(val)) {
+      ++dense_size_;
+    }
+  }
+
+  size_t size() const {
+    return isDense() ? dense_size_ + (has_empty_slot_value_ ? 1 : 0)
+                     : sparse_values_.size();
+  }
+
+  // Adds all the values of `that` to this set. The reduction already runs groups on
+  // separate threads, so a merge stays on the calling thread.
+  void merge(const CountDistinctHashSet& that) {
+    if (&that == this) {
+      return;
+    }
+    if (!that.isDense()) {
+      for (const auto val : that.sparse_values_) {
+        insert(val);
+      }
+      return;
+    }
+    reserve(size() + that.size());
+    has_empty_slot_value_ |= that.has_empty_slot_value_;
+    for (const auto val : that.slots_) {
+      if (val != kEmptySlot && insertIntoSlots(val)) {
+        ++dense_size_;
+      }
+    }
+  }
+
+ private:
+  static constexpr int64_t kEmptySlot{std::numeric_limits<int64_t>::min()};
+  static constexpr size_t kMaxSparseSize{16};
+
+  bool isDense() const { return !slots_.empty(); }
+
+  // Makes room for `count` values without further rehashing.
+  void reserve(const size_t count) {
+    if (!isDense() && count <= kMaxSparseSize) {
+      return;
+    }
+    size_t capacity = isDense() ? slots_.size() : 4 * kMaxSparseSize;
+    while (capacity < 2 * count) {
+      capacity *= 2;
+    }
+    if (capacity != slots_.size()) {
+      rehash(capacity);
+    }
+  }
+
+  // Moves all values into a dense table of `capacity` slots, a power of two.
+  void rehash(const size_t capacity) {
+    CHECK_EQ(capacity & (capacity - 1), size_t(0));
+    std::vector<int64_t> old_slots(capacity, kEmptySlot);
+    old_slots.swap(slots_);
+    dense_size_ = 0;
+    for (const auto val : old_slots) {
+      if (val != kEmptySlot && insertIntoSlots(val)) {
+        ++dense_size_;
+      }
+    }
+    for (const auto val : sparse_values_) {
+      if (val == kEmptySlot) {
+        has_empty_slot_value_ = true;
+      } else if (insertIntoSlots(val)) {
+        ++dense_size_;
+      }
+    }
+    std::vector<int64_t>().swap(sparse_values_);
+  }
+
+  // Returns true if `val` wasn't in the table yet.
+  bool insertIntoSlots(const int64_t val) {
+    const size_t mask = slots_.size() - 1;
+    for (size_t idx = hash(val) & mask;; idx = (idx + 1) & mask) {
+      auto& slot = slots_[idx];
+      if (slot == kEmptySlot) {
+        slot = val;
+        return true;
+      }
+      if (slot == val) {
+        return false;
+      }
+    }
+  }
+
+  // MurmurHash3 finalizer, spreads sequential ids across the table.
+  static size_t hash(const int64_t val) {
+    auto h = static_cast<uint64_t>(val);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  std::vector<int64_t> sparse_values_;
+  std::vector<int64_t> slots_;
+  size_t dense_size_{0};
+  // kEmptySlot marks free slots, so the value itself is tracked on the side.
+  bool has_empty_slot_value_{false};
+};
+
+#endif  // QUERYENGINE_COUNTDISTINCTHASHSET_H
@@ -17,9 +17,11 @@
 #pragma once
 
 #include "Analyzer/Analyzer.h"
+#include "Catalog/Catalog.h"
 #include "QueryEngine/ColumnarResults.h"
 #include "QueryEngine/Descriptors/InputDescriptors.h"
 #include "QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
+#include "QueryEngine/InputMetadata.h"
 #include "QueryEngine/JoinHashTable/HashTable.h"
 #include "QueryEngine/RelAlgExecutionUnit.h"
 #include "QueryEngine/ResultSet.h"
@@ -40,11 +42,10 @@ enum CacheItemType {
   HT_HASHING_SCHEME,          // Hashtable layout
   BASELINE_HT_APPROX_CARD,    // Approximated cardinality for baseline hashtable
   OVERLAPS_AUTO_TUNER_PARAM,  // Hashtable auto tuner's params for overlaps join
-  // TODO (yoonmin): support the following items for recycling
-  // ROW_RS,             Row-wise resultset
-  // COUNTALL_CARD_EST,  Cardinality of query result
-  // NDV_CARD_EST,       # Non-distinct value
-  // FILTER_SEL          Selectivity of (push-downed) filter node
+  ROW_RS,                     // Row-wise resultset
+  COUNTALL_CARD_EST,          // Cardinality of query result
+  NDV_CARD_EST,               // # Non-distinct value
+  FILTER_SEL,                 // Selectivity of (push-downed) filter node
   NUM_CACHE_ITEM_TYPE
 };
 
@@ -113,17 +114,25 @@ using CacheSizeMap = std::unordered_map<DeviceIdentifier, size_t>;
 using CacheMetricInfoMap =
     std::unordered_map<DeviceIdentifier, std::vector<std::shared_ptr<CacheItemMetric>>>;
 
+// the checkpointed epoch of each physical input table when a cached item was computed
+// every write to a table ends with a checkpoint which advances its epoch, and setting a
+// table epoch back clears the caches depending on them (see ExternalCacheInvalidators.h),
+// so a change of these numbers means the table data changed since
+using InputTableEpochs = std::vector<std::pair<int, size_t>>;
+
 class DataRecyclerUtil {
  public:
-  // need to add more constants if necessary: ROW_RS, COUNTALL_CARD_EST, NDV_CARD_EST,
-  // FILTER_SEL, ...
   static constexpr auto cache_item_type_str =
       shared::string_view_array("Perfect Join Hashtable",
                                 "Baseline Join Hashtable",
                                 "Overlaps Join Hashtable",
                                 "Hashing Scheme for Join Hashtable",
                                 "Baseline Join Hashtable's Approximated Cardinality",
-                                "Overlaps Join Hashtable's Auto Tuner's Parameters");
+                                "Overlaps Join Hashtable's Auto Tuner's Parameters",
+                                "Row-wise Resultset",
+                                "Cardinality of Query Result",
+                                "Estimated # Non-distinct Values",
+                                "Selectivity of Filter");
   static std::string_view toStringCacheItemType(CacheItemType item_type) {
     static_assert(cache_item_type_str.size() == NUM_CACHE_ITEM_TYPE);
     return cache_item_type_str[item_type];
@@ -137,6 +146,31 @@ class DataRecyclerUtil {
                ? device_type.append(std::to_string(device_identifier))
                : device_type;
   }
+
+  // returns std::nullopt if any of the input tables is the result of a previous query
+  // step, an in-memory table or a foreign table since their changes have no epochs
+  static std::optional<InputTableEpochs> getInputTableEpochs(
+      const std::vector<InputTableInfo>& table_infos,
+      const Catalog_Namespace::Catalog& catalog) {
+    InputTableEpochs input_table_epochs;
+    for (const auto& table_info : table_infos) {
+      if (table_info.table_id < 0) {
+        return std::nullopt;
+      }
+      const auto td = catalog.getMetadataForTable(table_info.table_id, false);
+      if (!td || table_is_temporary(td) ||
+          td->storageType == StorageType::FOREIGN_TABLE) {
+        return std::nullopt;
+      }
+      for (const auto physical_td : catalog.getPhysicalTablesDescriptors(td, false)) {
+        input_table_epochs.emplace_back(
+            physical_td->tableId,
+            catalog.getDataMgr().getTableEpoch(catalog.getDatabaseId(),
+                                               physical_td->tableId));
+      }
+    }
+    return input_table_epochs;
+  }
 };
 
 // contain information regarding 1) per-cache item metric: perfect ht-1, perfect ht-2,
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "EstimationRecycler.h"
+
+#include <algorithm>
+
+std::optional<size_t> EstimationRecycler::getItemFromCache(
+    QueryPlanHash key,
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    std::optional<EstimationMetaInfo> meta_info) const {
+  if (!g_enable_data_recycler || !g_use_estimator_result_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return std::nullopt;
+  }
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  if (!hasItemInCache(key, item_type, device_identifier, lock, meta_info)) {
+    return std::nullopt;
+  }
+  auto estimation_cache = getCachedItemContainer(item_type, device_identifier);
+  // the container is kept in least recently used order
+  auto itr = std::find_if(estimation_cache->begin(),
+                          estimation_cache->end(),
+                          [key](const auto& item) { return item.key == key; });
+  CHECK(itr != estimation_cache->end());
+  std::rotate(itr, std::next(itr), estimation_cache->end());
+  const auto& candidate_estimation = estimation_cache->back();
+  VLOG(1) << "[" << DataRecyclerUtil::toStringCacheItemType(item_type) << ", "
+          << DataRecyclerUtil::getDeviceIdentifierString(device_identifier)
+          << "] Recycle estimation: " << *candidate_estimation.cached_item;
+  return candidate_estimation.cached_item;
+}
+
+void EstimationRecycler::putItemToCache(QueryPlanHash key,
+                                        std::optional<size_t> item,
+                                        CacheItemType item_type,
+                                        DeviceIdentifier device_identifier,
+                                        size_t item_size,
+                                        size_t compute_time,
+                                        std::optional<EstimationMetaInfo> meta_info) {
+  if (!g_enable_data_recycler || !g_use_estimator_result_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY || !item || !g_max_cached_estimations) {
+    return;
+  }
+  CHECK(meta_info);
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  if (hasItemInCache(key, item_type, device_identifier, lock, meta_info)) {
+    return;
+  }
+  auto estimation_cache = getCachedItemContainer(item_type, device_identifier);
+  if (getCachedItem(key, *estimation_cache)) {
+    // drop the stale estimation computed before its input tables changed
+    removeItemFromCache(key, item_type, device_identifier, lock, meta_info);
+  }
+  if (estimation_cache->size() >= g_max_cached_estimations) {
+    cleanupCacheForInsertion(item_type, device_identifier, 1, lock);
+  }
+  estimation_cache->emplace_back(key, item, nullptr, meta_info);
+  VLOG(1) << "[" << DataRecyclerUtil::toStringCacheItemType(item_type) << ", "
+          << DataRecyclerUtil::getDeviceIdentifierString(device_identifier)
+          << "] Put estimation to cache: " << *item;
+}
+
+void EstimationRecycler::clearCache() {
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  for (auto& item_type : getCacheItemType()) {
+    getCachedItemContainer(item_type, ESTIMATION_CACHE_DEVICE_IDENTIFIER)->clear();
+  }
+}
+
+std::string EstimationRecycler::toString() const {
+  std::ostringstream oss;
+  oss << "Estimation cache:\n";
+  oss << "Device: "
+      << DataRecyclerUtil::getDeviceIdentifierString(ESTIMATION_CACHE_DEVICE_IDENTIFIER)
+      << "\n";
+  for (auto& item_type : getCacheItemType()) {
+    oss << "\t" << DataRecyclerUtil::toStringCacheItemType(item_type) << ":\n";
+    auto estimation_cache_container =
+        getCachedItemContainer(item_type, ESTIMATION_CACHE_DEVICE_IDENTIFIER);
+    for (auto& kv : *estimation_cache_container) {
+      oss << "\t\tkey: " << kv.key << ", estimation: " << *kv.cached_item << "\n";
+    }
+  }
+  return oss.str();
+}
+
+QueryPlanHash EstimationRecycler::getEstimationCacheKey(
+    const RelAlgExecutionUnit& ra_exe_unit) {
+  if (!g_enable_data_recycler || !g_use_estimator_result_cache) {
+    return EMPTY_HASHED_PLAN_DAG_KEY;
+  }
+  auto key = boost::hash_value(ra_exec_unit_desc_for_caching(ra_exe_unit));
+  return key == EMPTY_HASHED_PLAN_DAG_KEY ? key + 1 : key;
+}
+
+std::optional<EstimationMetaInfo> EstimationRecycler::getEstimationMetaInfo(
+    const std::vector<InputTableInfo>& table_infos,
+    const Catalog_Namespace::Catalog& catalog) {
+  auto input_table_epochs = DataRecyclerUtil::getInputTableEpochs(table_infos, catalog);
+  if (!input_table_epochs) {
+    return std::nullopt;
+  }
+  return EstimationMetaInfo{*input_table_epochs};
+}
+
+bool EstimationRecycler::hasItemInCache(
+    QueryPlanHash key,
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    std::lock_guard<std::mutex>& lock,
+    std::optional<EstimationMetaInfo> meta_info) const {
+  if (!g_enable_data_recycler || !g_use_estimator_result_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return false;
+  }
+  auto estimation_cache = getCachedItemContainer(item_type, device_identifier);
+  auto candidate_estimation = getCachedItem(key, *estimation_cache);
+  if (candidate_estimation) {
+    // the cached estimation is stale if any of its input tables changed since
+    CHECK(candidate_estimation->meta_info);
+    CHECK(meta_info);
+    return candidate_estimation->meta_info->input_table_epochs ==
+           meta_info->input_table_epochs;
+  }
+  return false;
+}
+
+void EstimationRecycler::removeItemFromCache(
+    QueryPlanHash key,
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    std::lock_guard<std::mutex>& lock,
+    std::optional<EstimationMetaInfo> meta_info) {
+  auto estimation_container = getCachedItemContainer(item_type, device_identifier);
+  auto filter = [key](auto const& item) { return item.key == key; };
+  auto itr =
+      std::find_if(estimation_container->cbegin(), estimation_container->cend(), filter);
+  if (itr != estimation_container->cend()) {
+    estimation_container->erase(itr);
+  }
+}
+
+void EstimationRecycler::cleanupCacheForInsertion(
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    size_t required_size,
+    std::lock_guard<std::mutex>& lock,
+    std::optional<EstimationMetaInfo> meta_info) {
+  // the least recently used estimations are at the beginning of the container
+  const auto num_cached_items =
+      getCachedItemContainer(item_type, device_identifier)->size();
+  const auto capacity = g_max_cached_estimations > required_size
+                            ? g_max_cached_estimations - required_size
+                            : size_t(0);
+  if (num_cached_items > capacity) {
+    removeCachedItemFromBeginning(
+        item_type, device_identifier, static_cast<int>(num_cached_items - capacity));
+  }
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "DataRecycler.h"
+
+extern bool g_use_estimator_result_cache;
+extern size_t g_max_cached_estimations;
+
+constexpr DeviceIdentifier ESTIMATION_CACHE_DEVICE_IDENTIFIER =
+    DataRecyclerUtil::CPU_DEVICE_IDENTIFIER;
+
+struct EstimationMetaInfo {
+  InputTableEpochs input_table_epochs;
+};
+
+// caches the results of the estimator queries we run before executing a work unit, which
+// only serve as hints for it:
+// NDV_CARD_EST: group by buffer entry guess derived from the NDV estimation, the query is
+// retried with a larger buffer if the guess is too small
+// FILTER_SEL: # rows passing a push-down filter candidate
+// the pre-flight count(*) of a projection (COUNTALL_CARD_EST) is not cached since it sets
+// the size of the output buffer
+// all of them are a single number, so instead of cache metrics every item type keeps at
+// most g_max_cached_estimations entries and evicts the least recently used one
+class EstimationRecycler
+    : public DataRecycler<std::optional<size_t>, EstimationMetaInfo> {
+ public:
+  EstimationRecycler()
+      : DataRecycler({CacheItemType::NDV_CARD_EST, CacheItemType::FILTER_SEL},
+                     std::numeric_limits<size_t>::max(),
+                     std::numeric_limits<size_t>::max(),
+                     0) {}
+
+  std::optional<size_t> getItemFromCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::optional<EstimationMetaInfo> meta_info = std::nullopt) const override;
+
+  void putItemToCache(
+      QueryPlanHash key,
+      std::optional<size_t> item,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      size_t item_size,
+      size_t compute_time,
+      std::optional<EstimationMetaInfo> meta_info = std::nullopt) override;
+
+  // nothing to do with estimation recycler
+  void initCache() override {}
+
+  void clearCache() override;
+
+  std::string toString() const override;
+
+  // returns EMPTY_HASHED_PLAN_DAG_KEY if the estimation of the given work unit
+  // cannot be recycled
+  static QueryPlanHash getEstimationCacheKey(const RelAlgExecutionUnit& ra_exe_unit);
+
+  static std::optional<EstimationMetaInfo> getEstimationMetaInfo(
+      const std::vector<InputTableInfo>& table_infos,
+      const Catalog_Namespace::Catalog& catalog);
+
+ private:
+  bool hasItemInCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<EstimationMetaInfo> meta_info = std::nullopt) const override;
+
+  void removeItemFromCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<EstimationMetaInfo> meta_info = std::nullopt) override;
+
+  // evicts the least recently used estimations until `required_size` more fit
+  void cleanupCacheForInsertion(
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      size_t required_size,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<EstimationMetaInfo> meta_info = std::nullopt) override;
+};
+
+// owns the estimation recycler shared by all executors
+class EstimationRecyclerHolder {
+ public:
+  static EstimationRecycler* getEstimationRecycler() {
+    static EstimationRecycler estimation_recycler;
+    return &estimation_recycler;
+  }
+
+  static auto getCacheInvalidator() -> std::function<void()> {
+    return getEstimationRecycler()->getCacheInvalidator();
+  }
+};
@@ -0,0 +1,224 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ResultSetRecycler.h"
+
+extern bool g_is_test_env;
+
+bool ResultSetRecycler::hasItemInCache(QueryPlanHash key,
+                                       CacheItemType item_type,
+                                       DeviceIdentifier device_identifier,
+                                       std::lock_guard<std::mutex>& lock,
+                                       std::optional<ResultSetMetaInfo> meta_info) const {
+  if (!g_enable_data_recycler || !g_use_query_resultset_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return false;
+  }
+  auto resultset_cache = getCachedItemContainer(item_type, device_identifier);
+  CHECK(resultset_cache);
+  auto candidate_resultset = getCachedItem(key, *resultset_cache);
+  if (candidate_resultset) {
+    // the cached result set is stale if any of its input tables changed since
+    CHECK(candidate_resultset->meta_info);
+    CHECK(meta_info);
+    return candidate_resultset->meta_info->input_table_epochs ==
+           meta_info->input_table_epochs;
+  }
+  return false;
+}
+
+ResultSetPtr ResultSetRecycler::getItemFromCache(
+    QueryPlanHash key,
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    std::optional<ResultSetMetaInfo> meta_info) const {
+  if (!g_enable_data_recycler || !g_use_query_resultset_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  if (!hasItemInCache(key, item_type, device_identifier, lock, meta_info)) {
+    return nullptr;
+  }
+  auto resultset_cache = getCachedItemContainer(item_type, device_identifier);
+  auto candidate_resultset = getCachedItem(key, *resultset_cache);
+  CHECK(candidate_resultset);
+  candidate_resultset->item_metric->incRefCount();
+  VLOG(1) << "[" << DataRecyclerUtil::toStringCacheItemType(item_type) << ", "
+          << DataRecyclerUtil::getDeviceIdentifierString(device_identifier)
+          << "] Recycle item in a cache";
+  return candidate_resultset->cached_item->copy();
+}
+
+void ResultSetRecycler::putItemToCache(QueryPlanHash key,
+                                       ResultSetPtr item_ptr,
+                                       CacheItemType item_type,
+                                       DeviceIdentifier device_identifier,
+                                       size_t item_size,
+                                       size_t compute_time,
+                                       std::optional<ResultSetMetaInfo> meta_info) {
+  if (!g_enable_data_recycler || !g_use_query_resultset_cache ||
+      key == EMPTY_HASHED_PLAN_DAG_KEY) {
+    return;
+  }
+  CHECK(meta_info);
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  if (!hasItemInCache(key, item_type, device_identifier, lock, meta_info)) {
+    auto resultset_cache = getCachedItemContainer(item_type, device_identifier);
+    if (getCachedItem(key, *resultset_cache)) {
+      // drop the stale result set computed before its input tables changed
+      removeItemFromCache(key, item_type, device_identifier, lock, meta_info);
+    }
+    // check cache's space availability
+    auto& metric_tracker = getMetricTracker(item_type);
+    auto cache_status = metric_tracker.canAddItem(device_identifier, item_size);
+    if (cache_status == CacheAvailability::UNAVAILABLE) {
+      // result set is too large
+      return;
+    } else if (cache_status == CacheAvailability::AVAILABLE_AFTER_CLEANUP) {
+      auto required_size = metric_tracker.calculateRequiredSpaceForItemAddition(
+          device_identifier, item_size);
+      cleanupCacheForInsertion(item_type, device_identifier, required_size, lock);
+    }
+    // put result set's metric to metric tracker
+    auto new_cache_metric_ptr = metric_tracker.putNewCacheItemMetric(
+        key, device_identifier, item_size, compute_time);
+    CHECK_EQ(item_size, new_cache_metric_ptr->getMemSize());
+    metric_tracker.updateCurrentCacheSize(
+        device_identifier, CacheUpdateAction::ADD, item_size);
+    // put a copy of the result set to cache, the given one is handed out to the caller
+    VLOG(1) << "[" << DataRecyclerUtil::toStringCacheItemType(item_type) << ", "
+            << DataRecyclerUtil::getDeviceIdentifierString(device_identifier)
+            << "] Put item to cache";
+    resultset_cache->emplace_back(key, item_ptr->copy(), new_cache_metric_ptr, meta_info);
+  }
+  // this result set is already cached
+  return;
+}
+
+void ResultSetRecycler::removeItemFromCache(
+    QueryPlanHash key,
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    std::lock_guard<std::mutex>& lock,
+    std::optional<ResultSetMetaInfo> meta_info) {
+  auto& cache_metrics = getMetricTracker(item_type);
+  // remove cached item from the cache
+  auto cache_metric = cache_metrics.getCacheItemMetric(key, device_identifier);
+  CHECK(cache_metric);
+  auto resultset_size = cache_metric->getMemSize();
+  auto resultset_container = getCachedItemContainer(item_type, device_identifier);
+  auto filter = [key](auto const& item) { return item.key == key; };
+  auto itr =
+      std::find_if(resultset_container->cbegin(), resultset_container->cend(), filter);
+  if (itr == resultset_container->cend()) {
+    return;
+  } else {
+    resultset_container->erase(itr);
+  }
+  // remove cache metric
+  cache_metrics.removeCacheItemMetric(key, device_identifier);
+  // update current cache size
+  cache_metrics.updateCurrentCacheSize(
+      device_identifier, CacheUpdateAction::REMOVE, resultset_size);
+  return;
+}
+
+void ResultSetRecycler::cleanupCacheForInsertion(
+    CacheItemType item_type,
+    DeviceIdentifier device_identifier,
+    size_t required_size,
+    std::lock_guard<std::mutex>& lock,
+    std::optional<ResultSetMetaInfo> meta_info) {
+  // sort the vector based on the importance of the cached items (by # referenced, size
+  // and compute time) and then remove unimportant cached items
+  int elimination_target_offset = 0;
+  size_t removed_size = 0;
+  auto& metric_tracker = getMetricTracker(item_type);
+  auto actual_space_to_free = metric_tracker.getTotalCacheSize() / 2;
+  if (!g_is_test_env && required_size < actual_space_to_free) {
+    // remove enough items to avoid too frequent cache cleanup
+    required_size = actual_space_to_free;
+  }
+  metric_tracker.sortCacheInfoByQueryMetric(device_identifier);
+  auto cached_item_metrics = metric_tracker.getCacheItemMetrics(device_identifier);
+  sortCacheContainerByQueryMetric(item_type, device_identifier);
+
+  // collect targets to eliminate
+  for (auto& metric : cached_item_metrics) {
+    auto target_size = metric->getMemSize();
+    ++elimination_target_offset;
+    removed_size += target_size;
+    if (removed_size > required_size) {
+      break;
+    }
+  }
+
+  // eliminate targets in 1) cache container and 2) their metrics
+  removeCachedItemFromBeginning(item_type, device_identifier, elimination_target_offset);
+  metric_tracker.removeMetricFromBeginning(device_identifier, elimination_target_offset);
+
+  // update the current cache size after this cleanup
+  metric_tracker.updateCurrentCacheSize(
+      device_identifier, CacheUpdateAction::REMOVE, removed_size);
+}
+
+void ResultSetRecycler::clearCache() {
+  std::lock_guard<std::mutex> lock(getCacheLock());
+  for (auto& item_type : getCacheItemType()) {
+    getMetricTracker(item_type).clearCacheMetricTracker();
+    auto item_cache = getItemCache().find(item_type)->second;
+    for (auto& kv : *item_cache) {
+      kv.second->clear();
+    }
+  }
+}
+
+std::string ResultSetRecycler::toString() const {
+  std::ostringstream oss;
+  oss << "A current status of the Resultset Recycler:\n";
+  for (auto& item_type : getCacheItemType()) {
+    oss << "\t" << DataRecyclerUtil::toStringCacheItemType(item_type);
+    auto& metric_tracker = getMetricTracker(item_type);
+    oss << "\n\t# cached resultsets:\n";
+    auto item_cache = getItemCache().find(item_type)->second;
+    for (auto& cache_container : *item_cache) {
+      oss << "\t\tDevice"
+          << DataRecyclerUtil::getDeviceIdentifierString(cache_container.first)
+          << ", # resultsets: " << cache_container.second->size() << "\n";
+      for (auto& rs : *cache_container.second) {
+        oss << "\t\t\tRS] " << rs.item_metric->toString() << "\n";
+      }
+    }
+    oss << "\t" << metric_tracker.toString() << "\n";
+  }
+  return oss.str();
+}
+
+std::optional<ResultSetMetaInfo> ResultSetRecycler::getResultSetMetaInfo(
+    const std::vector<InputTableInfo>& table_infos,
+    const Catalog_Namespace::Catalog& catalog) {
+  auto input_table_epochs = DataRecyclerUtil::getInputTableEpochs(table_infos, catalog);
+  if (!input_table_epochs) {
+    return std::nullopt;
+  }
+  return ResultSetMetaInfo{*input_table_epochs};
+}
+
+bool ResultSetRecycler::isCacheableResultSet(const ResultSet& rows) {
+  return rows.isSelfContained() &&
+         rows.getStorageSizeBytes() <= g_max_cacheable_query_resultset_size_bytes;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "DataRecycler.h"
+
+extern bool g_use_query_resultset_cache;
+extern size_t g_query_resultset_cache_total_bytes;
+extern size_t g_max_cacheable_query_resultset_size_bytes;
+
+struct ResultSetMetaInfo {
+  InputTableEpochs input_table_epochs;
+};
+
+class ResultSetRecycler : public DataRecycler<ResultSetPtr, ResultSetMetaInfo> {
+ public:
+  ResultSetRecycler()
+      : DataRecycler({CacheItemType::ROW_RS},
+                     g_query_resultset_cache_total_bytes,
+                     g_max_cacheable_query_resultset_size_bytes,
+                     0) {}
+
+  // returns a copy of the cached result set, so callers are free to sort, limit and
+  // iterate it
+  ResultSetPtr getItemFromCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::optional<ResultSetMetaInfo> meta_info = std::nullopt) const override;
+
+  // keeps a copy of the given result set
+  void putItemToCache(QueryPlanHash key,
+                      ResultSetPtr item_ptr,
+                      CacheItemType item_type,
+                      DeviceIdentifier device_identifier,
+                      size_t item_size,
+                      size_t compute_time,
+                      std::optional<ResultSetMetaInfo> meta_info = std::nullopt) override;
+
+  // nothing to do with result set recycler
+  void initCache() override {}
+
+  void clearCache() override;
+
+  std::string toString() const override;
+
+  // a work unit's result can be recycled when the work unit only reads physical tables;
+  // results of other query steps (temporary tables) have no epochs to track them by
+  static std::optional<ResultSetMetaInfo> getResultSetMetaInfo(
+      const std::vector<InputTableInfo>& table_infos,
+      const Catalog_Namespace::Catalog& catalog);
+
+  static bool isCacheableResultSet(const ResultSet& rows);
+
+ private:
+  bool hasItemInCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<ResultSetMetaInfo> meta_info = std::nullopt) const override;
+
+  void removeItemFromCache(
+      QueryPlanHash key,
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<ResultSetMetaInfo> meta_info = std::nullopt) override;
+
+  void cleanupCacheForInsertion(
+      CacheItemType item_type,
+      DeviceIdentifier device_identifier,
+      size_t required_size,
+      std::lock_guard<std::mutex>& lock,
+      std::optional<ResultSetMetaInfo> meta_info = std::nullopt) override;
+};
+
+// owns the result set recycler shared by all executors, in the same way the join
+// hashtable classes own their hashtable recyclers
+// the recycler is created on first use so that the cache sizes given on the command line
+// apply to it
+class ResultSetRecyclerHolder {
+ public:
+  static ResultSetRecycler* getResultSetRecycler() {
+    static ResultSetRecycler resultset_recycler;
+    return &resultset_recycler;
+  }
+
+  static auto getCacheInvalidator() -> std::function<void()> {
+    return getResultSetRecycler()->getCacheInvalidator();
+  }
+};
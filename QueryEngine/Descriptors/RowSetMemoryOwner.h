@@ -29,6 +29,7 @@
 #include "DataMgr/Allocators/ArenaAllocator.h"
 #include "DataMgr/DataMgr.h"
 #include "Logger/Logger.h"
+#include "QueryEngine/CountDistinctHashSet.h"
 #include "QueryEngine/StringDictionaryGenerations.h"
 #include "Shared/quantile.h"
 #include "StringDictionary/StringDictionaryProxy.h"
@@ -81,6 +82,11 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
     count_distinct_sets_.push_back(count_distinct_set);
   }
 
+  void addCountDistinctHashSet(CountDistinctHashSet* count_distinct_set) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    count_distinct_hash_sets_.push_back(count_distinct_set);
+  }
+
   void addGroupByBuffer(int64_t* group_by_buffer) {
     std::lock_guard<std::mutex> lock(state_mutex_);
     group_by_buffers_.push_back(group_by_buffer);
@@ -164,6 +170,9 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
     for (auto count_distinct_set : count_distinct_sets_) {
       delete count_distinct_set;
     }
+    for (auto count_distinct_set : count_distinct_hash_sets_) {
+      delete count_distinct_set;
+    }
     for (auto group_by_buffer : group_by_buffers_) {
       free(group_by_buffer);
     }
@@ -180,7 +189,11 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
   }
 
   std::shared_ptr<RowSetMemoryOwner> cloneStrDictDataOnly() {
-    auto rtn = std::make_shared<RowSetMemoryOwner>(arena_block_size_, /*num_kernels=*/1);
+    return cloneStrDictDataOnly(arena_block_size_);
+  }
+
+  std::shared_ptr<RowSetMemoryOwner> cloneStrDictDataOnly(const size_t arena_block_size) {
+    auto rtn = std::make_shared<RowSetMemoryOwner>(arena_block_size, /*num_kernels=*/1);
     rtn->str_dict_proxy_owned_ = str_dict_proxy_owned_;
     rtn->lit_str_dict_proxy_ = lit_str_dict_proxy_;
     return rtn;
@@ -205,6 +218,7 @@ class RowSetMemoryOwner final : public SimpleAllocator, boost::noncopyable {
 
   std::vector<CountDistinctBitmapBuffer> count_distinct_bitmaps_;
   std::vector<std::set<int64_t>*> count_distinct_sets_;
+  std::vector<CountDistinctHashSet*> count_distinct_hash_sets_;
   std::vector<int64_t*> group_by_buffers_;
   std::vector<void*> varlen_buffers_;
   std::list<std::string> strings_;
@@ -30,6 +30,7 @@
 #include <memory>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <thread>
 
@@ -39,6 +40,7 @@
 #include "Parser/ParserNode.h"
 #include "QueryEngine/AggregateUtils.h"
 #include "QueryEngine/AggregatedColRange.h"
+#include "QueryEngine/ChunkPrefetcher.h"
 #include "QueryEngine/CodeGenerator.h"
 #include "QueryEngine/ColumnFetcher.h"
 #include "QueryEngine/Descriptors/QueryCompilationDescriptor.h"
@@ -48,6 +50,7 @@
 #include "QueryEngine/ErrorHandling.h"
 #include "QueryEngine/ExpressionRewrite.h"
 #include "QueryEngine/ExternalCacheInvalidators.h"
+#include "QueryEngine/FragmentSkipping.h"
 #include "QueryEngine/GpuMemUtils.h"
 #include "QueryEngine/InPlaceSort.h"
 #include "QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
@@ -76,6 +79,7 @@
 bool g_enable_watchdog{false};
 bool g_enable_dynamic_watchdog{false};
 bool g_enable_cpu_sub_tasks{false};
+bool g_enable_chunk_prefetch{false};
 size_t g_cpu_sub_task_size{500'000};
 bool g_enable_filter_function{true};
 unsigned g_dynamic_watchdog_time_limit{10000};
@@ -86,7 +90,10 @@ bool g_inf_div_by_zero{false};
 unsigned g_trivial_loop_join_threshold{1000};
 bool g_from_table_reordering{true};
 bool g_inner_join_fragment_skipping{true};
+bool g_enable_fragment_skipping{true};
+bool g_enable_zone_map_row_skipping{true};
 extern bool g_enable_smem_group_by;
+extern bool g_enable_parallel_reduction;
 extern std::unique_ptr<llvm::Module> udf_gpu_module;
 extern std::unique_ptr<llvm::Module> udf_cpu_module;
 bool g_enable_filter_push_down{false};
@@ -99,6 +106,9 @@ bool g_optimize_row_initialization{true};
 bool g_enable_overlaps_hashjoin{true};
 bool g_enable_distance_rangejoin{true};
 bool g_enable_hashjoin_many_to_many{false};
+bool g_enable_partitioned_hash_join_build{false};
+size_t g_partitioned_hash_join_build_min_bytes{size_t(1) << 25};
+bool g_enable_sorted_key_join{false};
 size_t g_overlaps_max_table_size_bytes{1024 * 1024 * 1024};
 double g_overlaps_target_entries_per_bin{1.3};
 bool g_strip_join_covered_quals{false};
@@ -119,6 +129,7 @@ bool g_enable_lazy_fetch{true};
 bool g_enable_runtime_query_interrupt{true};
 bool g_enable_non_kernel_time_query_interrupt{true};
 bool g_use_estimator_result_cache{true};
+size_t g_max_cached_estimations{4096};  // per estimation type
 unsigned g_pending_query_interrupt_freq{1000};
 double g_running_query_interrupt_freq{0.1};
 size_t g_gpu_smem_threshold{
@@ -141,6 +152,9 @@ bool g_enable_data_recycler{true};
 bool g_use_hashtable_cache{true};
 size_t g_hashtable_cache_total_bytes{size_t(1) << 32};
 size_t g_max_cacheable_hashtable_size_bytes{size_t(1) << 31};
+bool g_use_query_resultset_cache{false};
+size_t g_query_resultset_cache_total_bytes{size_t(1) << 32};
+size_t g_max_cacheable_query_resultset_size_bytes{size_t(1) << 31};
 
 size_t g_approx_quantile_buffer{1000};
 size_t g_approx_quantile_centroids{300};
@@ -214,6 +228,7 @@ void Executor::clearMemory(const Data_Namespace::MemoryLevel memory_level) {
         // For now, assume the user wants to purge the hash table cache when they clear
         // CPU memory (currently used in ExecuteTest to lower memory pressure)
         JoinHashTableCacheInvalidator::invalidateCaches();
+        ResultSetCacheInvalidator::invalidateCaches();
       }
       break;
     }
@@ -1017,6 +1032,21 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
           return init + r->getQueryMemDesc().getEntryCount();
         });
     CHECK(total_entry_count);
+    if (result_set::use_partitioned_reduction(
+            first->getQueryMemDesc(), results_per_device.size(), total_entry_count)) {
+      int64_t compilation_queue_time = 0;
+      const auto reduction_code =
+          get_reduction_code(results_per_device, &compilation_queue_time);
+      std::vector<ResultSet*> result_sets;
+      for (const auto& result : results_per_device) {
+        result_sets.push_back(result.first.get());
+      }
+      ResultSetManager rs_manager;
+      rs_manager.reducePartitioned(result_sets, reduction_code, blockSize(), gridSize());
+      reduced_results = rs_manager.getOwnResultSet();
+      reduced_results->addCompilationQueueTime(compilation_queue_time);
+      return reduced_results;
+    }
     auto query_mem_desc = first->getQueryMemDesc();
     query_mem_desc.setEntryCount(total_entry_count);
     reduced_results = std::make_shared<ResultSet>(first->getTargetInfos(),
@@ -1048,9 +1078,19 @@ ResultSetPtr Executor::reduceMultiDeviceResultSets(
   const auto reduction_code =
       get_reduction_code(results_per_device, &compilation_queue_time);
 
-  for (size_t i = 1; i < results_per_device.size(); ++i) {
-    reduced_results->getStorage()->reduce(
-        *(results_per_device[i].first->getStorage()), {}, reduction_code);
+  if (g_enable_parallel_reduction && results_per_device.size() > 2 &&
+      query_mem_desc.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByPerfectHash) {
+    std::vector<const ResultSetStorage*> those;
+    for (size_t i = 1; i < results_per_device.size(); ++i) {
+      those.push_back(results_per_device[i].first->getStorage());
+    }
+    reduced_results->getStorage()->reduceParallel(those, {}, reduction_code);
+  } else {
+    for (size_t i = 1; i < results_per_device.size(); ++i) {
+      reduced_results->getStorage()->reduce(
+          *(results_per_device[i].first->getStorage()), {}, reduction_code);
+    }
   }
   reduced_results->addCompilationQueueTime(compilation_queue_time);
   return reduced_results;
@@ -1879,6 +1919,13 @@ void fill_entries_for_empty_input(std::vector<TargetInfo>& target_infos,
         entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
         continue;
       }
+      if (count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet) {
+        auto count_distinct_set = new CountDistinctHashSet();
+        CHECK(row_set_mem_owner);
+        row_set_mem_owner->addCountDistinctHashSet(count_distinct_set);
+        entry.push_back(reinterpret_cast<int64_t>(count_distinct_set));
+        continue;
+      }
     }
     const bool float_argument_input = takes_float_argument(agg_info);
     if (agg_info.agg_kind == kCOUNT || agg_info.agg_kind == kAPPROX_COUNT_DISTINCT) {
@@ -2291,20 +2338,37 @@ void Executor::launchKernels(SharedKernelContext& shared_context,
 
   VLOG(1) << "Launching " << kernels.size() << " kernels for query on "
           << (device_type == ExecutorDeviceType::CPU ? "CPU"s : "GPU"s) << ".";
+  // Only so many kernels run at a time, the chunks of the others are loaded meanwhile.
+  std::unique_ptr<ChunkPrefetcher> chunk_prefetcher;
+  if (g_enable_chunk_prefetch && kernels.size() > static_cast<size_t>(cpu_threads())) {
+    chunk_prefetcher =
+        std::make_unique<ChunkPrefetcher>(kernels,
+                                          shared_context.getQueryInfos(),
+                                          plan_state_->columns_to_not_fetch_,
+                                          *catalog_);
+  }
   size_t kernel_idx = 1;
   for (auto& kernel : kernels) {
     CHECK(kernel.get());
     tg.run([this,
             &kernel,
             &shared_context,
+            &chunk_prefetcher,
             parent_thread_id = logger::thread_id(),
             crt_kernel_idx = kernel_idx++] {
       DEBUG_TIMER_NEW_THREAD(parent_thread_id);
+      if (chunk_prefetcher) {
+        chunk_prefetcher->kernelStarted(crt_kernel_idx - 1);
+      }
       const size_t thread_i = crt_kernel_idx % cpu_threads();
       kernel->run(this, thread_i, shared_context);
+      if (chunk_prefetcher) {
+        chunk_prefetcher->kernelFinished(crt_kernel_idx - 1);
+      }
     });
   }
   tg.wait();
+  chunk_prefetcher.reset();
 
   for (auto& exec_ctx : shared_context.getTlsExecutionContext()) {
     // The first arg is used for GPU only, it's not our case.
@@ -3604,45 +3668,6 @@ std::tuple<RelAlgExecutionUnit, PlanState::DeletedColumnsMap> Executor::addDelet
   return std::make_tuple(ra_exe_unit_with_deleted, deleted_cols_map);
 }
 
-namespace {
-// Note(Wamsi): `get_hpt_overflow_underflow_safe_scaled_value` will return `true` for safe
-// scaled epoch value and `false` for overflow/underflow values as the first argument of
-// return type.
-std::tuple<bool, int64_t, int64_t> get_hpt_overflow_underflow_safe_scaled_values(
-    const int64_t chunk_min,
-    const int64_t chunk_max,
-    const SQLTypeInfo& lhs_type,
-    const SQLTypeInfo& rhs_type) {
-  const int32_t ldim = lhs_type.get_dimension();
-  const int32_t rdim = rhs_type.get_dimension();
-  CHECK(ldim != rdim);
-  const auto scale = DateTimeUtils::get_timestamp_precision_scale(abs(rdim - ldim));
-  if (ldim > rdim) {
-    // LHS type precision is more than RHS col type. No chance of overflow/underflow.
-    return {true, chunk_min / scale, chunk_max / scale};
-  }
-
-  using checked_int64_t = boost::multiprecision::number<
-      boost::multiprecision::cpp_int_backend<64,
-                                             64,
-                                             boost::multiprecision::signed_magnitude,
-                                             boost::multiprecision::checked,
-                                             void>>;
-
-  try {
-    auto ret =
-        std::make_tuple(true,
-                        int64_t(checked_int64_t(chunk_min) * checked_int64_t(scale)),
-                        int64_t(checked_int64_t(chunk_max) * checked_int64_t(scale)));
-    return ret;
-  } catch (const std::overflow_error& e) {
-    // noop
-  }
-  return std::make_tuple(false, chunk_min, chunk_max);
-}
-
-}  // namespace
-
 bool Executor::isFragmentFullyDeleted(
     const int table_id,
     const Fragmenter_Namespace::FragmentInfo& fragment) {
@@ -3698,124 +3723,168 @@ std::pair<bool, int64_t> Executor::skipFragment(
       // is this possible?
       return {false, -1};
     }
-    const auto lhs = comp_expr->get_left_operand();
-    auto lhs_col = dynamic_cast<const Analyzer::ColumnVar*>(lhs);
-    if (!lhs_col || !lhs_col->get_table_id() || lhs_col->get_rte_idx()) {
-      // See if lhs is a simple cast that was allowed through normalize_simple_predicate
-      auto lhs_uexpr = dynamic_cast<const Analyzer::UOper*>(lhs);
-      if (lhs_uexpr) {
-        CHECK(lhs_uexpr->get_optype() ==
-              kCAST);  // We should have only been passed a cast expression
-        lhs_col = dynamic_cast<const Analyzer::ColumnVar*>(lhs_uexpr->get_operand());
-        if (!lhs_col || !lhs_col->get_table_id() || lhs_col->get_rte_idx()) {
-          continue;
-        }
-      } else {
+    const auto lhs_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(comp_expr->get_left_operand());
+    const auto rhs_const =
+        dynamic_cast<const Analyzer::Constant*>(comp_expr->get_right_operand());
+    if (lhs_col && lhs_col->get_table_id() && !lhs_col->get_rte_idx() && rhs_const &&
+        !fragment.getChunkMetadataMap().count(lhs_col->get_column_id())) {
+      const auto cd =
+          get_column_descriptor(lhs_col->get_column_id(), table_id, *catalog_);
+      if (!cd->isVirtualCol) {
         continue;
       }
+      CHECK(cd->columnName == "rowid");
+      const auto& table_generation = getTableGeneration(table_id);
+      const int64_t start_rowid = table_generation.start_rowid;
+      const int64_t chunk_min = frag_offsets[frag_idx] + start_rowid;
+      const int64_t chunk_max = frag_offsets[frag_idx + 1] - 1 + start_rowid;
+
+      llvm::LLVMContext local_context;
+      CgenState local_cgen_state(local_context);
+      const auto rhs_val =
+          CodeGenerator::codegenIntConst(rhs_const, &local_cgen_state)->getSExtValue();
+
+      switch (comp_expr->get_optype()) {
+        case kGE:
+          if (chunk_max < rhs_val) {
+            return {true, -1};
+          }
+          break;
+        case kGT:
+          if (chunk_max <= rhs_val) {
+            return {true, -1};
+          }
+          break;
+        case kLE:
+          if (chunk_min > rhs_val) {
+            return {true, -1};
+          }
+          break;
+        case kLT:
+          if (chunk_min >= rhs_val) {
+            return {true, -1};
+          }
+          break;
+        case kEQ:
+          if (chunk_min > rhs_val || chunk_max < rhs_val) {
+            return {true, -1};
+          }
+          return {false, rhs_val - start_rowid};
+        default:
+          break;
+      }
+      continue;
     }
-    const auto rhs = comp_expr->get_right_operand();
-    const auto rhs_const = dynamic_cast<const Analyzer::Constant*>(rhs);
-    if (!rhs_const) {
-      // is this possible?
-      return {false, -1};
+    if (g_enable_fragment_skipping &&
+        !fragment_may_pass(simple_qual.get(), fragment, *catalog_)) {
+      return {true, -1};
+    }
+  }
+  return {false, -1};
+}
+
+bool Executor::skipFragmentByQuals(
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& quals) {
+  if (!g_enable_fragment_skipping) {
+    return false;
+  }
+  return std::any_of(quals.begin(), quals.end(), [&](const auto& qual) {
+    return !fragment_may_pass(qual.get(), fragment, *catalog_);
+  });
+}
+
+std::pair<size_t, size_t> Executor::getFragmentRowRange(
+    const Fragmenter_Namespace::FragmentInfo& fragment,
+    const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
+    const size_t num_rows) {
+  size_t begin{0};
+  size_t end{num_rows};
+  for (const auto& simple_qual : simple_quals) {
+    const auto comp_expr =
+        std::dynamic_pointer_cast<const Analyzer::BinOper>(simple_qual);
+    if (!comp_expr) {
+      continue;
     }
-    if (!lhs->get_type_info().is_integer() && !lhs->get_type_info().is_time()) {
+    const auto lhs_col =
+        dynamic_cast<const Analyzer::ColumnVar*>(comp_expr->get_left_operand());
+    const auto rhs_const =
+        dynamic_cast<const Analyzer::Constant*>(comp_expr->get_right_operand());
+    if (!lhs_col || !lhs_col->get_table_id() || lhs_col->get_rte_idx() || !rhs_const) {
       continue;
     }
-    const int col_id = lhs_col->get_column_id();
-    auto chunk_meta_it = fragment.getChunkMetadataMap().find(col_id);
-    int64_t chunk_min{0};
-    int64_t chunk_max{0};
-    bool is_rowid{false};
-    size_t start_rowid{0};
-    if (chunk_meta_it == fragment.getChunkMetadataMap().end()) {
-      auto cd = get_column_descriptor(col_id, table_id, *catalog_);
-      if (cd->isVirtualCol) {
-        CHECK(cd->columnName == "rowid");
-        const auto& table_generation = getTableGeneration(table_id);
-        start_rowid = table_generation.start_rowid;
-        chunk_min = frag_offsets[frag_idx] + start_rowid;
-        chunk_max = frag_offsets[frag_idx + 1] - 1 + start_rowid;
-        is_rowid = true;
-      }
-    } else {
-      const auto& chunk_type = lhs_col->get_type_info();
-      chunk_min = extract_min_stat(chunk_meta_it->second->chunkStats, chunk_type);
-      chunk_max = extract_max_stat(chunk_meta_it->second->chunkStats, chunk_type);
+    const auto& lhs_type = lhs_col->get_type_info();
+    if (!lhs_type.is_integer() && !lhs_type.is_time()) {
+      continue;
     }
-    if (chunk_min > chunk_max) {
-      // invalid metadata range, do not skip fragment
-      return {false, -1};
+    const auto chunk_meta_it =
+        fragment.getChunkMetadataMap().find(lhs_col->get_column_id());
+    if (chunk_meta_it == fragment.getChunkMetadataMap().end() ||
+        !chunk_meta_it->second->zoneMap) {
+      continue;
     }
-    if (lhs->get_type_info().is_timestamp() &&
-        (lhs_col->get_type_info().get_dimension() !=
-         rhs_const->get_type_info().get_dimension()) &&
-        (lhs_col->get_type_info().is_high_precision_timestamp() ||
-         rhs_const->get_type_info().is_high_precision_timestamp())) {
-      // If original timestamp lhs col has different precision,
-      // column metadata holds value in original precision
-      // therefore adjust rhs value to match lhs precision
-
-      // Note(Wamsi): We adjust rhs const value instead of lhs value to not
-      // artificially limit the lhs column range. RHS overflow/underflow is already
-      // been validated in `TimeGM::get_overflow_underflow_safe_epoch`.
-      bool is_valid;
-      std::tie(is_valid, chunk_min, chunk_max) =
-          get_hpt_overflow_underflow_safe_scaled_values(
-              chunk_min, chunk_max, lhs_col->get_type_info(), rhs_const->get_type_info());
-      if (!is_valid) {
-        VLOG(4) << "Overflow/Underflow detecting in fragments skipping logic.\nChunk min "
-                   "value: "
-                << std::to_string(chunk_min)
-                << "\nChunk max value: " << std::to_string(chunk_max)
-                << "\nLHS col precision is: "
-                << std::to_string(lhs_col->get_type_info().get_dimension())
-                << "\nRHS precision is: "
-                << std::to_string(rhs_const->get_type_info().get_dimension()) << ".";
-        return {false, -1};
-      }
+    const auto& zone_map = *chunk_meta_it->second->zoneMap;
+    if (zone_map.num_rows != num_rows) {
+      // The zone map is out of sync with the fragment, e.g. after a concurrent append.
+      continue;
     }
+    // As in skipFragment, the block range is scaled to the precision of the constant.
+    const bool needs_scaling =
+        lhs_type.is_timestamp() &&
+        lhs_type.get_dimension() != rhs_const->get_type_info().get_dimension() &&
+        (lhs_type.is_high_precision_timestamp() ||
+         rhs_const->get_type_info().is_high_precision_timestamp());
+
     llvm::LLVMContext local_context;
     CgenState local_cgen_state(local_context);
-    CodeGenerator code_generator(&local_cgen_state, nullptr);
-
     const auto rhs_val =
         CodeGenerator::codegenIntConst(rhs_const, &local_cgen_state)->getSExtValue();
 
-    switch (comp_expr->get_optype()) {
-      case kGE:
-        if (chunk_max < rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kGT:
-        if (chunk_max <= rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kLE:
-        if (chunk_min > rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kLT:
-        if (chunk_min >= rhs_val) {
-          return {true, -1};
-        }
-        break;
-      case kEQ:
-        if (chunk_min > rhs_val || chunk_max < rhs_val) {
-          return {true, -1};
-        } else if (is_rowid) {
-          return {false, rhs_val - start_rowid};
+    const auto may_match = [&](const ZoneMap::Block& block) {
+      if (!block.hasValues()) {
+        // Comparisons with nulls are never true.
+        return false;
+      }
+      int64_t block_min{block.min};
+      int64_t block_max{block.max};
+      if (needs_scaling) {
+        bool is_valid;
+        std::tie(is_valid, block_min, block_max) =
+            get_hpt_overflow_underflow_safe_scaled_values(
+                block_min, block_max, lhs_type, rhs_const->get_type_info());
+        if (!is_valid) {
+          return true;
         }
-        break;
-      default:
-        break;
+      }
+      switch (comp_expr->get_optype()) {
+        case kGE:
+          return block_max >= rhs_val;
+        case kGT:
+          return block_max > rhs_val;
+        case kLE:
+          return block_min <= rhs_val;
+        case kLT:
+          return block_min < rhs_val;
+        case kEQ:
+          return block_min <= rhs_val && rhs_val <= block_max;
+        default:
+          return true;
+      }
+    };
+    const auto& blocks = zone_map.blocks;
+    size_t first_block{0};
+    while (first_block < blocks.size() && !may_match(blocks[first_block])) {
+      ++first_block;
+    }
+    size_t last_block{blocks.size()};
+    while (last_block > first_block && !may_match(blocks[last_block - 1])) {
+      --last_block;
     }
+    begin = std::max(begin, std::min(first_block * zone_map.block_rows, num_rows));
+    end = std::min(end, last_block * zone_map.block_rows);
   }
-  return {false, -1};
+  return {begin, std::max(begin, end)};
 }
 
 /*
@@ -3857,14 +3926,22 @@ std::pair<bool, int64_t> Executor::skipFragmentInnerJoins(
     // extracting all the conjunctive simple_quals from the quals stored for the inner
     // join
     std::list<std::shared_ptr<Analyzer::Expr>> inner_join_simple_quals;
+    std::list<std::shared_ptr<Analyzer::Expr>> inner_join_other_quals;
     for (auto& qual : inner_join.quals) {
       auto temp_qual = qual_to_conjunctive_form(qual);
       inner_join_simple_quals.insert(inner_join_simple_quals.begin(),
                                      temp_qual.simple_quals.begin(),
                                      temp_qual.simple_quals.end());
+      inner_join_other_quals.insert(inner_join_other_quals.begin(),
+                                    temp_qual.quals.begin(),
+                                    temp_qual.quals.end());
     }
     auto temp_skip_frag = skipFragment(
         table_desc, fragment, inner_join_simple_quals, frag_offsets, frag_idx);
+    if (!temp_skip_frag.first && temp_skip_frag.second == -1 &&
+        skipFragmentByQuals(fragment, inner_join_other_quals)) {
+      temp_skip_frag.first = true;
+    }
     if (temp_skip_frag.second != -1) {
       skip_frag.second = temp_skip_frag.second;
       return skip_frag;
@@ -4260,25 +4337,6 @@ void Executor::enableRuntimeQueryInterrupt(
   }
 }
 
-void Executor::addToCardinalityCache(const std::string& cache_key,
-                                     const size_t cache_value) {
-  if (g_use_estimator_result_cache) {
-    mapd_unique_lock<mapd_shared_mutex> lock(recycler_mutex_);
-    cardinality_cache_[cache_key] = cache_value;
-    VLOG(1) << "Put estimated cardinality to the cache";
-  }
-}
-
-Executor::CachedCardinality Executor::getCachedCardinality(const std::string& cache_key) {
-  mapd_shared_lock<mapd_shared_mutex> lock(recycler_mutex_);
-  if (g_use_estimator_result_cache &&
-      cardinality_cache_.find(cache_key) != cardinality_cache_.end()) {
-    VLOG(1) << "Reuse cached cardinality";
-    return {true, cardinality_cache_[cache_key]};
-  }
-  return {false, -1};
-}
-
 std::vector<QuerySessionStatus> Executor::getQuerySessionInfo(
     const QuerySessionId& query_session,
     mapd_shared_lock<mapd_shared_mutex>& read_lock) {
@@ -4347,4 +4405,3 @@ std::mutex Executor::kernel_mutex_;
 
 QueryPlanDagCache Executor::query_plan_dag_cache_;
 mapd_shared_mutex Executor::recycler_mutex_;
-std::unordered_map<std::string, size_t> Executor::cardinality_cache_;
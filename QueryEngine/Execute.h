@@ -406,6 +406,16 @@ class Executor {
 
   static void clearMemory(const Data_Namespace::MemoryLevel memory_level);
 
+  // Stops the thread compiling optimized CPU code in the background, see
+  // g_enable_background_cpu_compilation. Called on shutdown.
+  static void shutdownBackgroundCompilation();
+
+  // Blocks until the optimized code of the modules submitted so far has been compiled.
+  static void waitForBackgroundCompilation();
+
+  // Number of times an executor picked up optimized code compiled in the background.
+  static size_t getNumBackgroundCodeSwaps();
+
   static size_t getArenaBlockSize();
 
   static void addUdfIrToModule(const std::string& udf_ir_filename, const bool is_cuda_ir);
@@ -903,7 +913,8 @@ class Executor {
       llvm::Function*,
       llvm::Function*,
       const std::unordered_set<llvm::Function*>&,
-      const CompilationOptions&);
+      const CompilationOptions&,
+      const bool allow_background_compilation);
   std::shared_ptr<CompilationContext> optimizeAndCodegenGPU(
       llvm::Function*,
       llvm::Function*,
@@ -949,6 +960,18 @@ class Executor {
       const std::vector<uint64_t>& frag_offsets,
       const size_t frag_idx);
 
+  // Returns true if the chunk metadata of the fragment rules out one of the quals which
+  // aren't simple quals, e.g. IN lists and disjunctions.
+  bool skipFragmentByQuals(const Fragmenter_Namespace::FragmentInfo& fragment,
+                           const std::list<std::shared_ptr<Analyzer::Expr>>& quals);
+
+  // Returns the range of rows of the fragment, as [begin, end), which the zone maps of
+  // its chunks don't rule out for the simple quals.
+  std::pair<size_t, size_t> getFragmentRowRange(
+      const Fragmenter_Namespace::FragmentInfo& fragment,
+      const std::list<std::shared_ptr<Analyzer::Expr>>& simple_quals,
+      const size_t num_rows);
+
   std::pair<bool, int64_t> skipFragmentInnerJoins(
       const InputDescriptor& table_desc,
       const RelAlgExecutionUnit& ra_exe_unit,
@@ -1029,11 +1052,6 @@ class Executor {
   // while performing non-kernel time task
   bool checkNonKernelTimeInterrupted() const;
 
-  // true when we have matched cardinality, and false otherwise
-  using CachedCardinality = std::pair<bool, size_t>;
-  void addToCardinalityCache(const std::string& cache_key, const size_t cache_value);
-  CachedCardinality getCachedCardinality(const std::string& cache_key);
-
   mapd_shared_mutex& getDataRecyclerLock();
   QueryPlanDagCache& getQueryPlanDagCache();
   JoinColumnsInfo getJoinColumnsInfo(const Analyzer::Expr* join_expr,
@@ -1151,7 +1169,6 @@ class Executor {
   static QueryPlanDagCache query_plan_dag_cache_;
   const QueryPlanHash INVALID_QUERY_PLAN_HASH{std::hash<std::string>{}(EMPTY_QUERY_PLAN)};
   static mapd_shared_mutex recycler_mutex_;
-  static std::unordered_map<std::string, size_t> cardinality_cache_;
 
  public:
   static const int32_t ERR_DIV_BY_ZERO{1};
@@ -1183,6 +1200,7 @@ class Executor {
   friend class HashJoin;  // cgen_state_
   friend class OverlapsJoinHashTable;
   friend class RangeJoinHashTable;
+  friend class SortedKeyJoinTable;
   friend class GroupByAndAggregate;
   friend class QueryCompilationDescriptor;
   friend class QueryMemoryDescriptor;
@@ -150,6 +150,10 @@ TableUpdateMetadata Executor::executeUpdate(
                                   ra_exe_unit.simple_quals,
                                   frag_offsets,
                                   fragment_index);
+    if (!skip_frag.first && skip_frag.second == -1 &&
+        skipFragmentByQuals(outer_fragments[fragment_index], ra_exe_unit.quals)) {
+      skip_frag.first = true;
+    }
     if (skip_frag.first) {
       VLOG(2) << "Update/delete skipping fragment with table id: "
               << outer_fragments[fragment_index].physicalTableId
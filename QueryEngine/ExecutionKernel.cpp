@@ -26,6 +26,8 @@
 #include "QueryEngine/ExternalExecutor.h"
 #include "QueryEngine/SerializeToSql.h"
 
+extern bool g_enable_zone_map_row_skipping;
+
 namespace {
 
 bool needs_skip_result(const ResultSetPtr& res) {
@@ -270,6 +272,31 @@ void ExecutionKernel::runImpl(Executor* executor,
   std::unique_ptr<QueryExecutionContext> query_exe_context_owned;
   const bool do_render = render_info_ && render_info_->isPotentialInSituRender();
 
+  // The zone maps of a fragment may rule out the rows at its start and its end, the
+  // kernel then only scans the rows in between. Only the CPU kernel can start at a given
+  // row.
+  uint32_t zone_map_start_rowid{0};
+  if (g_enable_zone_map_row_skipping && chosen_device_type == ExecutorDeviceType::CPU &&
+      rowid_lookup_key < 0 && !ra_exe_unit_.union_all &&
+      ra_exe_unit_.input_descs.size() == 1 && frag_list.size() == 1 &&
+      outer_tab_frag_ids.size() == 1 && fetch_result->num_rows.size() == 1 &&
+      fetch_result->num_rows.front().size() == 1) {
+    const auto& table_info = shared_context.getQueryInfos().front();
+    CHECK_EQ(table_info.table_id, outer_table_id);
+    CHECK_LT(outer_tab_frag_ids.front(), table_info.info.fragments.size());
+    const auto& fragment = table_info.info.fragments[outer_tab_frag_ids.front()];
+    auto& num_rows = fetch_result->num_rows.front().front();
+    const auto [begin, end] = executor->getFragmentRowRange(
+        fragment, ra_exe_unit_.simple_quals, static_cast<size_t>(num_rows));
+    if (begin > 0 || end < static_cast<size_t>(num_rows)) {
+      VLOG(2) << "Zone maps restrict fragment " << outer_tab_frag_ids.front()
+              << " of table " << outer_table_id << " to rows [" << begin << ", " << end
+              << ") out of " << num_rows;
+      zone_map_start_rowid = begin;
+      num_rows = end;
+    }
+  }
+
   int64_t total_num_input_rows{-1};
   if (kernel_dispatch_mode == ExecutorDispatchMode::KernelPerFragment &&
       query_mem_desc.getQueryDescriptionType() == QueryDescriptionType::Projection) {
@@ -301,6 +328,8 @@ void ExecutionKernel::runImpl(Executor* executor,
       start_rowid = rowid_lookup_key -
                     all_frag_row_offsets[frag_list.begin()->fragment_ids.front()];
     }
+  } else {
+    start_rowid = zone_map_start_rowid;
   }
 
 #ifdef HAVE_TBB
@@ -99,6 +99,9 @@ class ExecutionKernel {
            const size_t thread_idx,
            SharedKernelContext& shared_context);
 
+  const FragmentsList& getFragmentsList() const { return frag_list; }
+  const ColumnFetcher& getColumnFetcher() const { return column_fetcher; }
+
   const RelAlgExecutionUnit& ra_exe_unit_;
 
  private:
@@ -25,19 +25,27 @@
  */
 
 // Classes that are involved in needing a cache invalidated
+#include "DataRecycler/EstimationRecycler.h"
+#include "DataRecycler/ResultSetRecycler.h"
 #include "JoinHashTable/BaselineJoinHashTable.h"
 #include "JoinHashTable/OverlapsJoinHashTable.h"
 #include "JoinHashTable/PerfectJoinHashTable.h"
 
-using UpdateTriggeredCacheInvalidator =
-    CacheInvalidator<OverlapsJoinHashTable, BaselineJoinHashTable, PerfectJoinHashTable>;
+using UpdateTriggeredCacheInvalidator = CacheInvalidator<OverlapsJoinHashTable,
+                                                         BaselineJoinHashTable,
+                                                         PerfectJoinHashTable,
+                                                         ResultSetRecyclerHolder,
+                                                         EstimationRecyclerHolder>;
 using DeleteTriggeredCacheInvalidator = UpdateTriggeredCacheInvalidator;
 
-// Note that this is functionally the same as the above two invalidators. The
+// Note that this covers the join hashtable caches of the above two invalidators. The
 // JoinHashTableCacheInvalidator is a generic invalidator used during `clear_cpu` calls.
 // The above cache invalidators are specific invalidators called during update/delete and
 // will likely be extended in the future.
 using JoinHashTableCacheInvalidator =
     CacheInvalidator<OverlapsJoinHashTable, BaselineJoinHashTable, PerfectJoinHashTable>;
 
+// Cached query result sets also live in CPU memory not managed by the Buffer Manager.
+using ResultSetCacheInvalidator = CacheInvalidator<ResultSetRecyclerHolder>;
+
 #endif
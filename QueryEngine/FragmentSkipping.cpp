@@ -0,0 +1,361 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/FragmentSkipping.h"
+
+#include "Catalog/Catalog.h"
+#include "QueryEngine/DateTimeUtils.h"
+#include "QueryEngine/ExpressionRange.h"
+#include "QueryEngine/GroupByAndAggregate.h"
+#include "Shared/SqlTypesLayout.h"
+#include "StringDictionary/StringDictionary.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace {
+
+// Returns the column of the outer table `expr` refers to. Looks through the casts which
+// leave the order of the values of the column as is: between integers, as in
+// BinOper::simple_predicate_has_simple_cast, between timestamps of different precisions,
+// from dates to timestamps and to wider floating point types.
+const Analyzer::ColumnVar* get_outer_column(const Analyzer::Expr* expr) {
+  if (const auto cast_expr = dynamic_cast<const Analyzer::UOper*>(expr)) {
+    if (cast_expr->get_optype() != kCAST) {
+      return nullptr;
+    }
+    const auto& from_ti = cast_expr->get_operand()->get_type_info();
+    const auto& to_ti = cast_expr->get_type_info();
+    const bool is_order_preserving =
+        (from_ti.is_integer() && to_ti.is_integer()) ||
+        (from_ti.is_timestamp() && to_ti.is_timestamp()) ||
+        (from_ti.get_type() == kDATE && to_ti.is_timestamp() &&
+         to_ti.get_dimension() == 0) ||
+        (from_ti.is_fp() && to_ti.is_fp() && from_ti.get_size() <= to_ti.get_size());
+    if (!is_order_preserving) {
+      return nullptr;
+    }
+    expr = cast_expr->get_operand();
+  }
+  const auto col_var = dynamic_cast<const Analyzer::ColumnVar*>(expr);
+  if (!col_var || dynamic_cast<const Analyzer::Var*>(expr) || !col_var->get_table_id() ||
+      col_var->get_rte_idx()) {
+    return nullptr;
+  }
+  return col_var;
+}
+
+// Returns the constant `expr` compares the column `col_var` with. Strings compared with
+// dictionary encoded strings may be casted to the dictionary, see IN subqueries.
+const Analyzer::Constant* get_constant(const Analyzer::Expr* expr,
+                                       const Analyzer::ColumnVar* col_var) {
+  if (col_var->get_type_info().is_dict_encoded_string()) {
+    const auto cast_expr = dynamic_cast<const Analyzer::UOper*>(expr);
+    if (cast_expr && cast_expr->get_optype() == kCAST) {
+      expr = cast_expr->get_operand();
+    }
+  }
+  const auto constant = dynamic_cast<const Analyzer::Constant*>(expr);
+  return constant && !constant->get_is_null() ? constant : nullptr;
+}
+
+const ChunkMetadata* get_chunk_metadata(
+    const Analyzer::ColumnVar* col_var,
+    const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const auto& chunk_metadata_map = fragment.getChunkMetadataMap();
+  const auto chunk_meta_it = chunk_metadata_map.find(col_var->get_column_id());
+  return chunk_meta_it == chunk_metadata_map.end() ? nullptr
+                                                   : chunk_meta_it->second.get();
+}
+
+// Returns the range of the values of the chunk of `col_var`, invalid for unsupported
+// types and chunks without values or metadata.
+ExpressionRange get_chunk_range(const Analyzer::ColumnVar* col_var,
+                                const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const auto chunk_metadata = get_chunk_metadata(col_var, fragment);
+  if (!chunk_metadata) {
+    return ExpressionRange::makeInvalidRange();
+  }
+  const auto& chunk_stats = chunk_metadata->chunkStats;
+  const auto col_ti = get_logical_type_info(col_var->get_type_info());
+  if (col_ti.is_fp()) {
+    const bool is_float = col_ti.get_type() == kFLOAT;
+    const double chunk_min =
+        is_float ? chunk_stats.min.floatval : chunk_stats.min.doubleval;
+    const double chunk_max =
+        is_float ? chunk_stats.max.floatval : chunk_stats.max.doubleval;
+    if (!(chunk_min <= chunk_max)) {
+      return ExpressionRange::makeInvalidRange();
+    }
+    return is_float ? ExpressionRange::makeFloatRange(
+                          chunk_min, chunk_max, chunk_stats.has_nulls)
+                    : ExpressionRange::makeDoubleRange(
+                          chunk_min, chunk_max, chunk_stats.has_nulls);
+  }
+  if (col_ti.is_integer() || col_ti.is_time() || col_ti.is_decimal() ||
+      col_ti.is_dict_encoded_string()) {
+    const auto chunk_min = extract_min_stat(chunk_stats, col_ti);
+    const auto chunk_max = extract_max_stat(chunk_stats, col_ti);
+    if (chunk_min > chunk_max) {
+      return ExpressionRange::makeInvalidRange();
+    }
+    return ExpressionRange::makeIntRange(chunk_min, chunk_max, 0, chunk_stats.has_nulls);
+  }
+  return ExpressionRange::makeInvalidRange();
+}
+
+bool is_empty(const ExpressionRange& range) {
+  switch (range.getType()) {
+    case ExpressionRangeType::Integer:
+      return range.getIntMin() > range.getIntMax();
+    case ExpressionRangeType::Float:
+    case ExpressionRangeType::Double:
+      return range.getFpMin() > range.getFpMax();
+    default:
+      return false;
+  }
+}
+
+bool is_hpt_comparison(const SQLTypeInfo& col_ti, const SQLTypeInfo& const_ti) {
+  return (col_ti.is_timestamp() || const_ti.is_timestamp()) &&
+         col_ti.get_dimension() != const_ti.get_dimension();
+}
+
+// Returns the value stored in the chunks of `col_var` which compares equal to
+// `constant`: the string id for dictionary encoded strings, the scaled value for
+// decimals. Strings which aren't in the dictionary get an invalid id no chunk contains.
+std::optional<int64_t> get_stored_value(const Analyzer::ColumnVar* col_var,
+                                        const Analyzer::Constant* constant,
+                                        const Catalog_Namespace::Catalog& cat) {
+  const auto& col_ti = col_var->get_type_info();
+  const auto& const_ti = constant->get_type_info();
+  const auto& const_val = constant->get_constval();
+  if (col_ti.is_dict_encoded_string()) {
+    if (!const_ti.is_string() || !const_val.stringval || col_ti.get_comp_param() <= 0) {
+      return std::nullopt;
+    }
+    const auto dd = cat.getMetadataForDict(col_ti.get_comp_param());
+    if (!dd || !dd->stringDict) {
+      return std::nullopt;
+    }
+    return dd->stringDict->getIdOfString(*const_val.stringval);
+  }
+  if (col_ti.is_integer() && const_ti.is_integer()) {
+    return get_value_from_datum<int64_t>(const_val, const_ti.get_type());
+  }
+  if (col_ti.is_time() && const_ti.is_time() && !is_hpt_comparison(col_ti, const_ti)) {
+    return get_value_from_datum<int64_t>(const_val, const_ti.get_type());
+  }
+  if (col_ti.is_decimal() && (const_ti.is_decimal() || const_ti.is_integer())) {
+    const int32_t const_scale = const_ti.is_decimal() ? const_ti.get_scale() : 0;
+    if (const_scale > col_ti.get_scale()) {
+      return std::nullopt;
+    }
+    const auto value = get_value_from_datum<int64_t>(
+        const_val, const_ti.is_decimal() ? kDECIMAL : const_ti.get_type());
+    try {
+      return int64_t(checked_int64_t(value) *
+                     checked_int64_t(exp_to_scale(col_ti.get_scale() - const_scale)));
+    } catch (const std::overflow_error&) {
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
+}
+
+// Narrows `range`, the range of the chunk of `col_var`, to the values for which
+// `col_var <op> constant` may hold. Returns false if it can't tell.
+bool apply_comparison(const Analyzer::ColumnVar* col_var,
+                      const SQLOps op,
+                      const Analyzer::Constant* constant,
+                      const Catalog_Namespace::Catalog& cat,
+                      ExpressionRange& range) {
+  const auto& col_ti = col_var->get_type_info();
+  const auto& const_ti = constant->get_type_info();
+  const auto& const_val = constant->get_constval();
+  if (range.getType() == ExpressionRangeType::Float ||
+      range.getType() == ExpressionRangeType::Double) {
+    Datum datum;
+    if (const_ti.is_fp()) {
+      datum.doubleval = get_value_from_datum<double>(const_val, const_ti.get_type());
+    } else if (const_ti.is_integer()) {
+      datum.doubleval = get_value_from_datum<int64_t>(const_val, const_ti.get_type());
+    } else if (const_ti.is_decimal()) {
+      datum.doubleval = static_cast<double>(const_val.bigintval) /
+                        exp_to_scale(const_ti.get_scale());
+    } else {
+      return false;
+    }
+    apply_fp_qual(datum, kDOUBLE, op, range);
+    return true;
+  }
+  CHECK(range.getType() == ExpressionRangeType::Integer);
+  if (col_ti.is_time() && const_ti.is_time() && is_hpt_comparison(col_ti, const_ti)) {
+    // As the constant was already checked for overflows, the range of the chunk is
+    // scaled to its precision rather than the other way around.
+    const auto [is_valid, chunk_min, chunk_max] =
+        get_hpt_overflow_underflow_safe_scaled_values(
+            range.getIntMin(), range.getIntMax(), col_ti, const_ti);
+    if (!is_valid) {
+      VLOG(4) << "Overflow/Underflow detected in fragment skipping logic, chunk min: "
+              << range.getIntMin() << ", chunk max: " << range.getIntMax()
+              << ", column precision: " << col_ti.get_dimension()
+              << ", constant precision: " << const_ti.get_dimension();
+      return false;
+    }
+    range.setIntMin(chunk_min);
+    range.setIntMax(chunk_max);
+    apply_int_qual(const_val, const_ti.get_type(), op, range);
+    return true;
+  }
+  if (col_ti.is_dict_encoded_string() && op != kEQ) {
+    // String ids aren't ordered like the strings.
+    return false;
+  }
+  const auto stored_value = get_stored_value(col_var, constant, cat);
+  if (!stored_value) {
+    return false;
+  }
+  Datum datum;
+  datum.bigintval = *stored_value;
+  apply_int_qual(datum, kBIGINT, op, range);
+  return true;
+}
+
+// Returns false if no row of the fragment can have `col_expr <op> value_expr`.
+bool comparison_may_pass(const Analyzer::Expr* col_expr,
+                         const SQLOps op,
+                         const Analyzer::Expr* value_expr,
+                         const Fragmenter_Namespace::FragmentInfo& fragment,
+                         const Catalog_Namespace::Catalog& cat) {
+  const auto col_var = get_outer_column(col_expr);
+  if (!col_var) {
+    return true;
+  }
+  const auto constant = get_constant(value_expr, col_var);
+  if (!constant) {
+    return true;
+  }
+  auto range = get_chunk_range(col_var, fragment);
+  if (range.getType() != ExpressionRangeType::Invalid &&
+      apply_comparison(col_var, op, constant, cat, range) && is_empty(range)) {
+    return false;
+  }
+  if (op == kEQ && col_var == col_expr) {
+    const auto chunk_metadata = get_chunk_metadata(col_var, fragment);
+    if (chunk_metadata && chunk_metadata->bloomFilter) {
+      const auto stored_value = get_stored_value(col_var, constant, cat);
+      if (stored_value && !chunk_metadata->bloomFilter->mayContain(*stored_value)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// The values of an IN integer set are the ones stored in the chunks already, i.e. string
+// ids for dictionary encoded strings.
+bool in_integer_set_may_pass(const Analyzer::InIntegerSet* in_integer_set,
+                             const Fragmenter_Namespace::FragmentInfo& fragment) {
+  const auto arg = in_integer_set->get_arg();
+  const auto col_var = get_outer_column(arg);
+  if (!col_var || col_var != arg) {
+    return true;
+  }
+  const auto chunk_metadata = get_chunk_metadata(col_var, fragment);
+  if (!chunk_metadata) {
+    return true;
+  }
+  const auto range = get_chunk_range(col_var, fragment);
+  const bool has_range = range.getType() == ExpressionRangeType::Integer;
+  const auto& bloom_filter = chunk_metadata->bloomFilter;
+  if (!has_range && !bloom_filter) {
+    return true;
+  }
+  const auto& value_list = in_integer_set->get_value_list();
+  return std::any_of(value_list.begin(), value_list.end(), [&](const int64_t value) {
+    if (has_range && (value < range.getIntMin() || value > range.getIntMax())) {
+      return false;
+    }
+    return !bloom_filter || bloom_filter->mayContain(value);
+  });
+}
+
+}  // namespace
+
+bool fragment_may_pass(const Analyzer::Expr* qual,
+                       const Fragmenter_Namespace::FragmentInfo& fragment,
+                       const Catalog_Namespace::Catalog& cat) {
+  if (const auto bin_oper = dynamic_cast<const Analyzer::BinOper*>(qual)) {
+    const auto lhs = bin_oper->get_left_operand();
+    const auto rhs = bin_oper->get_right_operand();
+    const auto optype = bin_oper->get_optype();
+    if (optype == kAND) {
+      return fragment_may_pass(lhs, fragment, cat) &&
+             fragment_may_pass(rhs, fragment, cat);
+    }
+    if (optype == kOR) {
+      return fragment_may_pass(lhs, fragment, cat) ||
+             fragment_may_pass(rhs, fragment, cat);
+    }
+    if (!IS_COMPARISON(optype) || optype == kNE || bin_oper->get_qualifier() != kONE) {
+      return true;
+    }
+    if (get_outer_column(lhs)) {
+      return comparison_may_pass(lhs, optype, rhs, fragment, cat);
+    }
+    return comparison_may_pass(rhs, COMMUTE_COMPARISON(optype), lhs, fragment, cat);
+  }
+  if (const auto in_values = dynamic_cast<const Analyzer::InValues*>(qual)) {
+    const auto& value_list = in_values->get_value_list();
+    return std::any_of(value_list.begin(), value_list.end(), [&](const auto& value) {
+      return comparison_may_pass(in_values->get_arg(), kEQ, value.get(), fragment, cat);
+    });
+  }
+  if (const auto in_integer_set = dynamic_cast<const Analyzer::InIntegerSet*>(qual)) {
+    return in_integer_set_may_pass(in_integer_set, fragment);
+  }
+  return true;
+}
+
+// Note(Wamsi): `get_hpt_overflow_underflow_safe_scaled_value` will return `true` for safe
+// scaled epoch value and `false` for overflow/underflow values as the first argument of
+// return type.
+std::tuple<bool, int64_t, int64_t> get_hpt_overflow_underflow_safe_scaled_values(
+    const int64_t chunk_min,
+    const int64_t chunk_max,
+    const SQLTypeInfo& lhs_type,
+    const SQLTypeInfo& rhs_type) {
+  const int32_t ldim = lhs_type.get_dimension();
+  const int32_t rdim = rhs_type.get_dimension();
+  CHECK(ldim != rdim);
+  const auto scale = DateTimeUtils::get_timestamp_precision_scale(abs(rdim - ldim));
+  if (ldim > rdim) {
+    // LHS type precision is more than RHS col type. No chance of overflow/underflow.
+    return {true, chunk_min / scale, chunk_max / scale};
+  }
+
+  try {
+    auto ret =
+        std::make_tuple(true,
+                        int64_t(checked_int64_t(chunk_min) * checked_int64_t(scale)),
+                        int64_t(checked_int64_t(chunk_max) * checked_int64_t(scale)));
+    return ret;
+  } catch (const std::overflow_error& e) {
+    // noop
+  }
+  return std::make_tuple(false, chunk_min, chunk_max);
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    FragmentSkipping.h
+ * @brief   Decides from the chunk metadata of a fragment whether any of its rows can pass
+ * a filter, which lets the executor skip the fragments which can't.
+ *
+ * The values a qual lets through for a column are narrowed down to an ExpressionRange,
+ * as for the simple quals of getExpressionRange, and intersected with the range of the
+ * chunk of the column. Equalities are also checked against the Bloom filter of the
+ * chunk. Dictionary encoded strings are handled as their string ids, for equalities only.
+ */
+
+#pragma once
+
+#include "Analyzer/Analyzer.h"
+#include "Fragmenter/Fragmenter.h"
+
+#include <tuple>
+
+namespace Catalog_Namespace {
+class Catalog;
+}
+
+/**
+ * Returns false if no row of the fragment can pass `qual`. Handles comparisons of the
+ * columns of the outer table with constants, IN lists and AND / OR trees of those, any
+ * other qual may pass.
+ */
+bool fragment_may_pass(const Analyzer::Expr* qual,
+                       const Fragmenter_Namespace::FragmentInfo& fragment,
+                       const Catalog_Namespace::Catalog& cat);
+
+/**
+ * Scales the min and max of a chunk of timestamps to the precision of `rhs_type`. The
+ * first value is false if that overflows.
+ */
+std::tuple<bool, int64_t, int64_t> get_hpt_overflow_underflow_safe_scaled_values(
+    const int64_t chunk_min,
+    const int64_t chunk_max,
+    const SQLTypeInfo& lhs_type,
+    const SQLTypeInfo& rhs_type);
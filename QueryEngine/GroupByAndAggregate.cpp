@@ -19,6 +19,7 @@
 
 #include "CardinalityEstimator.h"
 #include "CodeGenerator.h"
+#include "CountDistinctHashSet.h"
 #include "Descriptors/QueryMemoryDescriptor.h"
 #include "ExpressionRange.h"
 #include "ExpressionRewrite.h"
@@ -50,6 +51,7 @@
 
 bool g_cluster{false};
 bool g_bigint_count{false};
+bool g_enable_count_distinct_hash_set{true};
 int g_hll_precision_bits{11};
 size_t g_watchdog_baseline_max_groups{120000000};
 extern size_t g_leaf_count;
@@ -634,6 +636,11 @@ CountDistinctDescriptors init_count_distinct_descriptors(
           count_distinct_impl_type == CountDistinctImplType::StdSet) {
         throw WatchdogException("Cannot use a fast path for COUNT distinct");
       }
+      if (g_enable_count_distinct_hash_set &&
+          count_distinct_impl_type == CountDistinctImplType::StdSet &&
+          (arg_ti.is_array() || !arg_ti.is_buffer())) {
+        count_distinct_impl_type = CountDistinctImplType::HashSet;
+      }
       const auto sub_bitmap_count =
           get_count_distinct_sub_bitmap_count(bitmap_sz_bits, ra_exe_unit, device_type);
       count_distinct_descriptors.emplace_back(
@@ -1614,6 +1621,20 @@ extern "C" RUNTIME_EXPORT void agg_count_distinct_skip_val(int64_t* agg,
   }
 }
 
+extern "C" RUNTIME_EXPORT void agg_count_distinct_hash_set(int64_t* agg,
+                                                           const int64_t val) {
+  reinterpret_cast<CountDistinctHashSet*>(*agg)->insert(val);
+}
+
+extern "C" RUNTIME_EXPORT void agg_count_distinct_hash_set_skip_val(
+    int64_t* agg,
+    const int64_t val,
+    const int64_t skip_val) {
+  if (val != skip_val) {
+    agg_count_distinct_hash_set(agg, val);
+  }
+}
+
 extern "C" RUNTIME_EXPORT void agg_approx_quantile(int64_t* agg, const double val) {
   auto* t_digest = reinterpret_cast<quantile::TDigest*>(*agg);
   t_digest->allocate();
@@ -1655,6 +1676,8 @@ void GroupByAndAggregate::codegenCountDistinct(
   if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::Bitmap) {
     agg_fname += "_bitmap";
     agg_args.push_back(LL_INT(static_cast<int64_t>(count_distinct_descriptor.min_val)));
+  } else if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet) {
+    agg_fname += "_hash_set";
   }
   if (agg_info.skip_null_val) {
     auto null_lv = executor_->cgen_state_->castToTypeIn(
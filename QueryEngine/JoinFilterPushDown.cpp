@@ -15,8 +15,10 @@
  */
 
 #include "JoinFilterPushDown.h"
+#include "DataRecycler/EstimationRecycler.h"
 #include "DeepCopyVisitor.h"
 #include "RelAlgExecutor.h"
+#include "Shared/measure.h"
 
 namespace {
 
@@ -98,6 +100,24 @@ FilterSelectivity RelAlgExecutor::getFilterSelectivity(
   const auto table_infos = get_table_infos(input_descs, executor_);
   CHECK_EQ(size_t(1), table_infos.size());
   const size_t total_rows_upper_bound = table_infos.front().info.getNumTuplesUpperBound();
+  const auto rows_total = std::max(total_rows_upper_bound, size_t(1));
+  // the # passing rows is recycled, the selectivity follows the current table size
+  auto estimation_recycler = EstimationRecyclerHolder::getEstimationRecycler();
+  const auto estimation_meta_info =
+      EstimationRecycler::getEstimationMetaInfo(table_infos, cat_);
+  const auto estimation_cache_key =
+      estimation_meta_info ? EstimationRecycler::getEstimationCacheKey(ra_exe_unit)
+                           : EMPTY_HASHED_PLAN_DAG_KEY;
+  if (const auto cached_rows_passing =
+          estimation_recycler->getItemFromCache(estimation_cache_key,
+                                                CacheItemType::FILTER_SEL,
+                                                ESTIMATION_CACHE_DEVICE_IDENTIFIER,
+                                                estimation_meta_info)) {
+    return {true,
+            static_cast<float>(*cached_rows_passing) / rows_total,
+            total_rows_upper_bound};
+  }
+  auto filter_clock_begin = timer_start();
   try {
     ColumnCacheMap column_cache;
     filtered_result = executor_->executeWorkUnit(
@@ -114,7 +134,13 @@ FilterSelectivity RelAlgExecutor::getFilterSelectivity(
   const auto count_ptr = boost::get<int64_t>(count_scalar_tv);
   CHECK(count_ptr);
   const auto rows_passing = *count_ptr;
-  const auto rows_total = std::max(total_rows_upper_bound, size_t(1));
+  estimation_recycler->putItemToCache(estimation_cache_key,
+                                      static_cast<size_t>(rows_passing),
+                                      CacheItemType::FILTER_SEL,
+                                      ESTIMATION_CACHE_DEVICE_IDENTIFIER,
+                                      sizeof(size_t),
+                                      timer_stop(filter_clock_begin),
+                                      estimation_meta_info);
   return {true, static_cast<float>(rows_passing) / rows_total, total_rows_upper_bound};
 }
 
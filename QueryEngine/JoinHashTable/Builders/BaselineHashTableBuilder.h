@@ -23,6 +23,12 @@
 #include "QueryEngine/JoinHashTable/Runtime/JoinHashTableGpuUtils.h"
 #include "Shared/thread_count.h"
 
+#include <algorithm>
+#include <atomic>
+
+extern bool g_enable_partitioned_hash_join_build;
+extern size_t g_partitioned_hash_join_build_min_bytes;
+
 template <typename SIZE,
           class KEY_HANDLER,
           typename std::enable_if<sizeof(SIZE) == 4, SIZE>::type* = nullptr>
@@ -344,58 +350,89 @@ class BaselineJoinHashTableBuilder {
     for (auto& child : init_cpu_buff_threads) {
       child.get();
     }
-    std::vector<std::future<int>> fill_cpu_buff_threads;
-    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
-      fill_cpu_buff_threads.emplace_back(std::async(
-          std::launch::async,
-          [key_handler,
-           keyspace_entry_count,
-           &join_columns,
-           key_component_count,
-           key_component_width,
-           layout,
-           thread_idx,
-           cpu_hash_table_ptr,
-           thread_count,
-           for_semi_join] {
-            switch (key_component_width) {
-              case 4: {
-                return fill_baseline_hash_join_buff<int32_t>(cpu_hash_table_ptr,
-                                                             keyspace_entry_count,
-                                                             -1,
-                                                             for_semi_join,
-                                                             key_component_count,
-                                                             layout == HashType::OneToOne,
-                                                             key_handler,
-                                                             join_columns[0].num_elems,
-                                                             thread_idx,
-                                                             thread_count);
-                break;
-              }
-              case 8: {
-                return fill_baseline_hash_join_buff<int64_t>(cpu_hash_table_ptr,
-                                                             keyspace_entry_count,
-                                                             -1,
-                                                             for_semi_join,
-                                                             key_component_count,
-                                                             layout == HashType::OneToOne,
-                                                             key_handler,
-                                                             join_columns[0].num_elems,
-                                                             thread_idx,
-                                                             thread_count);
-                break;
-              }
-              default:
-                CHECK(false);
-            }
-            return -1;
-          }));
-    }
     int err = 0;
-    for (auto& child : fill_cpu_buff_threads) {
-      int partial_err = child.get();
-      if (partial_err) {
-        err = partial_err;
+    bool filled_by_partitions{false};
+    if constexpr (std::is_same_v<KEY_HANDLER, GenericKeyHandler>) {
+      if (usePartitionedBuildOnCpu(composite_key_info,
+                                   keyspace_entry_count * entry_size)) {
+        switch (key_component_width) {
+          case 4:
+            err = fillHashTablePartitionedOnCpu<int32_t>(key_handler,
+                                                         keyspace_entry_count,
+                                                         for_semi_join,
+                                                         layout == HashType::OneToOne,
+                                                         key_component_count,
+                                                         entry_size);
+            break;
+          case 8:
+            err = fillHashTablePartitionedOnCpu<int64_t>(key_handler,
+                                                         keyspace_entry_count,
+                                                         for_semi_join,
+                                                         layout == HashType::OneToOne,
+                                                         key_component_count,
+                                                         entry_size);
+            break;
+          default:
+            CHECK(false);
+        }
+        filled_by_partitions = true;
+      }
+    }
+    if (!filled_by_partitions) {
+      std::vector<std::future<int>> fill_cpu_buff_threads;
+      for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+        fill_cpu_buff_threads.emplace_back(std::async(
+            std::launch::async,
+            [key_handler,
+             keyspace_entry_count,
+             &join_columns,
+             key_component_count,
+             key_component_width,
+             layout,
+             thread_idx,
+             cpu_hash_table_ptr,
+             thread_count,
+             for_semi_join] {
+              switch (key_component_width) {
+                case 4: {
+                  return fill_baseline_hash_join_buff<int32_t>(
+                      cpu_hash_table_ptr,
+                      keyspace_entry_count,
+                      -1,
+                      for_semi_join,
+                      key_component_count,
+                      layout == HashType::OneToOne,
+                      key_handler,
+                      join_columns[0].num_elems,
+                      thread_idx,
+                      thread_count);
+                  break;
+                }
+                case 8: {
+                  return fill_baseline_hash_join_buff<int64_t>(
+                      cpu_hash_table_ptr,
+                      keyspace_entry_count,
+                      -1,
+                      for_semi_join,
+                      key_component_count,
+                      layout == HashType::OneToOne,
+                      key_handler,
+                      join_columns[0].num_elems,
+                      thread_idx,
+                      thread_count);
+                  break;
+                }
+                default:
+                  CHECK(false);
+              }
+              return -1;
+            }));
+      }
+      for (auto& child : fill_cpu_buff_threads) {
+        int partial_err = child.get();
+        if (partial_err) {
+          err = partial_err;
+        }
       }
     }
     if (err) {
@@ -638,6 +675,168 @@ class BaselineJoinHashTableBuilder {
   HashType getHashLayout() const { return layout_; }
 
  private:
+  // Large tables are filled one cache sized range of slots at a time. Translating string
+  // keys is too expensive to run for every row twice, so those keep the plain build.
+  bool usePartitionedBuildOnCpu(const CompositeKeyInfo& composite_key_info,
+                                const size_t hash_table_bytes) const {
+    if (!g_enable_partitioned_hash_join_build ||
+        hash_table_bytes < g_partitioned_hash_join_build_min_bytes) {
+      return false;
+    }
+    return std::all_of(composite_key_info.sd_inner_proxy_per_key.begin(),
+                       composite_key_info.sd_inner_proxy_per_key.end(),
+                       [](const void* sd_inner_proxy) { return !sd_inner_proxy; });
+  }
+
+  // Groups the rows by the range of slots their key hashes to, in a histogram and a
+  // scatter pass over the join columns, then fills the ranges in parallel. Each range is
+  // filled by one thread and its slots stay in the cache while it's being filled.
+  template <typename T>
+  int fillHashTablePartitionedOnCpu(const GenericKeyHandler* key_handler,
+                                    const size_t keyspace_entry_count,
+                                    const bool for_semi_join,
+                                    const bool with_val_slot,
+                                    const size_t key_component_count,
+                                    const size_t entry_size) {
+    auto timer = DEBUG_TIMER(__func__);
+    const auto cpu_hash_table_ptr = hash_table_->getCpuBuffer();
+    const int thread_count = cpu_threads();
+    const size_t partition_entry_count =
+        std::max(std::max(partitioned_build_cache_bytes_ / entry_size, size_t(1)),
+                 (keyspace_entry_count + max_build_partitions_ - 1) /
+                     max_build_partitions_);
+    const size_t partition_count =
+        (keyspace_entry_count + partition_entry_count - 1) / partition_entry_count;
+    VLOG(1) << "Filling CPU Join Hash Table in " << partition_count << " partitions of "
+            << partition_entry_count << " hash entries";
+
+    std::vector<std::vector<int64_t>> partition_offsets_per_thread(
+        thread_count, std::vector<int64_t>(partition_count, 0));
+    std::vector<std::future<void>> count_threads;
+    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      count_threads.emplace_back(std::async(std::launch::async, [&, thread_idx] {
+        if constexpr (sizeof(T) == 4) {
+          count_baseline_hash_join_partitions_32(
+              partition_offsets_per_thread[thread_idx].data(),
+              keyspace_entry_count,
+              partition_entry_count,
+              key_component_count,
+              key_handler,
+              thread_idx,
+              thread_count);
+        } else {
+          count_baseline_hash_join_partitions_64(
+              partition_offsets_per_thread[thread_idx].data(),
+              keyspace_entry_count,
+              partition_entry_count,
+              key_component_count,
+              key_handler,
+              thread_idx,
+              thread_count);
+        }
+      }));
+    }
+    for (auto& child : count_threads) {
+      child.get();
+    }
+
+    // Turn the counts into the offsets each thread writes its rows of a partition at,
+    // the rows of a partition are contiguous.
+    std::vector<int64_t> partition_offsets(partition_count + 1, 0);
+    int64_t row_count{0};
+    for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+      partition_offsets[partition_idx] = row_count;
+      for (auto& thread_partition_offsets : partition_offsets_per_thread) {
+        const auto thread_row_count = thread_partition_offsets[partition_idx];
+        thread_partition_offsets[partition_idx] = row_count;
+        row_count += thread_row_count;
+      }
+    }
+    partition_offsets[partition_count] = row_count;
+
+    const size_t row_size = key_component_count + 1;
+    std::vector<T> partitioned_rows(row_count * row_size);
+    std::vector<std::future<void>> scatter_threads;
+    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      scatter_threads.emplace_back(std::async(std::launch::async, [&, thread_idx] {
+        if constexpr (sizeof(T) == 4) {
+          scatter_baseline_hash_join_partitions_32(
+              partitioned_rows.data(),
+              partition_offsets_per_thread[thread_idx].data(),
+              keyspace_entry_count,
+              partition_entry_count,
+              key_component_count,
+              key_handler,
+              thread_idx,
+              thread_count);
+        } else {
+          scatter_baseline_hash_join_partitions_64(
+              partitioned_rows.data(),
+              partition_offsets_per_thread[thread_idx].data(),
+              keyspace_entry_count,
+              partition_entry_count,
+              key_component_count,
+              key_handler,
+              thread_idx,
+              thread_count);
+        }
+      }));
+    }
+    for (auto& child : scatter_threads) {
+      child.get();
+    }
+
+    // Rows probing past the end of their range land in the next one, which may be filled
+    // at the same time; writing a slot is atomic, as in the unpartitioned build.
+    std::atomic<size_t> next_partition_idx{0};
+    std::atomic<int> err{0};
+    std::vector<std::future<void>> fill_threads;
+    for (int thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+      fill_threads.emplace_back(std::async(std::launch::async, [&] {
+        for (auto partition_idx = next_partition_idx++;
+             partition_idx < partition_count && !err;
+             partition_idx = next_partition_idx++) {
+          const auto partition_rows =
+              partitioned_rows.data() + partition_offsets[partition_idx] * row_size;
+          const auto partition_row_count =
+              partition_offsets[partition_idx + 1] - partition_offsets[partition_idx];
+          int partition_err{0};
+          if constexpr (sizeof(T) == 4) {
+            partition_err = fill_baseline_hash_join_buff_from_partition_32(
+                cpu_hash_table_ptr,
+                keyspace_entry_count,
+                -1,
+                for_semi_join,
+                key_component_count,
+                with_val_slot,
+                partition_rows,
+                partition_row_count);
+          } else {
+            partition_err = fill_baseline_hash_join_buff_from_partition_64(
+                cpu_hash_table_ptr,
+                keyspace_entry_count,
+                -1,
+                for_semi_join,
+                key_component_count,
+                with_val_slot,
+                partition_rows,
+                partition_row_count);
+          }
+          if (partition_err) {
+            err = partition_err;
+          }
+        }
+      }));
+    }
+    for (auto& child : fill_threads) {
+      child.get();
+    }
+    return err;
+  }
+
+  static constexpr size_t partitioned_build_cache_bytes_ = 256 * 1024;
+  static constexpr size_t max_build_partitions_ = 65536;
+
   std::unique_ptr<BaselineHashTable> hash_table_;
   HashType layout_;
 };
@@ -22,11 +22,13 @@
 #include "QueryEngine/JoinHashTable/BaselineJoinHashTable.h"
 #include "QueryEngine/JoinHashTable/OverlapsJoinHashTable.h"
 #include "QueryEngine/JoinHashTable/PerfectJoinHashTable.h"
+#include "QueryEngine/JoinHashTable/SortedKeyJoinTable.h"
 #include "QueryEngine/RangeTableIndexVisitor.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryEngine/ScalarExprVisitor.h"
 
 extern bool g_enable_overlaps_hashjoin;
+extern bool g_enable_sorted_key_join;
 
 void ColumnsForDevice::setBucketInfo(
     const std::vector<double>& inverse_bucket_sizes_for_dimension,
@@ -293,21 +295,35 @@ std::shared_ptr<HashJoin> HashJoin::getInstance(
                                                           hashtable_build_dag_map,
                                                           table_id_to_node_map);
     } catch (TooManyHashEntries&) {
-      const auto join_quals = coalesce_singleton_equi_join(qual_bin_oper);
-      CHECK_EQ(join_quals.size(), size_t(1));
-      const auto join_qual =
-          std::dynamic_pointer_cast<Analyzer::BinOper>(join_quals.front());
-      VLOG(1) << "Trying to build keyed hash table after perfect hash table:";
-      join_hash_table = BaselineJoinHashTable::getInstance(join_qual,
-                                                           query_infos,
-                                                           memory_level,
-                                                           join_type,
-                                                           preferred_hash_type,
-                                                           device_count,
-                                                           column_cache,
-                                                           executor,
-                                                           hashtable_build_dag_map,
-                                                           table_id_to_node_map);
+      if (g_enable_sorted_key_join &&
+          SortedKeyJoinTable::isSupported(
+              qual_bin_oper.get(), memory_level, join_type, executor)) {
+        // The size of a sorted key table doesn't depend on the range of the keys.
+        VLOG(1) << "Trying to build sorted key table after perfect hash table:";
+        join_hash_table = SortedKeyJoinTable::getInstance(qual_bin_oper,
+                                                          query_infos,
+                                                          memory_level,
+                                                          join_type,
+                                                          device_count,
+                                                          column_cache,
+                                                          executor);
+      } else {
+        const auto join_quals = coalesce_singleton_equi_join(qual_bin_oper);
+        CHECK_EQ(join_quals.size(), size_t(1));
+        const auto join_qual =
+            std::dynamic_pointer_cast<Analyzer::BinOper>(join_quals.front());
+        VLOG(1) << "Trying to build keyed hash table after perfect hash table:";
+        join_hash_table = BaselineJoinHashTable::getInstance(join_qual,
+                                                             query_infos,
+                                                             memory_level,
+                                                             join_type,
+                                                             preferred_hash_type,
+                                                             device_count,
+                                                             column_cache,
+                                                             executor,
+                                                             hashtable_build_dag_map,
+                                                             table_id_to_node_map);
+      }
     }
   }
   CHECK(join_hash_table);
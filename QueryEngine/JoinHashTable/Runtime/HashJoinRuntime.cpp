@@ -1932,6 +1932,221 @@ int range_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                                cpu_thread_count);
 }
 
+// The partitioned build of a baseline hash table splits the table into ranges of
+// partition_entry_count slots. The rows of the build side are first grouped by the range
+// their key hashes to, then every range is filled on its own, so the slots being written
+// stay in the cache. Rows are stored as their key followed by their index.
+
+template <typename T>
+void count_baseline_hash_join_partitions(int64_t* partition_counts,
+                                         const int64_t entry_count,
+                                         const int64_t partition_entry_count,
+                                         const size_t key_component_count,
+                                         const GenericKeyHandler* key_handler,
+                                         const int32_t cpu_thread_idx,
+                                         const int32_t cpu_thread_count) {
+  T key_scratch_buff[g_maximum_conditions_to_coalesce];
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  auto key_buff_handler = [partition_counts,
+                           entry_count,
+                           partition_entry_count,
+                           key_size_in_bytes](const int64_t entry_idx,
+                                              const T* key_scratch_buffer,
+                                              const size_t key_component_count) {
+    const uint32_t h =
+        MurmurHash1Impl(key_scratch_buffer, key_size_in_bytes, 0) % entry_count;
+    ++partition_counts[h / partition_entry_count];
+    return 0;
+  };
+
+  JoinColumnTuple cols(key_handler->get_number_of_columns(),
+                       key_handler->get_join_columns(),
+                       key_handler->get_join_column_type_infos());
+  for (auto& it : cols.slice(cpu_thread_idx, cpu_thread_count)) {
+    (*key_handler)(it.join_column_iterators, key_scratch_buff, key_buff_handler);
+  }
+}
+
+template <typename T>
+void scatter_baseline_hash_join_partitions(T* partitioned_rows,
+                                           int64_t* partition_offsets,
+                                           const int64_t entry_count,
+                                           const int64_t partition_entry_count,
+                                           const size_t key_component_count,
+                                           const GenericKeyHandler* key_handler,
+                                           const int32_t cpu_thread_idx,
+                                           const int32_t cpu_thread_count) {
+  T key_scratch_buff[g_maximum_conditions_to_coalesce];
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  auto key_buff_handler = [partitioned_rows,
+                           partition_offsets,
+                           entry_count,
+                           partition_entry_count,
+                           key_size_in_bytes](const int64_t entry_idx,
+                                              const T* key_scratch_buffer,
+                                              const size_t key_component_count) {
+    const uint32_t h =
+        MurmurHash1Impl(key_scratch_buffer, key_size_in_bytes, 0) % entry_count;
+    auto row_ptr = partitioned_rows + partition_offsets[h / partition_entry_count]++ *
+                                          (key_component_count + 1);
+    memcpy(row_ptr, key_scratch_buffer, key_size_in_bytes);
+    row_ptr[key_component_count] = entry_idx;
+    return 0;
+  };
+
+  JoinColumnTuple cols(key_handler->get_number_of_columns(),
+                       key_handler->get_join_columns(),
+                       key_handler->get_join_column_type_infos());
+  for (auto& it : cols.slice(cpu_thread_idx, cpu_thread_count)) {
+    (*key_handler)(it.join_column_iterators, key_scratch_buff, key_buff_handler);
+  }
+}
+
+template <typename T>
+int fill_baseline_hash_join_buff_from_partition(int8_t* hash_buff,
+                                                const int64_t entry_count,
+                                                const int32_t invalid_slot_val,
+                                                const bool for_semi_join,
+                                                const size_t key_component_count,
+                                                const bool with_val_slot,
+                                                const T* partition_rows,
+                                                const int64_t partition_row_count) {
+  const size_t key_size_in_bytes = key_component_count * sizeof(T);
+  const size_t hash_entry_size =
+      (key_component_count + (with_val_slot ? 1 : 0)) * sizeof(T);
+  for (int64_t i = 0; i < partition_row_count; ++i) {
+    const auto row_ptr = partition_rows + i * (key_component_count + 1);
+    const auto entry_idx = static_cast<int32_t>(row_ptr[key_component_count]);
+    const auto err = for_semi_join
+                         ? write_baseline_hash_slot_for_semi_join<T>(entry_idx,
+                                                                     hash_buff,
+                                                                     entry_count,
+                                                                     row_ptr,
+                                                                     key_component_count,
+                                                                     with_val_slot,
+                                                                     invalid_slot_val,
+                                                                     key_size_in_bytes,
+                                                                     hash_entry_size)
+                         : write_baseline_hash_slot<T>(entry_idx,
+                                                       hash_buff,
+                                                       entry_count,
+                                                       row_ptr,
+                                                       key_component_count,
+                                                       with_val_slot,
+                                                       invalid_slot_val,
+                                                       key_size_in_bytes,
+                                                       hash_entry_size);
+    if (err) {
+      return err;
+    }
+  }
+  return 0;
+}
+
+void count_baseline_hash_join_partitions_32(int64_t* partition_counts,
+                                            const int64_t entry_count,
+                                            const int64_t partition_entry_count,
+                                            const size_t key_component_count,
+                                            const GenericKeyHandler* key_handler,
+                                            const int32_t cpu_thread_idx,
+                                            const int32_t cpu_thread_count) {
+  count_baseline_hash_join_partitions<int32_t>(partition_counts,
+                                               entry_count,
+                                               partition_entry_count,
+                                               key_component_count,
+                                               key_handler,
+                                               cpu_thread_idx,
+                                               cpu_thread_count);
+}
+
+void count_baseline_hash_join_partitions_64(int64_t* partition_counts,
+                                            const int64_t entry_count,
+                                            const int64_t partition_entry_count,
+                                            const size_t key_component_count,
+                                            const GenericKeyHandler* key_handler,
+                                            const int32_t cpu_thread_idx,
+                                            const int32_t cpu_thread_count) {
+  count_baseline_hash_join_partitions<int64_t>(partition_counts,
+                                               entry_count,
+                                               partition_entry_count,
+                                               key_component_count,
+                                               key_handler,
+                                               cpu_thread_idx,
+                                               cpu_thread_count);
+}
+
+void scatter_baseline_hash_join_partitions_32(int32_t* partitioned_rows,
+                                              int64_t* partition_offsets,
+                                              const int64_t entry_count,
+                                              const int64_t partition_entry_count,
+                                              const size_t key_component_count,
+                                              const GenericKeyHandler* key_handler,
+                                              const int32_t cpu_thread_idx,
+                                              const int32_t cpu_thread_count) {
+  scatter_baseline_hash_join_partitions<int32_t>(partitioned_rows,
+                                                 partition_offsets,
+                                                 entry_count,
+                                                 partition_entry_count,
+                                                 key_component_count,
+                                                 key_handler,
+                                                 cpu_thread_idx,
+                                                 cpu_thread_count);
+}
+
+void scatter_baseline_hash_join_partitions_64(int64_t* partitioned_rows,
+                                              int64_t* partition_offsets,
+                                              const int64_t entry_count,
+                                              const int64_t partition_entry_count,
+                                              const size_t key_component_count,
+                                              const GenericKeyHandler* key_handler,
+                                              const int32_t cpu_thread_idx,
+                                              const int32_t cpu_thread_count) {
+  scatter_baseline_hash_join_partitions<int64_t>(partitioned_rows,
+                                                 partition_offsets,
+                                                 entry_count,
+                                                 partition_entry_count,
+                                                 key_component_count,
+                                                 key_handler,
+                                                 cpu_thread_idx,
+                                                 cpu_thread_count);
+}
+
+int fill_baseline_hash_join_buff_from_partition_32(int8_t* hash_buff,
+                                                   const int64_t entry_count,
+                                                   const int32_t invalid_slot_val,
+                                                   const bool for_semi_join,
+                                                   const size_t key_component_count,
+                                                   const bool with_val_slot,
+                                                   const int32_t* partition_rows,
+                                                   const int64_t partition_row_count) {
+  return fill_baseline_hash_join_buff_from_partition<int32_t>(hash_buff,
+                                                              entry_count,
+                                                              invalid_slot_val,
+                                                              for_semi_join,
+                                                              key_component_count,
+                                                              with_val_slot,
+                                                              partition_rows,
+                                                              partition_row_count);
+}
+
+int fill_baseline_hash_join_buff_from_partition_64(int8_t* hash_buff,
+                                                   const int64_t entry_count,
+                                                   const int32_t invalid_slot_val,
+                                                   const bool for_semi_join,
+                                                   const size_t key_component_count,
+                                                   const bool with_val_slot,
+                                                   const int64_t* partition_rows,
+                                                   const int64_t partition_row_count) {
+  return fill_baseline_hash_join_buff_from_partition<int64_t>(hash_buff,
+                                                              entry_count,
+                                                              invalid_slot_val,
+                                                              for_semi_join,
+                                                              key_component_count,
+                                                              with_val_slot,
+                                                              partition_rows,
+                                                              partition_row_count);
+}
+
 template <typename T>
 void fill_one_to_many_baseline_hash_table(
     int32_t* buff,
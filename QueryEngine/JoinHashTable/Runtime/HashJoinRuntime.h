@@ -308,6 +308,58 @@ int range_fill_baseline_hash_join_buff_64(int8_t* hash_buff,
                                           const int32_t cpu_thread_idx,
                                           const int32_t cpu_thread_count);
 
+void count_baseline_hash_join_partitions_32(int64_t* partition_counts,
+                                            const int64_t entry_count,
+                                            const int64_t partition_entry_count,
+                                            const size_t key_component_count,
+                                            const GenericKeyHandler* key_handler,
+                                            const int32_t cpu_thread_idx,
+                                            const int32_t cpu_thread_count);
+
+void count_baseline_hash_join_partitions_64(int64_t* partition_counts,
+                                            const int64_t entry_count,
+                                            const int64_t partition_entry_count,
+                                            const size_t key_component_count,
+                                            const GenericKeyHandler* key_handler,
+                                            const int32_t cpu_thread_idx,
+                                            const int32_t cpu_thread_count);
+
+void scatter_baseline_hash_join_partitions_32(int32_t* partitioned_rows,
+                                              int64_t* partition_offsets,
+                                              const int64_t entry_count,
+                                              const int64_t partition_entry_count,
+                                              const size_t key_component_count,
+                                              const GenericKeyHandler* key_handler,
+                                              const int32_t cpu_thread_idx,
+                                              const int32_t cpu_thread_count);
+
+void scatter_baseline_hash_join_partitions_64(int64_t* partitioned_rows,
+                                              int64_t* partition_offsets,
+                                              const int64_t entry_count,
+                                              const int64_t partition_entry_count,
+                                              const size_t key_component_count,
+                                              const GenericKeyHandler* key_handler,
+                                              const int32_t cpu_thread_idx,
+                                              const int32_t cpu_thread_count);
+
+int fill_baseline_hash_join_buff_from_partition_32(int8_t* hash_buff,
+                                                   const int64_t entry_count,
+                                                   const int32_t invalid_slot_val,
+                                                   const bool for_semi_join,
+                                                   const size_t key_component_count,
+                                                   const bool with_val_slot,
+                                                   const int32_t* partition_rows,
+                                                   const int64_t partition_row_count);
+
+int fill_baseline_hash_join_buff_from_partition_64(int8_t* hash_buff,
+                                                   const int64_t entry_count,
+                                                   const int32_t invalid_slot_val,
+                                                   const bool for_semi_join,
+                                                   const size_t key_component_count,
+                                                   const bool with_val_slot,
+                                                   const int64_t* partition_rows,
+                                                   const int64_t partition_row_count);
+
 void fill_baseline_hash_join_buff_on_device_32(int8_t* hash_buff,
                                                const int64_t entry_count,
                                                const int32_t invalid_slot_val,
@@ -354,3 +354,40 @@ get_num_buckets_for_bounds(const int8_t* range_bytes,
 
   return num_buckets;
 }
+
+// A sorted key table starts with the number of keys, followed by the keys in ascending
+// order and then by the row id of each key.
+FORCE_INLINE DEVICE int64_t sorted_join_bound_impl(const int64_t sorted_buff,
+                                                   const int64_t key,
+                                                   const bool upper) {
+  const auto entry_count = *reinterpret_cast<const int64_t*>(sorted_buff);
+  const auto keys = reinterpret_cast<const int64_t*>(sorted_buff) + 1;
+  int64_t lo = 0;
+  int64_t hi = entry_count;
+  while (lo < hi) {
+    const auto mid = lo + (hi - lo) / 2;
+    if (keys[mid] < key || (upper && keys[mid] == key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+extern "C" RUNTIME_EXPORT ALWAYS_INLINE DEVICE int64_t
+sorted_join_lower_bound(int64_t sorted_buff, const int64_t key) {
+  return sorted_join_bound_impl(sorted_buff, key, false);
+}
+
+extern "C" RUNTIME_EXPORT ALWAYS_INLINE DEVICE int64_t
+sorted_join_upper_bound(int64_t sorted_buff, const int64_t key) {
+  return sorted_join_bound_impl(sorted_buff, key, true);
+}
+
+extern "C" RUNTIME_EXPORT ALWAYS_INLINE DEVICE int64_t
+sorted_join_row_id_buffer(int64_t sorted_buff) {
+  const auto entry_count = *reinterpret_cast<const int64_t*>(sorted_buff);
+  return reinterpret_cast<int64_t>(reinterpret_cast<const int64_t*>(sorted_buff) + 1 +
+                                   entry_count);
+}
@@ -0,0 +1,449 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/JoinHashTable/SortedKeyJoinTable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <limits>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/CodeGenerator.h"
+#include "QueryEngine/ColumnFetcher.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ExpressionRewrite.h"
+#include "QueryEngine/JoinHashTable/PerfectJoinHashTable.h"
+#include "QueryEngine/JoinHashTable/Runtime/JoinColumnIterator.h"
+#include "Shared/thread_count.h"
+
+namespace {
+
+using KeyAndRowId = std::pair<int64_t, int32_t>;
+using SortedRun = std::vector<KeyAndRowId>;
+
+// Runs of at most this many entries are copied to the sorted key table by one task.
+constexpr size_t copy_block_size{size_t(1) << 20};
+
+InnerOuter get_cols(const Analyzer::BinOper* qual_bin_oper,
+                    const Catalog_Namespace::Catalog& cat,
+                    const TemporaryTables* temporary_tables) {
+  const auto lhs = qual_bin_oper->get_left_operand();
+  const auto rhs = qual_bin_oper->get_right_operand();
+  return HashJoin::normalizeColumnPair(lhs, rhs, cat, temporary_tables);
+}
+
+bool is_sortable_key_type(const SQLTypeInfo& ti) {
+  return ti.is_integer() || (ti.is_time() && !ti.is_date_in_days());
+}
+
+bool key_less(const KeyAndRowId& lhs, const KeyAndRowId& rhs) {
+  return lhs.first < rhs.first;
+}
+
+void run_tasks(const size_t task_count, const std::function<void(const size_t)>& task) {
+  std::atomic<size_t> next_task_idx{0};
+  auto run_remaining_tasks = [&]() {
+    for (auto task_idx = next_task_idx++; task_idx < task_count;
+         task_idx = next_task_idx++) {
+      task(task_idx);
+    }
+  };
+  const size_t thread_count = std::min(static_cast<size_t>(cpu_threads()), task_count);
+  std::vector<std::future<void>> task_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    task_threads.emplace_back(std::async(std::launch::async, run_remaining_tasks));
+  }
+  for (auto& task_thread : task_threads) {
+    task_thread.wait();
+  }
+  for (auto& task_thread : task_threads) {
+    task_thread.get();
+  }
+}
+
+}  // namespace
+
+//! Make sorted key table from an in-flight SQL query's parse tree etc.
+std::shared_ptr<SortedKeyJoinTable> SortedKeyJoinTable::getInstance(
+    const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
+    const std::vector<InputTableInfo>& query_infos,
+    const Data_Namespace::MemoryLevel memory_level,
+    const JoinType join_type,
+    const int device_count,
+    ColumnCacheMap& column_cache,
+    Executor* executor) {
+  if (!isSupported(qual_bin_oper.get(), memory_level, join_type, executor)) {
+    throw HashJoinFail(
+        "Sorted key join is only supported on CPU for a single integer key column");
+  }
+  const auto cols = get_cols(
+      qual_bin_oper.get(), *executor->getCatalog(), executor->getTemporaryTables());
+  const auto inner_col = cols.first;
+  CHECK(inner_col);
+  decltype(std::chrono::steady_clock::now()) ts1, ts2;
+  if (VLOGGING(1)) {
+    ts1 = std::chrono::steady_clock::now();
+  }
+  auto join_table = std::shared_ptr<SortedKeyJoinTable>(new SortedKeyJoinTable(
+      qual_bin_oper, inner_col, query_infos, device_count, column_cache, executor));
+  try {
+    join_table->reify();
+  } catch (const TableMustBeReplicated& e) {
+    // Throw a runtime error to abort the query
+    join_table->freeHashBufferMemory();
+    throw std::runtime_error(e.what());
+  } catch (const HashJoinFail& e) {
+    join_table->freeHashBufferMemory();
+    throw HashJoinFail(std::string("Could not build a sorted key table for columns "
+                                   "involved in equijoin | ") +
+                       e.what());
+  } catch (const TooManyHashEntries&) {
+    join_table->freeHashBufferMemory();
+    throw;
+  } catch (const ColumnarConversionNotSupported& e) {
+    throw HashJoinFail(std::string("Could not build sorted key table for equijoin | ") +
+                       e.what());
+  } catch (const OutOfMemory& e) {
+    throw HashJoinFail(
+        std::string("Ran out of memory while building sorted key table for equijoin | ") +
+        e.what());
+  } catch (const std::exception& e) {
+    throw std::runtime_error(
+        std::string("Fatal error while attempting to build hash tables for join: ") +
+        e.what());
+  }
+  if (VLOGGING(1)) {
+    ts2 = std::chrono::steady_clock::now();
+    VLOG(1) << "Built sorted key table in "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(ts2 - ts1).count()
+            << " ms";
+  }
+  return join_table;
+}
+
+bool SortedKeyJoinTable::isSupported(const Analyzer::BinOper* qual_bin_oper,
+                                     const Data_Namespace::MemoryLevel memory_level,
+                                     const JoinType join_type,
+                                     const Executor* executor) {
+  if (memory_level != Data_Namespace::CPU_LEVEL || qual_bin_oper->get_optype() != kEQ ||
+      (join_type != JoinType::INNER && join_type != JoinType::LEFT) ||
+      qual_bin_oper->is_overlaps_oper() ||
+      dynamic_cast<const Analyzer::ExpressionTuple*>(qual_bin_oper->get_left_operand())) {
+    return false;
+  }
+  InnerOuter cols;
+  try {
+    cols = get_cols(
+        qual_bin_oper, *executor->getCatalog(), executor->getTemporaryTables());
+  } catch (const HashJoinFail&) {
+    return false;
+  }
+  CHECK(cols.first && cols.second);
+  const auto& inner_ti = cols.first->get_type_info();
+  const auto& outer_ti = cols.second->get_type_info();
+  if (!is_sortable_key_type(inner_ti) || !is_sortable_key_type(outer_ti)) {
+    return false;
+  }
+  if (inner_ti.is_integer() || outer_ti.is_integer()) {
+    return inner_ti.is_integer() && outer_ti.is_integer();
+  }
+  // Times are only compared as integers in the same unit.
+  return inner_ti.get_type() == outer_ti.get_type() &&
+         inner_ti.get_dimension() == outer_ti.get_dimension();
+}
+
+void SortedKeyJoinTable::reify() {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto inner_table_id = getInnerTableId();
+  HashJoin::checkHashJoinReplicationConstraint(
+      inner_table_id, get_shard_count(qual_bin_oper_.get(), executor_), executor_);
+  const auto& query_info = get_inner_query_info(inner_table_id, query_infos_).info;
+  if (query_info.getNumTuplesUpperBound() >
+      static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+    throw TooManyHashEntries();
+  }
+  if (query_info.fragments.empty()) {
+    hash_tables_for_device_[0] = std::make_shared<SortedKeyTable>(0);
+    return;
+  }
+  const auto catalog = executor_->getCatalog();
+  CHECK(catalog);
+  const auto inner_cd =
+      get_column_descriptor_maybe(col_var_->get_column_id(), inner_table_id, *catalog);
+  if (inner_cd && inner_cd->isVirtualCol) {
+    throw FailedToJoinOnVirtualColumn();
+  }
+  std::vector<std::shared_ptr<Chunk_NS::Chunk>> chunks_owner;
+  std::vector<std::shared_ptr<void>> malloc_owner;
+  const auto join_column = fetchJoinColumn(col_var_.get(),
+                                           query_info.fragments,
+                                           Data_Namespace::CPU_LEVEL,
+                                           0,
+                                           chunks_owner,
+                                           nullptr,
+                                           malloc_owner,
+                                           executor_,
+                                           &column_cache_);
+  const auto& ti = col_var_->get_type_info();
+  const JoinColumnTypeInfo type_info{static_cast<size_t>(ti.get_size()),
+                                     0,
+                                     0,
+                                     inline_fixed_encoding_null_val(ti),
+                                     false,
+                                     0,
+                                     get_join_column_type_kind(ti)};
+  hash_tables_for_device_[0] = initSortedKeyTable(join_column, type_info);
+}
+
+std::shared_ptr<SortedKeyTable> SortedKeyJoinTable::initSortedKeyTable(
+    const JoinColumn& join_column,
+    const JoinColumnTypeInfo& type_info) const {
+  auto timer = DEBUG_TIMER(__func__);
+  const auto chunks = reinterpret_cast<const JoinChunk*>(join_column.col_chunks_buff);
+  std::vector<size_t> chunk_row_offsets(join_column.num_chunks);
+  size_t row_count{0};
+  for (size_t chunk_idx = 0; chunk_idx < join_column.num_chunks; ++chunk_idx) {
+    chunk_row_offsets[chunk_idx] = row_count;
+    row_count += chunks[chunk_idx].num_elems;
+  }
+  CHECK_EQ(row_count, join_column.num_elems);
+
+  // Sort the keys of each fragment on its own. Null keys never match and are left out.
+  std::vector<SortedRun> runs(join_column.num_chunks);
+  run_tasks(join_column.num_chunks, [&](const size_t chunk_idx) {
+    const JoinColumn chunk_column{reinterpret_cast<const int8_t*>(&chunks[chunk_idx]),
+                                  sizeof(JoinChunk),
+                                  1,
+                                  chunks[chunk_idx].num_elems,
+                                  join_column.elem_sz};
+    auto& run = runs[chunk_idx];
+    run.reserve(chunk_column.num_elems);
+    JoinColumnTyped col{&chunk_column, &type_info};
+    for (auto item : col) {
+      if (item.element == type_info.null_val) {
+        continue;
+      }
+      run.emplace_back(item.element,
+                       static_cast<int32_t>(chunk_row_offsets[chunk_idx] + item.index));
+    }
+    // The fragments of a table sorted on the column are already in order.
+    if (!std::is_sorted(run.begin(), run.end(), key_less)) {
+      std::sort(run.begin(), run.end());
+    }
+  });
+
+  // Chain the runs by their key ranges: a run whose keys all follow the ones of another
+  // run is appended to it, only the chains are merged.
+  std::vector<const SortedRun*> ordered_runs;
+  for (const auto& run : runs) {
+    if (!run.empty()) {
+      ordered_runs.push_back(&run);
+    }
+  }
+  std::sort(ordered_runs.begin(),
+            ordered_runs.end(),
+            [](const SortedRun* lhs, const SortedRun* rhs) {
+              return lhs->front() < rhs->front();
+            });
+  std::vector<std::vector<const SortedRun*>> chains;
+  for (const auto run : ordered_runs) {
+    auto chain_it = std::find_if(
+        chains.begin(), chains.end(), [run](const std::vector<const SortedRun*>& chain) {
+          return chain.back()->back().first <= run->front().first;
+        });
+    if (chain_it == chains.end()) {
+      chains.emplace_back(1, run);
+    } else {
+      chain_it->push_back(run);
+    }
+  }
+  std::vector<SortedRun> merged_runs;
+  if (chains.size() > 1) {
+    merged_runs.resize(chains.size());
+    run_tasks(chains.size(), [&](const size_t chain_idx) {
+      auto& merged_run = merged_runs[chain_idx];
+      for (const auto run : chains[chain_idx]) {
+        merged_run.insert(merged_run.end(), run->begin(), run->end());
+      }
+    });
+    runs.clear();
+    while (merged_runs.size() > 1) {
+      std::vector<SortedRun> next_merged_runs((merged_runs.size() + 1) / 2);
+      run_tasks(next_merged_runs.size(), [&](const size_t run_idx) {
+        auto& lhs = merged_runs[2 * run_idx];
+        if (2 * run_idx + 1 == merged_runs.size()) {
+          next_merged_runs[run_idx] = std::move(lhs);
+          return;
+        }
+        auto& rhs = merged_runs[2 * run_idx + 1];
+        auto& merged_run = next_merged_runs[run_idx];
+        merged_run.resize(lhs.size() + rhs.size());
+        std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), merged_run.begin());
+        SortedRun().swap(lhs);
+        SortedRun().swap(rhs);
+      });
+      merged_runs.swap(next_merged_runs);
+    }
+    chains = {{&merged_runs.front()}};
+  }
+
+  // Copy the keys and row ids to the table, in blocks so that a single long run is
+  // copied in parallel as well.
+  struct CopyBlock {
+    const KeyAndRowId* entries;
+    size_t entry_count;
+    size_t table_offset;
+  };
+  std::vector<CopyBlock> copy_blocks;
+  size_t entry_count{0};
+  if (!chains.empty()) {
+    CHECK_EQ(chains.size(), size_t(1));
+    for (const auto run : chains.front()) {
+      for (size_t run_offset = 0; run_offset < run->size();
+           run_offset += copy_block_size) {
+        const auto block_size = std::min(copy_block_size, run->size() - run_offset);
+        copy_blocks.push_back({run->data() + run_offset, block_size, entry_count});
+        entry_count += block_size;
+      }
+    }
+  }
+  auto sorted_key_table = std::make_shared<SortedKeyTable>(entry_count);
+  auto keys = sorted_key_table->getKeys();
+  auto row_ids = sorted_key_table->getRowIds();
+  run_tasks(copy_blocks.size(), [&](const size_t block_idx) {
+    const auto& block = copy_blocks[block_idx];
+    for (size_t i = 0; i < block.entry_count; ++i) {
+      keys[block.table_offset + i] = block.entries[i].first;
+      row_ids[block.table_offset + i] = block.entries[i].second;
+    }
+  });
+  return sorted_key_table;
+}
+
+SortedKeyTable* SortedKeyJoinTable::getSortedKeyTable() const {
+  return dynamic_cast<SortedKeyTable*>(getHashTableForDevice(0));
+}
+
+size_t SortedKeyJoinTable::getComponentBufferSize() const noexcept {
+  const auto sorted_key_table = getSortedKeyTable();
+  return sorted_key_table ? sorted_key_table->getEntryCount() * sizeof(int64_t) : 0;
+}
+
+HashJoinMatchingSet SortedKeyJoinTable::codegenMatchingSet(const CompilationOptions& co,
+                                                           const size_t index) {
+  AUTOMATIC_IR_METADATA(executor_->cgen_state_.get());
+  const auto cols = get_cols(
+      qual_bin_oper_.get(), *executor_->getCatalog(), executor_->getTemporaryTables());
+  auto key_col = cols.second;
+  CHECK(key_col);
+  auto val_col = cols.first;
+  CHECK(val_col);
+  const auto key_col_var = dynamic_cast<const Analyzer::ColumnVar*>(key_col);
+  if (key_col_var &&
+      self_join_not_covered_by_left_deep_tree(
+          key_col_var,
+          val_col,
+          get_max_rte_scan_table(executor_->cgen_state_->scan_idx_to_hash_pos_))) {
+    throw std::runtime_error(
+        "Query execution fails because the query contains not supported self-join "
+        "pattern. We suspect the query requires multiple left-deep join tree due to "
+        "the join condition of the self-join and is not supported for now. Please "
+        "consider rewriting table order in FROM clause.");
+  }
+  auto& ir_builder = executor_->cgen_state_->ir_builder_;
+  auto sorted_buff = HashJoin::codegenHashTableLoad(index, executor_);
+  if (!sorted_buff->getType()->isIntegerTy(64)) {
+    CHECK(sorted_buff->getType()->isPointerTy());
+    sorted_buff = ir_builder.CreatePtrToInt(
+        get_arg_by_name(executor_->cgen_state_->row_func_, "join_hash_tables"),
+        llvm::Type::getInt64Ty(executor_->cgen_state_->context_));
+  }
+  CodeGenerator code_generator(executor_);
+  const auto key_lvs = code_generator.codegen(key_col, true, co);
+  CHECK_EQ(size_t(1), key_lvs.size());
+  const auto key_lv = executor_->cgen_state_->castToTypeIn(key_lvs.front(), 64);
+
+  const auto lower_lv =
+      executor_->cgen_state_->emitCall("sorted_join_lower_bound", {sorted_buff, key_lv});
+  const auto upper_lv =
+      executor_->cgen_state_->emitCall("sorted_join_upper_bound", {sorted_buff, key_lv});
+  llvm::Value* row_count_lv = ir_builder.CreateSub(upper_lv, lower_lv);
+  const auto key_col_logical_ti = get_logical_type_info(key_col->get_type_info());
+  if (!key_col_logical_ti.get_notnull()) {
+    // The null keys of the inner column are left out of the table, a null outer key
+    // mustn't match the key of the same value in a wider inner column either.
+    const auto null_key_lv =
+        executor_->cgen_state_->llInt(inline_fixed_encoding_null_val(key_col_logical_ti));
+    const auto is_null_lv = ir_builder.CreateICmpEQ(key_lv, null_key_lv);
+    row_count_lv = ir_builder.CreateSelect(
+        is_null_lv, executor_->cgen_state_->llInt(int64_t(0)), row_count_lv);
+  }
+  const auto rowid_base_i32 = ir_builder.CreateIntToPtr(
+      executor_->cgen_state_->emitCall("sorted_join_row_id_buffer", {sorted_buff}),
+      llvm::Type::getInt32PtrTy(executor_->cgen_state_->context_));
+  const auto rowid_ptr_i32 = ir_builder.CreateGEP(rowid_base_i32, lower_lv);
+  return {rowid_ptr_i32, row_count_lv, lower_lv};
+}
+
+std::string SortedKeyJoinTable::toString(const ExecutorDeviceType device_type,
+                                         const int device_id,
+                                         bool raw) const {
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  CHECK_EQ(device_id, 0);
+  std::string txt = "| sorted " + getHashTypeString(getHashType());
+  const auto sorted_key_table = getSortedKeyTable();
+  if (!sorted_key_table) {
+    return txt + " |";
+  }
+  const auto keys = sorted_key_table->getKeys();
+  const auto row_ids = sorted_key_table->getRowIds();
+  const auto entry_count = sorted_key_table->getEntryCount();
+  txt += " | keys";
+  for (size_t i = 0; i < entry_count; ++i) {
+    txt += " " + std::to_string(keys[i]);
+  }
+  txt += " | payloads";
+  for (size_t i = 0; i < entry_count; ++i) {
+    txt += " " + std::to_string(row_ids[i]);
+  }
+  return txt + " |";
+}
+
+DecodedJoinHashBufferSet SortedKeyJoinTable::toSet(const ExecutorDeviceType device_type,
+                                                   const int device_id) const {
+  CHECK(device_type == ExecutorDeviceType::CPU);
+  CHECK_EQ(device_id, 0);
+  DecodedJoinHashBufferSet s;
+  const auto sorted_key_table = getSortedKeyTable();
+  if (!sorted_key_table) {
+    return s;
+  }
+  const auto keys = sorted_key_table->getKeys();
+  const auto row_ids = sorted_key_table->getRowIds();
+  const auto entry_count = sorted_key_table->getEntryCount();
+  for (size_t i = 0; i < entry_count;) {
+    decltype(DecodedJoinHashBufferEntry::payload) payload;
+    size_t j = i;
+    for (; j < entry_count && keys[j] == keys[i]; ++j) {
+      payload.insert(row_ids[j]);
+    }
+    s.insert({{keys[i]}, std::move(payload)});
+    i = j;
+  }
+  return s;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SortedKeyJoinTable.h
+ * @brief   Equijoin on a single integer key through the sorted inner column.
+ *
+ * The inner column is sorted one fragment at a time, fragments which are already in
+ * order (e.g. because of the SORT_COLUMN of the table) are taken as they are, and the
+ * sorted fragments are merged, or just concatenated when their key ranges don't overlap.
+ * Each outer row then gets the range of its key in the sorted keys by binary search,
+ * the outer rows aren't sorted, so this is not a sort-merge join. The size of the table
+ * only depends on the number of inner rows and not on the range of the keys, which is
+ * why it's built when the perfect hash table throws TooManyHashEntries.
+ */
+
+#pragma once
+
+#include "Analyzer/Analyzer.h"
+#include "QueryEngine/Descriptors/InputDescriptors.h"
+#include "QueryEngine/InputMetadata.h"
+#include "QueryEngine/JoinHashTable/HashJoin.h"
+#include "QueryEngine/JoinHashTable/SortedKeyTable.h"
+
+#include <llvm/IR/Value.h>
+
+#include <memory>
+
+class SortedKeyJoinTable : public HashJoin {
+ public:
+  //! Make sorted key table from an in-flight SQL query's parse tree etc.
+  static std::shared_ptr<SortedKeyJoinTable> getInstance(
+      const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
+      const std::vector<InputTableInfo>& query_infos,
+      const Data_Namespace::MemoryLevel memory_level,
+      const JoinType join_type,
+      const int device_count,
+      ColumnCacheMap& column_cache,
+      Executor* executor);
+
+  //! Whether a sorted key table can be built for the join qual.
+  static bool isSupported(const Analyzer::BinOper* qual_bin_oper,
+                          const Data_Namespace::MemoryLevel memory_level,
+                          const JoinType join_type,
+                          const Executor* executor);
+
+  std::string toString(const ExecutorDeviceType device_type,
+                       const int device_id = 0,
+                       bool raw = false) const override;
+
+  DecodedJoinHashBufferSet toSet(const ExecutorDeviceType device_type,
+                                 const int device_id) const override;
+
+  llvm::Value* codegenSlot(const CompilationOptions&, const size_t) override {
+    UNREACHABLE();  // a key may match many rows of the sorted key table
+    return nullptr;
+  }
+
+  HashJoinMatchingSet codegenMatchingSet(const CompilationOptions&,
+                                         const size_t) override;
+
+  int getInnerTableId() const noexcept override { return col_var_->get_table_id(); }
+
+  int getInnerTableRteIdx() const noexcept override { return col_var_->get_rte_idx(); }
+
+  HashType getHashType() const noexcept override { return HashType::OneToMany; }
+
+  Data_Namespace::MemoryLevel getMemoryLevel() const noexcept override {
+    return Data_Namespace::CPU_LEVEL;
+  }
+
+  int getDeviceCount() const noexcept override { return device_count_; }
+
+  size_t offsetBufferOff() const noexcept override { return sizeof(int64_t); }
+
+  size_t countBufferOff() const noexcept override { return payloadBufferOff(); }
+
+  size_t payloadBufferOff() const noexcept override {
+    return offsetBufferOff() + getComponentBufferSize();
+  }
+
+  std::string getHashJoinType() const final { return "SortedKey"; }
+
+  virtual ~SortedKeyJoinTable() {}
+
+ private:
+  SortedKeyJoinTable(const std::shared_ptr<Analyzer::BinOper> qual_bin_oper,
+                     const Analyzer::ColumnVar* col_var,
+                     const std::vector<InputTableInfo>& query_infos,
+                     const int device_count,
+                     ColumnCacheMap& column_cache,
+                     Executor* executor)
+      : qual_bin_oper_(qual_bin_oper)
+      , col_var_(std::dynamic_pointer_cast<Analyzer::ColumnVar>(col_var->deep_copy()))
+      , query_infos_(query_infos)
+      , device_count_(device_count)
+      , column_cache_(column_cache)
+      , executor_(executor) {
+    CHECK_EQ(device_count_, 1);
+    hash_tables_for_device_.resize(device_count_);
+  }
+
+  void reify();
+
+  std::shared_ptr<SortedKeyTable> initSortedKeyTable(
+      const JoinColumn& join_column,
+      const JoinColumnTypeInfo& type_info) const;
+
+  SortedKeyTable* getSortedKeyTable() const;
+
+  size_t getComponentBufferSize() const noexcept override;
+
+  std::shared_ptr<Analyzer::BinOper> qual_bin_oper_;
+  std::shared_ptr<Analyzer::ColumnVar> col_var_;
+  const std::vector<InputTableInfo>& query_infos_;
+  const int device_count_;
+  ColumnCacheMap& column_cache_;
+  Executor* executor_;
+};
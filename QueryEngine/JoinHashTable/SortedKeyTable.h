@@ -0,0 +1,71 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/JoinHashTable/HashTable.h"
+
+// The non-null keys of the inner column of a join in ascending order, along with the row
+// id of each key. The layout of the CPU buffer is:
+// | key count (int64) | keys (int64 x key count) | row ids (int32 x key count) |
+class SortedKeyTable : public HashTable {
+ public:
+  SortedKeyTable(const size_t entry_count)
+      : entry_count_(entry_count)
+      , cpu_buff_size_(sizeof(int64_t) + entry_count_ * sizeof(int64_t) +
+                       entry_count_ * sizeof(int32_t)) {
+    cpu_buff_.reset(new int8_t[cpu_buff_size_]);
+    *reinterpret_cast<int64_t*>(cpu_buff_.get()) = entry_count_;
+  }
+
+  size_t getHashTableBufferSize(const ExecutorDeviceType device_type) const override {
+    return device_type == ExecutorDeviceType::CPU ? cpu_buff_size_ : 0;
+  }
+
+  HashType getLayout() const override { return HashType::OneToMany; }
+
+  int8_t* getCpuBuffer() override { return cpu_buff_.get(); }
+
+  int8_t* getGpuBuffer() const override { return nullptr; }
+
+  size_t getEntryCount() const override { return entry_count_; }
+
+  size_t getEmittedKeysCount() const override { return entry_count_; }
+
+  int64_t* getKeys() { return reinterpret_cast<int64_t*>(cpu_buff_.get()) + 1; }
+
+  const int64_t* getKeys() const {
+    return reinterpret_cast<const int64_t*>(cpu_buff_.get()) + 1;
+  }
+
+  int32_t* getRowIds() { return reinterpret_cast<int32_t*>(getKeys() + entry_count_); }
+
+  const int32_t* getRowIds() const {
+    return reinterpret_cast<const int32_t*>(getKeys() + entry_count_);
+  }
+
+ private:
+  size_t entry_count_;  // number of non-null keys of the inner column
+  size_t cpu_buff_size_;
+  std::unique_ptr<int8_t[]> cpu_buff_;
+};
@@ -24,6 +24,7 @@ static_assert(false, "LLVM Version >= 9 is required.");
 #include <llvm/Analysis/TypeBasedAliasAnalysis.h>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Config/llvm-config.h>
 #include <llvm/ExecutionEngine/MCJIT.h>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/GlobalValue.h>
@@ -68,12 +69,23 @@ static_assert(false, "LLVM Version >= 9 is required.");
 #include "QueryEngine/LLVMFunctionAttributesUtil.h"
 #include "QueryEngine/Optimization/AnnotateInternalFunctionsPass.h"
 #include "QueryEngine/OutputBufferInitialization.h"
+#include "QueryEngine/PersistentCodeCache.h"
 #include "QueryEngine/QueryTemplateGenerator.h"
 #include "Shared/InlineNullValues.h"
 #include "Shared/MathUtils.h"
 #include "StreamingTopN.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <optional>
+#include <queue>
+#include <thread>
+
 float g_fraction_code_cache_to_evict = 0.2;
+bool g_enable_persistent_jit_cache{false};
+size_t g_persistent_jit_cache_max_bytes{size_t(1) << 30};
+bool g_enable_background_cpu_compilation{false};
+size_t g_background_compilation_max_rows{10000000};
 
 std::unique_ptr<llvm::Module> udf_gpu_module;
 std::unique_ptr<llvm::Module> udf_cpu_module;
@@ -319,6 +331,14 @@ void optimize_ir(llvm::Function* query_func,
   // the always inliner legacy pass must always run first
   pass_manager.add(llvm::createAlwaysInlinerLegacyPass());
 
+  if (co.opt_level == ExecutorOptLevel::Baseline) {
+    // only drop the runtime functions the query doesn't use, so they don't get compiled
+    pass_manager.add(llvm::createGlobalDCEPass());
+    pass_manager.run(*module);
+    eliminate_dead_self_recursive_funcs(*module, live_funcs);
+    return;
+  }
+
   pass_manager.add(new AnnotateInternalFunctionsPass());
 
   pass_manager.add(llvm::createSROAPass());
@@ -443,12 +463,17 @@ std::string assemblyForCPU(ExecutionEngineWrapper& execution_engine,
 ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
     llvm::Function* func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    PersistentCodeCache* persistent_code_cache) {
   auto module = func->getParent();
+  const bool has_cached_object =
+      persistent_code_cache && persistent_code_cache->hasObject();
   // run optimizations
 #ifndef WITH_JIT_DEBUG
   llvm::legacy::PassManager pass_manager;
-  optimize_ir(func, module, pass_manager, live_funcs, co);
+  if (!has_cached_object) {
+    optimize_ir(func, module, pass_manager, live_funcs, co);
+  }
 #endif  // WITH_JIT_DEBUG
 
   auto init_err = llvm::InitializeNativeTarget();
@@ -466,7 +491,8 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
   llvm::TargetOptions to;
   to.EnableFastISel = true;
   eb.setTargetOptions(to);
-  if (co.opt_level == ExecutorOptLevel::ReductionJIT) {
+  if (co.opt_level == ExecutorOptLevel::ReductionJIT ||
+      co.opt_level == ExecutorOptLevel::Baseline) {
     eb.setOptLevel(llvm::CodeGenOpt::None);
   }
 
@@ -479,17 +505,251 @@ ExecutionEngineWrapper CodeGenerator::generateNativeCPUCode(
 
   ExecutionEngineWrapper execution_engine(eb.create(), co);
   CHECK(execution_engine.get());
-  LOG(ASM) << assemblyForCPU(execution_engine, module);
+  if (!has_cached_object) {
+    LOG(ASM) << assemblyForCPU(execution_engine, module);
+  }
 
+  if (persistent_code_cache) {
+    execution_engine->setObjectCache(persistent_code_cache);
+  }
   execution_engine->finalizeObject();
+  if (persistent_code_cache) {
+    // the cache only lives for this compilation
+    execution_engine->setObjectCache(nullptr);
+  }
   return execution_engine;
 }
 
+namespace {
+
+// Identifies the runtime functions query modules are linked with and the host CPU the
+// code is generated for, so that objects cached by another build or on another machine
+// sharing the data directory aren't loaded.
+const std::string& get_persistent_code_cache_fingerprint() {
+  static const std::string fingerprint = [] {
+    std::ostringstream oss;
+    oss << LLVM_VERSION_STRING << ';' << llvm::sys::getProcessTriple() << ';'
+        << llvm::sys::getHostCPUName().str() << ';';
+    llvm::StringMap<bool> host_features;
+    if (llvm::sys::getHostCPUFeatures(host_features)) {
+      std::set<std::string> enabled_features;
+      for (const auto& feature : host_features) {
+        if (feature.getValue()) {
+          enabled_features.insert(feature.getKey().str());
+        }
+      }
+      for (const auto& feature : enabled_features) {
+        oss << feature << ',';
+      }
+    }
+    oss << ';' << boost::hash_value(serialize_llvm_object(g_rt_module.get()));
+    return oss.str();
+  }();
+  return fingerprint;
+}
+
+// Code linked from UDF or GEOS modules can change without the query IR changing.
+bool can_use_persistent_code_cache(const CgenState* cgen_state) {
+  return g_enable_persistent_jit_cache && !cgen_state->needs_geos_ && !udf_cpu_module &&
+         !rt_udf_cpu_module;
+}
+
+// Compiles fully optimized code for the query modules executed with baseline code, on a
+// thread of its own and in LLVM contexts of its own so that it doesn't hold up the
+// compilation of other queries. Executors pick the optimized code up the next time they
+// look the module up in their code cache. The worker is stopped explicitly on shutdown,
+// through Executor::shutdownBackgroundCompilation.
+class BackgroundCodeCompiler {
+ public:
+  struct Task {
+    CodeCacheKey key;
+    // Keeps the module compiled to baseline code alive until it has been serialized.
+    // Machine code generation only lowered its IR, so it is still fit for optimization.
+    std::shared_ptr<CpuCompilationContext> baseline_code;
+    const llvm::Module* baseline_module;
+    std::string multifrag_query_func_name;
+    std::string query_func_name;
+    std::vector<std::string> live_func_names;
+    CompilationOptions co;
+    // empty if the compiled code can't be stored in the persistent code cache
+    std::string persistent_code_cache_fingerprint;
+  };
+
+  static BackgroundCodeCompiler& instance() {
+    // never destroyed, the worker must not outlive the data it compiles with
+    static auto background_code_compiler = new BackgroundCodeCompiler();
+    return *background_code_compiler;
+  }
+
+  // Whether optimized code for the module will be compiled if submitted, or already is
+  // on its way.
+  bool canAccept(const CodeCacheKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !threads_should_exit_ &&
+           (pending_keys_.count(key) || tasks_.size() < kMaxPendingTasks);
+  }
+
+  // Called with Executor::compilation_mutex_ held, like the rest of the compilation.
+  void submit(Task&& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_should_exit_ || pending_keys_.count(task.key)) {
+      return;
+    }
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&BackgroundCodeCompiler::worker, this);
+    }
+    pending_keys_.insert(task.key);
+    tasks_.push(std::move(task));
+    cv_.notify_all();
+  }
+
+  std::optional<CodeCacheValWithModule> getCompiledCode(const CodeCacheKey& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = compiled_code_.find(key);
+    if (it == compiled_code_.cend()) {
+      return std::nullopt;
+    }
+    return it->second;
+  }
+
+  void waitUntilIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pending_keys_.empty() || threads_should_exit_; });
+  }
+
+  // Drops the pending tasks and the compiled code, waits for the task being compiled.
+  void shutdown() {
+    std::queue<Task> pending_tasks;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      threads_should_exit_ = true;
+      pending_tasks.swap(tasks_);
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) {
+      worker_.join();
+    }
+    {
+      std::lock_guard<std::mutex> compilation_lock(Executor::compilation_mutex_);
+      while (!pending_tasks.empty()) {
+        pending_tasks.pop();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_keys_.clear();
+    compiled_code_.clear();
+  }
+
+ private:
+  static constexpr size_t kMaxPendingTasks{64};
+  static constexpr size_t kMaxCompiledCode{1000};
+
+  BackgroundCodeCompiler() : compiled_code_(kMaxCompiledCode) {}
+
+  void worker() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      cv_.wait(lock, [this] { return !tasks_.empty() || threads_should_exit_; });
+      if (threads_should_exit_) {
+        return;
+      }
+      auto task = std::move(tasks_.front());
+      tasks_.pop();
+      lock.unlock();
+      std::optional<CodeCacheValWithModule> compiled_code;
+      try {
+        auto clock_begin = timer_start();
+        compiled_code = compile(task);
+        VLOG(1) << "Compiled optimized code in the background in "
+                << timer_stop(clock_begin) << " ms";
+      } catch (const std::exception& e) {
+        LOG(WARNING) << "Background compilation failed: " << e.what();
+      }
+      lock.lock();
+      pending_keys_.erase(task.key);
+      if (compiled_code) {
+        compiled_code_.put(task.key, *compiled_code);
+      }
+      cv_.notify_all();
+    }
+  }
+
+  static CodeCacheValWithModule compile(Task& task) {
+    std::string module_bitcode;
+    {
+      // the baseline module belongs to the global LLVM context, used by the executors
+      std::lock_guard<std::mutex> compilation_lock(Executor::compilation_mutex_);
+      llvm::raw_string_ostream bitcode_os(module_bitcode);
+      llvm::WriteBitcodeToFile(*task.baseline_module, bitcode_os);
+      bitcode_os.flush();
+      task.baseline_module = nullptr;
+      task.baseline_code.reset();
+    }
+    auto llvm_context = std::make_unique<llvm::LLVMContext>();
+    auto module_or_err = llvm::parseBitcodeFile(
+        llvm::MemoryBufferRef(module_bitcode, "background_module"), *llvm_context);
+    if (!module_or_err) {
+      throw std::runtime_error("Could not read query module bitcode: " +
+                               llvm::toString(module_or_err.takeError()));
+    }
+    // the execution engine takes ownership of the module
+    auto module = module_or_err->release();
+    auto query_func = module->getFunction(task.query_func_name);
+    auto multifrag_query_func = module->getFunction(task.multifrag_query_func_name);
+    CHECK(query_func);
+    CHECK(multifrag_query_func);
+    std::unordered_set<llvm::Function*> live_funcs;
+    for (const auto& live_func_name : task.live_func_names) {
+      if (auto live_func = module->getFunction(live_func_name)) {
+        live_funcs.insert(live_func);
+      }
+    }
+    std::unique_ptr<PersistentCodeCache> persistent_code_cache;
+    if (!task.persistent_code_cache_fingerprint.empty()) {
+      auto persistent_key = task.key;
+      persistent_key.push_back(std::to_string(static_cast<int>(task.co.opt_level)));
+      persistent_code_cache = std::make_unique<PersistentCodeCache>(
+          persistent_key, task.persistent_code_cache_fingerprint);
+    }
+    auto execution_engine = CodeGenerator::generateNativeCPUCode(
+        query_func, live_funcs, task.co, persistent_code_cache.get());
+    auto cpu_compilation_context = std::make_shared<CpuCompilationContext>(
+        std::move(execution_engine), std::move(llvm_context));
+    cpu_compilation_context->setFunctionPointer(multifrag_query_func);
+    return {cpu_compilation_context, module};
+  }
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool threads_should_exit_{false};
+  std::queue<Task> tasks_;
+  std::unordered_set<CodeCacheKey, boost::hash<CodeCacheKey>> pending_keys_;
+  CodeCache compiled_code_;
+  std::thread worker_;
+};
+
+std::atomic<size_t> g_num_background_code_swaps{0};
+
+}  // namespace
+
+void Executor::shutdownBackgroundCompilation() {
+  BackgroundCodeCompiler::instance().shutdown();
+}
+
+void Executor::waitForBackgroundCompilation() {
+  BackgroundCodeCompiler::instance().waitUntilIdle();
+}
+
+size_t Executor::getNumBackgroundCodeSwaps() {
+  return g_num_background_code_swaps;
+}
+
 std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
     llvm::Function* query_func,
     llvm::Function* multifrag_query_func,
     const std::unordered_set<llvm::Function*>& live_funcs,
-    const CompilationOptions& co) {
+    const CompilationOptions& co,
+    const bool allow_background_compilation) {
   auto module = multifrag_query_func->getParent();
   CodeCacheKey key{serialize_llvm_object(query_func),
                    serialize_llvm_object(cgen_state_->row_func_)};
@@ -499,6 +759,18 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
   for (const auto helper : cgen_state_->helper_functions_) {
     key.push_back(serialize_llvm_object(helper));
   }
+  if (g_enable_background_cpu_compilation) {
+    // replaces the baseline code this executor may have cached with the optimized one
+    auto optimized_code = BackgroundCodeCompiler::instance().getCompiledCode(key);
+    if (optimized_code) {
+      auto it = cpu_code_cache_.find(key);
+      if (it == cpu_code_cache_.cend() || it->second.first != optimized_code->first) {
+        addCodeToCache(
+            key, optimized_code->first, optimized_code->second, cpu_code_cache_);
+        ++g_num_background_code_swaps;
+      }
+    }
+  }
   auto cached_code = getCodeFromCache(key, cpu_code_cache_);
   if (cached_code) {
     return cached_code;
@@ -529,12 +801,52 @@ std::shared_ptr<CompilationContext> Executor::optimizeAndCodegenCPU(
 #endif
   }
 
-  auto execution_engine =
-      CodeGenerator::generateNativeCPUCode(query_func, live_funcs, co);
+  const auto persistent_code_cache_fingerprint =
+      can_use_persistent_code_cache(cgen_state_.get())
+          ? get_persistent_code_cache_fingerprint()
+          : std::string();
+  std::unique_ptr<PersistentCodeCache> persistent_code_cache;
+  if (!persistent_code_cache_fingerprint.empty()) {
+    auto persistent_key = key;
+    persistent_key.push_back(std::to_string(static_cast<int>(co.opt_level)));
+    persistent_code_cache = std::make_unique<PersistentCodeCache>(
+        persistent_key, persistent_code_cache_fingerprint);
+  }
+
+  auto codegen_co = co;
+  std::optional<BackgroundCodeCompiler::Task> background_task;
+  if (allow_background_compilation &&
+      !(persistent_code_cache && persistent_code_cache->hasObject()) &&
+      BackgroundCodeCompiler::instance().canAccept(key)) {
+    // Execute baseline code right away and compile the optimized code in the
+    // background, from a copy of the module written by the background compiler.
+    background_task = BackgroundCodeCompiler::Task{key,
+                                                   nullptr,
+                                                   module,
+                                                   multifrag_query_func->getName().str(),
+                                                   query_func->getName().str(),
+                                                   {},
+                                                   co,
+                                                   persistent_code_cache_fingerprint};
+    for (const auto live_func : live_funcs) {
+      if (live_func && live_func->hasName()) {
+        background_task->live_func_names.push_back(live_func->getName().str());
+      }
+    }
+    codegen_co.opt_level = ExecutorOptLevel::Baseline;
+    // baseline code isn't worth keeping on disk
+    persistent_code_cache.reset();
+  }
+  auto execution_engine = CodeGenerator::generateNativeCPUCode(
+      query_func, live_funcs, codegen_co, persistent_code_cache.get());
   auto cpu_compilation_context =
       std::make_shared<CpuCompilationContext>(std::move(execution_engine));
   cpu_compilation_context->setFunctionPointer(multifrag_query_func);
   addCodeToCache(key, cpu_compilation_context, module, cpu_code_cache_);
+  if (background_task) {
+    background_task->baseline_code = cpu_compilation_context;
+    BackgroundCodeCompiler::instance().submit(std::move(*background_task));
+  }
   return cpu_compilation_context;
 }
 
@@ -2556,6 +2868,22 @@ std::string serialize_llvm_metadata_footnotes(llvm::Function* query_func,
 }
 #endif  // NDEBUG
 
+// Only queries over a few rows run on baseline code, the optimized code pays for its
+// compilation time on larger inputs.
+bool can_compile_in_background(const std::vector<InputTableInfo>& query_infos,
+                               const CompilationOptions& co,
+                               const ExecutionOptions& eo) {
+  if (!g_enable_background_cpu_compilation || eo.just_explain || eo.jit_debug ||
+      co.explain_type != ExecutorExplainType::Default) {
+    return false;
+  }
+  size_t num_rows{0};
+  for (const auto& query_info : query_infos) {
+    num_rows += query_info.info.getNumTuplesUpperBound();
+  }
+  return num_rows <= g_background_compilation_max_rows;
+}
+
 }  // namespace
 
 std::tuple<CompilationResult, std::unique_ptr<QueryMemoryDescriptor>>
@@ -2645,6 +2973,7 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
       const auto& count_distinct_descriptor =
           query_mem_desc->getCountDistinctDescriptor(i);
       if (count_distinct_descriptor.impl_type_ == CountDistinctImplType::StdSet ||
+          count_distinct_descriptor.impl_type_ == CountDistinctImplType::HashSet ||
           (count_distinct_descriptor.impl_type_ != CountDistinctImplType::Invalid &&
            !co.hoist_literals)) {
         throw QueryMustRunOnCpu();
@@ -2938,7 +3267,11 @@ Executor::compileWorkUnit(const std::vector<InputTableInfo>& query_infos,
   return std::make_tuple(
       CompilationResult{
           co.device_type == ExecutorDeviceType::CPU
-              ? optimizeAndCodegenCPU(query_func, multifrag_query_func, live_funcs, co)
+              ? optimizeAndCodegenCPU(query_func,
+                                      multifrag_query_func,
+                                      live_funcs,
+                                      co,
+                                      can_compile_in_background(query_infos, co, eo))
               : optimizeAndCodegenGPU(query_func,
                                       multifrag_query_func,
                                       live_funcs,
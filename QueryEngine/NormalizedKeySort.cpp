@@ -0,0 +1,238 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "NormalizedKeySort.h"
+
+#include "Logger/Logger.h"
+#include "Shared/Intervals.h"
+#include "Shared/thread_count.h"
+#include "Shared/threading.h"
+
+#include <algorithm>
+#include <array>
+
+namespace normalized_key_sort {
+
+namespace {
+
+constexpr size_t kRadix{256};
+// Buckets at most this large are finished with an insertion sort.
+constexpr size_t kInsertionSortThreshold{32};
+
+using Histogram = std::array<size_t, kRadix>;
+
+inline uint8_t radix_at(const int8_t* record, const size_t byte_idx) {
+  return static_cast<uint8_t>(record[byte_idx]);
+}
+
+void insertion_sort(int8_t* records,
+                    const size_t count,
+                    const size_t record_width,
+                    const size_t key_width,
+                    const size_t byte_idx,
+                    int8_t* tmp) {
+  for (size_t i = 1; i < count; ++i) {
+    const auto record = records + i * record_width;
+    size_t j = i;
+    while (j > 0 && std::memcmp(records + (j - 1) * record_width + byte_idx,
+                                record + byte_idx,
+                                key_width - byte_idx) > 0) {
+      --j;
+    }
+    if (j != i) {
+      std::memcpy(tmp, record, record_width);
+      std::memmove(records + (j + 1) * record_width,
+                   records + j * record_width,
+                   (i - j) * record_width);
+      std::memcpy(records + j * record_width, tmp, record_width);
+    }
+  }
+}
+
+// Sorts `count` records in place on key bytes [byte_idx, key_width), using `scratch`
+// (at least as large as the records) as the scatter target and `tmp` (one record) for
+// swaps.
+void msd_radix_sort(int8_t* records,
+                    int8_t* scratch,
+                    const size_t count,
+                    const size_t record_width,
+                    const size_t key_width,
+                    size_t byte_idx,
+                    int8_t* tmp) {
+  while (byte_idx < key_width) {
+    if (count <= kInsertionSortThreshold) {
+      insertion_sort(records, count, record_width, key_width, byte_idx, tmp);
+      return;
+    }
+    Histogram histogram{};
+    for (size_t i = 0; i < count; ++i) {
+      ++histogram[radix_at(records + i * record_width, byte_idx)];
+    }
+    const auto single_bucket = std::find(histogram.begin(), histogram.end(), count);
+    if (single_bucket != histogram.end()) {
+      // All records share this byte, move on to the next one without scattering.
+      ++byte_idx;
+      continue;
+    }
+    Histogram offsets;
+    size_t running_offset{0};
+    for (size_t bucket = 0; bucket < kRadix; ++bucket) {
+      offsets[bucket] = running_offset;
+      running_offset += histogram[bucket];
+    }
+    auto write_pos = offsets;
+    for (size_t i = 0; i < count; ++i) {
+      const auto record = records + i * record_width;
+      std::memcpy(scratch + write_pos[radix_at(record, byte_idx)]++ * record_width,
+                  record,
+                  record_width);
+    }
+    std::memcpy(records, scratch, count * record_width);
+    for (size_t bucket = 0; bucket < kRadix; ++bucket) {
+      if (histogram[bucket] > 1) {
+        msd_radix_sort(records + offsets[bucket] * record_width,
+                       scratch + offsets[bucket] * record_width,
+                       histogram[bucket],
+                       record_width,
+                       key_width,
+                       byte_idx + 1,
+                       tmp);
+      }
+    }
+    return;
+  }
+}
+
+// Partitions the records on the first distinguishing key byte with all available
+// threads, then sorts the resulting buckets independently.
+void parallel_msd_radix_sort(int8_t* records,
+                             int8_t* scratch,
+                             const size_t count,
+                             const size_t record_width,
+                             const size_t key_width) {
+  const size_t nthreads = cpu_threads();
+  const auto intervals = makeIntervals<size_t>(0, count, nthreads);
+  std::vector<Histogram> thread_histograms(nthreads);
+  Histogram bucket_sizes;
+  size_t byte_idx{0};
+  for (; byte_idx < key_width; ++byte_idx) {
+    threading::task_group histogram_threads;
+    for (auto interval : intervals) {
+      histogram_threads.run([&, interval] {
+        auto& histogram = thread_histograms[interval.index];
+        histogram.fill(0);
+        for (size_t i = interval.begin; i < interval.end; ++i) {
+          ++histogram[radix_at(records + i * record_width, byte_idx)];
+        }
+      });
+    }
+    histogram_threads.wait();
+    bucket_sizes.fill(0);
+    for (const auto& histogram : thread_histograms) {
+      for (size_t bucket = 0; bucket < kRadix; ++bucket) {
+        bucket_sizes[bucket] += histogram[bucket];
+      }
+    }
+    if (std::find(bucket_sizes.begin(), bucket_sizes.end(), count) ==
+        bucket_sizes.end()) {
+      break;
+    }
+  }
+  if (byte_idx == key_width) {
+    // All keys are equal.
+    return;
+  }
+
+  // Every thread scatters into a disjoint slice of each bucket.
+  Histogram bucket_offsets;
+  std::vector<Histogram> thread_offsets(nthreads);
+  size_t running_offset{0};
+  for (size_t bucket = 0; bucket < kRadix; ++bucket) {
+    bucket_offsets[bucket] = running_offset;
+    for (size_t thread_idx = 0; thread_idx < nthreads; ++thread_idx) {
+      thread_offsets[thread_idx][bucket] = running_offset;
+      running_offset += thread_histograms[thread_idx][bucket];
+    }
+  }
+  CHECK_EQ(running_offset, count);
+
+  threading::task_group scatter_threads;
+  for (auto interval : intervals) {
+    scatter_threads.run([&, interval] {
+      auto& write_pos = thread_offsets[interval.index];
+      for (size_t i = interval.begin; i < interval.end; ++i) {
+        const auto record = records + i * record_width;
+        std::memcpy(scratch + write_pos[radix_at(record, byte_idx)]++ * record_width,
+                    record,
+                    record_width);
+      }
+    });
+  }
+  scatter_threads.wait();
+
+  threading::task_group bucket_threads;
+  for (size_t bucket = 0; bucket < kRadix; ++bucket) {
+    if (!bucket_sizes[bucket]) {
+      continue;
+    }
+    bucket_threads.run([&, bucket] {
+      const auto bucket_records = records + bucket_offsets[bucket] * record_width;
+      const auto bucket_scratch = scratch + bucket_offsets[bucket] * record_width;
+      std::memcpy(bucket_records, bucket_scratch, bucket_sizes[bucket] * record_width);
+      if (bucket_sizes[bucket] > 1) {
+        std::vector<int8_t> tmp(record_width);
+        msd_radix_sort(bucket_records,
+                       bucket_scratch,
+                       bucket_sizes[bucket],
+                       record_width,
+                       key_width,
+                       byte_idx + 1,
+                       tmp.data());
+      }
+    });
+  }
+  bucket_threads.wait();
+}
+
+}  // namespace
+
+KeyBuffer::KeyBuffer(const size_t key_width, const size_t entry_count)
+    : key_width_(key_width)
+    , record_width_(key_width + sizeof(RowIndex))
+    , entry_count_(entry_count)
+    , records_(record_width_ * entry_count) {}
+
+void KeyBuffer::sort(const bool single_threaded) {
+  if (entry_count_ < 2 || !key_width_) {
+    return;
+  }
+  std::vector<int8_t> scratch(records_.size());
+  if (single_threaded || cpu_threads() < 2) {
+    std::vector<int8_t> tmp(record_width_);
+    msd_radix_sort(records_.data(),
+                   scratch.data(),
+                   entry_count_,
+                   record_width_,
+                   key_width_,
+                   0,
+                   tmp.data());
+  } else {
+    parallel_msd_radix_sort(
+        records_.data(), scratch.data(), entry_count_, record_width_, key_width_);
+  }
+}
+
+}  // namespace normalized_key_sort
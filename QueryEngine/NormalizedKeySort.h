@@ -0,0 +1,99 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    NormalizedKeySort.h
+ * @brief   Radix sort over fixed-width, byte-comparable ("normalized") sort keys.
+ *
+ * Every ORDER BY entry of a row is encoded into a fixed number of bytes such that
+ * comparing two full keys with memcmp() yields the same ordering as the row
+ * comparator. The keys are stored in records of the form [key bytes][row index],
+ * which are then sorted with an MSD radix sort.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace normalized_key_sort {
+
+using RowIndex = uint32_t;
+
+// Maps a signed integer to an unsigned one with the same ordering.
+inline uint64_t normalize_int(const int64_t val) {
+  return static_cast<uint64_t>(val) ^ (uint64_t(1) << 63);
+}
+
+// Maps an IEEE 754 double to an unsigned integer with the same ordering. Negative and
+// positive zero are folded together since they compare equal.
+inline uint64_t normalize_double(const double val) {
+  const double folded = val == 0.0 ? 0.0 : val;
+  uint64_t bits;
+  std::memcpy(&bits, &folded, sizeof(bits));
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+// Writes the lowest `width` bytes of `val` to `dst` in big-endian order, inverting
+// them for descending sort order.
+inline void store_key_bytes(int8_t* dst,
+                            const uint64_t val,
+                            const size_t width,
+                            const bool invert) {
+  const uint64_t bits = invert ? ~val : val;
+  for (size_t i = 0; i < width; ++i) {
+    dst[i] = static_cast<int8_t>(bits >> (8 * (width - i - 1)));
+  }
+}
+
+// Fixed-width records holding a normalized key followed by the row index it belongs to.
+class KeyBuffer {
+ public:
+  KeyBuffer(const size_t key_width, const size_t entry_count);
+
+  size_t keyWidth() const { return key_width_; }
+
+  size_t recordWidth() const { return record_width_; }
+
+  size_t entryCount() const { return entry_count_; }
+
+  int8_t* key(const size_t i) { return &records_[i * record_width_]; }
+
+  const int8_t* key(const size_t i) const { return &records_[i * record_width_]; }
+
+  RowIndex rowIndex(const size_t i) const {
+    RowIndex idx;
+    std::memcpy(&idx, &records_[i * record_width_ + key_width_], sizeof(idx));
+    return idx;
+  }
+
+  void setRowIndex(const size_t i, const RowIndex idx) {
+    std::memcpy(&records_[i * record_width_ + key_width_], &idx, sizeof(idx));
+  }
+
+  // Sorts all records by key. Records with equal keys end up in unspecified order.
+  void sort(const bool single_threaded);
+
+ private:
+  const size_t key_width_;
+  const size_t record_width_;
+  const size_t entry_count_;
+  std::vector<int8_t> records_;
+};
+
+}  // namespace normalized_key_sort
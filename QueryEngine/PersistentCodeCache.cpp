@@ -0,0 +1,253 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QueryEngine/PersistentCodeCache.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+extern std::string g_base_path;
+
+namespace {
+
+std::string to_hex(const size_t hash) {
+  std::ostringstream oss;
+  oss << std::hex << std::setfill('0') << std::setw(16) << hash;
+  return oss.str();
+}
+
+// Size and last use of the cached objects, scanned from the cache directory on first use.
+// The least recently used objects are evicted to make room for new ones. The last use
+// is kept as the modification time of the files, so that it survives restarts.
+class CacheIndex {
+ public:
+  CacheIndex(const std::string& cache_dir) : cache_dir_(cache_dir) {}
+
+  // Creates and scans the cache directory once. Objects whose file name doesn't start
+  // with `file_prefix` belong to another fingerprint and can never be loaded again, they
+  // are removed along with temporary files left behind by a crash.
+  void init(const std::string& file_prefix) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (initialized_) {
+      return;
+    }
+    initialized_ = true;
+    boost::system::error_code ec;
+    boost::filesystem::create_directories(cache_dir_, ec);
+    if (ec) {
+      LOG(WARNING) << "Could not create JIT cache directory " << cache_dir_ << ": "
+                   << ec.message();
+      return;
+    }
+    std::vector<std::pair<std::time_t, std::string>> files_by_last_use;
+    for (boost::filesystem::directory_iterator it(cache_dir_, ec), end;
+         !ec && it != end;
+         it.increment(ec)) {
+      if (!boost::filesystem::is_regular_file(it->status())) {
+        continue;
+      }
+      const auto& path = it->path();
+      boost::system::error_code file_ec;
+      if (path.filename().string().compare(0, file_prefix.size(), file_prefix) != 0 ||
+          path.extension() != ".o") {
+        VLOG(1) << "Removing stale JIT cache file " << path;
+        boost::filesystem::remove(path, file_ec);
+        continue;
+      }
+      const auto last_use = boost::filesystem::last_write_time(path, file_ec);
+      if (!file_ec) {
+        files_by_last_use.emplace_back(last_use, path.string());
+      }
+    }
+    std::sort(files_by_last_use.begin(), files_by_last_use.end());
+    for (const auto& [last_use, path] : files_by_last_use) {
+      boost::system::error_code file_ec;
+      const auto size = boost::filesystem::file_size(path, file_ec);
+      if (!file_ec) {
+        addEntry(path, size);
+      }
+    }
+  }
+
+  // Marks the object at `path` as the most recently used one.
+  void touch(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+      return;
+    }
+    lru_paths_.splice(lru_paths_.end(), lru_paths_, it->second.lru_it);
+    boost::system::error_code ec;
+    boost::filesystem::last_write_time(path, std::time(nullptr), ec);
+  }
+
+  // Reserves room for an object of `size` bytes stored at `path`, evicting the least
+  // recently used objects if needed. Returns false if the object is larger than the
+  // whole cache.
+  bool reserve(const std::string& path, const size_t size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (size > g_persistent_jit_cache_max_bytes) {
+      return false;
+    }
+    // the same module may have been compiled concurrently
+    removeEntry(path);
+    while (total_bytes_ + size > g_persistent_jit_cache_max_bytes) {
+      CHECK(!lru_paths_.empty());
+      const auto evicted_path = lru_paths_.front();
+      VLOG(1) << "Evicting JIT cache file " << evicted_path;
+      removeEntry(evicted_path);
+      boost::system::error_code ec;
+      boost::filesystem::remove(evicted_path, ec);
+    }
+    addEntry(path, size);
+    return true;
+  }
+
+  void release(const std::string& path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    removeEntry(path);
+  }
+
+ private:
+  struct Entry {
+    size_t size;
+    std::list<std::string>::iterator lru_it;
+  };
+
+  void addEntry(const std::string& path, const size_t size) {
+    lru_paths_.push_back(path);
+    entries_.emplace(path, Entry{size, std::prev(lru_paths_.end())});
+    total_bytes_ += size;
+  }
+
+  void removeEntry(const std::string& path) {
+    auto it = entries_.find(path);
+    if (it == entries_.end()) {
+      return;
+    }
+    CHECK_LE(it->second.size, total_bytes_);
+    total_bytes_ -= it->second.size;
+    lru_paths_.erase(it->second.lru_it);
+    entries_.erase(it);
+  }
+
+  const std::string cache_dir_;
+  std::mutex mutex_;
+  bool initialized_{false};
+  size_t total_bytes_{0};
+  // least recently used first
+  std::list<std::string> lru_paths_;
+  std::unordered_map<std::string, Entry> entries_;
+};
+
+// One index per cache directory, which only changes with the base path.
+CacheIndex& get_cache_index(const std::string& cache_dir) {
+  static std::mutex mutex;
+  static std::map<std::string, std::unique_ptr<CacheIndex>> cache_indexes;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& cache_index = cache_indexes[cache_dir];
+  if (!cache_index) {
+    cache_index = std::make_unique<CacheIndex>(cache_dir);
+  }
+  return *cache_index;
+}
+
+}  // namespace
+
+PersistentCodeCache::PersistentCodeCache(const CodeCacheKey& key,
+                                         const std::string& fingerprint)
+    : cache_dir_(getCacheDirectory()) {
+  std::ostringstream oss;
+  oss << fingerprint.size() << ':' << fingerprint;
+  for (const auto& key_part : key) {
+    oss << key_part.size() << ':' << key_part;
+  }
+  key_str_ = oss.str();
+  // files are grouped by fingerprint, to find the ones of other builds or CPUs
+  const auto file_prefix = to_hex(boost::hash_value(fingerprint)) + '_';
+  get_cache_index(cache_dir_).init(file_prefix);
+  file_path_ = (boost::filesystem::path(cache_dir_) /
+                (file_prefix + to_hex(boost::hash_value(key_str_)) + ".o"))
+                   .string();
+
+  std::ifstream cache_file(file_path_, std::ios::binary);
+  if (!cache_file) {
+    return;
+  }
+  const std::string contents{std::istreambuf_iterator<char>(cache_file),
+                             std::istreambuf_iterator<char>()};
+  if (contents.size() <= key_str_.size() ||
+      contents.compare(0, key_str_.size(), key_str_) != 0) {
+    VLOG(1) << "Ignoring JIT cache file " << file_path_ << " of another module";
+    return;
+  }
+  cached_object_ = llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(contents).substr(key_str_.size()), file_path_);
+  get_cache_index(cache_dir_).touch(file_path_);
+  VLOG(1) << "Loaded compiled query module from " << file_path_;
+}
+
+void PersistentCodeCache::notifyObjectCompiled(const llvm::Module* module,
+                                               llvm::MemoryBufferRef object) {
+  const auto file_size = key_str_.size() + object.getBufferSize();
+  if (!get_cache_index(cache_dir_).reserve(file_path_, file_size)) {
+    VLOG(1) << "Compiled query module too large for the JIT cache, not storing "
+            << file_path_;
+    return;
+  }
+  // write to a temporary file first, so that concurrent lookups never see a partial file
+  const auto tmp_path =
+      file_path_ + boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp").string();
+  {
+    std::ofstream tmp_file(tmp_path, std::ios::binary | std::ios::trunc);
+    tmp_file.write(key_str_.data(), key_str_.size());
+    tmp_file.write(object.getBufferStart(), object.getBufferSize());
+    if (!tmp_file) {
+      LOG(WARNING) << "Could not write JIT cache file " << tmp_path;
+      get_cache_index(cache_dir_).release(file_path_);
+      boost::system::error_code ec;
+      boost::filesystem::remove(tmp_path, ec);
+      return;
+    }
+  }
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmp_path, file_path_, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not store JIT cache file " << file_path_ << ": "
+                 << ec.message();
+    get_cache_index(cache_dir_).release(file_path_);
+    boost::filesystem::remove(tmp_path, ec);
+  }
+}
+
+std::unique_ptr<llvm::MemoryBuffer> PersistentCodeCache::getObject(
+    const llvm::Module* module) {
+  return std::move(cached_object_);
+}
+
+std::string PersistentCodeCache::getCacheDirectory() {
+  return (boost::filesystem::path(g_base_path) / "mapd_jit_cache").string();
+}
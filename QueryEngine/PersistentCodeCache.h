@@ -0,0 +1,68 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    PersistentCodeCache.h
+ * @brief   On-disk cache of the object code generated for CPU query modules.
+ *
+ * The in-memory CodeCache is lost on restart. This cache keeps the object file MCJIT
+ * emits for a query module under <base path>/mapd_jit_cache, keyed by the CodeCacheKey
+ * and a fingerprint of the runtime functions and the host CPU, so compiling the same
+ * query shape again skips the LLVM optimization and code generation passes. The cache
+ * is bounded by g_persistent_jit_cache_max_bytes with least recently used eviction, and
+ * the objects of other fingerprints are removed the first time the cache is used.
+ */
+
+#pragma once
+
+#include <llvm/ExecutionEngine/ObjectCache.h>
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <memory>
+#include <string>
+
+#include "Logger/Logger.h"
+#include "QueryEngine/CodeCache.h"
+
+extern bool g_enable_persistent_jit_cache;
+extern size_t g_persistent_jit_cache_max_bytes;
+
+// Object cache of a single module, given to the MCJIT engine compiling it. MCJIT asks
+// for the cached object before generating code and hands over the object it generated
+// on a miss.
+class PersistentCodeCache : public llvm::ObjectCache {
+ public:
+  PersistentCodeCache(const CodeCacheKey& key, const std::string& fingerprint);
+
+  // Whether an object was found on disk for the module, in which case there is no need
+  // to optimize it.
+  bool hasObject() const { return cached_object_ != nullptr; }
+
+  void notifyObjectCompiled(const llvm::Module* module,
+                            llvm::MemoryBufferRef object) override;
+
+  std::unique_ptr<llvm::MemoryBuffer> getObject(const llvm::Module* module) override;
+
+  static std::string getCacheDirectory();
+
+ private:
+  std::string cache_dir_;
+  // the fingerprint and the key are stored in front of the object, to tell hash
+  // collisions apart
+  std::string key_str_;
+  std::string file_path_;
+  std::unique_ptr<llvm::MemoryBuffer> cached_object_;
+};
@@ -16,21 +16,46 @@
 
 #pragma once
 
+#include <algorithm>
 #include <condition_variable>
 #include <future>
+#include <list>
 #include <mutex>
 #include <queue>
+#include <string>
 #include <thread>
+#include <unordered_map>
 
 /**
  * QueryDispatchQueue maintains a list of pending queries and dispatches those queries as
  * Executors become available
+ *
+ * Pending queries are kept in one FIFO per session and priority. Interactive queries are
+ * always dispatched before heavy ones, and within a priority sessions take turns so a
+ * session submitting many queries cannot starve the others. Heavy queries, as estimated
+ * by the caller from the size of the tables they scan, are admitted on at most all but
+ * one of the workers, which keeps an executor available for interactive queries. A
+ * pending heavy query ages: once max_heavy_task_bypasses interactive queries have been
+ * dispatched ahead of it, it goes next, so a steady stream of interactive queries cannot
+ * starve it.
  */
 class QueryDispatchQueue {
  public:
   using Task = std::packaged_task<void(size_t)>;
 
-  QueryDispatchQueue(const size_t parallel_executors_max) {
+  enum class Priority { kInteractive, kHeavy };
+
+  // Value initialized to an interactive task of the anonymous session.
+  struct TaskInfo {
+    std::string session_id;
+    Priority priority;
+  };
+
+  static constexpr size_t kDefaultMaxHeavyTaskBypasses{16};
+
+  QueryDispatchQueue(const size_t parallel_executors_max,
+                     const size_t max_heavy_task_bypasses = kDefaultMaxHeavyTaskBypasses)
+      : max_heavy_task_bypasses_(max_heavy_task_bypasses) {
     workers_.resize(parallel_executors_max);
     for (size_t i = 0; i < workers_.size(); i++) {
       // worker IDs are 1-indexed, leaving Executor 0 for non-dispatch queue worker tasks
@@ -38,6 +63,7 @@ class QueryDispatchQueue {
     }
     num_running_workers_ = 0;
     num_workers_ = parallel_executors_max;
+    max_running_heavy_workers_ = std::max(num_workers_ - 1, 1);
   }
 
   /**
@@ -45,7 +71,9 @@ class QueryDispatchQueue {
    * expected to maintain a copy of the shared_ptr which will be used to access results
    * once the task runs.
    */
-  void submit(std::shared_ptr<Task> task, const bool is_update_delete) {
+  void submit(std::shared_ptr<Task> task,
+              const bool is_update_delete,
+              const TaskInfo& task_info = {}) {
     if (workers_.size() == 1 && is_update_delete) {
       std::lock_guard<decltype(update_delete_mutex_)> update_delete_lock(
           update_delete_mutex_);
@@ -60,15 +88,20 @@ class QueryDispatchQueue {
     }
     std::unique_lock<decltype(queue_mutex_)> lock(queue_mutex_);
 
-    LOG(INFO) << "Dispatching query with " << queue_.size() << " queries in the queue.";
-    queue_.push(task);
+    LOG(INFO) << "Dispatching query with " << num_queued_tasks_
+              << " queries in the queue.";
+    getPendingTasks(task_info.priority).push(task_info.session_id, task);
+    ++num_queued_tasks_;
     lock.unlock();
     cv_.notify_all();
   }
 
-  bool hasIdleWorker() {
+  // Whether a task of the given priority would be picked up right away.
+  bool hasIdleWorker(const Priority priority = Priority::kInteractive) {
     std::lock_guard<decltype(queue_mutex_)> lock(queue_mutex_);
-    return num_running_workers_ < num_workers_;
+    return num_running_workers_ < num_workers_ &&
+           (priority == Priority::kInteractive ||
+            num_running_heavy_workers_ < max_running_heavy_workers_);
   }
 
   ~QueryDispatchQueue() {
@@ -83,31 +116,96 @@ class QueryDispatchQueue {
   }
 
  private:
+  // Pending tasks of one priority, served round robin across sessions.
+  class PendingTasks {
+   public:
+    bool empty() const { return sessions_.empty(); }
+
+    void push(const std::string& session_id, std::shared_ptr<Task> task) {
+      auto& session_tasks = tasks_by_session_[session_id];
+      if (session_tasks.empty()) {
+        sessions_.push_back(session_id);
+      }
+      session_tasks.push(task);
+    }
+
+    std::shared_ptr<Task> pop() {
+      CHECK(!empty());
+      const auto session_id = sessions_.front();
+      sessions_.pop_front();
+      auto session_tasks_it = tasks_by_session_.find(session_id);
+      CHECK(session_tasks_it != tasks_by_session_.end());
+      auto& session_tasks = session_tasks_it->second;
+      auto task = session_tasks.front();
+      session_tasks.pop();
+      if (session_tasks.empty()) {
+        tasks_by_session_.erase(session_tasks_it);
+      } else {
+        // the session goes back to the end of the line
+        sessions_.push_back(session_id);
+      }
+      return task;
+    }
+
+   private:
+    std::list<std::string> sessions_;
+    std::unordered_map<std::string, std::queue<std::shared_ptr<Task>>> tasks_by_session_;
+  };
+
+  PendingTasks& getPendingTasks(const Priority priority) {
+    return priority == Priority::kHeavy ? heavy_tasks_ : interactive_tasks_;
+  }
+
+  // Must be called under queue_mutex_.
+  bool canDispatchHeavyTask() const {
+    return !heavy_tasks_.empty() &&
+           num_running_heavy_workers_ < max_running_heavy_workers_;
+  }
+
   void worker(const size_t worker_idx) {
     std::unique_lock<std::mutex> lock(queue_mutex_);
     while (true) {
-      cv_.wait(lock, [this] { return !queue_.empty() || threads_should_exit_; });
+      cv_.wait(lock, [this] {
+        return !interactive_tasks_.empty() || canDispatchHeavyTask() ||
+               threads_should_exit_;
+      });
 
       if (threads_should_exit_) {
         return;
       }
 
-      if (!queue_.empty()) {
-        auto task = queue_.front();
-        queue_.pop();
-        ++num_running_workers_;
-
-        LOG(INFO) << "Worker " << worker_idx
-                  << " running query and returning control. There are now "
-                  << num_running_workers_ << " workers are running and " << queue_.size()
-                  << " queries in the queue.";
-        // allow other threads to pick up tasks
-        lock.unlock();
-        CHECK(task);
-        (*task)(worker_idx);
-        // wait for signal
-        lock.lock();
-        --num_running_workers_;
+      // interactive queries first unless a heavy one has waited too long, heavy ones are
+      // only picked up within their limit
+      const bool heavy_task_is_due =
+          num_heavy_task_bypasses_ >= max_heavy_task_bypasses_;
+      const bool is_heavy =
+          canDispatchHeavyTask() && (interactive_tasks_.empty() || heavy_task_is_due);
+      auto task = getPendingTasks(is_heavy ? Priority::kHeavy : Priority::kInteractive)
+                      .pop();
+      --num_queued_tasks_;
+      ++num_running_workers_;
+      if (is_heavy) {
+        ++num_running_heavy_workers_;
+        num_heavy_task_bypasses_ = 0;
+      } else if (!heavy_tasks_.empty()) {
+        ++num_heavy_task_bypasses_;
+      }
+
+      LOG(INFO) << "Worker " << worker_idx << " running " << (is_heavy ? "heavy " : "")
+                << "query and returning control. There are now " << num_running_workers_
+                << " workers are running and " << num_queued_tasks_
+                << " queries in the queue.";
+      // allow other threads to pick up tasks
+      lock.unlock();
+      CHECK(task);
+      (*task)(worker_idx);
+      // wait for signal
+      lock.lock();
+      --num_running_workers_;
+      if (is_heavy) {
+        --num_running_heavy_workers_;
+        // an idle worker may have been held back by the heavy query limit
+        cv_.notify_all();
       }
     }
   }
@@ -118,8 +216,15 @@ class QueryDispatchQueue {
   std::mutex update_delete_mutex_;
 
   bool threads_should_exit_{false};
-  std::queue<std::shared_ptr<Task>> queue_;
+  PendingTasks interactive_tasks_;
+  PendingTasks heavy_tasks_;
+  size_t num_queued_tasks_{0};
   std::vector<std::thread> workers_;
   int num_running_workers_;  // manipulate this under queue_lock
+  int num_running_heavy_workers_{0};
   int num_workers_;
+  int max_running_heavy_workers_;
+  // interactive tasks dispatched while a heavy task was pending
+  size_t num_heavy_task_bypasses_{0};
+  const size_t max_heavy_task_bypasses_;
 };
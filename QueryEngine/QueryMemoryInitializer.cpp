@@ -33,6 +33,11 @@ int64_t g_bitmap_memory_limit{8LL * 1000 * 1000 * 1000};
 
 namespace {
 
+// markers of the count distinct sets to allocate for each group slot, in place of the
+// bitmap size returned by allocateCountDistinctBuffers
+constexpr int64_t kDeferredCountDistinctStdSet{-1};
+constexpr int64_t kDeferredCountDistinctHashSet{-2};
+
 inline void check_total_bitmap_memory(const QueryMemoryDescriptor& query_mem_desc) {
   const int32_t groups_buffer_entry_count = query_mem_desc.getEntryCount();
   checked_int64_t total_bytes_per_group = 0;
@@ -695,8 +700,13 @@ void QueryMemoryInitializer::initColumnsPerRow(
       // COUNT DISTINCT / APPROX_COUNT_DISTINCT
       CHECK_EQ(static_cast<size_t>(query_mem_desc.getPaddedSlotWidthBytes(col_idx)),
                sizeof(int64_t));
-      init_val =
-          bm_sz > 0 ? allocateCountDistinctBitmap(bm_sz) : allocateCountDistinctSet();
+      if (bm_sz > 0) {
+        init_val = allocateCountDistinctBitmap(bm_sz);
+      } else {
+        init_val = allocateCountDistinctSet(bm_sz == kDeferredCountDistinctHashSet
+                                                ? CountDistinctImplType::HashSet
+                                                : CountDistinctImplType::StdSet);
+      }
       ++init_vec_idx;
     } else if (query_mem_desc.isGroupBy() && quantile_params[col_idx]) {
       auto const q = *quantile_params[col_idx];
@@ -795,11 +805,16 @@ std::vector<int64_t> QueryMemoryInitializer::allocateCountDistinctBuffers(
           init_agg_vals_[agg_col_idx] = allocateCountDistinctBitmap(bitmap_byte_sz);
         }
       } else {
-        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet);
+        CHECK(count_distinct_desc.impl_type_ == CountDistinctImplType::StdSet ||
+              count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet);
         if (deferred) {
-          agg_bitmap_size[agg_col_idx] = -1;
+          agg_bitmap_size[agg_col_idx] =
+              count_distinct_desc.impl_type_ == CountDistinctImplType::HashSet
+                  ? kDeferredCountDistinctHashSet
+                  : kDeferredCountDistinctStdSet;
         } else {
-          init_agg_vals_[agg_col_idx] = allocateCountDistinctSet();
+          init_agg_vals_[agg_col_idx] =
+              allocateCountDistinctSet(count_distinct_desc.impl_type_);
         }
       }
     }
@@ -821,7 +836,14 @@ int64_t QueryMemoryInitializer::allocateCountDistinctBitmap(const size_t bitmap_
       row_set_mem_owner_->allocateCountDistinctBuffer(bitmap_byte_sz, thread_idx_));
 }
 
-int64_t QueryMemoryInitializer::allocateCountDistinctSet() {
+int64_t QueryMemoryInitializer::allocateCountDistinctSet(
+    const CountDistinctImplType impl_type) {
+  if (impl_type == CountDistinctImplType::HashSet) {
+    auto count_distinct_set = new CountDistinctHashSet();
+    row_set_mem_owner_->addCountDistinctHashSet(count_distinct_set);
+    return reinterpret_cast<int64_t>(count_distinct_set);
+  }
+  CHECK(impl_type == CountDistinctImplType::StdSet);
   auto count_distinct_set = new std::set<int64_t>();
   row_set_mem_owner_->addCountDistinctSet(count_distinct_set);
   return reinterpret_cast<int64_t>(count_distinct_set);
@@ -171,7 +171,7 @@ class QueryMemoryInitializer {
 
   int64_t allocateCountDistinctBitmap(const size_t bitmap_byte_sz);
 
-  int64_t allocateCountDistinctSet();
+  int64_t allocateCountDistinctSet(const CountDistinctImplType impl_type);
 
   std::vector<QuantileParam> allocateTDigests(const QueryMemoryDescriptor& query_mem_desc,
                                               const bool deferred,
@@ -3004,6 +3004,35 @@ inline bool can_use_bump_allocator(const RelAlgExecutionUnit& ra_exe_unit,
          !eo.output_columnar_hint && ra_exe_unit.sort_info.order_entries.empty();
 }
 
+// Work units depending on the current time (NOW, CURRENT_DATE, ...) or on the session
+// have no query plan DAG (see QueryPlanDagChecker), so their results aren't cached.
+bool can_use_resultset_cache(const RelAlgExecutionUnit& ra_exe_unit,
+                             const ExecutionOptions& eo,
+                             const RenderInfo* render_info) {
+  return g_enable_data_recycler && g_use_query_resultset_cache &&
+         ra_exe_unit.query_plan_dag != EMPTY_QUERY_PLAN && !ra_exe_unit.estimator &&
+         !eo.just_explain && !eo.just_validate && !eo.just_calcite_explain &&
+         eo.executor_type == ::ExecutorType::Native && !render_info &&
+         !is_window_execution_unit(ra_exe_unit);
+}
+
+// The plan DAG of a sort's input doesn't cover the limit and the ordering pushed down
+// to it, and DAG node ids are reassigned when the DAG cache fills up, so the key also
+// includes those and the hash of the work unit's body.
+QueryPlanHash get_resultset_cache_key(const RelAlgExecutionUnit& ra_exe_unit,
+                                      const RelAlgNode* body) {
+  auto key = boost::hash_value(ra_exe_unit.query_plan_dag);
+  boost::hash_combine(key, body->toHash());
+  boost::hash_combine(key, ra_exe_unit.scan_limit);
+  boost::hash_combine(key, ra_exe_unit.sort_info.limit);
+  boost::hash_combine(key, ra_exe_unit.sort_info.offset);
+  boost::hash_combine(key, static_cast<int>(ra_exe_unit.sort_info.algorithm));
+  for (const auto& order_entry : ra_exe_unit.sort_info.order_entries) {
+    boost::hash_combine(key, order_entry.toString());
+  }
+  return key;
+}
+
 }  // namespace
 
 ExecutionResult RelAlgExecutor::executeWorkUnit(
@@ -3057,6 +3086,29 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
   }
   const auto table_infos = get_table_infos(work_unit.exe_unit, executor_);
 
+  QueryPlanHash resultset_cache_key{EMPTY_HASHED_PLAN_DAG_KEY};
+  std::optional<ResultSetMetaInfo> resultset_meta_info;
+  if (can_use_resultset_cache(work_unit.exe_unit, eo, render_info)) {
+    resultset_meta_info = ResultSetRecycler::getResultSetMetaInfo(table_infos, cat_);
+    if (resultset_meta_info) {
+      resultset_cache_key = get_resultset_cache_key(work_unit.exe_unit, body);
+      auto resultset_recycler = ResultSetRecyclerHolder::getResultSetRecycler();
+      auto cached_rows =
+          resultset_recycler->getItemFromCache(resultset_cache_key,
+                                               CacheItemType::ROW_RS,
+                                               DataRecyclerUtil::CPU_DEVICE_IDENTIFIER,
+                                               resultset_meta_info);
+      if (cached_rows) {
+        executor_->addTransientStringLiterals(work_unit.exe_unit,
+                                              executor_->row_set_mem_owner_);
+        ExecutionResult result(cached_rows, targets_meta);
+        result.setQueueTime(queue_time_ms);
+        return result;
+      }
+    }
+  }
+  auto compute_clock_begin = timer_start();
+
   auto ra_exe_unit = decide_approx_count_distinct_implementation(
       work_unit.exe_unit, table_infos, executor_, co.device_type, target_exprs_owned_);
 
@@ -3138,13 +3190,24 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     }
   };
 
-  auto cache_key = ra_exec_unit_desc_for_caching(ra_exe_unit);
+  auto estimation_recycler = EstimationRecyclerHolder::getEstimationRecycler();
+  const auto estimation_meta_info =
+      EstimationRecycler::getEstimationMetaInfo(table_infos, cat_);
+  const auto estimation_cache_key =
+      estimation_meta_info ? EstimationRecycler::getEstimationCacheKey(ra_exe_unit)
+                           : EMPTY_HASHED_PLAN_DAG_KEY;
+  auto get_cached_cardinality = [&]() {
+    return estimation_recycler->getItemFromCache(estimation_cache_key,
+                                                 CacheItemType::NDV_CARD_EST,
+                                                 ESTIMATION_CACHE_DEVICE_IDENTIFIER,
+                                                 estimation_meta_info);
+  };
   try {
-    auto cached_cardinality = executor_->getCachedCardinality(cache_key);
-    auto card = cached_cardinality.second;
-    if (cached_cardinality.first && card >= 0) {
-      result = execute_and_handle_errors(
-          card, /*has_cardinality_estimation=*/true, /*has_ndv_estimation=*/false);
+    const auto cached_cardinality = get_cached_cardinality();
+    if (cached_cardinality) {
+      result = execute_and_handle_errors(*cached_cardinality,
+                                         /*has_cardinality_estimation=*/true,
+                                         /*has_ndv_estimation=*/false);
     } else {
       result = execute_and_handle_errors(
           max_groups_buffer_entry_guess,
@@ -3153,11 +3216,12 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
     }
   } catch (const CardinalityEstimationRequired& e) {
     // check the cardinality cache
-    auto cached_cardinality = executor_->getCachedCardinality(cache_key);
-    auto card = cached_cardinality.second;
-    if (cached_cardinality.first && card >= 0) {
-      result = execute_and_handle_errors(card, true, /*has_ndv_estimation=*/true);
+    const auto cached_cardinality = get_cached_cardinality();
+    if (cached_cardinality) {
+      result = execute_and_handle_errors(
+          *cached_cardinality, true, /*has_ndv_estimation=*/true);
     } else {
+      auto ndv_clock_begin = timer_start();
       const auto ndv_groups_estimation =
           getNDVEstimation(work_unit, e.range(), is_agg, co, eo);
       const auto estimated_groups_buffer_entry_guess =
@@ -3165,15 +3229,35 @@ ExecutionResult RelAlgExecutor::executeWorkUnit(
                                     : std::min(groups_approx_upper_bound(table_infos),
                                                g_estimator_failure_max_groupby_size);
       CHECK_GT(estimated_groups_buffer_entry_guess, size_t(0));
+      const auto ndv_estimation_time = timer_stop(ndv_clock_begin);
       result = execute_and_handle_errors(
           estimated_groups_buffer_entry_guess, true, /*has_ndv_estimation=*/true);
       if (!(eo.just_validate || eo.just_explain)) {
-        executor_->addToCardinalityCache(cache_key, estimated_groups_buffer_entry_guess);
+        estimation_recycler->putItemToCache(estimation_cache_key,
+                                            estimated_groups_buffer_entry_guess,
+                                            CacheItemType::NDV_CARD_EST,
+                                            ESTIMATION_CACHE_DEVICE_IDENTIFIER,
+                                            sizeof(size_t),
+                                            ndv_estimation_time,
+                                            estimation_meta_info);
       }
     }
   }
 
   result.setQueueTime(queue_time_ms);
+  if (resultset_cache_key != EMPTY_HASHED_PLAN_DAG_KEY) {
+    const auto& rows = result.getRows();
+    if (rows && ResultSetRecycler::isCacheableResultSet(*rows)) {
+      ResultSetRecyclerHolder::getResultSetRecycler()->putItemToCache(
+          resultset_cache_key,
+          rows,
+          CacheItemType::ROW_RS,
+          DataRecyclerUtil::CPU_DEVICE_IDENTIFIER,
+          rows->getStorageSizeBytes(),
+          timer_stop(compute_clock_begin),
+          resultset_meta_info);
+    }
+  }
   if (render_info) {
     build_render_targets(*render_info, work_unit.exe_unit.target_exprs, targets_meta);
     if (render_info->isPotentialInSituRender()) {
@@ -3202,6 +3286,8 @@ std::optional<size_t> RelAlgExecutor::getFilteredCountAll(const WorkUnit& work_u
                                   nullptr);
   const auto count_all_exe_unit =
       create_count_all_execution_unit(work_unit.exe_unit, count);
+  // not recycled: the count becomes the scan limit of the projection, which must hold
+  // every row passing the filters
   size_t one{1};
   TemporaryTable count_all_result;
   try {
@@ -21,13 +21,16 @@
  */
 
 #include "ResultSet.h"
+#include "Catalog/SysCatalog.h"
 #include "DataMgr/Allocators/CudaAllocator.h"
 #include "DataMgr/BufferMgr/BufferMgr.h"
 #include "Execute.h"
 #include "GpuMemUtils.h"
 #include "InPlaceSort.h"
+#include "NormalizedKeySort.h"
 #include "OutputBufferInitialization.h"
 #include "RuntimeFunctions.h"
+#include "SortedRunMerger.h"
 #include "Shared/Intervals.h"
 #include "Shared/SqlTypesLayout.h"
 #include "Shared/checked_alloc.h"
@@ -39,14 +42,30 @@
 #include "tbb/parallel_sort.h"
 #endif
 
+#include <boost/filesystem.hpp>
+
 #include <algorithm>
 #include <atomic>
 #include <bitset>
 #include <future>
 #include <numeric>
+#include <unordered_set>
 
 size_t g_parallel_top_min = 100e3;
 size_t g_parallel_top_max = 20e6;  // In effect only with g_enable_watchdog.
+bool g_enable_normalized_key_sort{true};
+size_t g_normalized_key_sort_parallel_min{20000};
+bool g_enable_external_sort{true};
+size_t g_external_sort_threshold{std::numeric_limits<uint32_t>::max()};
+size_t g_external_sort_run_size{size_t(1) << 25};
+size_t g_external_sort_merge_buffer_bytes{size_t(64) << 20};
+
+namespace {
+
+// Subdirectory of the data directory receiving the runs of external sorts.
+const std::string kExternalSortSpillDir{"omnisci_sort_spill"};
+
+}  // namespace
 
 void ResultSet::keepFirstN(const size_t n) {
   CHECK_EQ(-1, cached_row_count_);
@@ -272,6 +291,241 @@ void ResultSet::append(ResultSet& that) {
   }
 }
 
+bool ResultSet::isSelfContained() const {
+  if (!storage_ || estimator_ || just_explain_ || for_validation_only_) {
+    return false;
+  }
+  if (separate_varlen_storage_valid_ || !chunks_.empty() || !chunk_iters_.empty()) {
+    return false;
+  }
+  for (const auto& col_lazy_fetch : lazy_fetch_info_) {
+    if (col_lazy_fetch.is_lazily_fetched) {
+      return false;
+    }
+  }
+  if (!permutation_.empty() || drop_first_ || keep_first_) {
+    return false;
+  }
+  for (const auto& target : targets_) {
+    // t-digests live in the row set memory owner and can't be copied
+    if (target.agg_kind == kAPPROX_QUANTILE) {
+      return false;
+    }
+    if (is_distinct_target(target) && query_mem_desc_.getWarpCount() != 1) {
+      return false;
+    }
+  }
+  const auto copyable_storage = [](const ResultSetStorage& storage) {
+    return !storage.varlen_output_info_ &&
+           !storage.query_mem_desc_.useStreamingTopN();
+  };
+  if (!copyable_storage(*storage_)) {
+    return false;
+  }
+  return std::all_of(appended_storage_.begin(),
+                     appended_storage_.end(),
+                     [&copyable_storage](const auto& storage) {
+                       return storage && copyable_storage(*storage);
+                     });
+}
+
+namespace {
+
+// Calls `func` with the address of the count distinct slot of every entry of `buff`, laid
+// out as described by `query_mem_desc`, and the descriptor of its target.
+template <typename FUNC>
+void for_each_count_distinct_slot(const std::vector<TargetInfo>& targets,
+                                  const std::vector<size_t>& slot_indices,
+                                  const QueryMemoryDescriptor& query_mem_desc,
+                                  int8_t* buff,
+                                  FUNC func) {
+  for (size_t target_idx = 0; target_idx < targets.size(); ++target_idx) {
+    if (!is_distinct_target(targets[target_idx])) {
+      continue;
+    }
+    CHECK_EQ(query_mem_desc.getWarpCount(), size_t(1));
+    const auto slot_idx = slot_indices[target_idx];
+    CHECK_EQ(query_mem_desc.getPaddedSlotWidthBytes(slot_idx), sizeof(int64_t));
+    const auto& count_distinct_desc =
+        query_mem_desc.getCountDistinctDescriptor(target_idx);
+    const auto col_off = query_mem_desc.getColOffInBytes(slot_idx);
+    const auto entry_bytes = query_mem_desc.didOutputColumnar()
+                                 ? sizeof(int64_t)
+                                 : query_mem_desc.getRowSize();
+    for (size_t entry_idx = 0; entry_idx < query_mem_desc.getEntryCount(); ++entry_idx) {
+      const auto slot_ptr = buff + col_off + entry_idx * entry_bytes;
+      func(reinterpret_cast<int64_t*>(slot_ptr), count_distinct_desc);
+    }
+  }
+}
+
+size_t count_distinct_bitmap_bytes(const CountDistinctDescriptor& count_distinct_desc) {
+  return count_distinct_desc.sub_bitmap_count == 1
+             ? count_distinct_desc.bitmapSizeBytes()
+             : count_distinct_desc.bitmapPaddedSizeBytes();
+}
+
+// Approximate, the sets are only charged for their values and not the bookkeeping.
+size_t count_distinct_set_bytes(const int64_t set_handle,
+                                const CountDistinctDescriptor& count_distinct_desc) {
+  if (!set_handle) {
+    return 0;
+  }
+  if (count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap) {
+    return count_distinct_bitmap_bytes(count_distinct_desc);
+  }
+  return count_distinct_set_size(set_handle, count_distinct_desc) * sizeof(int64_t);
+}
+
+int64_t copy_count_distinct_set(const int64_t set_handle,
+                                const CountDistinctDescriptor& count_distinct_desc,
+                                RowSetMemoryOwner& row_set_mem_owner) {
+  if (!set_handle) {
+    return 0;
+  }
+  switch (count_distinct_desc.impl_type_) {
+    case CountDistinctImplType::Bitmap: {
+      const auto bitmap_byte_sz = count_distinct_bitmap_bytes(count_distinct_desc);
+      auto bitmap = row_set_mem_owner.allocateCountDistinctBuffer(bitmap_byte_sz);
+      memcpy(bitmap, reinterpret_cast<const int8_t*>(set_handle), bitmap_byte_sz);
+      return reinterpret_cast<int64_t>(bitmap);
+    }
+    case CountDistinctImplType::HashSet: {
+      auto set = new CountDistinctHashSet(
+          *reinterpret_cast<const CountDistinctHashSet*>(set_handle));
+      row_set_mem_owner.addCountDistinctHashSet(set);
+      return reinterpret_cast<int64_t>(set);
+    }
+    case CountDistinctImplType::StdSet: {
+      auto set =
+          new std::set<int64_t>(*reinterpret_cast<const std::set<int64_t>*>(set_handle));
+      row_set_mem_owner.addCountDistinctSet(set);
+      return reinterpret_cast<int64_t>(set);
+    }
+    default:
+      UNREACHABLE();
+  }
+  return 0;
+}
+
+}  // namespace
+
+std::shared_ptr<ResultSet> ResultSet::copy() const {
+  CHECK(isSelfContained());
+  std::vector<const ResultSetStorage*> storages{storage_.get()};
+  for (const auto& storage : appended_storage_) {
+    storages.push_back(storage.get());
+  }
+  const auto slot_indices = getSlotIndicesForTargetIndices();
+  // GPU results keep device pointers in the count distinct slots and map them to the
+  // host sets, the copy maps them to its own copies instead.
+  const auto get_set_handle = [](const ResultSetStorage& storage, const int64_t slot) {
+    return storage.count_distinct_sets_mapping_.empty() ? slot : storage.mappedPtr(slot);
+  };
+  // Size the arena to the bitmaps, the default block size is meant for whole queries.
+  size_t bitmap_bytes{0};
+  for (const auto storage : storages) {
+    for_each_count_distinct_slot(
+        targets_,
+        slot_indices,
+        storage->query_mem_desc_,
+        storage->getUnderlyingBuffer(),
+        [&](const int64_t* slot, const CountDistinctDescriptor& count_distinct_desc) {
+          if (count_distinct_desc.impl_type_ == CountDistinctImplType::Bitmap &&
+              get_set_handle(*storage, *slot)) {
+            bitmap_bytes += count_distinct_bitmap_bytes(count_distinct_desc);
+          }
+        });
+  }
+  auto row_set_mem_owner = row_set_mem_owner_->cloneStrDictDataOnly(
+      std::max(bitmap_bytes + kArenaBlockOverhead, size_t(4096)));
+  row_set_mem_owner->setDictionaryGenerations(
+      row_set_mem_owner_->getStringDictionaryGenerations());
+  auto result = std::make_shared<ResultSet>(targets_,
+                                            device_type_,
+                                            query_mem_desc_,
+                                            row_set_mem_owner,
+                                            catalog_,
+                                            block_size_,
+                                            grid_size_);
+  // a set is copied once, however many slots point to it
+  std::unordered_map<int64_t, int64_t> set_copies;
+  const auto copy_set = [&](const int64_t set_handle,
+                            const CountDistinctDescriptor& count_distinct_desc) {
+    auto it = set_copies.find(set_handle);
+    if (it == set_copies.end()) {
+      it = set_copies
+               .emplace(set_handle,
+                        copy_count_distinct_set(
+                            set_handle, count_distinct_desc, *row_set_mem_owner))
+               .first;
+    }
+    return it->second;
+  };
+  const auto copy_storage = [&](const ResultSetStorage& storage) {
+    const auto buff_size = storage.query_mem_desc_.getBufferSizeBytes(device_type_);
+    auto buff = static_cast<int8_t*>(checked_malloc(buff_size));
+    memcpy(buff, storage.getUnderlyingBuffer(), buff_size);
+    std::unique_ptr<ResultSetStorage> storage_copy(new ResultSetStorage(
+        targets_, storage.query_mem_desc_, buff, /*buff_is_provided=*/false));
+    storage_copy->target_init_vals_ = storage.target_init_vals_;
+    for_each_count_distinct_slot(
+        targets_,
+        slot_indices,
+        storage.query_mem_desc_,
+        buff,
+        [&](int64_t* slot, const CountDistinctDescriptor& count_distinct_desc) {
+          if (storage.count_distinct_sets_mapping_.empty()) {
+            *slot = copy_set(*slot, count_distinct_desc);
+          } else if (const auto set_handle = storage.mappedPtr(*slot)) {
+            storage_copy->count_distinct_sets_mapping_[*slot] =
+                copy_set(set_handle, count_distinct_desc);
+          }
+        });
+    return storage_copy;
+  };
+  result->storage_ = copy_storage(*storage_);
+  for (const auto& storage : appended_storage_) {
+    result->appended_storage_.push_back(copy_storage(*storage));
+  }
+  result->literal_buffers_ = literal_buffers_;
+  result->outer_table_id_ = outer_table_id_;
+  result->geo_return_type_ = geo_return_type_;
+  result->cached_row_count_ = cached_row_count_.load();
+  return result;
+}
+
+size_t ResultSet::getStorageSizeBytes() const {
+  size_t size_bytes{0};
+  const auto slot_indices = getSlotIndicesForTargetIndices();
+  std::unordered_set<int64_t> counted_sets;
+  const auto add_storage = [&](const ResultSetStorage& storage) {
+    size_bytes += storage.query_mem_desc_.getBufferSizeBytes(device_type_);
+    for_each_count_distinct_slot(
+        targets_,
+        slot_indices,
+        storage.query_mem_desc_,
+        storage.getUnderlyingBuffer(),
+        [&](const int64_t* slot, const CountDistinctDescriptor& count_distinct_desc) {
+          const auto set_handle = storage.count_distinct_sets_mapping_.empty()
+                                      ? *slot
+                                      : storage.mappedPtr(*slot);
+          if (counted_sets.insert(set_handle).second) {
+            size_bytes += count_distinct_set_bytes(set_handle, count_distinct_desc);
+          }
+        });
+  };
+  if (storage_) {
+    add_storage(*storage_);
+  }
+  for (const auto& storage : appended_storage_) {
+    if (storage) {
+      add_storage(*storage);
+    }
+  }
+  return size_bytes;
+}
+
 const ResultSetStorage* ResultSet::getStorage() const {
   return storage_.get();
 }
@@ -534,12 +788,23 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     }
     return;
   }
-  // This check isn't strictly required, but allows the index buffer to be 32-bit.
-  if (query_mem_desc_.getEntryCount() > std::numeric_limits<uint32_t>::max()) {
-    throw RowSortException("Sorting more than 4B elements not supported");
-  }
-
   CHECK(permutation_.empty());
+  CHECK(!external_sort_rows_);
+
+  // The in-memory sort keeps 32-bit indexes into the result set buffer; larger result
+  // sets (or ones above the configured threshold) are sorted in runs spilled to disk
+  // when possible, and in memory otherwise.
+  const bool exceeds_permutation = entryCount() > std::numeric_limits<uint32_t>::max();
+  if (exceeds_permutation || entryCount() > g_external_sort_threshold) {
+    if (canUseExternalSort(order_entries, executor)) {
+      externalSort<RowWiseTargetAccessor>(order_entries, top_n, executor);
+      return;
+    }
+    if (exceeds_permutation) {
+      throw RowSortException("Sorting more than 4B elements not supported");
+    }
+    VLOG(1) << "Cannot sort the result set externally, sorting it in memory";
+  }
 
   if (top_n && g_parallel_top_min < entryCount()) {
     if (g_enable_watchdog && g_parallel_top_max < entryCount()) {
@@ -557,8 +822,20 @@ void ResultSet::sort(const std::list<Analyzer::OrderEntry>& order_entries,
     if (top_n == 0) {
       top_n = pv.size();  // top_n == 0 implies a full sort
     }
-    pv = topPermutation(
-        pv, top_n, createComparator(order_entries, pv, executor, false), false);
+    // A LIMIT below the row count is cheaper to serve with the heap of topPermutation()
+    // than with a full radix sort.
+    if (g_enable_normalized_key_sort && top_n >= pv.size() &&
+        canUseNormalizedKeySort(order_entries, executor)) {
+      const bool single_threaded = pv.size() < g_normalized_key_sort_parallel_min;
+      pv = query_mem_desc_.didOutputColumnar()
+               ? normalizedKeySort<ColumnWiseTargetAccessor>(
+                     pv, top_n, order_entries, executor, single_threaded)
+               : normalizedKeySort<RowWiseTargetAccessor>(
+                     pv, top_n, order_entries, executor, single_threaded);
+    } else {
+      pv = topPermutation(
+          pv, top_n, createComparator(order_entries, pv, executor, false), false);
+    }
     if (pv.size() < permutation_.size()) {
       permutation_.resize(pv.size());
       permutation_.shrink_to_fit();
@@ -960,6 +1237,453 @@ PermutationView ResultSet::topPermutation(PermutationView permutation,
   return permutation;
 }
 
+bool ResultSet::canUseNormalizedKeySort(
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    const Executor* executor) const {
+  for (const auto& order_entry : order_entries) {
+    CHECK_GE(order_entry.tle_no, 1);
+    const auto& agg_info = targets_[order_entry.tle_no - 1];
+    if (is_distinct_target(agg_info) || agg_info.agg_kind == kAPPROX_QUANTILE) {
+      continue;
+    }
+    const auto entry_ti = get_compact_type(agg_info);
+    if (entry_ti.is_string()) {
+      // None-encoded strings have no fixed-width representation.
+      if (entry_ti.get_compression() != kENCODING_DICT || !executor) {
+        return false;
+      }
+    } else if (entry_ti.is_array() || entry_ti.is_geometry()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ResultSet::canUseExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                                   const Executor* executor) const {
+  if (!g_enable_external_sort || query_mem_desc_.didOutputColumnar() ||
+      query_mem_desc_.hasKeylessHash() || separate_varlen_storage_valid_) {
+    return false;
+  }
+  switch (query_mem_desc_.getQueryDescriptionType()) {
+    case QueryDescriptionType::Projection:
+    case QueryDescriptionType::GroupByPerfectHash:
+    case QueryDescriptionType::GroupByBaselineHash:
+      break;
+    default:
+      return false;
+  }
+  // The sorted rows end up in a single storage, while lazily fetched columns are looked
+  // up by the index of the storage holding the row.
+  const bool has_lazy_fetch = std::any_of(
+      lazy_fetch_info_.begin(), lazy_fetch_info_.end(), [](const auto& col_lazy_fetch) {
+        return col_lazy_fetch.is_lazily_fetched;
+      });
+  if (has_lazy_fetch && !appended_storage_.empty()) {
+    return false;
+  }
+  const auto sortable_storage = [](const ResultSetStorage& storage) {
+    return !storage.varlen_output_info_ && !storage.query_mem_desc_.useStreamingTopN();
+  };
+  if (!sortable_storage(*storage_) ||
+      !std::all_of(appended_storage_.begin(),
+                   appended_storage_.end(),
+                   [&sortable_storage](const auto& storage) {
+                     return storage && sortable_storage(*storage);
+                   })) {
+    return false;
+  }
+  return canUseNormalizedKeySort(order_entries, executor);
+}
+
+std::vector<ResultSet::NormalizedKeyColumn> ResultSet::makeNormalizedKeyColumns(
+    const std::list<Analyzer::OrderEntry>& order_entries) const {
+  std::vector<NormalizedKeyColumn> key_columns;
+  for (const auto& order_entry : order_entries) {
+    const size_t target_idx = order_entry.tle_no - 1;
+    const auto& agg_info = targets_[target_idx];
+    const auto entry_ti = get_compact_type(agg_info);
+    bool float_argument_input = takes_float_argument(agg_info);
+    // Same float storage detection as ResultSetComparator::operator().
+    if (entry_ti.get_type() == kFLOAT) {
+      const auto is_col_lazy = !lazy_fetch_info_.empty() &&
+                               lazy_fetch_info_[target_idx].is_lazily_fetched;
+      if (query_mem_desc_.getPaddedSlotWidthBytes(target_idx) == sizeof(float)) {
+        float_argument_input = query_mem_desc_.didOutputColumnar() ? !is_col_lazy : true;
+      }
+    }
+    NormalizedKeyColumn::Kind kind;
+    bool nullable = !entry_ti.get_notnull();
+    size_t value_width = sizeof(int64_t);
+    if (is_distinct_target(agg_info)) {
+      kind = NormalizedKeyColumn::Kind::CountDistinct;
+      nullable = false;
+    } else if (agg_info.agg_kind == kAPPROX_QUANTILE) {
+      kind = NormalizedKeyColumn::Kind::ApproxQuantile;
+    } else if (agg_info.is_agg && agg_info.agg_kind == kAVG) {
+      kind = NormalizedKeyColumn::Kind::Average;
+    } else if (entry_ti.is_string()) {
+      CHECK_EQ(kENCODING_DICT, entry_ti.get_compression());
+      kind = NormalizedKeyColumn::Kind::DictionaryRank;
+      value_width = sizeof(uint32_t);
+    } else if (entry_ti.is_fp()) {
+      kind = NormalizedKeyColumn::Kind::FloatingPoint;
+    } else {
+      kind = NormalizedKeyColumn::Kind::Integer;
+    }
+    key_columns.push_back(NormalizedKeyColumn{kind,
+                                              target_idx,
+                                              entry_ti,
+                                              float_argument_input,
+                                              order_entry.is_desc,
+                                              order_entry.nulls_first,
+                                              nullable,
+                                              value_width,
+                                              {}});
+  }
+  return key_columns;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::unordered_map<int32_t, uint32_t> ResultSet::rankDictionaryStrings(
+    const BUFFER_ITERATOR_TYPE& buffer_itr,
+    const NormalizedKeyColumn& key_column,
+    const Executor* executor) const {
+  CHECK(executor);
+  std::vector<int32_t> string_ids;
+  for (size_t entry_idx = 0; entry_idx < query_mem_desc_.getEntryCount(); ++entry_idx) {
+    const auto storage_lookup_result = findStorage(entry_idx);
+    const auto storage = storage_lookup_result.storage_ptr;
+    const auto off = storage_lookup_result.fixedup_entry_idx;
+    if (storage->isEmptyEntry(off)) {
+      continue;
+    }
+    const auto value = buffer_itr.getColumnInternal(
+        storage->buff_, off, key_column.target_idx, storage_lookup_result);
+    if (!isNull(key_column.entry_ti, value, key_column.float_argument_input)) {
+      string_ids.push_back(static_cast<int32_t>(value.i1));
+    }
+  }
+  std::sort(string_ids.begin(), string_ids.end());
+  string_ids.erase(std::unique(string_ids.begin(), string_ids.end()), string_ids.end());
+
+  const auto string_dict_proxy = executor->getStringDictionaryProxy(
+      key_column.entry_ti.get_comp_param(), row_set_mem_owner_, false);
+  std::vector<std::string> strings;
+  strings.reserve(string_ids.size());
+  for (const auto string_id : string_ids) {
+    strings.push_back(string_dict_proxy->getString(string_id));
+  }
+  std::vector<uint32_t> order(string_ids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(),
+            order.end(),
+            [&strings](const uint32_t lhs, const uint32_t rhs) {
+              return strings[lhs] < strings[rhs];
+            });
+
+  // Equal strings (e.g. transient ids aliasing persisted ones) share a rank.
+  std::unordered_map<int32_t, uint32_t> string_ranks;
+  string_ranks.reserve(order.size());
+  uint32_t rank{0};
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i && strings[order[i]] != strings[order[i - 1]]) {
+      ++rank;
+    }
+    string_ranks.emplace(string_ids[order[i]], rank);
+  }
+  return string_ranks;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+std::vector<ResultSet::NormalizedKeyColumn> ResultSet::makeRankedNormalizedKeyColumns(
+    const BUFFER_ITERATOR_TYPE& buffer_itr,
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    const Executor* executor) const {
+  auto key_columns = makeNormalizedKeyColumns(order_entries);
+  for (auto& key_column : key_columns) {
+    if (key_column.kind == NormalizedKeyColumn::Kind::DictionaryRank) {
+      key_column.string_ranks = rankDictionaryStrings(buffer_itr, key_column, executor);
+    }
+  }
+  return key_columns;
+}
+
+namespace {
+
+// Encodes a single order entry value of a row at `key`. Null values only set the null
+// indicator byte, which is ordered according to NULLS FIRST / LAST but never inverted
+// for descending order, matching ResultSetComparator.
+void encode_normalized_key(int8_t* key,
+                           const ResultSet::NormalizedKeyColumn& key_column,
+                           const bool is_null,
+                           const uint64_t normalized_value) {
+  if (key_column.nullable) {
+    *key++ = static_cast<int8_t>(is_null != key_column.nulls_first);
+  }
+  if (is_null) {
+    std::memset(key, 0, key_column.value_width);
+    return;
+  }
+  normalized_key_sort::store_key_bytes(
+      key, normalized_value, key_column.value_width, key_column.is_desc);
+}
+
+size_t get_normalized_key_width(
+    const std::vector<ResultSet::NormalizedKeyColumn>& key_columns) {
+  size_t key_width{0};
+  for (const auto& key_column : key_columns) {
+    key_width += key_column.width();
+  }
+  return key_width;
+}
+
+}  // namespace
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::encodeNormalizedKeys(normalized_key_sort::KeyBuffer& key_buffer,
+                                     const std::vector<NormalizedKeyColumn>& key_columns,
+                                     const BUFFER_ITERATOR_TYPE& buffer_itr,
+                                     const size_t entry_base,
+                                     const PermutationView permutation,
+                                     const bool single_threaded) {
+  CHECK_EQ(key_buffer.entryCount(), permutation.size());
+  const auto encode = [&, query_id = logger::query_id()](const size_t start,
+                                                         const size_t end) {
+    auto qid_scope_guard = logger::set_thread_local_query_id(query_id);
+    for (size_t i = start; i < end; ++i) {
+      const auto storage_lookup_result = findStorage(entry_base + permutation[i]);
+      const auto storage = storage_lookup_result.storage_ptr;
+      const auto off = storage_lookup_result.fixedup_entry_idx;
+      auto key = key_buffer.key(i);
+      for (const auto& key_column : key_columns) {
+        const auto value = buffer_itr.getColumnInternal(
+            storage->buff_, off, key_column.target_idx, storage_lookup_result);
+        switch (key_column.kind) {
+          case NormalizedKeyColumn::Kind::CountDistinct: {
+            const auto set_size = count_distinct_set_size(
+                value.i1,
+                query_mem_desc_.getCountDistinctDescriptor(key_column.target_idx));
+            encode_normalized_key(
+                key, key_column, false, normalized_key_sort::normalize_int(set_size));
+            break;
+          }
+          case NormalizedKeyColumn::Kind::ApproxQuantile: {
+            const auto t_digest = reinterpret_cast<quantile::TDigest*>(value.i1);
+            const double quantile = t_digest ? calculateQuantile(t_digest) : NULL_DOUBLE;
+            encode_normalized_key(key,
+                                  key_column,
+                                  key_column.nullable && quantile == NULL_DOUBLE,
+                                  normalized_key_sort::normalize_double(quantile));
+            break;
+          }
+          case NormalizedKeyColumn::Kind::Average: {
+            CHECK(value.isPair());
+            const bool is_null =
+                isNull(key_column.entry_ti, value, key_column.float_argument_input);
+            encode_normalized_key(
+                key,
+                key_column,
+                is_null,
+                is_null ? 0
+                        : normalized_key_sort::normalize_double(
+                              pair_to_double({value.i1, value.i2},
+                                             key_column.entry_ti,
+                                             key_column.float_argument_input)));
+            break;
+          }
+          case NormalizedKeyColumn::Kind::DictionaryRank: {
+            CHECK(value.isInt());
+            const bool is_null =
+                isNull(key_column.entry_ti, value, key_column.float_argument_input);
+            uint64_t rank{0};
+            if (!is_null) {
+              const auto it =
+                  key_column.string_ranks.find(static_cast<int32_t>(value.i1));
+              CHECK(it != key_column.string_ranks.end());
+              rank = it->second;
+            }
+            encode_normalized_key(key, key_column, is_null, rank);
+            break;
+          }
+          case NormalizedKeyColumn::Kind::FloatingPoint: {
+            CHECK(value.isInt());
+            const bool is_null =
+                isNull(key_column.entry_ti, value, key_column.float_argument_input);
+            const double dval =
+                key_column.float_argument_input
+                    ? static_cast<double>(
+                          *reinterpret_cast<const float*>(may_alias_ptr(&value.i1)))
+                    : *reinterpret_cast<const double*>(may_alias_ptr(&value.i1));
+            encode_normalized_key(
+                key, key_column, is_null, normalized_key_sort::normalize_double(dval));
+            break;
+          }
+          case NormalizedKeyColumn::Kind::Integer: {
+            CHECK(value.isInt());
+            encode_normalized_key(
+                key,
+                key_column,
+                isNull(key_column.entry_ti, value, key_column.float_argument_input),
+                normalized_key_sort::normalize_int(value.i1));
+            break;
+          }
+        }
+        key += key_column.width();
+      }
+      key_buffer.setRowIndex(i, permutation[i]);
+    }
+  };
+  if (single_threaded) {
+    encode(0, permutation.size());
+  } else {
+    threading::task_group thread_pool;
+    for (auto interval : makeIntervals<size_t>(0, permutation.size(), cpu_threads())) {
+      thread_pool.run([=] { encode(interval.begin, interval.end); });
+    }
+    thread_pool.wait();
+  }
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+PermutationView ResultSet::normalizedKeySort(
+    PermutationView permutation,
+    const size_t n,
+    const std::list<Analyzer::OrderEntry>& order_entries,
+    const Executor* executor,
+    const bool single_threaded) {
+  auto timer = DEBUG_TIMER(__func__);
+  const BUFFER_ITERATOR_TYPE buffer_itr(this);
+  const auto key_columns =
+      makeRankedNormalizedKeyColumns(buffer_itr, order_entries, executor);
+  normalized_key_sort::KeyBuffer key_buffer(get_normalized_key_width(key_columns),
+                                            permutation.size());
+  encodeNormalizedKeys(
+      key_buffer, key_columns, buffer_itr, 0, permutation, single_threaded);
+  key_buffer.sort(single_threaded);
+  const size_t top_n = std::min(n, static_cast<size_t>(permutation.size()));
+  for (size_t i = 0; i < top_n; ++i) {
+    permutation[i] = key_buffer.rowIndex(i);
+  }
+  permutation.resize(top_n);
+  return permutation;
+}
+
+template <typename BUFFER_ITERATOR_TYPE>
+void ResultSet::externalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                             const size_t top_n,
+                             const Executor* executor) {
+  auto timer = DEBUG_TIMER(__func__);
+  CHECK_GT(g_external_sort_run_size, size_t(0));
+  CHECK_LE(g_external_sort_run_size, size_t(std::numeric_limits<PermutationIdx>::max()));
+  const BUFFER_ITERATOR_TYPE buffer_itr(this);
+  const auto key_columns =
+      makeRankedNormalizedKeyColumns(buffer_itr, order_entries, executor);
+  const auto key_width = get_normalized_key_width(key_columns);
+
+  const auto spill_dir = boost::filesystem::path(g_base_path) / kExternalSortSpillDir;
+  boost::filesystem::create_directories(spill_dir);
+  const auto spill_prefix =
+      boost::filesystem::unique_path("%%%%-%%%%-%%%%-%%%%").string();
+
+  std::vector<std::string> run_paths;
+  size_t row_count{0};
+  Permutation run_permutation;
+  try {
+    const auto entry_count = query_mem_desc_.getEntryCount();
+    for (size_t run_begin = 0; run_begin < entry_count;
+         run_begin += g_external_sort_run_size) {
+      const auto run_end = std::min(run_begin + g_external_sort_run_size, entry_count);
+      // Run-relative indexes of the non-empty entries in [run_begin, run_end).
+      run_permutation.clear();
+      for (size_t entry_idx = run_begin; entry_idx < run_end; ++entry_idx) {
+        const auto storage_lookup_result = findStorage(entry_idx);
+        if (!storage_lookup_result.storage_ptr->isEmptyEntry(
+                storage_lookup_result.fixedup_entry_idx)) {
+          run_permutation.push_back(entry_idx - run_begin);
+        }
+      }
+      if (run_permutation.empty()) {
+        continue;
+      }
+      const PermutationView pv(run_permutation.data(), run_permutation.size());
+      normalized_key_sort::KeyBuffer key_buffer(key_width, pv.size());
+      encodeNormalizedKeys(key_buffer, key_columns, buffer_itr, run_begin, pv, false);
+      key_buffer.sort(false);
+      run_paths.push_back(
+          (spill_dir / (spill_prefix + "." + std::to_string(run_paths.size()))).string());
+      normalized_key_sort::spill_sorted_run(run_paths.back(), key_buffer, run_begin);
+      row_count += pv.size();
+    }
+  } catch (...) {
+    for (const auto& run_path : run_paths) {
+      boost::system::error_code ec;
+      boost::filesystem::remove(run_path, ec);
+    }
+    throw;
+  }
+  VLOG(1) << "Externally sorted " << row_count << " rows in " << run_paths.size()
+          << " runs spilled to " << spill_dir;
+
+  // Write the rows in sort order to another spill file, which then replaces the
+  // buffers of the result set: the sorted result needs neither a permutation nor its
+  // payload in memory, and is read like any other result set.
+  normalized_key_sort::SortedRunMerger merger(
+      run_paths,
+      key_width,
+      g_external_sort_merge_buffer_bytes / std::max(run_paths.size(), size_t(1)));
+  const size_t sorted_row_count = top_n ? std::min(top_n, row_count) : row_count;
+  const auto sorted_rows_path = (spill_dir / (spill_prefix + ".sorted")).string();
+  const auto row_bytes = get_row_bytes(query_mem_desc_);
+  {
+    normalized_key_sort::SpillFileWriter writer(sorted_rows_path,
+                                                g_external_sort_merge_buffer_bytes);
+    size_t entry_idx{0};
+    for (size_t i = 0; i < sorted_row_count && merger.next(entry_idx); ++i) {
+      const auto storage_lookup_result = findStorage(entry_idx);
+      const auto storage = storage_lookup_result.storage_ptr;
+      writer.append(row_ptr_rowwise(storage->buff_,
+                                    storage->query_mem_desc_,
+                                    storage_lookup_result.fixedup_entry_idx),
+                    row_bytes);
+    }
+    writer.close();
+  }
+  auto sorted_rows =
+      std::make_unique<normalized_key_sort::SpilledBuffer>(sorted_rows_path);
+  CHECK_EQ(sorted_rows->size(), sorted_row_count * row_bytes);
+
+  // Only the buffers owned by this result set are freed. Provided buffers come from the
+  // arenas of the row set memory owner, which other result sets may share, and stay
+  // allocated until the owner goes away.
+  const auto release_storage = [](const ResultSetStorage& storage) {
+    if (!storage.buff_is_provided_) {
+      free(storage.buff_);
+    }
+  };
+  for (const auto& storage : appended_storage_) {
+    release_storage(*storage);
+  }
+  appended_storage_.clear();
+  query_mem_desc_.setEntryCount(sorted_row_count);
+  if (!sorted_rows->data()) {
+    storage_->updateEntryCount(0);
+    return;
+  }
+  auto sorted_query_mem_desc = storage_->query_mem_desc_;
+  sorted_query_mem_desc.setEntryCount(sorted_row_count);
+  std::unique_ptr<ResultSetStorage> sorted_storage(
+      new ResultSetStorage(targets_,
+                           sorted_query_mem_desc,
+                           sorted_rows->data(),
+                           /*buff_is_provided=*/true));
+  sorted_storage->target_init_vals_ = storage_->target_init_vals_;
+  sorted_storage->count_distinct_sets_mapping_ = storage_->count_distinct_sets_mapping_;
+  release_storage(*storage_);
+  storage_ = std::move(sorted_storage);
+  external_sort_rows_ = std::move(sorted_rows);
+}
+
 void ResultSet::radixSortOnGpu(
     const std::list<Analyzer::OrderEntry>& order_entries) const {
   auto timer = DEBUG_TIMER(__func__);
@@ -35,6 +35,7 @@
 #include <atomic>
 #include <functional>
 #include <list>
+#include <unordered_map>
 
 /*
  * Stores the underlying buffer and the meta-data for a result set. The buffer
@@ -91,6 +92,11 @@ class Executor;
 
 class ResultSet;
 
+namespace normalized_key_sort {
+class KeyBuffer;
+class SpilledBuffer;
+}  // namespace normalized_key_sort
+
 class ResultSetRowIterator {
  public:
   using value_type = std::vector<TargetValue>;
@@ -269,6 +275,20 @@ class ResultSet {
 
   void append(ResultSet& that);
 
+  // Whether all the rows live in the storage buffers of this result set, i.e. nothing
+  // points into chunks, lazily fetched columns or serialized varlen buffers, and the
+  // rows haven't been sorted or limited yet. Only such result sets can be copied.
+  bool isSelfContained() const;
+
+  // Deep copy of the storage buffers of a self contained result set. The copy gets its
+  // own row set memory owner, which holds copies of the count distinct sets and shares
+  // only the string dictionary proxies, so it doesn't keep the arenas of the query alive.
+  std::shared_ptr<ResultSet> copy() const;
+
+  // Bytes held by the storage buffers, appended ones included, and by the count distinct
+  // sets they point to.
+  size_t getStorageSizeBytes() const;
+
   const ResultSetStorage* getStorage() const;
 
   size_t colCount() const;
@@ -699,6 +719,82 @@ class ResultSet {
                                         const Comparator&,
                                         const bool single_threaded);
 
+ public:
+  // Describes how one order entry is encoded into a fixed-width, memcmp-comparable key.
+  struct NormalizedKeyColumn {
+    enum class Kind {
+      Integer,
+      FloatingPoint,
+      Average,
+      DictionaryRank,
+      CountDistinct,
+      ApproxQuantile
+    };
+
+    Kind kind;
+    size_t target_idx;
+    SQLTypeInfo entry_ti;
+    bool float_argument_input;
+    bool is_desc;
+    bool nulls_first;
+    bool nullable;
+    size_t value_width;
+    // Rank of every dictionary id in sorted string order, for Kind::DictionaryRank.
+    std::unordered_map<int32_t, uint32_t> string_ranks;
+
+    size_t width() const { return (nullable ? 1 : 0) + value_width; }
+  };
+
+ private:
+  bool canUseNormalizedKeySort(const std::list<Analyzer::OrderEntry>& order_entries,
+                               const Executor* executor) const;
+
+  std::vector<NormalizedKeyColumn> makeNormalizedKeyColumns(
+      const std::list<Analyzer::OrderEntry>& order_entries) const;
+
+  // Sorts the permutation into its top n elements by encoding all order entries into
+  // normalized keys and radix sorting them, instead of calling a row comparator.
+  template <typename BUFFER_ITERATOR_TYPE>
+  PermutationView normalizedKeySort(PermutationView permutation,
+                                    const size_t n,
+                                    const std::list<Analyzer::OrderEntry>& order_entries,
+                                    const Executor* executor,
+                                    const bool single_threaded);
+
+  // Whether the rows can be sorted by externalSort(), which needs row-wise entries that
+  // don't depend on their position in the buffer.
+  bool canUseExternalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                          const Executor* executor) const;
+
+  // Sorts the result set in runs of bounded size which are spilled to disk, merges them
+  // into a spill file of the sorted rows and makes that file the storage of the result
+  // set. Lifts the 4B entries limit of the permutation.
+  template <typename BUFFER_ITERATOR_TYPE>
+  void externalSort(const std::list<Analyzer::OrderEntry>& order_entries,
+                    const size_t top_n,
+                    const Executor* executor);
+
+  template <typename BUFFER_ITERATOR_TYPE>
+  std::vector<NormalizedKeyColumn> makeRankedNormalizedKeyColumns(
+      const BUFFER_ITERATOR_TYPE& buffer_itr,
+      const std::list<Analyzer::OrderEntry>& order_entries,
+      const Executor* executor) const;
+
+  // Encodes the keys of entries entry_base + permutation[i] into key_buffer.
+  template <typename BUFFER_ITERATOR_TYPE>
+  void encodeNormalizedKeys(normalized_key_sort::KeyBuffer& key_buffer,
+                            const std::vector<NormalizedKeyColumn>& key_columns,
+                            const BUFFER_ITERATOR_TYPE& buffer_itr,
+                            const size_t entry_base,
+                            const PermutationView permutation,
+                            const bool single_threaded);
+
+  template <typename BUFFER_ITERATOR_TYPE>
+  std::unordered_map<int32_t, uint32_t> rankDictionaryStrings(
+      const BUFFER_ITERATOR_TYPE& buffer_itr,
+      const NormalizedKeyColumn& key_column,
+      const Executor* executor) const;
+
   PermutationView initPermutationBuffer(PermutationView permutation,
                                         PermutationIdx const begin,
                                         PermutationIdx const end) const;
@@ -751,6 +847,8 @@ class ResultSet {
   size_t keep_first_;
   std::shared_ptr<RowSetMemoryOwner> row_set_mem_owner_;
   Permutation permutation_;
+  // Backs storage_ once the result set has been sorted externally.
+  std::unique_ptr<normalized_key_sort::SpilledBuffer> external_sort_rows_;
 
   const Catalog_Namespace::Catalog* catalog_;
   unsigned block_size_{0};
@@ -822,6 +920,11 @@ class ResultSetManager {
  public:
   ResultSet* reduce(std::vector<ResultSet*>&);
 
+  ResultSet* reducePartitioned(const std::vector<ResultSet*>& result_sets,
+                               const ReductionCode& reduction_code,
+                               const unsigned block_size,
+                               const unsigned grid_size);
+
   std::shared_ptr<ResultSet> getOwnResultSet();
 
   void rewriteVarlenAggregates(ResultSet*);
@@ -841,6 +944,12 @@ bool can_use_parallel_algorithms(const ResultSet& rows);
 
 bool use_parallel_algorithms(const ResultSet& rows);
 
+// Whether the baseline hash results of the kernels should be reduced by
+// ResultSetManager::reducePartitioned instead of one after the other.
+bool use_partitioned_reduction(const QueryMemoryDescriptor& query_mem_desc,
+                               const size_t result_set_count,
+                               const size_t total_entry_count);
+
 }  // namespace result_set
 
 #endif  // QUERYENGINE_RESULTSET_H
@@ -35,11 +35,15 @@
 #include <llvm/ExecutionEngine/GenericValue.h>
 
 #include <algorithm>
+#include <atomic>
 #include <future>
 #include <numeric>
 
 extern bool g_enable_dynamic_watchdog;
 
+bool g_enable_parallel_reduction{true};
+bool g_enable_partitioned_reduction{false};
+
 namespace {
 
 bool use_multithreaded_reduction(const size_t entry_count) {
@@ -383,6 +387,82 @@ void ResultSetStorage::reduce(const ResultSetStorage& that,
   }
 }
 
+void ResultSetStorage::reduceParallel(
+    const std::vector<const ResultSetStorage*>& those,
+    const std::vector<std::vector<std::string>>& serialized_varlen_buffers,
+    const ReductionCode& reduction_code) const {
+  CHECK(query_mem_desc_.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByPerfectHash);
+  const auto entry_count = query_mem_desc_.getEntryCount();
+  CHECK_GT(entry_count, size_t(0));
+  auto this_buff = buff_;
+  CHECK(this_buff);
+  for (const auto that : those) {
+    CHECK_EQ(entry_count, that->query_mem_desc_.getEntryCount());
+    CHECK(that->buff_);
+  }
+  CHECK(serialized_varlen_buffers.empty() ||
+        serialized_varlen_buffers.size() == those.size() + 1);
+  const std::vector<std::string> empty_serialized_varlen_buffer;
+  auto executor = query_mem_desc_.getExecutor();
+  if (!executor) {
+    executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID).get();
+  }
+  const auto executor_id = executor->getExecutorId();
+  auto reduce_entries = [&](const size_t start_index, const size_t end_index) {
+    for (size_t that_idx = 0; that_idx < those.size(); ++that_idx) {
+      const auto& that = *those[that_idx];
+      const auto& serialized_varlen_buffer =
+          serialized_varlen_buffers.empty() ? empty_serialized_varlen_buffer
+                                            : serialized_varlen_buffers[that_idx + 1];
+      if (query_mem_desc_.didOutputColumnar()) {
+        reduceEntriesNoCollisionsColWise(this_buff,
+                                         that.buff_,
+                                         that,
+                                         start_index,
+                                         end_index,
+                                         serialized_varlen_buffer,
+                                         executor_id);
+      } else {
+        CHECK(reduction_code.ir_reduce_loop);
+        run_reduction_code(reduction_code,
+                           this_buff,
+                           that.buff_,
+                           start_index,
+                           end_index,
+                           entry_count,
+                           &query_mem_desc_,
+                           &that.query_mem_desc_,
+                           &serialized_varlen_buffer);
+      }
+    }
+  };
+  if (!use_multithreaded_reduction(entry_count * those.size())) {
+    reduce_entries(0, entry_count);
+    return;
+  }
+  // Unlike a chain of pairwise reductions, each thread keeps working on the same part of
+  // this buffer, and the threads only have to be joined once.
+  const size_t thread_count = std::min(static_cast<size_t>(cpu_threads()), entry_count);
+  const auto thread_entry_count = (entry_count + thread_count - 1) / thread_count;
+  std::vector<std::future<void>> reduction_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    const auto start_index = thread_idx * thread_entry_count;
+    const auto end_index = std::min(start_index + thread_entry_count, entry_count);
+    if (start_index >= end_index) {
+      break;
+    }
+    reduction_threads.emplace_back(
+        std::async(std::launch::async, reduce_entries, start_index, end_index));
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.wait();
+  }
+  for (auto& reduction_thread : reduction_threads) {
+    reduction_thread.get();
+  }
+}
+
 namespace {
 
 ALWAYS_INLINE void check_watchdog() {
@@ -1119,6 +1199,17 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
                                       result_rs->getTargetInfos(),
                                       result_rs->getTargetInitVals());
   auto reduction_code = reduction_jit.codegen();
+  if (g_enable_parallel_reduction && result_sets.size() > 2 &&
+      result->query_mem_desc_.getQueryDescriptionType() ==
+          QueryDescriptionType::GroupByPerfectHash) {
+    std::vector<const ResultSetStorage*> those;
+    for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
+         ++result_it) {
+      those.push_back((*result_it)->storage_.get());
+    }
+    result->reduceParallel(those, serialized_varlen_buffer, reduction_code);
+    return result_rs;
+  }
   size_t ctr = 1;
   for (auto result_it = result_sets.begin() + 1; result_it != result_sets.end();
        ++result_it) {
@@ -1132,6 +1223,219 @@ ResultSet* ResultSetManager::reduce(std::vector<ResultSet*>& result_sets) {
   return result_rs;
 }
 
+namespace {
+
+// The hash table of a partition is sized to stay in the L2 cache while it's reduced.
+const size_t PARTITION_TABLE_BYTES{512 * 1024};
+const size_t MAX_PARTITION_RADIX_BITS{12};
+
+size_t get_partition_idx(const int8_t* row_ptr,
+                         const size_t key_count,
+                         const size_t key_width,
+                         const size_t radix_bits) {
+  if (!radix_bits) {
+    return 0;
+  }
+  const auto h =
+      key_hash(reinterpret_cast<const int64_t*>(row_ptr), key_count, key_width);
+  // The slot within a partition is the hash modulo the size of its table, take the
+  // partition from the high bits of the scrambled hash instead.
+  return (static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ULL) >> (64 - radix_bits);
+}
+
+// Runs `task` for every index in [0, task_count), spread over up to cpu_threads()
+// threads which pick the next index as they become free.
+void run_partition_tasks(const size_t task_count,
+                         const std::function<void(const size_t)>& task) {
+  std::atomic<size_t> next_task_idx{0};
+  auto run_tasks = [&]() {
+    for (auto task_idx = next_task_idx++; task_idx < task_count;
+         task_idx = next_task_idx++) {
+      task(task_idx);
+    }
+  };
+  const size_t thread_count =
+      std::min(static_cast<size_t>(cpu_threads()), task_count);
+  std::vector<std::future<void>> task_threads;
+  for (size_t thread_idx = 0; thread_idx < thread_count; ++thread_idx) {
+    task_threads.emplace_back(std::async(std::launch::async, run_tasks));
+  }
+  for (auto& task_thread : task_threads) {
+    task_thread.wait();
+  }
+  for (auto& task_thread : task_threads) {
+    task_thread.get();
+  }
+}
+
+}  // namespace
+
+bool result_set::use_partitioned_reduction(const QueryMemoryDescriptor& query_mem_desc,
+                                           const size_t result_set_count,
+                                           const size_t total_entry_count) {
+  return g_enable_partitioned_reduction && result_set_count > 1 &&
+         query_mem_desc.getQueryDescriptionType() ==
+             QueryDescriptionType::GroupByBaselineHash &&
+         !query_mem_desc.didOutputColumnar() && !query_mem_desc.hasKeylessHash() &&
+         use_multithreaded_reduction(total_entry_count);
+}
+
+// Reduces the row-wise baseline hash buffers of `result_sets` by first partitioning
+// their groups on the key hash. Each partition gets its own hash table, sized to the
+// groups in it, and is reduced by a single thread straight from the buffers of the
+// inputs, only the entry indices of the groups are partitioned. The tables are laid out
+// one after the other in the buffer of the result, which is owned by this object.
+ResultSet* ResultSetManager::reducePartitioned(const std::vector<ResultSet*>& result_sets,
+                                               const ReductionCode& reduction_code,
+                                               const unsigned block_size,
+                                               const unsigned grid_size) {
+  CHECK(!result_sets.empty());
+  const auto first_result = result_sets.front();
+  CHECK(first_result->storage_);
+  const auto& first_query_mem_desc = first_result->storage_->query_mem_desc_;
+  CHECK(first_query_mem_desc.getQueryDescriptionType() ==
+        QueryDescriptionType::GroupByBaselineHash);
+  CHECK(!first_query_mem_desc.didOutputColumnar());
+  CHECK(reduction_code.ir_reduce_loop);
+  const auto row_bytes = get_row_bytes(first_query_mem_desc);
+  const auto key_count = first_query_mem_desc.getGroupbyColCount();
+  const auto key_width = first_query_mem_desc.getEffectiveKeyWidth();
+  const auto input_count = result_sets.size();
+  std::vector<const ResultSetStorage*> storages;
+  for (const auto result_set : result_sets) {
+    CHECK_EQ(first_result->row_set_mem_owner_, result_set->row_set_mem_owner_);
+    CHECK_EQ(first_result->catalog_, result_set->catalog_);
+    const auto storage = result_set->storage_.get();
+    CHECK(storage);
+    CHECK_EQ(row_bytes, get_row_bytes(storage->query_mem_desc_));
+    storages.push_back(storage);
+  }
+
+  // Count the groups first, the number of partitions depends on it.
+  std::vector<size_t> input_group_counts(input_count, 0);
+  run_partition_tasks(input_count, [&](const size_t input_idx) {
+    const auto storage = storages[input_idx];
+    const auto entry_count = storage->getEntryCount();
+    size_t group_count{0};
+    for (size_t entry_idx = 0; entry_idx < entry_count; ++entry_idx) {
+      if (!storage->isEmptyEntry(entry_idx)) {
+        ++group_count;
+      }
+    }
+    input_group_counts[input_idx] = group_count;
+  });
+  const auto group_count =
+      std::accumulate(input_group_counts.begin(), input_group_counts.end(), size_t(0));
+  // Every table gets twice as many entries as its partition has groups.
+  const auto max_partition_group_count =
+      std::max(PARTITION_TABLE_BYTES / (2 * row_bytes), size_t(1));
+  const auto min_partition_count = static_cast<size_t>(cpu_threads());
+  size_t radix_bits{0};
+  while (radix_bits < MAX_PARTITION_RADIX_BITS &&
+         ((size_t(1) << radix_bits) < min_partition_count ||
+          (group_count >> radix_bits) > max_partition_group_count)) {
+    ++radix_bits;
+  }
+  const size_t partition_count = size_t(1) << radix_bits;
+
+  std::vector<std::vector<size_t>> input_partition_sizes(
+      input_count, std::vector<size_t>(partition_count, 0));
+  run_partition_tasks(input_count, [&](const size_t input_idx) {
+    const auto storage = storages[input_idx];
+    const auto buff = storage->getUnderlyingBuffer();
+    auto& partition_sizes = input_partition_sizes[input_idx];
+    for (size_t entry_idx = 0; entry_idx < storage->getEntryCount(); ++entry_idx) {
+      if (!storage->isEmptyEntry(entry_idx)) {
+        ++partition_sizes[get_partition_idx(
+            buff + entry_idx * row_bytes, key_count, key_width, radix_bits)];
+      }
+    }
+  });
+
+  // Only the entry indices of the groups are partitioned, the groups themselves are
+  // reduced from the buffers of the inputs. The indices of a partition are contiguous.
+  std::vector<std::vector<size_t>> input_partition_offsets(
+      input_count, std::vector<size_t>(partition_count + 1, 0));
+  std::vector<std::vector<int32_t>> input_partition_entries(input_count);
+  run_partition_tasks(input_count, [&](const size_t input_idx) {
+    const auto storage = storages[input_idx];
+    const auto buff = storage->getUnderlyingBuffer();
+    const auto& partition_sizes = input_partition_sizes[input_idx];
+    auto& partition_offsets = input_partition_offsets[input_idx];
+    for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+      partition_offsets[partition_idx + 1] =
+          partition_offsets[partition_idx] + partition_sizes[partition_idx];
+    }
+    CHECK_EQ(input_group_counts[input_idx], partition_offsets[partition_count]);
+    auto& entries = input_partition_entries[input_idx];
+    entries.resize(input_group_counts[input_idx]);
+    std::vector<size_t> write_offsets(partition_offsets.begin(),
+                                      partition_offsets.end() - 1);
+    for (size_t entry_idx = 0; entry_idx < storage->getEntryCount(); ++entry_idx) {
+      if (!storage->isEmptyEntry(entry_idx)) {
+        const auto partition_idx = get_partition_idx(
+            buff + entry_idx * row_bytes, key_count, key_width, radix_bits);
+        entries[write_offsets[partition_idx]++] = entry_idx;
+      }
+    }
+  });
+
+  std::vector<size_t> table_offsets(partition_count + 1, 0);
+  for (size_t partition_idx = 0; partition_idx < partition_count; ++partition_idx) {
+    size_t partition_group_count{0};
+    for (size_t input_idx = 0; input_idx < input_count; ++input_idx) {
+      partition_group_count += input_partition_sizes[input_idx][partition_idx];
+    }
+    table_offsets[partition_idx + 1] =
+        table_offsets[partition_idx] + 2 * partition_group_count;
+  }
+  auto query_mem_desc = first_query_mem_desc;
+  query_mem_desc.setEntryCount(std::max(table_offsets.back(), size_t(1)));
+  rs_.reset(new ResultSet(first_result->targets_,
+                          ExecutorDeviceType::CPU,
+                          query_mem_desc,
+                          first_result->row_set_mem_owner_,
+                          first_result->catalog_,
+                          block_size,
+                          grid_size));
+  auto result_storage = rs_->allocateStorage(first_result->storage_->target_init_vals_);
+  rs_->initializeStorage();
+  const auto result_buff = result_storage->getUnderlyingBuffer();
+
+  // Each partition is reduced on its own into its slice of the result buffer, the slices
+  // are never merged, so no group can be in two of them. The reduction loop runs on one
+  // entry of an input at a time, since the groups of a partition are spread over it.
+  run_partition_tasks(partition_count, [&](const size_t partition_idx) {
+    const auto table_entry_count =
+        table_offsets[partition_idx + 1] - table_offsets[partition_idx];
+    if (!table_entry_count) {
+      return;
+    }
+    auto this_query_mem_desc = first_query_mem_desc;
+    this_query_mem_desc.setEntryCount(table_entry_count);
+    const auto this_buff = result_buff + table_offsets[partition_idx] * row_bytes;
+    for (size_t input_idx = 0; input_idx < input_count; ++input_idx) {
+      const auto storage = storages[input_idx];
+      const auto& partition_offsets = input_partition_offsets[input_idx];
+      const auto& entries = input_partition_entries[input_idx];
+      for (auto i = partition_offsets[partition_idx];
+           i < partition_offsets[partition_idx + 1];
+           ++i) {
+        run_reduction_code(reduction_code,
+                           this_buff,
+                           storage->getUnderlyingBuffer(),
+                           entries[i],
+                           entries[i] + 1,
+                           storage->getEntryCount(),
+                           &this_query_mem_desc,
+                           &storage->query_mem_desc_,
+                           nullptr);
+      }
+    }
+  });
+  return rs_.get();
+}
+
 std::shared_ptr<ResultSet> ResultSetManager::getOwnResultSet() {
   return rs_;
 }
@@ -107,6 +107,16 @@ class ResultSetStorage {
               const std::vector<std::string>& serialized_varlen_buffer,
               const ReductionCode& reduction_code) const;
 
+  // Reduces all of `those` into this perfect hash storage in a single pass. Large
+  // reductions run in parallel, each thread owns a disjoint range of the entries and
+  // reduces it across all the inputs.
+  // `serialized_varlen_buffers` is either empty or holds the buffer of this storage
+  // followed by one for each of `those`.
+  void reduceParallel(
+      const std::vector<const ResultSetStorage*>& those,
+      const std::vector<std::vector<std::string>>& serialized_varlen_buffers,
+      const ReductionCode& reduction_code) const;
+
   void rewriteAggregateBufferOffsets(
       const std::vector<std::string>& serialized_varlen_buffer) const;
 
@@ -0,0 +1,251 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SortedRunMerger.h"
+
+#include "Logger/Logger.h"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace normalized_key_sort {
+
+namespace {
+
+constexpr size_t kSpillEntryIndexBytes{sizeof(uint64_t)};
+
+std::FILE* open_run_file(const std::string& path, const char* mode) {
+  auto file = std::fopen(path.c_str(), mode);
+  if (!file) {
+    throw std::runtime_error("Could not open sort spill file " + path);
+  }
+  return file;
+}
+
+}  // namespace
+
+SpillFileWriter::SpillFileWriter(const std::string& path, const size_t buffer_bytes)
+    : path_(path)
+    , buffer_(std::max(buffer_bytes, size_t(1)))
+    , file_(open_run_file(path, "wb")) {}
+
+SpillFileWriter::~SpillFileWriter() {
+  if (file_) {
+    std::fclose(file_);
+    boost::system::error_code ec;
+    boost::filesystem::remove(path_, ec);
+  }
+}
+
+void SpillFileWriter::append(const int8_t* data, const size_t bytes) {
+  CHECK(file_);
+  size_t appended{0};
+  while (appended < bytes) {
+    if (buffered_bytes_ == buffer_.size()) {
+      flush();
+    }
+    const auto chunk = std::min(bytes - appended, buffer_.size() - buffered_bytes_);
+    std::memcpy(buffer_.data() + buffered_bytes_, data + appended, chunk);
+    buffered_bytes_ += chunk;
+    appended += chunk;
+  }
+}
+
+void SpillFileWriter::close() {
+  CHECK(file_);
+  flush();
+  const auto status = std::fclose(file_);
+  file_ = nullptr;
+  if (status) {
+    throw std::runtime_error("Could not write sort spill file " + path_);
+  }
+}
+
+void SpillFileWriter::flush() {
+  if (buffered_bytes_ &&
+      std::fwrite(buffer_.data(), 1, buffered_bytes_, file_) != buffered_bytes_) {
+    throw std::runtime_error("Could not write sort spill file " + path_);
+  }
+  buffered_bytes_ = 0;
+}
+
+SpilledBuffer::SpilledBuffer(const std::string& path) : path_(path) {
+  try {
+    if (boost::filesystem::file_size(path_)) {
+      file_.open(path_, boost::iostreams::mapped_file::priv);
+    }
+  } catch (...) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path_, ec);
+    throw;
+  }
+}
+
+SpilledBuffer::~SpilledBuffer() {
+  if (file_.is_open()) {
+    file_.close();
+  }
+  boost::system::error_code ec;
+  boost::filesystem::remove(path_, ec);
+  if (ec) {
+    LOG(WARNING) << "Could not remove sort spill file " << path_ << ": " << ec.message();
+  }
+}
+
+int8_t* SpilledBuffer::data() const {
+  return file_.is_open() ? reinterpret_cast<int8_t*>(file_.data()) : nullptr;
+}
+
+size_t SpilledBuffer::size() const {
+  return file_.is_open() ? file_.size() : 0;
+}
+
+void spill_sorted_run(const std::string& path,
+                      const KeyBuffer& key_buffer,
+                      const uint64_t entry_base) {
+  const size_t key_width = key_buffer.keyWidth();
+  // Write in batches to keep the number of fwrite calls low.
+  constexpr size_t kRecordsPerWrite{4096};
+  SpillFileWriter writer(path, kRecordsPerWrite * (key_width + kSpillEntryIndexBytes));
+  for (size_t i = 0; i < key_buffer.entryCount(); ++i) {
+    writer.append(key_buffer.key(i), key_width);
+    const uint64_t entry_idx = entry_base + key_buffer.rowIndex(i);
+    writer.append(reinterpret_cast<const int8_t*>(&entry_idx), kSpillEntryIndexBytes);
+  }
+  writer.close();
+}
+
+class SortedRunMerger::RunReader {
+ public:
+  RunReader(const std::string& path,
+            const size_t record_width,
+            const size_t buffer_records)
+      : path_(path)
+      , record_width_(record_width)
+      , buffer_(record_width * buffer_records)
+      , buffer_records_(buffer_records)
+      , file_(open_run_file(path, "rb")) {
+    refill();
+  }
+
+  ~RunReader() { std::fclose(file_); }
+
+  bool exhausted() const { return pos_ == count_; }
+
+  const int8_t* record() const { return &buffer_[pos_ * record_width_]; }
+
+  void advance() {
+    CHECK_LT(pos_, count_);
+    if (++pos_ == count_) {
+      refill();
+    }
+  }
+
+ private:
+  void refill() {
+    count_ = std::fread(buffer_.data(), record_width_, buffer_records_, file_);
+    if (count_ < buffer_records_ && std::ferror(file_)) {
+      throw std::runtime_error("Could not read sort spill file " + path_);
+    }
+    pos_ = 0;
+  }
+
+  const std::string path_;
+  const size_t record_width_;
+  std::vector<int8_t> buffer_;
+  const size_t buffer_records_;
+  std::FILE* file_;
+  size_t pos_{0};
+  size_t count_{0};
+};
+
+SortedRunMerger::SortedRunMerger(const std::vector<std::string>& run_paths,
+                                 const size_t key_width,
+                                 const size_t read_buffer_bytes)
+    : run_paths_(run_paths)
+    , key_width_(key_width)
+    , record_width_(key_width + kSpillEntryIndexBytes)
+    , read_buffer_records_(std::max(size_t(1), read_buffer_bytes / record_width_)) {
+  rewind();
+}
+
+SortedRunMerger::~SortedRunMerger() {
+  readers_.clear();
+  for (const auto& path : run_paths_) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(path, ec);
+    if (ec) {
+      LOG(WARNING) << "Could not remove sort spill file " << path << ": "
+                   << ec.message();
+    }
+  }
+}
+
+void SortedRunMerger::rewind() {
+  readers_.clear();
+  heap_.clear();
+  for (size_t run_idx = 0; run_idx < run_paths_.size(); ++run_idx) {
+    readers_.emplace_back(std::make_unique<RunReader>(
+        run_paths_[run_idx], record_width_, read_buffer_records_));
+    if (!readers_.back()->exhausted()) {
+      pushHeap(run_idx);
+    }
+  }
+}
+
+bool SortedRunMerger::next(size_t& entry_idx) {
+  if (heap_.empty()) {
+    return false;
+  }
+  const auto run_idx = popHeap();
+  auto& reader = *readers_[run_idx];
+  uint64_t spilled_entry_idx;
+  std::memcpy(
+      &spilled_entry_idx, reader.record() + key_width_, sizeof(spilled_entry_idx));
+  entry_idx = spilled_entry_idx;
+  reader.advance();
+  if (!reader.exhausted()) {
+    pushHeap(run_idx);
+  }
+  return true;
+}
+
+bool SortedRunMerger::runKeyGreater(const size_t lhs_run_idx,
+                                    const size_t rhs_run_idx) const {
+  return std::memcmp(readers_[lhs_run_idx]->record(),
+                     readers_[rhs_run_idx]->record(),
+                     key_width_) > 0;
+}
+
+void SortedRunMerger::pushHeap(const size_t run_idx) {
+  heap_.push_back(run_idx);
+  std::push_heap(heap_.begin(), heap_.end(), [this](const size_t lhs, const size_t rhs) {
+    return runKeyGreater(lhs, rhs);
+  });
+}
+
+size_t SortedRunMerger::popHeap() {
+  std::pop_heap(heap_.begin(), heap_.end(), [this](const size_t lhs, const size_t rhs) {
+    return runKeyGreater(lhs, rhs);
+  });
+  const auto run_idx = heap_.back();
+  heap_.pop_back();
+  return run_idx;
+}
+
+}  // namespace normalized_key_sort
@@ -0,0 +1,128 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SortedRunMerger.h
+ * @brief   Spilling of sorted normalized key runs to disk and k-way merging of them,
+ *          used by the external (out-of-core) result set sort.
+ *
+ * On disk, a run is a sequence of records of the form [key bytes][uint64 entry index],
+ * ordered by key. The merged rows are spilled again in sort order and mapped back into
+ * memory, so the payload of the result set doesn't have to stay resident either.
+ */
+
+#pragma once
+
+#include "NormalizedKeySort.h"
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace normalized_key_sort {
+
+// Appends to a spill file through a write buffer of `buffer_bytes`. The file is removed
+// if the writer is destroyed before close().
+class SpillFileWriter {
+ public:
+  SpillFileWriter(const std::string& path, const size_t buffer_bytes);
+
+  ~SpillFileWriter();
+
+  void append(const int8_t* data, const size_t bytes);
+
+  void close();
+
+  SpillFileWriter(const SpillFileWriter&) = delete;
+  SpillFileWriter& operator=(const SpillFileWriter&) = delete;
+
+ private:
+  void flush();
+
+  const std::string path_;
+  std::vector<int8_t> buffer_;
+  size_t buffered_bytes_{0};
+  std::FILE* file_;
+};
+
+// A spill file mapped copy-on-write into memory and deleted on destruction. Pages which
+// were not written to are backed by the file, so they can be dropped under memory
+// pressure and read back on access.
+class SpilledBuffer {
+ public:
+  explicit SpilledBuffer(const std::string& path);
+
+  ~SpilledBuffer();
+
+  // nullptr for an empty file.
+  int8_t* data() const;
+
+  size_t size() const;
+
+  SpilledBuffer(const SpilledBuffer&) = delete;
+  SpilledBuffer& operator=(const SpilledBuffer&) = delete;
+
+ private:
+  const std::string path_;
+  boost::iostreams::mapped_file file_;
+};
+
+// Writes the (already sorted) records of `key_buffer` to `path`, storing
+// `entry_base + rowIndex(i)` as the entry index of every record.
+void spill_sorted_run(const std::string& path,
+                      const KeyBuffer& key_buffer,
+                      const uint64_t entry_base);
+
+// Streams the entry indices of several spilled runs in global key order.
+class SortedRunMerger {
+ public:
+  // Takes ownership of the run files, which are deleted on destruction.
+  SortedRunMerger(const std::vector<std::string>& run_paths,
+                  const size_t key_width,
+                  const size_t read_buffer_bytes);
+
+  ~SortedRunMerger();
+
+  // Sets `entry_idx` to the next entry in sorted order; returns false once all runs are
+  // exhausted.
+  bool next(size_t& entry_idx);
+
+  // Restarts the merge from the first entry.
+  void rewind();
+
+  SortedRunMerger(const SortedRunMerger&) = delete;
+  SortedRunMerger& operator=(const SortedRunMerger&) = delete;
+
+ private:
+  class RunReader;
+
+  bool runKeyGreater(const size_t lhs_run_idx, const size_t rhs_run_idx) const;
+  void pushHeap(const size_t run_idx);
+  size_t popHeap();
+
+  const std::vector<std::string> run_paths_;
+  const size_t key_width_;
+  const size_t record_width_;
+  const size_t read_buffer_records_;
+  std::vector<std::unique_ptr<RunReader>> readers_;
+  // Min-heap of run indices, ordered by the current key of each run.
+  std::vector<size_t> heap_;
+};
+
+}  // namespace normalized_key_sort
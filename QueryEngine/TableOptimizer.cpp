@@ -20,12 +20,20 @@
 #include "LockMgr/LockMgr.h"
 #include "Logger/Logger.h"
 #include "QueryEngine/Execute.h"
+#include "QueryEngine/GroupByAndAggregate.h"
 #include "Shared/misc.h"
 #include "Shared/scope.h"
 
 // By default, when rows are deleted, vacuum fragments with a least 10% deleted rows
 float g_vacuum_min_selectivity{0.1};
 
+// By default, cluster tables when the sort column ranges of a quarter of their fragments
+// overlap
+float g_cluster_min_overlap{0.25};
+
+// Cluster at most about 64M rows under one table write lock
+size_t g_cluster_max_batch_rows{size_t(1) << 26};
+
 TableOptimizer::TableOptimizer(const TableDescriptor* td,
                                Executor* executor,
                                const Catalog_Namespace::Catalog& cat)
@@ -115,6 +123,16 @@ inline ExecutionOptions get_execution_options() {
       false, false, false, false, false, false, false, false, 0, false, false, 0, false};
 }
 
+std::pair<double, double> get_stats_range(const ChunkStats& stats,
+                                          const SQLTypeInfo& ti) {
+  if (ti.get_type() == kFLOAT) {
+    return {stats.min.floatval, stats.max.floatval};
+  } else if (ti.get_type() == kDOUBLE) {
+    return {stats.min.doubleval, stats.max.doubleval};
+  }
+  return {extract_min_stat(stats, ti), extract_max_stat(stats, ti)};
+}
+
 }  // namespace
 
 void TableOptimizer::recomputeMetadata() const {
@@ -550,3 +568,198 @@ void TableOptimizer::vacuumFragmentsAboveMinSelectivity(
     cat_.checkpointWithAutoRollback(td_->tableId);
   }
 }
+
+void TableOptimizer::clusterRows(const std::vector<std::string>& column_names,
+                                 const bool z_order) const {
+  auto timer = DEBUG_TIMER(__func__);
+  if (!td_->hasDeletedCol) {
+    throw std::runtime_error("Cannot cluster table " + td_->tableName +
+                             ", clustering requires VACUUM = 'DELAYED'.");
+  }
+  const auto column_ids = getClusterColumnIds(column_names);
+  LOG(INFO) << "Clustering rows of " << td_->tableName;
+  const auto table_id = td_->tableId;
+  const auto db_id = cat_.getDatabaseId();
+  std::vector<std::vector<std::vector<int>>> batches_per_shard;
+  {
+    const auto table_lock =
+        lockmgr::TableDataLockMgr::getReadLockForTable({db_id, table_id});
+    for (const auto shard : cat_.getPhysicalTablesDescriptors(td_)) {
+      batches_per_shard.push_back(getClusterBatches(shard, column_ids.front()));
+    }
+  }
+
+  // Each batch is clustered under its own write lock. The rows of the batch are written
+  // to new fragments and deleted from the old ones in one checkpoint, the old fragments
+  // are only dropped after it, so that their pages can't be reused before the new
+  // fragments are durable.
+  for (size_t shard_idx = 0; shard_idx < batches_per_shard.size(); ++shard_idx) {
+    int last_fragment_id{-1};
+    for (const auto& fragment_ids : batches_per_shard[shard_idx]) {
+      {
+        const auto table_lock =
+            lockmgr::TableDataLockMgr::getWriteLockForTable({db_id, table_id});
+        const auto shards = cat_.getPhysicalTablesDescriptors(td_);
+        CHECK_EQ(shards.size(), batches_per_shard.size());
+        const auto shard = shards[shard_idx];
+        CHECK(shard->fragmenter);
+        const auto table_epochs = cat_.getTableEpochs(db_id, table_id);
+        try {
+          last_fragment_id = shard->fragmenter->clusterRows(
+              column_ids, z_order, fragment_ids, last_fragment_id);
+          cat_.checkpoint(table_id);
+        } catch (...) {
+          cat_.setTableEpochsLogExceptions(db_id, table_epochs);
+          // The fragmenters may already list the new fragments.
+          for (const auto shard : shards) {
+            cat_.removeFragmenterForTable(shard->tableId);
+          }
+          throw;
+        }
+        shard->fragmenter->dropFragments(fragment_ids);
+        cat_.checkpoint(table_id);
+      }
+      mapd_unique_lock<mapd_shared_mutex> lock(executor_->execute_mutex_);
+      executor_->clearMetaInfoCache();
+    }
+  }
+
+  const auto table_lock =
+      lockmgr::TableDataLockMgr::getWriteLockForTable({db_id, table_id});
+  for (auto shard : cat_.getPhysicalTablesDescriptors(td_)) {
+    cat_.removeFragmenterForTable(shard->tableId);
+    cat_.getDataMgr().getGlobalFileMgr()->compactDataFiles(cat_.getDatabaseId(),
+                                                           shard->tableId);
+  }
+}
+
+std::vector<std::vector<int>> TableOptimizer::getClusterBatches(
+    const TableDescriptor* td,
+    const int column_id) const {
+  CHECK(td->fragmenter);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  const auto cd = cat_.getMetadataForColumn(td->tableId, column_id);
+  CHECK(cd);
+  const auto& ti = cd->columnType;
+  // Batches of fragments with close values of the first clustering column give
+  // fragments with narrow ranges on it, other columns keep the fragments in order.
+  const bool has_stats = !(ti.is_string() && !ti.is_dict_encoded_string());
+  std::vector<std::pair<double, const Fragmenter_Namespace::FragmentInfo*>> fragments;
+  for (const auto& fragment : table_info.fragments) {
+    double min{0};
+    if (has_stats && fragment.getPhysicalNumTuples()) {
+      const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+      const auto it = chunk_metadata_map.find(column_id);
+      CHECK(it != chunk_metadata_map.end());
+      min = get_stats_range(it->second->chunkStats, ti).first;
+    }
+    fragments.emplace_back(min, &fragment);
+  }
+  std::stable_sort(
+      fragments.begin(), fragments.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first < rhs.first;
+      });
+  std::vector<std::vector<int>> batches;
+  size_t batch_rows{0};
+  for (const auto& [min, fragment] : fragments) {
+    static_cast<void>(min);
+    const auto num_rows = fragment->getPhysicalNumTuples();
+    if (batches.empty() || batch_rows + num_rows > g_cluster_max_batch_rows) {
+      batches.emplace_back();
+      batch_rows = 0;
+    }
+    batches.back().push_back(fragment->fragmentId);
+    batch_rows += num_rows;
+  }
+  return batches;
+}
+
+std::vector<int> TableOptimizer::getClusterColumnIds(
+    const std::vector<std::string>& column_names) const {
+  if (column_names.empty()) {
+    if (td_->sortedColumnId == 0) {
+      throw std::runtime_error("Table " + td_->tableName +
+                               " has no sort column, the columns to cluster on must be "
+                               "given.");
+    }
+    return {td_->sortedColumnId};
+  }
+  std::vector<int> column_ids;
+  for (const auto& column_name : column_names) {
+    const auto cd = cat_.getMetadataForColumn(td_->tableId, column_name);
+    if (!cd || cd->isSystemCol || cd->isVirtualCol) {
+      throw std::runtime_error("Column " + column_name + " does not exist in table " +
+                               td_->tableName + ".");
+    }
+    if (cd->columnType.is_geometry() || cd->columnType.is_array()) {
+      throw std::runtime_error("Cannot cluster on column " + column_name +
+                               ", clustering on geo and array columns is not supported.");
+    }
+    if (!shared::contains(column_ids, cd->columnId)) {
+      column_ids.push_back(cd->columnId);
+    }
+  }
+  return column_ids;
+}
+
+bool TableOptimizer::shouldClusterRows() const {
+  if (td_->sortedColumnId == 0 || !td_->hasDeletedCol) {
+    return false;
+  }
+  const auto table_lock = lockmgr::TableDataLockMgr::getReadLockForTable(
+      {cat_.getDatabaseId(), td_->tableId});
+  for (const auto shard : cat_.getPhysicalTablesDescriptors(td_)) {
+    if (shouldClusterRows(shard)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TableOptimizer::shouldClusterRows(const TableDescriptor* td) const {
+  CHECK(td->fragmenter);
+  const auto table_info = td->fragmenter->getFragmentsForQuery();
+  const auto& fragments = table_info.fragments;
+  const auto num_rows = table_info.getPhysicalNumTuples();
+  const auto max_fragment_rows =
+      std::max(static_cast<size_t>(td->maxFragRows), size_t(1));
+  const size_t min_fragment_count =
+      std::max((num_rows + max_fragment_rows - 1) / max_fragment_rows, size_t(1));
+  if (fragments.size() > min_fragment_count) {
+    return true;
+  }
+
+  const auto cd = cat_.getMetadataForColumn(td->tableId, td_->sortedColumnId);
+  CHECK(cd);
+  const auto& ti = cd->columnType;
+  if (fragments.size() < 2 || (ti.is_string() && !ti.is_dict_encoded_string()) ||
+      ti.is_array() || ti.is_geometry()) {
+    return false;
+  }
+  // Sort the ranges of the sort column by their minimum and count the ranges which
+  // overlap any of the ranges before them. Ranges which only touch don't overlap, the
+  // rows of a key may straddle the boundary of two clustered fragments.
+  std::vector<std::pair<double, double>> ranges;
+  for (const auto& fragment : fragments) {
+    if (fragment.getPhysicalNumTuples() == 0) {
+      continue;
+    }
+    const auto& chunk_metadata_map = fragment.getChunkMetadataMapPhysical();
+    const auto it = chunk_metadata_map.find(cd->columnId);
+    CHECK(it != chunk_metadata_map.end());
+    ranges.push_back(get_stats_range(it->second->chunkStats, ti));
+  }
+  if (ranges.size() < 2) {
+    return false;
+  }
+  std::sort(ranges.begin(), ranges.end());
+  size_t overlapping_range_count{0};
+  auto max = ranges.front().second;
+  for (size_t i = 1; i < ranges.size(); ++i) {
+    if (ranges[i].first < max) {
+      ++overlapping_range_count;
+    }
+    max = std::max(max, ranges[i].second);
+  }
+  return float(overlapping_range_count) / ranges.size() >= g_cluster_min_overlap;
+}
@@ -72,6 +72,29 @@ class TableOptimizer {
   void vacuumFragmentsAboveMinSelectivity(
       const TableUpdateMetadata& table_update_metadata) const;
 
+  /**
+   * @brief Rewrites the rows of the table into new fragments sorted on the given
+   * columns, or on the sort column of the table if no columns are given.
+   * Rows are sorted lexicographically on the columns, or along a Z-order curve over
+   * them if `z_order` is set, which keeps the ranges of each of the columns narrow in
+   * every fragment. The new fragments are full, so small fragments get merged, and
+   * deleted rows are dropped. The fragments are clustered in batches of fragments with
+   * close values of the first column and up to --cluster-max-batch-rows rows, each under
+   * its own table write lock. The rows are only sorted within a batch, so the ranges of
+   * fragments of different batches may still overlap. Like vacuuming, clustering is a checkpointing operation,
+   * the rows of a batch move to the new fragments with one epoch and the old fragments
+   * are dropped with the next one.
+   */
+  void clusterRows(const std::vector<std::string>& column_names,
+                   const bool z_order) const;
+
+  /**
+   * Returns true if the table has a sort column and either has more fragments than its
+   * rows need, or the ranges of the sort column of enough of its fragments overlap, as
+   * configured by the minimum cluster overlap threshold.
+   */
+  bool shouldClusterRows() const;
+
  private:
   DeletedColumnStats recomputeDeletedColumnMetadata(
       const TableDescriptor* td,
@@ -93,6 +116,14 @@ class TableOptimizer {
       const TableDescriptor* td,
       const std::set<size_t>& fragment_indexes) const;
 
+  std::vector<int> getClusterColumnIds(
+      const std::vector<std::string>& column_names) const;
+
+  bool shouldClusterRows(const TableDescriptor* td) const;
+
+  std::vector<std::vector<int>> getClusterBatches(const TableDescriptor* td,
+                                                  const int column_id) const;
+
   const TableDescriptor* td_;
   Executor* executor_;
   const Catalog_Namespace::Catalog& cat_;
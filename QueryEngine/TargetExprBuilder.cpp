@@ -318,8 +318,12 @@ void TargetExprCodegen::codegenAggregate(
         CHECK_EQ(size_t(0), col_off_in_bytes % sizeof(int64_t));
         col_off /= sizeof(int64_t);
       }
+      const bool use_hash_set =
+          query_mem_desc.getCountDistinctDescriptor(target_idx).impl_type_ ==
+          CountDistinctImplType::HashSet;
       executor->cgen_state_->emitExternalCall(
-          "agg_count_distinct_array_" + numeric_type_name(elem_ti),
+          std::string("agg_count_distinct_array_") + (use_hash_set ? "hash_set_" : "") +
+              numeric_type_name(elem_ti),
           llvm::Type::getVoidTy(LL_CONTEXT),
           {is_group_by
                ? LL_BUILDER.CreateGEP(std::get<0>(agg_out_ptr_w_idx), LL_INT(col_off))
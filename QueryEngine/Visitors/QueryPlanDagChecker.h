@@ -34,7 +34,11 @@ class QueryPlanDagChecker final : public RelRexDagVisitor {
     not_supported_functions.emplace("CARDINALITY");
     not_supported_functions.emplace("ARRAY_LENGTH");
     not_supported_functions.emplace("ITEM");
+    // the current time is resolved when the query is translated
     not_supported_functions.emplace("NOW");
+    not_supported_functions.emplace("CURRENT_DATE");
+    not_supported_functions.emplace("CURRENT_TIME");
+    not_supported_functions.emplace("CURRENT_TIMESTAMP");
     not_supported_functions.emplace("SIGN");
     not_supported_functions.emplace("OFFSET_IN_FRAGMENT");
     not_supported_functions.emplace("DATETIME");
@@ -23,7 +23,8 @@ struct TColSlotContext {
 enum TCountDistinctImplType {
   Invalid,
   Bitmap,
-  StdSet
+  StdSet,
+  HashSet
 }
 
 struct TCountDistinctDescriptor {
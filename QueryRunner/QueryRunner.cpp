@@ -1034,6 +1034,7 @@ size_t QueryRunner::getNumberOfCachedOverlapsHashTablesAndTuningParams() {
 }
 
 void QueryRunner::reset() {
+  Executor::shutdownBackgroundCompilation();
   qr_instance_.reset(nullptr);
   calcite_shutdown_handler();
 }
@@ -0,0 +1,70 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    SequenceEncoding.h
+ * @brief   Chunk layouts of the run length (RL) and differential (DIFF) integer
+ *          encodings.
+ *
+ * Unlike the fixed width encodings, these don't store one slot per row:
+ *
+ * RL:   [int64 run count][run 0]...[run n - 1], where every run is a pair of slots
+ *       (value, end row exclusive). Slots are 4 bytes wide for types up to 32 bits and
+ *       8 bytes otherwise.
+ *
+ * DIFF: [int64 first value][int64 last value][int32 slot width][int32 unused]
+ *       [slot 0]...[slot n - 1], where every slot holds the difference between the row
+ *       value and the previous non null value, the first value of the chunk for the
+ *       first one, using the narrowest width (1, 2 or 4 bytes) which fits all of them.
+ *       When the differences need 8 bytes the slots hold the values themselves. The
+ *       smallest value of the slot type marks nulls.
+ *
+ * Neither can be read by position, so chunks are decoded into one slot per row when they
+ * are fetched for a query, see SequenceEncoder::getDecodedRows().
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace sequence_encoding {
+
+constexpr int64_t kRunLengthHeaderBytes{8};
+constexpr int64_t kDiffHeaderBytes{24};
+
+inline int32_t run_length_slot_width(const int32_t logical_width) {
+  return logical_width <= 4 ? 4 : 8;
+}
+
+inline int64_t read_slot(const int8_t* slot, const int32_t slot_width) {
+  switch (slot_width) {
+    case 1:
+      return *slot;
+    case 2:
+      return *reinterpret_cast<const int16_t*>(slot);
+    case 4:
+      return *reinterpret_cast<const int32_t*>(slot);
+    default:
+      return *reinterpret_cast<const int64_t*>(slot);
+  }
+}
+
+inline int64_t diff_null_slot(const int32_t slot_width) {
+  return slot_width == 8 ? static_cast<int64_t>(uint64_t(1) << 63)
+                         : -(int64_t(1) << (8 * slot_width - 1));
+}
+
+}  // namespace sequence_encoding
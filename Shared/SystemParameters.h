@@ -71,6 +71,9 @@ struct SystemParameters {
   size_t calcite_timeout = 5000;     // calcite connect/send/receive timeout
   size_t calcite_keepalive = false;  // calcite keepalive connection
   int num_executors = 2;
+  // queries over tables with at least this many rows are dispatched as heavy queries,
+  // which may not take the last free executor; 0 (default) disables the distinction
+  size_t heavy_query_min_rows = 0;
   int num_sessions = -1;  // maximum number of user sessions
 
   SystemParameters() : cuda_block_size(0), cuda_grid_size(0), calcite_max_mem(1024) {}
@@ -865,6 +865,12 @@ class SQLTypeInfo {
     return false;
   }
 
+  // Run length and differential encoded chunks don't store one slot per row, see
+  // SequenceEncoding.h. The size of these types is their decoded width.
+  HOST DEVICE inline bool is_sequence_encoded() const {
+    return compression == kENCODING_RL || compression == kENCODING_DIFF;
+  }
+
   inline bool is_date() const { return type == kDATE; }
 
   inline bool is_high_precision_timestamp() const {
@@ -902,13 +908,12 @@ class SQLTypeInfo {
       case kSMALLINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
+          case kENCODING_DIFF:
             return sizeof(int16_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -916,14 +921,13 @@ class SQLTypeInfo {
       case kINT:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
+          case kENCODING_DIFF:
             return sizeof(int32_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
           case kENCODING_GEOINT:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -933,13 +937,12 @@ class SQLTypeInfo {
       case kDECIMAL:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
+          case kENCODING_DIFF:
             return sizeof(int64_t);
           case kENCODING_FIXED:
           case kENCODING_SPARSE:
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
-            break;
           default:
             assert(false);
         }
@@ -979,14 +982,14 @@ class SQLTypeInfo {
       case kDATE:
         switch (compression) {
           case kENCODING_NONE:
+          case kENCODING_RL:
+          case kENCODING_DIFF:
             return sizeof(int64_t);
           case kENCODING_FIXED:
             if (type == kTIMESTAMP && dimension > 0) {
               assert(false);  // disable compression for timestamp precisions
             }
             return comp_param / 8;
-          case kENCODING_RL:
-          case kENCODING_DIFF:
           case kENCODING_SPARSE:
             assert(false);
             break;
@@ -1048,7 +1051,7 @@ int64_t convert_decimal_value_to_scale(const int64_t decimal_value,
 
 inline SQLTypeInfo get_logical_type_info(const SQLTypeInfo& type_info) {
   EncodingType encoding = type_info.get_compression();
-  if (encoding == kENCODING_DATE_IN_DAYS ||
+  if (encoding == kENCODING_DATE_IN_DAYS || type_info.is_sequence_encoded() ||
       (encoding == kENCODING_FIXED && type_info.get_type() != kARRAY)) {
     encoding = kENCODING_NONE;
   }
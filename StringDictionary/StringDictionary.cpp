@@ -37,6 +37,7 @@
 #include "Shared/sqltypes.h"
 #include "Shared/thread_count.h"
 #include "StringDictionaryClient.h"
+#include "TrigramIndex.h"
 #include "Utils/Regexp.h"
 #include "Utils/StringLike.h"
 
@@ -88,6 +89,7 @@ string_dict_hash_t hash_string(const std::string_view& str) {
 }  // namespace
 
 bool g_enable_stringdict_parallel{false};
+bool g_enable_stringdict_trigram_index{false};
 constexpr int32_t StringDictionary::INVALID_STR_ID;
 constexpr size_t StringDictionary::MAX_STRLEN;
 constexpr size_t StringDictionary::MAX_STRCOUNT;
@@ -117,6 +119,12 @@ StringDictionary::StringDictionary(const std::string& folder,
 
   // initial capacity must be a power of two for efficient bucket computation
   CHECK_EQ(size_t(0), (initial_capacity & (initial_capacity - 1)));
+  if (g_enable_stringdict_trigram_index) {
+    // Strings are indexed lazily, by the first pattern search after they are added.
+    trigram_index_ = std::make_unique<TrigramIndex>(
+        isTemp_ ? std::string()
+                : (boost::filesystem::path(folder) / "DictTrigrams").string());
+  }
   if (!isTemp_) {
     boost::filesystem::path storage_path(folder);
     offsets_path_ = (storage_path / boost::filesystem::path("DictOffsets")).string();
@@ -228,6 +236,7 @@ void StringDictionary::processDictionaryFutures(
       ++str_count_;
     }
   }
+  readable_str_count_.store(str_count_, std::memory_order_release);
   dictionary_futures.clear();
 }
 
@@ -413,6 +422,7 @@ void StringDictionary::getOrAddBulk(const std::vector<String>& input_strings,
   }
   const size_t num_strings_added = str_count_ - initial_str_count;
   if (num_strings_added > 0) {
+    readable_str_count_.store(str_count_, std::memory_order_release);
     invalidateInvertedIndex();
   }
 }
@@ -429,23 +439,59 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
   std::vector<string_dict_hash_t> input_strings_hashes(input_strings.size());
   hashStrings(input_strings, input_strings_hashes);
 
+  // Most strings of a batch are usually in the dictionary already: look them all up in
+  // parallel under the shared lock, so that lookups of concurrent loads and queries
+  // proceed, and only hold the write lock to add the strings which are still missing.
+  std::vector<size_t> missing_string_indices;
+  {
+    std::vector<uint8_t> is_missing(input_strings.size(), 0);
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    tbb::parallel_for(
+        tbb::blocked_range<size_t>(0, input_strings.size()),
+        [&](const tbb::blocked_range<size_t>& r) {
+          for (size_t input_string_idx = r.begin(); input_string_idx != r.end();
+               ++input_string_idx) {
+            const auto& input_string = input_strings[input_string_idx];
+            // Currently we make empty strings null
+            if (input_string.empty()) {
+              output_string_ids[input_string_idx] = inline_int_null_value<T>();
+              continue;
+            }
+            // TODO: Recover gracefully if an input string is too long
+            CHECK(input_string.size() <= MAX_STRLEN);
+            const auto hash_bucket = computeBucket(input_strings_hashes[input_string_idx],
+                                                   input_string,
+                                                   string_id_string_dict_hash_table_);
+            const auto string_id = string_id_string_dict_hash_table_[hash_bucket];
+            if (string_id == INVALID_STR_ID) {
+              is_missing[input_string_idx] = 1;
+            } else {
+              output_string_ids[input_string_idx] = string_id;
+            }
+          }
+        });
+    for (size_t input_string_idx = 0; input_string_idx < is_missing.size();
+         ++input_string_idx) {
+      if (is_missing[input_string_idx]) {
+        missing_string_indices.push_back(input_string_idx);
+      }
+    }
+  }
+  if (missing_string_indices.empty()) {
+    return;
+  }
+
   mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
   size_t shadow_str_count =
       str_count_;  // Need to shadow str_count_ now with bulk add methods
   const size_t storage_high_water_mark = shadow_str_count;
   std::vector<size_t> string_memory_ids;
   size_t sum_new_string_lengths = 0;
-  string_memory_ids.reserve(input_strings.size());
-  size_t input_string_idx{0};
-  for (const auto& input_string : input_strings) {
-    // Currently we make empty strings null
-    if (input_string.empty()) {
-      output_string_ids[input_string_idx++] = inline_int_null_value<T>();
-      continue;
-    }
-    // TODO: Recover gracefully if an input string is too long
-    CHECK(input_string.size() <= MAX_STRLEN);
-
+  string_memory_ids.reserve(missing_string_indices.size());
+  // Another writer may have added some of the missing strings since the lookup above,
+  // so they are looked up again under the write lock.
+  for (const auto input_string_idx : missing_string_indices) {
+    const auto& input_string = input_strings[input_string_idx];
     if (fillRateIsHigh(shadow_str_count)) {
       // resize when more than 50% is full
       increaseHashTableCapacityFromStorageAndMemory(shadow_str_count,
@@ -469,7 +515,7 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     // (computeBucketFromStorageAndMemory) already checked to ensure the input string and
     // bucket string are equal)
     if (string_id_string_dict_hash_table_[hash_bucket] != INVALID_STR_ID) {
-      output_string_ids[input_string_idx++] =
+      output_string_ids[input_string_idx] =
           string_id_string_dict_hash_table_[hash_bucket];
       continue;
     }
@@ -491,12 +537,13 @@ void StringDictionary::getOrAddBulkParallel(const std::vector<String>& input_str
     if (materialize_hashes_) {
       hash_cache_[shadow_str_count] = input_string_hash;
     }
-    output_string_ids[input_string_idx++] = shadow_str_count++;
+    output_string_ids[input_string_idx] = shadow_str_count++;
   }
   appendToStorageBulk(input_strings, string_memory_ids, sum_new_string_lengths);
   const size_t num_strings_added = shadow_str_count - str_count_;
   str_count_ = shadow_str_count;
   if (num_strings_added > 0) {
+    readable_str_count_.store(str_count_, std::memory_order_release);
     invalidateInvertedIndex();
   }
 }
@@ -574,13 +621,17 @@ int32_t StringDictionary::getUnlocked(const std::string& str) const noexcept {
 }
 
 std::string StringDictionary::getString(int32_t string_id) const {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
     std::string ret;
     client_->get_string(ret, string_id);
     return ret;
   }
-  return getStringUnlocked(string_id);
+  // Storage entries are never modified once readable, so only a concurrent remap of the
+  // storage buffers can get in the way.
+  CHECK_LT(string_id,
+           static_cast<int32_t>(readable_str_count_.load(std::memory_order_acquire)));
+  mapd_shared_lock<mapd_shared_mutex> storage_lock(storage_remap_mutex_);
+  return getStringChecked(string_id);
 }
 
 std::string StringDictionary::getStringUnlocked(int32_t string_id) const noexcept {
@@ -590,19 +641,19 @@ std::string StringDictionary::getStringUnlocked(int32_t string_id) const noexcep
 
 std::pair<char*, size_t> StringDictionary::getStringBytes(int32_t string_id) const
     noexcept {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   CHECK(!client_);
   CHECK_LE(0, string_id);
-  CHECK_LT(string_id, static_cast<int32_t>(str_count_));
+  CHECK_LT(string_id,
+           static_cast<int32_t>(readable_str_count_.load(std::memory_order_acquire)));
+  mapd_shared_lock<mapd_shared_mutex> storage_lock(storage_remap_mutex_);
   return getStringBytesChecked(string_id);
 }
 
 size_t StringDictionary::storageEntryCount() const {
-  mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
   if (client_) {
     return client_->storage_entry_count();
   }
-  return str_count_;
+  return readable_str_count_.load(std::memory_order_acquire);
 }
 
 namespace {
@@ -631,40 +682,37 @@ bool is_like(const std::string& str,
 
 }  // namespace
 
-std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
-                                               const bool icase,
-                                               const bool is_simple,
-                                               const char escape,
-                                               const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
-  if (client_) {
-    return client_->get_like(pattern, icase, is_simple, escape, generation);
-  }
-  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
-  const auto it = like_cache_.find(cache_key);
-  if (it != like_cache_.end()) {
-    return it->second;
+template <class Matcher>
+std::vector<int32_t> StringDictionary::getMatchingStringIds(
+    const std::vector<std::string>& required_literals,
+    const size_t generation,
+    const Matcher& is_match) const {
+  std::optional<std::vector<int32_t>> candidates;
+  if (trigram_index_) {
+    trigram_index_->update(str_count_, [this](const int32_t string_id) {
+      return getStringFromStorageFast(string_id);
+    });
+    candidates = trigram_index_->getCandidates(required_literals, generation);
   }
-  std::vector<int32_t> result;
+  const size_t candidate_count = candidates ? candidates->size() : generation;
   std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
+  const int worker_count = candidate_count > 10000 ? cpu_threads() : 1;
   CHECK_GT(worker_count, 0);
   std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
   for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
     workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          icase,
-                          is_simple,
-                          escape,
+                          &candidates,
+                          &is_match,
+                          candidate_count,
                           worker_idx,
                           worker_count,
                           this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
+      for (size_t candidate_idx = worker_idx; candidate_idx < candidate_count;
+           candidate_idx += worker_count) {
+        const int32_t string_id = candidates ? (*candidates)[candidate_idx]
+                                             : static_cast<int32_t>(candidate_idx);
         const auto str = getStringUnlocked(string_id);
-        if (is_like(str, pattern, icase, is_simple, escape)) {
+        if (is_match(str)) {
           worker_results[worker_idx].push_back(string_id);
         }
       }
@@ -673,14 +721,46 @@ std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
   for (auto& worker : workers) {
     worker.join();
   }
+  std::vector<int32_t> result;
   for (const auto& worker_result : worker_results) {
     result.insert(result.end(), worker_result.begin(), worker_result.end());
   }
-  // place result into cache for reuse if similar query
-  const auto it_ok = like_cache_.insert(std::make_pair(cache_key, result));
-
-  CHECK(it_ok.second);
+  return result;
+}
 
+std::vector<int32_t> StringDictionary::getLike(const std::string& pattern,
+                                               const bool icase,
+                                               const bool is_simple,
+                                               const char escape,
+                                               const size_t generation) const {
+  if (client_) {
+    return client_->get_like(pattern, icase, is_simple, escape, generation);
+  }
+  const auto cache_key = std::make_tuple(pattern, icase, is_simple, escape);
+  std::vector<int32_t> result;
+  size_t str_count{0};
+  {
+    // Matching only reads the strings, lookups and other searches can proceed.
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    const auto it = like_cache_.find(cache_key);
+    if (it != like_cache_.end()) {
+      return it->second;
+    }
+    CHECK_LE(generation, str_count_);
+    str_count = str_count_;
+    result = getMatchingStringIds(
+        TrigramIndex::getLikeLiterals(pattern, is_simple, escape),
+        generation,
+        [&pattern, icase, is_simple, escape](const std::string& str) {
+          return is_like(str, pattern, icase, is_simple, escape);
+        });
+  }
+  // place result into cache for reuse if similar query, unless strings added in the
+  // meantime invalidated the cache
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  if (str_count_ == str_count) {
+    like_cache_.emplace(cache_key, result);
+  }
   return result;
 }
 
@@ -908,47 +988,30 @@ bool is_regexp_like(const std::string& str,
 std::vector<int32_t> StringDictionary::getRegexpLike(const std::string& pattern,
                                                      const char escape,
                                                      const size_t generation) const {
-  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
   if (client_) {
     return client_->get_regexp_like(pattern, escape, generation);
   }
   const auto cache_key = std::make_pair(pattern, escape);
-  const auto it = regex_cache_.find(cache_key);
-  if (it != regex_cache_.end()) {
-    return it->second;
-  }
   std::vector<int32_t> result;
-  std::vector<std::thread> workers;
-  int worker_count = cpu_threads();
-  CHECK_GT(worker_count, 0);
-  std::vector<std::vector<int32_t>> worker_results(worker_count);
-  CHECK_LE(generation, str_count_);
-  for (int worker_idx = 0; worker_idx < worker_count; ++worker_idx) {
-    workers.emplace_back([&worker_results,
-                          &pattern,
-                          generation,
-                          escape,
-                          worker_idx,
-                          worker_count,
-                          this]() {
-      for (size_t string_id = worker_idx; string_id < generation;
-           string_id += worker_count) {
-        const auto str = getStringUnlocked(string_id);
-        if (is_regexp_like(str, pattern, escape)) {
-          worker_results[worker_idx].push_back(string_id);
-        }
-      }
-    });
-  }
-  for (auto& worker : workers) {
-    worker.join();
+  size_t str_count{0};
+  {
+    mapd_shared_lock<mapd_shared_mutex> read_lock(rw_mutex_);
+    const auto it = regex_cache_.find(cache_key);
+    if (it != regex_cache_.end()) {
+      return it->second;
+    }
+    CHECK_LE(generation, str_count_);
+    str_count = str_count_;
+    result = getMatchingStringIds(TrigramIndex::getRegexpLiterals(pattern),
+                                  generation,
+                                  [&pattern, escape](const std::string& str) {
+                                    return is_regexp_like(str, pattern, escape);
+                                  });
   }
-  for (const auto& worker_result : worker_results) {
-    result.insert(result.end(), worker_result.begin(), worker_result.end());
+  mapd_lock_guard<mapd_shared_mutex> write_lock(rw_mutex_);
+  if (str_count_ == str_count) {
+    regex_cache_.emplace(cache_key, result);
   }
-  const auto it_ok = regex_cache_.insert(std::make_pair(cache_key, result));
-  CHECK(it_ok.second);
-
   return result;
 }
 
@@ -1098,6 +1161,7 @@ int32_t StringDictionary::getOrAddImpl(const std::string_view& str) noexcept {
       hash_cache_[str_count_] = hash;
     }
     ++str_count_;
+    readable_str_count_.store(str_count_, std::memory_order_release);
     invalidateInvertedIndex();
   }
   return string_id_string_dict_hash_table_[bucket];
@@ -1220,6 +1284,7 @@ void StringDictionary::checkAndConditionallyIncreasePayloadCapacity(
   if (payload_file_off_ + write_length > payload_file_size_) {
     const size_t min_capacity_needed =
         write_length - (payload_file_size_ - payload_file_off_);
+    mapd_lock_guard<mapd_shared_mutex> storage_lock(storage_remap_mutex_);
     if (!isTemp_) {
       CHECK_GE(payload_fd_, 0);
       omnisci::checked_munmap(payload_map_, payload_file_size_);
@@ -1240,6 +1305,7 @@ void StringDictionary::checkAndConditionallyIncreaseOffsetCapacity(
   if (offset_file_off + write_length >= offset_file_size_) {
     const size_t min_capacity_needed =
         write_length - (offset_file_size_ - offset_file_off);
+    mapd_lock_guard<mapd_shared_mutex> storage_lock(storage_remap_mutex_);
     if (!isTemp_) {
       CHECK_GE(offset_fd_, 0);
       omnisci::checked_munmap(offset_map_, offset_file_size_);
@@ -1396,6 +1462,7 @@ bool StringDictionary::checkpoint() noexcept {
     }
   }
   CHECK(!isTemp_);
+  const size_t str_count = readable_str_count_.load(std::memory_order_acquire);
   bool ret = true;
   ret = ret &&
         (omnisci::msync((void*)offset_map_, offset_file_size_, /*async=*/false) == 0);
@@ -1403,6 +1470,12 @@ bool StringDictionary::checkpoint() noexcept {
         (omnisci::msync((void*)payload_map_, payload_file_size_, /*async=*/false) == 0);
   ret = ret && (omnisci::fsync(offset_fd_) == 0);
   ret = ret && (omnisci::fsync(payload_fd_) == 0);
+  // The trigram index is derived from the strings and can be rebuilt, failing to
+  // persist it doesn't fail the checkpoint.
+  if (ret && trigram_index_ && !trigram_index_->checkpoint(str_count)) {
+    LOG(WARNING) << "Trigram index of string dictionary " << folder_
+                 << " not checkpointed";
+  }
   return ret;
 }
 
@@ -22,6 +22,7 @@
 #include "DictionaryCache.hpp"
 #include "LeafHostInfo.h"
 
+#include <atomic>
 #include <future>
 #include <map>
 #include <string>
@@ -29,8 +30,10 @@
 #include <vector>
 
 extern bool g_enable_stringdict_parallel;
+extern bool g_enable_stringdict_trigram_index;
 
 class StringDictionaryClient;
+class TrigramIndex;
 
 class DictPayloadUnavailable : public std::runtime_error {
  public:
@@ -158,6 +161,11 @@ class StringDictionary {
   void getOrAddBulkRemote(const std::vector<String>& string_vec, T* encoded_vec);
   int32_t getUnlocked(const std::string& str) const noexcept;
   std::string getStringUnlocked(int32_t string_id) const noexcept;
+  template <class Matcher>
+  std::vector<int32_t> getMatchingStringIds(
+      const std::vector<std::string>& required_literals,
+      const size_t generation,
+      const Matcher& is_match) const;
   std::string getStringChecked(const int string_id) const noexcept;
   std::pair<char*, size_t> getStringBytesChecked(const int string_id) const noexcept;
   template <class String>
@@ -220,12 +228,19 @@ class StringDictionary {
   size_t payload_file_size_;
   size_t payload_file_off_;
   mutable mapd_shared_mutex rw_mutex_;
+  // Number of strings whose storage entries are completely written. getString() and
+  // getStringBytes() only check ids against it and don't take rw_mutex_.
+  std::atomic<size_t> readable_str_count_{0};
+  // Taken exclusively only while the payload and offset buffers are grown and remapped,
+  // so readers of existing strings don't wait behind inserts.
+  mutable mapd_shared_mutex storage_remap_mutex_;
   mutable std::map<std::tuple<std::string, bool, bool, char>, std::vector<int32_t>>
       like_cache_;
   mutable std::map<std::pair<std::string, char>, std::vector<int32_t>> regex_cache_;
   mutable std::map<std::string, int32_t> equal_cache_;
   mutable DictionaryCache<std::string, compare_cache_value_t> compare_cache_;
   mutable std::shared_ptr<std::vector<std::string>> strings_cache_;
+  std::unique_ptr<TrigramIndex> trigram_index_;
   std::unique_ptr<StringDictionaryClient> client_;
   std::unique_ptr<StringDictionaryClient> client_no_timeout_;
 
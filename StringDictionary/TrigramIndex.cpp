@@ -0,0 +1,303 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StringDictionary/TrigramIndex.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cctype>
+#include <fstream>
+
+#include "Logger/Logger.h"
+
+namespace {
+
+// Each checkpoint appends a segment made of this header followed, for each of
+// `trigram_count` trigrams, by the trigram, the number of ids and the ids themselves.
+struct SegmentHeader {
+  uint64_t magic;
+  uint64_t begin_id;
+  uint64_t end_id;
+  uint64_t trigram_count;
+};
+
+constexpr uint64_t kSegmentMagic{0x314D415247495254};  // "TRIGRAM1"
+
+char lowercase(const char c) {
+  return ('A' <= c && c <= 'Z') ? 'a' + (c - 'A') : c;
+}
+
+uint32_t get_trigram(const char* str) {
+  return static_cast<uint32_t>(static_cast<uint8_t>(lowercase(str[0]))) << 16 |
+         static_cast<uint32_t>(static_cast<uint8_t>(lowercase(str[1]))) << 8 |
+         static_cast<uint32_t>(static_cast<uint8_t>(lowercase(str[2])));
+}
+
+template <class T>
+bool read_value(std::istream& in, T& value) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+template <class T>
+void write_value(std::ostream& out, const T& value) {
+  out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void end_literal(std::vector<std::string>& literals, std::string& literal) {
+  if (!literal.empty()) {
+    literals.push_back(literal);
+    literal.clear();
+  }
+}
+
+}  // namespace
+
+TrigramIndex::TrigramIndex(const std::string& path) : path_(path) {
+  if (!path_.empty() && boost::filesystem::exists(path_)) {
+    load();
+  }
+}
+
+void TrigramIndex::addString(PostingLists& posting_lists,
+                             const int32_t string_id,
+                             const std::string_view str) {
+  for (size_t i = 0; i + 3 <= str.size(); ++i) {
+    auto& posting_list = posting_lists[get_trigram(str.data() + i)];
+    // A trigram repeated in the string was already added by its first occurrence.
+    if (posting_list.empty() || posting_list.back() != string_id) {
+      posting_list.push_back(string_id);
+    }
+  }
+}
+
+std::optional<std::vector<int32_t>> TrigramIndex::getCandidates(
+    const std::vector<std::string>& literals,
+    const size_t generation) const {
+  std::vector<uint32_t> trigrams;
+  for (const auto& literal : literals) {
+    for (size_t i = 0; i + 3 <= literal.size(); ++i) {
+      trigrams.push_back(get_trigram(literal.data() + i));
+    }
+  }
+  if (trigrams.empty()) {
+    return std::nullopt;
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+
+  mapd_shared_lock<mapd_shared_mutex> read_lock(mutex_);
+  std::vector<const std::vector<int32_t>*> posting_lists;
+  for (const auto trigram : trigrams) {
+    const auto it = posting_lists_.find(trigram);
+    if (it == posting_lists_.end()) {
+      return std::vector<int32_t>{};
+    }
+    posting_lists.push_back(&it->second);
+  }
+  // Intersect starting from the shortest list, the result only gets shorter.
+  std::sort(posting_lists.begin(),
+            posting_lists.end(),
+            [](const std::vector<int32_t>* lhs, const std::vector<int32_t>* rhs) {
+              return lhs->size() < rhs->size();
+            });
+  const auto& shortest_list = *posting_lists.front();
+  std::vector<int32_t> candidates(
+      shortest_list.begin(),
+      std::lower_bound(
+          shortest_list.begin(), shortest_list.end(), static_cast<int64_t>(generation)));
+  std::vector<int32_t> intersection;
+  for (size_t i = 1; i < posting_lists.size() && !candidates.empty(); ++i) {
+    intersection.clear();
+    std::set_intersection(candidates.begin(),
+                          candidates.end(),
+                          posting_lists[i]->begin(),
+                          posting_lists[i]->end(),
+                          std::back_inserter(intersection));
+    candidates.swap(intersection);
+  }
+  return candidates;
+}
+
+bool TrigramIndex::checkpoint(const size_t str_count) {
+  if (path_.empty()) {
+    return true;
+  }
+  mapd_lock_guard<mapd_shared_mutex> write_lock(mutex_);
+  const size_t end_id = std::min(indexed_count_, str_count);
+  if (end_id <= persisted_count_) {
+    return true;
+  }
+  // Drop whatever follows the valid segments, left by an interrupted checkpoint.
+  if (boost::filesystem::exists(path_) &&
+      boost::filesystem::file_size(path_) != persisted_file_size_) {
+    boost::filesystem::resize_file(path_, persisted_file_size_);
+  }
+  std::ofstream out(path_, std::ios::binary | std::ios::app);
+  std::vector<std::pair<uint32_t, std::pair<std::vector<int32_t>::const_iterator,
+                                            std::vector<int32_t>::const_iterator>>>
+      new_ids;
+  for (const auto& [trigram, posting_list] : posting_lists_) {
+    const auto begin = std::lower_bound(posting_list.begin(),
+                                        posting_list.end(),
+                                        static_cast<int64_t>(persisted_count_));
+    const auto end =
+        std::lower_bound(begin, posting_list.end(), static_cast<int64_t>(end_id));
+    if (begin != end) {
+      new_ids.emplace_back(trigram, std::make_pair(begin, end));
+    }
+  }
+  size_t segment_size = sizeof(SegmentHeader);
+  write_value(out,
+              SegmentHeader{kSegmentMagic, persisted_count_, end_id, new_ids.size()});
+  for (const auto& [trigram, ids] : new_ids) {
+    const uint32_t id_count = ids.second - ids.first;
+    write_value(out, trigram);
+    write_value(out, id_count);
+    out.write(reinterpret_cast<const char*>(&*ids.first), id_count * sizeof(int32_t));
+    segment_size += sizeof(trigram) + sizeof(id_count) + id_count * sizeof(int32_t);
+  }
+  out.flush();
+  if (!out) {
+    LOG(WARNING) << "Could not write the trigram index " << path_;
+    return false;
+  }
+  persisted_count_ = end_id;
+  persisted_file_size_ += segment_size;
+  return true;
+}
+
+void TrigramIndex::load() {
+  std::ifstream in(path_, std::ios::binary);
+  SegmentHeader header;
+  while (read_value(in, header)) {
+    if (header.magic != kSegmentMagic || header.begin_id != indexed_count_ ||
+        header.end_id < header.begin_id) {
+      break;
+    }
+    PostingLists segment_posting_lists;
+    size_t segment_size = sizeof(SegmentHeader);
+    bool segment_complete = true;
+    for (uint64_t i = 0; i < header.trigram_count; ++i) {
+      uint32_t trigram;
+      uint32_t id_count;
+      if (!read_value(in, trigram) || !read_value(in, id_count)) {
+        segment_complete = false;
+        break;
+      }
+      auto& ids = segment_posting_lists[trigram];
+      ids.resize(id_count);
+      if (!in.read(reinterpret_cast<char*>(ids.data()), id_count * sizeof(int32_t))) {
+        segment_complete = false;
+        break;
+      }
+      segment_size += sizeof(trigram) + sizeof(id_count) + id_count * sizeof(int32_t);
+    }
+    if (!segment_complete) {
+      // Interrupted checkpoint, the next one overwrites this segment.
+      LOG(WARNING) << "Ignoring the incomplete last segment of the trigram index "
+                   << path_;
+      break;
+    }
+    for (const auto& [trigram, ids] : segment_posting_lists) {
+      auto& posting_list = posting_lists_[trigram];
+      posting_list.insert(posting_list.end(), ids.begin(), ids.end());
+    }
+    indexed_count_ = header.end_id;
+    persisted_count_ = header.end_id;
+    persisted_file_size_ += segment_size;
+  }
+}
+
+void TrigramIndex::reset() {
+  PostingLists().swap(posting_lists_);
+  indexed_count_ = 0;
+  persisted_count_ = 0;
+  persisted_file_size_ = 0;
+}
+
+std::vector<std::string> TrigramIndex::getLikeLiterals(const std::string& pattern,
+                                                       const bool is_simple,
+                                                       const char escape) {
+  if (is_simple) {
+    // The wildcards around simple patterns are already stripped.
+    return {pattern};
+  }
+  std::vector<std::string> literals;
+  std::string literal;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    if (pattern[i] == escape && i + 1 < pattern.size()) {
+      literal += pattern[++i];
+    } else if (pattern[i] == '%' || pattern[i] == '_') {
+      end_literal(literals, literal);
+    } else {
+      literal += pattern[i];
+    }
+  }
+  end_literal(literals, literal);
+  return literals;
+}
+
+std::vector<std::string> TrigramIndex::getRegexpLiterals(const std::string& pattern) {
+  if (pattern.find_first_of("|()") != std::string::npos) {
+    return {};
+  }
+  std::vector<std::string> literals;
+  std::string literal;
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    const char c = pattern[i];
+    if (c == '\\' && i + 1 < pattern.size()) {
+      const char escaped = pattern[++i];
+      if (std::isalnum(static_cast<unsigned char>(escaped))) {
+        // Character class or assertion, such as \d or \b.
+        end_literal(literals, literal);
+      } else {
+        literal += escaped;
+      }
+    } else if (c == '[') {
+      end_literal(literals, literal);
+      size_t class_end = i + 1;
+      if (class_end < pattern.size() && pattern[class_end] == '^') {
+        ++class_end;
+      }
+      if (class_end < pattern.size() && pattern[class_end] == ']') {
+        ++class_end;
+      }
+      class_end = pattern.find(']', class_end);
+      if (class_end == std::string::npos) {
+        return {};
+      }
+      i = class_end;
+    } else if (c == '*' || c == '?' || c == '{') {
+      // The quantified character may be absent.
+      if (!literal.empty()) {
+        literal.pop_back();
+      }
+      end_literal(literals, literal);
+      if (c == '{') {
+        const auto bound_end = pattern.find('}', i);
+        if (bound_end == std::string::npos) {
+          return {};
+        }
+        i = bound_end;
+      }
+    } else if (c == '+' || c == '.' || c == '^' || c == '$') {
+      end_literal(literals, literal);
+    } else {
+      literal += c;
+    }
+  }
+  end_literal(literals, literal);
+  return literals;
+}
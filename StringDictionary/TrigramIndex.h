@@ -0,0 +1,135 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file    TrigramIndex.h
+ * @brief   Posting lists of the ids of the dictionary strings containing each trigram,
+ * used to narrow down the strings matched against LIKE and REGEXP patterns.
+ *
+ * Trigrams are taken on ASCII lowercased strings, so the same index serves LIKE and
+ * ILIKE. A candidate contains all the trigrams of the literals required by a pattern,
+ * it still has to be matched against the pattern.
+ *
+ * Strings are indexed in id order, which keeps the posting lists sorted and lets every
+ * checkpoint append a segment with just the ids indexed since the previous one to the
+ * index file.
+ */
+
+#ifndef STRINGDICTIONARY_TRIGRAMINDEX_H
+#define STRINGDICTIONARY_TRIGRAMINDEX_H
+
+#include "../Shared/mapd_shared_mutex.h"
+#include "../Shared/thread_count.h"
+
+#include <algorithm>
+#include <future>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class TrigramIndex {
+ public:
+  // Loads the segments found in the index file at `path`. An empty path keeps the index
+  // in memory only.
+  TrigramIndex(const std::string& path);
+
+  // Indexes the strings with ids from the number of strings already indexed up to
+  // `str_count`. `get_string(id)` must return the string with the given id.
+  template <class GetString>
+  void update(const size_t str_count, const GetString& get_string);
+
+  // Returns the sorted ids, below `generation`, of the strings which contain all the
+  // given literals, or std::nullopt if none of the literals is long enough to use the
+  // index.
+  std::optional<std::vector<int32_t>> getCandidates(
+      const std::vector<std::string>& literals,
+      const size_t generation) const;
+
+  // Appends the ids indexed since the previous checkpoint, up to `str_count`, the number
+  // of strings known to be persisted, to the index file.
+  bool checkpoint(const size_t str_count);
+
+  // Substrings contained by every string matching the LIKE pattern.
+  static std::vector<std::string> getLikeLiterals(const std::string& pattern,
+                                                  const bool is_simple,
+                                                  const char escape);
+
+  // Substrings contained by every string matching the regular expression. Patterns with
+  // alternations or groups are not analyzed and yield no literals.
+  static std::vector<std::string> getRegexpLiterals(const std::string& pattern);
+
+ private:
+  using PostingLists = std::unordered_map<uint32_t, std::vector<int32_t>>;
+
+  static void addString(PostingLists& posting_lists,
+                        const int32_t string_id,
+                        const std::string_view str);
+  void load();
+  void reset();
+
+  const std::string path_;
+  PostingLists posting_lists_;
+  size_t indexed_count_{0};
+  // Number of ids and bytes in the valid segments of the index file.
+  size_t persisted_count_{0};
+  size_t persisted_file_size_{0};
+  mutable mapd_shared_mutex mutex_;
+};
+
+template <class GetString>
+void TrigramIndex::update(const size_t str_count, const GetString& get_string) {
+  mapd_lock_guard<mapd_shared_mutex> write_lock(mutex_);
+  if (indexed_count_ > str_count) {
+    // The index file has strings the dictionary didn't recover, start over.
+    reset();
+  }
+  if (indexed_count_ == str_count) {
+    return;
+  }
+  constexpr size_t kMinStringsPerWorker{100000};
+  const size_t new_str_count = str_count - indexed_count_;
+  const size_t worker_count = std::max(
+      std::min(static_cast<size_t>(cpu_threads()), new_str_count / kMinStringsPerWorker),
+      size_t(1));
+  const size_t stride = (new_str_count + worker_count - 1) / worker_count;
+  std::vector<std::future<PostingLists>> workers;
+  for (size_t start = indexed_count_; start < str_count; start += stride) {
+    const size_t end = std::min(start + stride, str_count);
+    workers.emplace_back(std::async(
+        worker_count > 1 ? std::launch::async : std::launch::deferred,
+        [&get_string, start, end] {
+          PostingLists posting_lists;
+          for (size_t string_id = start; string_id < end; ++string_id) {
+            addString(posting_lists, string_id, get_string(string_id));
+          }
+          return posting_lists;
+        }));
+  }
+  // Workers index consecutive ranges of ids, appending their lists in order keeps the
+  // posting lists sorted.
+  for (auto& worker : workers) {
+    const auto worker_posting_lists = worker.get();
+    for (const auto& [trigram, string_ids] : worker_posting_lists) {
+      auto& posting_list = posting_lists_[trigram];
+      posting_list.insert(posting_list.end(), string_ids.begin(), string_ids.end());
+    }
+  }
+  indexed_count_ = str_count;
+}
+
+#endif  // STRINGDICTIONARY_TRIGRAMINDEX_H
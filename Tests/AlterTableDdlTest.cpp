@@ -502,6 +502,68 @@ TEST_F(AlterTableSetMaxRowsTest, NegativeMaxRows) {
                       {{i(1)}, {i(2)}, {i(3)}, {i(4)}, {i(5)}});
 }
 
+class AlterTableSetEvictionPriorityTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    sql("drop table if exists test_table;");
+  }
+
+  void TearDown() override {
+    sql("drop table if exists test_table;");
+    DBHandlerTestFixture::TearDown();
+  }
+
+  int getEvictionPriority(const int table_id) {
+    auto& catalog = getCatalog();
+    return catalog.getDataMgr().getTableEvictionPriority(catalog.getDatabaseId(),
+                                                         table_id);
+  }
+};
+
+TEST_F(AlterTableSetEvictionPriorityTest, SetAndDrop) {
+  sql("create table test_table (i integer);");
+  const auto table_id = getCatalog().getMetadataForTable("test_table", false)->tableId;
+  sql("alter table test_table set eviction_priority = 2;");
+  EXPECT_EQ(2, getEvictionPriority(table_id));
+  sql("alter table test_table set eviction_priority = 0;");
+  EXPECT_EQ(0, getEvictionPriority(table_id));
+  sql("alter table test_table set eviction_priority = 3;");
+  sql("drop table test_table;");
+  EXPECT_EQ(0, getEvictionPriority(table_id));
+}
+
+TEST_F(AlterTableSetEvictionPriorityTest, ReappliedOnCatalogReload) {
+  sql("create table test_table (i integer);");
+  const auto table_id = getCatalog().getMetadataForTable("test_table", false)->tableId;
+  sql("alter table test_table set eviction_priority = 2;");
+
+  // Clear the buffer pool state as a server restart would
+  auto& catalog = getCatalog();
+  catalog.getDataMgr().setTableEvictionPriority(catalog.getDatabaseId(), table_id, 0);
+  resetCatalog();
+  loginAdmin();
+
+  EXPECT_EQ(2, getCatalog().getMetadataForTable(table_id)->evictionPriority);
+  EXPECT_EQ(2, getEvictionPriority(table_id));
+}
+
+TEST_F(AlterTableSetEvictionPriorityTest, ShardedTable) {
+  sql("create table test_table (i integer, shard key (i)) with (shard_count = 2);");
+  auto& catalog = getCatalog();
+  const auto td = catalog.getMetadataForTable("test_table", false);
+  sql("alter table test_table set eviction_priority = -1;");
+  for (const auto shard : catalog.getPhysicalTablesDescriptors(td)) {
+    EXPECT_EQ(-1, getEvictionPriority(shard->tableId));
+  }
+}
+
+TEST_F(AlterTableSetEvictionPriorityTest, OutOfRange) {
+  sql("create table test_table (i integer);");
+  queryAndAssertException("alter table test_table set eviction_priority = 4294967296;",
+                          "Eviction priority is out of range.");
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -17,6 +17,7 @@
 #include <gtest/gtest.h>
 #include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Verifier.h>
 #include <llvm/Support/SourceMgr.h>
@@ -27,8 +28,17 @@
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/IRCodegenUtils.h"
 #include "QueryEngine/LLVMGlobalContext.h"
+#include "QueryEngine/PersistentCodeCache.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+extern std::string g_base_path;
+extern size_t g_persistent_jit_cache_max_bytes;
+
 TEST(CodeGeneratorTest, IntegerConstant) {
   auto& ctx = getGlobalLLVMContext();
   std::unique_ptr<llvm::Module> module(read_template_module(ctx));
@@ -362,6 +372,139 @@ TEST(CodeGeneratorTest, IntegerExprGPU) {
 }
 #endif  // HAVE_CUDA
 
+namespace {
+
+// Module with a single function returning `val`, named the same for all values.
+llvm::Function* make_constant_function(const int32_t val) {
+  auto& ctx = getGlobalLLVMContext();
+  auto module = std::make_unique<llvm::Module>("persistent_code_cache_test", ctx);
+  auto func = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getInt32Ty(ctx), false),
+      llvm::Function::ExternalLinkage,
+      "persistent_code_cache_test_func",
+      module.get());
+  llvm::IRBuilder<> builder(llvm::BasicBlock::Create(ctx, "entry", func));
+  builder.CreateRet(llvm::ConstantInt::get(llvm::Type::getInt32Ty(ctx), val));
+  verify_function_ir(func);
+  // owned by the execution engine from now on
+  module.release();
+  return func;
+}
+
+// Points the persistent code cache of the test to an empty base path of its own, removed
+// at the end of the test.
+class ScopedBasePath {
+ public:
+  ScopedBasePath()
+      : base_path_state_(g_base_path)
+      , base_path_(boost::filesystem::temp_directory_path() /
+                   boost::filesystem::unique_path()) {
+    CHECK(boost::filesystem::create_directories(base_path_));
+    g_base_path = base_path_.string();
+  }
+
+  ~ScopedBasePath() {
+    g_base_path = base_path_state_;
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(base_path_, ec);
+  }
+
+ private:
+  const std::string base_path_state_;
+  const boost::filesystem::path base_path_;
+};
+
+}  // namespace
+
+TEST(CodeGeneratorTest, PersistentCodeCache) {
+  ScopedBasePath base_path;
+  // written before the first use of the cache directory, which scans it
+  CHECK(boost::filesystem::create_directories(PersistentCodeCache::getCacheDirectory()));
+  const auto stale_file_path =
+      boost::filesystem::path(PersistentCodeCache::getCacheDirectory()) / "stale.o";
+  std::ofstream(stale_file_path.string()) << "code of another build";
+  ASSERT_TRUE(boost::filesystem::exists(stale_file_path));
+
+  const CodeCacheKey key{"define void @query_func()", "define i32 @row_func()"};
+  const std::string object{"compiled query module"};
+  {
+    PersistentCodeCache persistent_code_cache(key, "fingerprint");
+    ASSERT_FALSE(persistent_code_cache.hasObject());
+    persistent_code_cache.notifyObjectCompiled(nullptr,
+                                               llvm::MemoryBufferRef(object, "object"));
+  }
+  EXPECT_FALSE(boost::filesystem::exists(stale_file_path));
+  // as after a restart
+  PersistentCodeCache persistent_code_cache(key, "fingerprint");
+  ASSERT_TRUE(persistent_code_cache.hasObject());
+  EXPECT_EQ(persistent_code_cache.getObject(nullptr)->getBuffer().str(), object);
+  // code generated by another build or for another CPU isn't reused
+  EXPECT_FALSE(PersistentCodeCache(key, "other fingerprint").hasObject());
+  EXPECT_FALSE(
+      PersistentCodeCache({"define void @query_func()"}, "fingerprint").hasObject());
+}
+
+TEST(CodeGeneratorTest, PersistentCodeCacheEviction) {
+  ScopedBasePath base_path;
+  const auto max_bytes_state = g_persistent_jit_cache_max_bytes;
+  ScopeGuard reset = [max_bytes_state] {
+    g_persistent_jit_cache_max_bytes = max_bytes_state;
+  };
+  // room for two of the objects below, along with their keys
+  g_persistent_jit_cache_max_bytes = 2500;
+  const std::string object(1000, 'x');
+  const auto store = [&object](const CodeCacheKey& key) {
+    PersistentCodeCache persistent_code_cache(key, "fingerprint");
+    ASSERT_FALSE(persistent_code_cache.hasObject());
+    persistent_code_cache.notifyObjectCompiled(nullptr,
+                                               llvm::MemoryBufferRef(object, "object"));
+  };
+  store({"query 1"});
+  store({"query 2"});
+  // a hit makes the first object the most recently used one
+  EXPECT_TRUE(PersistentCodeCache({"query 1"}, "fingerprint").hasObject());
+  store({"query 3"});
+  EXPECT_TRUE(PersistentCodeCache({"query 1"}, "fingerprint").hasObject());
+  EXPECT_FALSE(PersistentCodeCache({"query 2"}, "fingerprint").hasObject());
+  EXPECT_TRUE(PersistentCodeCache({"query 3"}, "fingerprint").hasObject());
+
+  // larger than the whole cache
+  PersistentCodeCache persistent_code_cache({"query 4"}, "fingerprint");
+  const std::string large_object(3000, 'x');
+  persistent_code_cache.notifyObjectCompiled(
+      nullptr, llvm::MemoryBufferRef(large_object, "object"));
+  EXPECT_FALSE(PersistentCodeCache({"query 4"}, "fingerprint").hasObject());
+  EXPECT_TRUE(PersistentCodeCache({"query 3"}, "fingerprint").hasObject());
+}
+
+TEST(CodeGeneratorTest, PersistentCodeCacheRoundTrip) {
+  ScopedBasePath base_path;
+  const auto co = CompilationOptions::defaults(ExecutorDeviceType::CPU);
+  const CodeCacheKey key{"persistent_code_cache_test_func"};
+  using FuncPtr = int32_t (*)();
+  {
+    PersistentCodeCache persistent_code_cache(key, "fingerprint");
+    ASSERT_FALSE(persistent_code_cache.hasObject());
+    auto func = make_constant_function(42);
+    auto execution_engine = CodeGenerator::generateNativeCPUCode(
+        func, {func}, co, &persistent_code_cache);
+    auto func_ptr =
+        reinterpret_cast<FuncPtr>(execution_engine->getPointerToFunction(func));
+    ASSERT_TRUE(func_ptr);
+    EXPECT_EQ(func_ptr(), 42);
+  }
+  // The key claims the modules are the same, so the object compiled for the first one
+  // is loaded instead of compiling the second.
+  PersistentCodeCache persistent_code_cache(key, "fingerprint");
+  ASSERT_TRUE(persistent_code_cache.hasObject());
+  auto func = make_constant_function(7);
+  auto execution_engine =
+      CodeGenerator::generateNativeCPUCode(func, {func}, co, &persistent_code_cache);
+  auto func_ptr = reinterpret_cast<FuncPtr>(execution_engine->getPointerToFunction(func));
+  ASSERT_TRUE(func_ptr);
+  EXPECT_EQ(func_ptr(), 42);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -19,6 +19,7 @@
 #include "Catalog/Catalog.h"
 #include "DBHandlerTestHelpers.h"
 #include "QueryEngine/TableOptimizer.h"
+#include "Shared/scope.h"
 
 #include <gtest/gtest.h>
 #include <string>
@@ -29,6 +30,7 @@
 #endif
 
 extern float g_vacuum_min_selectivity;
+extern size_t g_cluster_max_batch_rows;
 
 namespace {
 
@@ -1834,6 +1836,197 @@ TEST_F(OpportunisticVacuumingTest, VarLenColumnUpdateOfConsecutiveInnerFragments
   // clang-format on
 }
 
+class OptimizeTableClusterTest : public DBHandlerTestFixture {
+ protected:
+  void SetUp() override {
+    DBHandlerTestFixture::SetUp();
+    sql("drop table if exists test_table;");
+  }
+
+  void TearDown() override {
+    sql("drop table if exists test_table;");
+    DBHandlerTestFixture::TearDown();
+  }
+
+  void assertFragmentCount(size_t fragment_count) {
+    auto td = getCatalog().getMetadataForTable("test_table");
+    ASSERT_TRUE(td->fragmenter != nullptr);
+    ASSERT_EQ(fragment_count, td->fragmenter->getFragmentsForQuery().fragments.size());
+  }
+
+  bool shouldClusterRows() {
+    auto& cat = getCatalog();
+    auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+    TableOptimizer optimizer(
+        cat.getMetadataForTable("test_table"), executor.get(), cat);
+    return optimizer.shouldClusterRows();
+  }
+};
+
+TEST_F(OptimizeTableClusterTest, SortColumn) {
+  sql("create table test_table (i int, t text encoding none, d text) with "
+      "(fragment_size = 2, sort_column = 'i');");
+  sql("insert into test_table values (5, 'e', 'ee');");
+  sql("insert into test_table values (3, 'c', 'cc');");
+  sql("insert into test_table values (1, 'a', 'aa');");
+  sql("insert into test_table values (4, 'd', 'dd');");
+  sql("insert into test_table values (2, 'b', 'bb');");
+  sql("optimize table test_table with (cluster = 'true');");
+  assertFragmentCount(3);
+  sqlAndCompareResult("select * from test_table;",
+                      {{i(1), "a", "aa"},
+                       {i(2), "b", "bb"},
+                       {i(3), "c", "cc"},
+                       {i(4), "d", "dd"},
+                       {i(5), "e", "ee"}});
+  sqlAndCompareResult("select count(*) from test_table where i = 3;", {{i(1)}});
+}
+
+TEST_F(OptimizeTableClusterTest, DropsDeletedRowsAndMergesFragments) {
+  sql("create table test_table (i int, f double) with (fragment_size = 2);");
+  for (int value = 6; value >= 1; value--) {
+    sql("insert into test_table values (" + std::to_string(value) + ", " +
+        std::to_string(value) + ".5);");
+  }
+  sql("delete from test_table where i in (2, 3, 5);");
+  sql("optimize table test_table with (cluster = 'i');");
+  assertFragmentCount(2);
+  sqlAndCompareResult("select * from test_table;",
+                      {{i(1), 1.5}, {i(4), 4.5}, {i(6), 6.5}});
+}
+
+TEST_F(OptimizeTableClusterTest, ZOrder) {
+  sql("create table test_table (a int, b smallint);");
+  sql("insert into test_table values (0, 3);");
+  sql("insert into test_table values (1, 0);");
+  sql("insert into test_table values (2, 1);");
+  sql("insert into test_table values (3, 2);");
+  sql("optimize table test_table with (cluster = 'a, b', zorder = 'true');");
+  // The bits of the ranks are interleaved, a first, e.g. (0, 3) maps to 0b0101.
+  sqlAndCompareResult("select * from test_table;",
+                      {{i(1), i(0)}, {i(0), i(3)}, {i(2), i(1)}, {i(3), i(2)}});
+}
+
+TEST_F(OptimizeTableClusterTest, DictEncodedStrings) {
+  sql("create table test_table (i int, s8 text encoding dict(8), s16 text encoding "
+      "dict(16)) with (fragment_size = 2);");
+  sql("insert into test_table values (1, 'b', 'z');");
+  sql("insert into test_table values (2, 'a', 'y');");
+  sql("insert into test_table values (3, 'b', 'y');");
+  sql("insert into test_table values (4, 'a', 'z');");
+  // Dictionary encoded strings are clustered on their ids, i.e. in the order the strings
+  // were first added to the dictionary.
+  sql("optimize table test_table with (cluster = 's8');");
+  sqlAndCompareResult(
+      "select * from test_table;",
+      {{i(1), "b", "z"}, {i(3), "b", "y"}, {i(2), "a", "y"}, {i(4), "a", "z"}});
+  sql("optimize table test_table with (cluster = 's16');");
+  assertFragmentCount(2);
+  sqlAndCompareResult(
+      "select * from test_table;",
+      {{i(1), "b", "z"}, {i(4), "a", "z"}, {i(3), "b", "y"}, {i(2), "a", "y"}});
+  sqlAndCompareResult("select count(*) from test_table where s8 = 'a';", {{i(2)}});
+  sqlAndCompareResult("select count(*) from test_table where s16 = 'y';", {{i(2)}});
+}
+
+TEST_F(OptimizeTableClusterTest, DateTimeAndDecimal) {
+  sql("create table test_table (d date, dd date encoding days(16), t time, ts "
+      "timestamp, dc decimal(10, 2)) with (fragment_size = 2);");
+  sql("insert into test_table values ('2021-03-01', '2021-03-01', '12:00:00', "
+      "'2021-03-01 12:00:00', 3.25);");
+  sql("insert into test_table values ('2020-01-01', '2020-01-01', '08:30:00', "
+      "'2020-01-01 08:30:00', 10.00);");
+  sql("insert into test_table values ('2022-06-15', '2022-06-15', '23:59:59', "
+      "'2022-06-15 23:59:59', -1.50);");
+  sql("optimize table test_table with (cluster = 'd');");
+  assertFragmentCount(2);
+  sqlAndCompareResult(
+      "select * from test_table;",
+      {{"2020-01-01", "2020-01-01", "08:30:00", "2020-01-01 08:30:00", 10.00},
+       {"2021-03-01", "2021-03-01", "12:00:00", "2021-03-01 12:00:00", 3.25},
+       {"2022-06-15", "2022-06-15", "23:59:59", "2022-06-15 23:59:59", -1.50}});
+  sql("optimize table test_table with (cluster = 'dc');");
+  sqlAndCompareResult(
+      "select * from test_table;",
+      {{"2022-06-15", "2022-06-15", "23:59:59", "2022-06-15 23:59:59", -1.50},
+       {"2021-03-01", "2021-03-01", "12:00:00", "2021-03-01 12:00:00", 3.25},
+       {"2020-01-01", "2020-01-01", "08:30:00", "2020-01-01 08:30:00", 10.00}});
+  sqlAndCompareResult("select count(*) from test_table where dd = '2021-03-01';",
+                      {{i(1)}});
+  sqlAndCompareResult("select count(*) from test_table where t < '12:00:00';", {{i(1)}});
+  sqlAndCompareResult("select count(*) from test_table where dc > 0;", {{i(2)}});
+}
+
+TEST_F(OptimizeTableClusterTest, NullHeavyColumns) {
+  sql("create table test_table (i int, s text encoding dict(16), f double, dc "
+      "decimal(10, 2), d date) with (fragment_size = 2);");
+  sql("insert into test_table values (null, null, null, null, null);");
+  sql("insert into test_table values (3, null, null, null, null);");
+  sql("insert into test_table values (null, 'b', null, 1.50, null);");
+  sql("insert into test_table values (1, null, 2.5, null, '2020-01-01');");
+  sql("insert into test_table values (null, null, null, null, null);");
+  sql("insert into test_table values (2, 'a', null, null, null);");
+  sql("optimize table test_table with (cluster = 'i');");
+  assertFragmentCount(3);
+  // Nulls are the smallest values of the encoded types and come first.
+  sqlAndCompareResult("select * from test_table;",
+                      {{Null, Null, Null, Null, Null},
+                       {Null, "b", Null, 1.50, Null},
+                       {Null, Null, Null, Null, Null},
+                       {i(1), Null, 2.5, Null, "2020-01-01"},
+                       {i(2), "a", Null, Null, Null},
+                       {i(3), Null, Null, Null, Null}});
+  sqlAndCompareResult("select count(*) from test_table where i is null;", {{i(3)}});
+  sqlAndCompareResult("select count(*) from test_table where s is null;", {{i(4)}});
+  sqlAndCompareResult("select count(*) from test_table where f is null;", {{i(5)}});
+  sqlAndCompareResult("select count(*) from test_table where dc is null;", {{i(5)}});
+  sqlAndCompareResult("select count(*) from test_table where d is null;", {{i(5)}});
+}
+
+TEST_F(OptimizeTableClusterTest, Batches) {
+  const auto max_batch_rows = g_cluster_max_batch_rows;
+  ScopeGuard reset_max_batch_rows = [max_batch_rows] {
+    g_cluster_max_batch_rows = max_batch_rows;
+  };
+  g_cluster_max_batch_rows = 2;
+  sql("create table test_table (i int) with (fragment_size = 2);");
+  for (int value = 6; value >= 1; value--) {
+    sql("insert into test_table values (" + std::to_string(value) + ");");
+  }
+  sql("delete from test_table where i = 4;");
+  // The batches are the fragments in the order of their minimum, each batch continues
+  // the last fragment of the previous one.
+  sql("optimize table test_table with (cluster = 'i');");
+  assertFragmentCount(3);
+  sqlAndCompareResult("select * from test_table;",
+                      {{i(1)}, {i(2)}, {i(3)}, {i(5)}, {i(6)}});
+  sqlAndCompareResult("select count(*) from test_table where i > 2;", {{i(3)}});
+}
+
+TEST_F(OptimizeTableClusterTest, ShouldClusterRows) {
+  sql("create table test_table (i int) with (fragment_size = 2, sort_column = 'i');");
+  for (const auto value : {1, 1, 1, 2, 2, 3, 0}) {
+    sql("insert into test_table values (" + std::to_string(value) + ");");
+  }
+  // The ranges of the fragments only touch.
+  EXPECT_FALSE(shouldClusterRows());
+  sql("insert into test_table values (3);");
+  EXPECT_TRUE(shouldClusterRows());
+  // The rows of the duplicate keys straddle the boundaries of the new fragments.
+  sql("optimize table test_table with (cluster = 'true');");
+  assertFragmentCount(4);
+  sqlAndCompareResult("select * from test_table;",
+                      {{i(0)}, {i(1)}, {i(1)}, {i(1)}, {i(2)}, {i(2)}, {i(3)}, {i(3)}});
+  EXPECT_FALSE(shouldClusterRows());
+}
+
+TEST_F(OptimizeTableClusterTest, NoSortColumn) {
+  sql("create table test_table (i int);");
+  queryAndAssertException(
+      "optimize table test_table with (cluster = 'true');",
+      "Table test_table has no sort column, the columns to cluster on must be given.");
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -22,8 +22,14 @@
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
 #include "CudaMgr/CudaMgr.h"
 #include "DataMgr/Allocators/ArenaAllocator.h"
+#include "DataMgr/BufferMgr/Buffer.h"
 #include "DataMgr/BufferMgr/CpuBufferMgr/TieredCpuBufferMgr.h"
 #include "DataMgr/Chunk/Chunk.h"
 #include "DataMgr/DataMgr.h"
@@ -31,6 +37,9 @@
 
 extern bool g_enable_tiered_cpu_mem;
 extern size_t g_pmem_size;
+extern std::string g_buffer_pool_eviction_policy;
+extern size_t g_buffer_pool_correlated_period;
+extern size_t g_buffer_pool_retained_period;
 
 // A Mock that wraps the Arena allocators.  Forwards calls to the allocator, but also has
 // a "tier" value assigned to it that represends the intended memory tier and allows
@@ -93,12 +102,20 @@ class DataMgrTest : public testing::Test {
   std::shared_ptr<Chunk_NS::Chunk> writeChunkForKey(const ChunkKey& key) {
     auto disk_buf = data_mgr_->createChunkBuffer(key, MemoryLevel::DISK_LEVEL);
     disk_buf->append(std::vector<int8_t>{1, 2, 3, 4}.data(), 4U);
+    return getChunkForKey(key);
+  }
+
+  std::shared_ptr<Chunk_NS::Chunk> getChunkForKey(const ChunkKey& key) {
     auto cd =
         std::make_unique<ColumnDescriptor>(key[1], key[2], "temp", SQLTypeInfo{kTINYINT});
     return Chunk_NS::Chunk::getChunk(
         cd.get(), data_mgr_.get(), key, MemoryLevel::CPU_LEVEL, 0, 4, 4);
   }
 
+  bool isChunkInCpuPool(const ChunkKey& key) {
+    return data_mgr_->isBufferOnDevice(key, MemoryLevel::CPU_LEVEL, 0);
+  }
+
  protected:
   std::string data_mgr_path_{"./data_mgr_test_dir"};
   bool use_gpus_{false};
@@ -160,6 +177,225 @@ TEST_F(DataMgrTest, ReuseWithPinnedGaps) {
   writeChunkForKey({1, 1, 1, 3});                // unpinned
 }
 
+class BufferEvictionPolicyTest : public DataMgrTest {
+ public:
+  void SetUp() override {
+    g_buffer_pool_eviction_policy = "lru2";
+    DataMgrTest::SetUp();
+  }
+
+  void TearDown() override {
+    DataMgrTest::TearDown();
+    g_buffer_pool_eviction_policy = eviction_policy_;
+    g_buffer_pool_correlated_period = correlated_period_;
+    g_buffer_pool_retained_period = retained_period_;
+  }
+
+ protected:
+  const std::string eviction_policy_{g_buffer_pool_eviction_policy};
+  const size_t correlated_period_{g_buffer_pool_correlated_period};
+  const size_t retained_period_{g_buffer_pool_retained_period};
+};
+
+TEST_F(BufferEvictionPolicyTest, LRUEvictsLeastRecentlyUsed) {
+  g_buffer_pool_eviction_policy = "lru";
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  getChunkForKey({1, 1, 1, 1});
+  writeChunkForKey({1, 1, 1, 2});
+  writeChunkForKey({1, 1, 1, 3});
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 2}));
+}
+
+TEST_F(BufferEvictionPolicyTest, LRU2KeepsReferencedChunksOverScannedChunks) {
+  g_buffer_pool_correlated_period = 0;
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  getChunkForKey({1, 1, 1, 1});
+  // A scan reads each of its chunks once.
+  writeChunkForKey({1, 1, 1, 2});
+  writeChunkForKey({1, 1, 1, 3});
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 2}));
+  writeChunkForKey({1, 1, 1, 4});
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 3}));
+}
+
+TEST_F(BufferEvictionPolicyTest, LRU2IgnoresCorrelatedReferences) {
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  // Referenced again right away, as by the next step of the same query.
+  getChunkForKey({1, 1, 1, 1});
+  writeChunkForKey({1, 1, 1, 2});
+  writeChunkForKey({1, 1, 1, 3});
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 2}));
+}
+
+TEST_F(BufferEvictionPolicyTest, LRU2ForgetsOldReferences) {
+  g_buffer_pool_correlated_period = 0;
+  g_buffer_pool_retained_period = 2;
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  getChunkForKey({1, 1, 1, 1});
+  writeChunkForKey({1, 1, 1, 2});
+  writeChunkForKey({1, 1, 1, 3});
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 2}));
+}
+
+TEST_F(BufferEvictionPolicyTest, LRU2PinnedReferenceIsNotNew) {
+  g_buffer_pool_correlated_period = 0;
+  resetDataMgr(2);
+  {
+    // Fetched while still pinned, as by a kernel from the chunk prefetcher.
+    auto prefetched_chunk = writeChunkForKey({1, 1, 1, 1});
+    getChunkForKey({1, 1, 1, 1});
+  }
+  writeChunkForKey({1, 1, 1, 2});
+  // Both chunks have a single reference, the older one goes.
+  writeChunkForKey({1, 1, 1, 3});
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 2}));
+}
+
+TEST_F(BufferEvictionPolicyTest, TablePriority) {
+  resetDataMgr(2);
+  data_mgr_->setTableEvictionPriority(1, 1, 1);
+  writeChunkForKey({1, 1, 1, 1});
+  writeChunkForKey({1, 2, 1, 1});
+  writeChunkForKey({1, 2, 1, 2});
+  EXPECT_TRUE(isChunkInCpuPool({1, 1, 1, 1}));
+  EXPECT_FALSE(isChunkInCpuPool({1, 2, 1, 1}));
+
+  data_mgr_->setTableEvictionPriority(1, 1, 0);
+  writeChunkForKey({1, 2, 1, 3});
+  EXPECT_FALSE(isChunkInCpuPool({1, 1, 1, 1}));
+}
+
+TEST_F(BufferEvictionPolicyTest, Stats) {
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  getChunkForKey({1, 1, 1, 1});
+  writeChunkForKey({1, 1, 1, 2});
+  writeChunkForKey({1, 1, 1, 3});
+  const auto stats = data_mgr_->getCpuBufferMgr()->getStats();
+  EXPECT_EQ(stats.num_hits, 1U);
+  EXPECT_EQ(stats.num_misses, 3U);
+  EXPECT_EQ(stats.num_evicted_buffers, 1U);
+}
+
+TEST_F(DataMgrTest, PrefetchMemoryBudget) {
+  resetDataMgr(4);
+  // The default budget is a quarter of the CPU buffer pool, one slab here.
+  EXPECT_TRUE(data_mgr_->reservePrefetchMemory(slab_size_ / 2));
+  EXPECT_FALSE(data_mgr_->reservePrefetchMemory(slab_size_));
+  EXPECT_TRUE(data_mgr_->reservePrefetchMemory(slab_size_ / 2));
+  EXPECT_FALSE(data_mgr_->reservePrefetchMemory(1));
+  data_mgr_->releasePrefetchMemory(slab_size_);
+  EXPECT_TRUE(data_mgr_->reservePrefetchMemory(slab_size_));
+  data_mgr_->releasePrefetchMemory(slab_size_);
+}
+
+TEST_F(DataMgrTest, WaitForPrefetchMemory) {
+  resetDataMgr(4);
+  const auto never = [] { return false; };
+  EXPECT_TRUE(data_mgr_->waitForPrefetchMemory(slab_size_, never));
+  // More than the whole budget never fits.
+  EXPECT_FALSE(data_mgr_->waitForPrefetchMemory(slab_size_ + 1, never));
+
+  // A waiter gets the bytes once they're released.
+  auto waiter = std::async(std::launch::async, [this, &never] {
+    return data_mgr_->waitForPrefetchMemory(slab_size_ / 2, never);
+  });
+  EXPECT_EQ(waiter.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+  data_mgr_->releasePrefetchMemory(slab_size_ / 2);
+  EXPECT_TRUE(waiter.get());
+
+  // And gives up once cancelled.
+  std::atomic<bool> cancelled{false};
+  auto cancelled_waiter = std::async(std::launch::async, [this, &cancelled] {
+    return data_mgr_->waitForPrefetchMemory(1, [&cancelled] { return cancelled.load(); });
+  });
+  EXPECT_EQ(cancelled_waiter.wait_for(std::chrono::milliseconds(100)),
+            std::future_status::timeout);
+  cancelled = true;
+  data_mgr_->wakePrefetchWaiters();
+  EXPECT_FALSE(cancelled_waiter.get());
+  data_mgr_->releasePrefetchMemory(slab_size_);
+  EXPECT_TRUE(data_mgr_->reservePrefetchMemory(slab_size_));
+  data_mgr_->releasePrefetchMemory(slab_size_);
+}
+
+TEST_F(DataMgrTest, ConcurrentHits) {
+  resetDataMgr(2);
+  writeChunkForKey({1, 1, 1, 1});
+  constexpr size_t num_threads{8};
+  constexpr size_t num_gets_per_thread{1000};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([this] {
+      for (size_t j = 0; j < num_gets_per_thread; ++j) {
+        getChunkForKey({1, 1, 1, 1});
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto buffer = data_mgr_->getChunkBuffer({1, 1, 1, 1}, MemoryLevel::CPU_LEVEL, 0, 4);
+  // Only the pin of the buffer just taken is left.
+  EXPECT_EQ(buffer->getPinCount(), 1);
+  buffer->unPin();
+  const auto stats = data_mgr_->getCpuBufferMgr()->getStats();
+  EXPECT_EQ(stats.num_hits, num_threads * num_gets_per_thread + 1);
+  EXPECT_EQ(stats.num_misses, 1U);
+}
+
+TEST_F(DataMgrTest, ConcurrentLoadAndHits) {
+  resetDataMgr(2);
+  auto disk_buf = data_mgr_->createChunkBuffer({1, 1, 1, 1}, MemoryLevel::DISK_LEVEL);
+  disk_buf->append(std::vector<int8_t>{1, 2, 3, 4}.data(), 4U);
+  constexpr size_t num_threads{8};
+  constexpr size_t num_gets_per_thread{100};
+  std::vector<std::thread> threads;
+  std::atomic<size_t> num_bad_reads{0};
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([this, &num_bad_reads] {
+      for (size_t j = 0; j < num_gets_per_thread; ++j) {
+        // Hits must see the whole load.
+        auto chunk = getChunkForKey({1, 1, 1, 1});
+        const auto buffer = chunk->getBuffer();
+        if (buffer->size() != 4 || buffer->getMemoryPtr()[3] != 4) {
+          ++num_bad_reads;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_bad_reads, 0U);
+  EXPECT_EQ(data_mgr_->getCpuBufferMgr()->getStats().num_misses, 1U);
+}
+
+TEST_F(DataMgrTest, UnloadedBufferTakesSlowPath) {
+  resetDataMgr(2);
+  auto cpu_buf = dynamic_cast<Buffer_Namespace::Buffer*>(
+      data_mgr_->createChunkBuffer({1, 1, 1, 1}, MemoryLevel::CPU_LEVEL));
+  ASSERT_NE(cpu_buf, nullptr);
+  cpu_buf->append(std::vector<int8_t>{1, 2, 3, 4}.data(), 4U);
+  cpu_buf->unPin();
+  // Written in place rather than loaded, so not published to the lock free lookups yet.
+  EXPECT_EQ(cpu_buf->getLoadedSize(), 0U);
+  auto buffer = data_mgr_->getChunkBuffer({1, 1, 1, 1}, MemoryLevel::CPU_LEVEL, 0, 4);
+  EXPECT_EQ(buffer, cpu_buf);
+  EXPECT_EQ(cpu_buf->getLoadedSize(), 4U);
+  buffer->unPin();
+}
+
 TEST_F(TieredCpuBufferMgrTest, AllocateInOrder) {
   // Two buffers will each allocate a new slab, so they should use new allocators for
   // each.
@@ -18,6 +18,8 @@
 
 #include "Logger/Logger.h"
 #include "QueryEngine/CompilationOptions.h"
+#include "QueryEngine/DataRecycler/EstimationRecycler.h"
+#include "QueryEngine/DataRecycler/ResultSetRecycler.h"
 #include "QueryEngine/Execute.h"
 #include "QueryEngine/QueryPlanDagCache.h"
 #include "QueryEngine/QueryPlanDagExtractor.h"
@@ -1588,6 +1590,242 @@ TEST(DataRecycler, Hashtable_From_Subqueries) {
   }
 }
 
+TEST(DataRecycler, ResultSet_Recycler) {
+  const auto use_query_resultset_cache = g_use_query_resultset_cache;
+  g_use_query_resultset_cache = true;
+  ScopeGuard reset_flag = [use_query_resultset_cache] {
+    g_use_query_resultset_cache = use_query_resultset_cache;
+  };
+  auto resultset_recycler = ResultSetRecyclerHolder::getResultSetRecycler();
+  auto num_cached_resultsets = [resultset_recycler] {
+    return resultset_recycler->getCurrentNumCachedItems(
+        CacheItemType::ROW_RS, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER);
+  };
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID).get();
+  executor->clearMemory(MemoryLevel::CPU_LEVEL);
+  ASSERT_EQ(static_cast<size_t>(0), num_cached_resultsets());
+
+  run_ddl_statement("DROP TABLE IF EXISTS rs_recycler_t;");
+  run_ddl_statement("CREATE TABLE rs_recycler_t (x INT, y INT);");
+  for (int i = 0; i < 10; ++i) {
+    QR::get()->runSQL("INSERT INTO rs_recycler_t VALUES (" + std::to_string(i) + ", " +
+                          std::to_string(i % 3) + ");",
+                      ExecutorDeviceType::CPU);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    if (skip_tests(dt)) {
+      continue;
+    }
+    executor->clearMemory(MemoryLevel::CPU_LEVEL);
+    const auto q1 = "SELECT SUM(x) FROM rs_recycler_t WHERE y = 1;";
+    ASSERT_EQ(static_cast<int64_t>(12), v<int64_t>(run_simple_query(q1, dt)));
+    ASSERT_EQ(static_cast<size_t>(1), num_cached_resultsets());
+    // recycled, and consuming the recycled rows doesn't affect the cached ones
+    ASSERT_EQ(static_cast<int64_t>(12), v<int64_t>(run_simple_query(q1, dt)));
+    ASSERT_EQ(static_cast<int64_t>(12), v<int64_t>(run_simple_query(q1, dt)));
+    ASSERT_EQ(static_cast<size_t>(1), num_cached_resultsets());
+
+    // a group by result sorted and limited by the caller stays intact in the cache
+    const auto q2 =
+        "SELECT y, COUNT(*) FROM rs_recycler_t GROUP BY y ORDER BY y LIMIT 1;";
+    const auto q3 = "SELECT y, COUNT(*) FROM rs_recycler_t GROUP BY y ORDER BY y DESC;";
+    for (int i = 0; i < 2; ++i) {
+      auto rows = QR::get()->runSQL(q2, dt);
+      ASSERT_EQ(static_cast<size_t>(1), rows->rowCount());
+      auto row = rows->getNextRow(true, true);
+      ASSERT_EQ(static_cast<int64_t>(0), v<int64_t>(row[0]));
+      ASSERT_EQ(static_cast<int64_t>(4), v<int64_t>(row[1]));
+      rows = QR::get()->runSQL(q3, dt);
+      ASSERT_EQ(static_cast<size_t>(3), rows->rowCount());
+      row = rows->getNextRow(true, true);
+      ASSERT_EQ(static_cast<int64_t>(2), v<int64_t>(row[0]));
+      ASSERT_EQ(static_cast<int64_t>(3), v<int64_t>(row[1]));
+    }
+
+    // appending to the table advances its epoch, which makes the cached result stale
+    QR::get()->runSQL("INSERT INTO rs_recycler_t VALUES (100, 1);",
+                      ExecutorDeviceType::CPU);
+    ASSERT_EQ(static_cast<int64_t>(112), v<int64_t>(run_simple_query(q1, dt)));
+
+    // updates clear the cache
+    QR::get()->runSQL("UPDATE rs_recycler_t SET x = 0 WHERE x = 100;",
+                      ExecutorDeviceType::CPU);
+    ASSERT_EQ(static_cast<size_t>(0), num_cached_resultsets());
+    ASSERT_EQ(static_cast<int64_t>(12), v<int64_t>(run_simple_query(q1, dt)));
+    QR::get()->runSQL("DELETE FROM rs_recycler_t WHERE x = 0;", ExecutorDeviceType::CPU);
+    ASSERT_EQ(static_cast<size_t>(0), num_cached_resultsets());
+    QR::get()->runSQL("INSERT INTO rs_recycler_t VALUES (0, 0);",
+                      ExecutorDeviceType::CPU);
+
+    // results depending on the current time are not cached
+    executor->clearMemory(MemoryLevel::CPU_LEVEL);
+    ASSERT_EQ(static_cast<int64_t>(10),
+              v<int64_t>(run_simple_query(
+                  "SELECT COUNT(*) FROM rs_recycler_t WHERE x < EXTRACT(YEAR FROM "
+                  "CURRENT_DATE);",
+                  dt)));
+    ASSERT_EQ(static_cast<int64_t>(10),
+              v<int64_t>(run_simple_query(
+                  "SELECT COUNT(*) FROM rs_recycler_t WHERE CURRENT_TIMESTAMP > "
+                  "TIMESTAMP '2000-01-01 00:00:00';",
+                  dt)));
+    ASSERT_EQ(static_cast<int64_t>(10),
+              v<int64_t>(run_simple_query(
+                  "SELECT COUNT(*) FROM rs_recycler_t WHERE NOW() > TIMESTAMP "
+                  "'2000-01-01 00:00:00';",
+                  dt)));
+    ASSERT_EQ(static_cast<size_t>(0), num_cached_resultsets());
+
+    // setting the table epoch back clears the cache, the epochs after it get reused
+    ASSERT_EQ(static_cast<int64_t>(12), v<int64_t>(run_simple_query(q1, dt)));
+    ASSERT_EQ(static_cast<size_t>(1), num_cached_resultsets());
+    const auto& cat = *executor->getCatalog();
+    const auto td = cat.getMetadataForTable("rs_recycler_t", false);
+    CHECK(td);
+    const auto epoch = cat.getTableEpoch(cat.getDatabaseId(), td->tableId);
+    const_cast<Catalog_Namespace::Catalog&>(cat).setTableEpoch(
+        cat.getDatabaseId(), td->tableId, epoch);
+    ASSERT_EQ(static_cast<size_t>(0), num_cached_resultsets());
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS rs_recycler_t;");
+}
+
+TEST(DataRecycler, ResultSet_Recycler_CountDistinct) {
+  const auto use_query_resultset_cache = g_use_query_resultset_cache;
+  g_use_query_resultset_cache = true;
+  ScopeGuard reset_flag = [use_query_resultset_cache] {
+    g_use_query_resultset_cache = use_query_resultset_cache;
+  };
+  auto resultset_recycler = ResultSetRecyclerHolder::getResultSetRecycler();
+  auto num_cached_resultsets = [resultset_recycler] {
+    return resultset_recycler->getCurrentNumCachedItems(
+        CacheItemType::ROW_RS, DataRecyclerUtil::CPU_DEVICE_IDENTIFIER);
+  };
+  auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID).get();
+
+  run_ddl_statement("DROP TABLE IF EXISTS rs_recycler_cd;");
+  run_ddl_statement("CREATE TABLE rs_recycler_cd (x INT, y INT, z BIGINT);");
+  for (int i = 0; i < 10; ++i) {
+    QR::get()->runSQL("INSERT INTO rs_recycler_cd VALUES (" + std::to_string(i) + ", " +
+                          std::to_string(i % 3) + ", " +
+                          std::to_string(int64_t(i) * 1000000000000) + ");",
+                      ExecutorDeviceType::CPU);
+  }
+
+  // a bitmap for y, a set for the wide range of z
+  const auto query =
+      "SELECT x % 2, COUNT(DISTINCT y), COUNT(DISTINCT z), APPROX_COUNT_DISTINCT(y) FROM "
+      "rs_recycler_cd GROUP BY 1 ORDER BY 1;";
+  auto check_rows = [](const ResultSet& rows) {
+    ASSERT_EQ(static_cast<size_t>(2), rows.rowCount());
+    for (int64_t g = 0; g < 2; ++g) {
+      const auto row = rows.getNextRow(true, true);
+      ASSERT_EQ(g, v<int64_t>(row[0]));
+      ASSERT_EQ(static_cast<int64_t>(3), v<int64_t>(row[1]));
+      ASSERT_EQ(static_cast<int64_t>(5), v<int64_t>(row[2]));
+      ASSERT_EQ(static_cast<int64_t>(3), v<int64_t>(row[3]));
+    }
+  };
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    if (skip_tests(dt)) {
+      continue;
+    }
+    executor->clearMemory(MemoryLevel::CPU_LEVEL);
+    auto rows = QR::get()->runSQL(query, dt);
+    check_rows(*rows);
+    ASSERT_EQ(static_cast<size_t>(1), num_cached_resultsets());
+    // the cached copy has its own count distinct sets, not those of the query
+    std::weak_ptr<RowSetMemoryOwner> query_row_set_mem_owner = rows->getRowSetMemOwner();
+    rows.reset();
+    for (int i = 0; i < 2; ++i) {
+      auto recycled_rows = QR::get()->runSQL(query, dt);
+      EXPECT_NE(query_row_set_mem_owner.lock(), recycled_rows->getRowSetMemOwner());
+      check_rows(*recycled_rows);
+    }
+    ASSERT_EQ(static_cast<size_t>(1), num_cached_resultsets());
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS rs_recycler_cd;");
+}
+
+TEST(DataRecycler, Estimation_Recycler) {
+  auto estimation_recycler = EstimationRecyclerHolder::getEstimationRecycler();
+  auto num_cached_estimations = [estimation_recycler] {
+    return estimation_recycler->getCurrentNumCachedItems(
+               CacheItemType::NDV_CARD_EST, ESTIMATION_CACHE_DEVICE_IDENTIFIER) +
+           estimation_recycler->getCurrentNumCachedItems(
+               CacheItemType::FILTER_SEL, ESTIMATION_CACHE_DEVICE_IDENTIFIER);
+  };
+  estimation_recycler->clearCache();
+  ASSERT_EQ(static_cast<size_t>(0), num_cached_estimations());
+
+  run_ddl_statement("DROP TABLE IF EXISTS est_recycler_t;");
+  run_ddl_statement("CREATE TABLE est_recycler_t (x INT, y INT);");
+  for (int i = 0; i < 10; ++i) {
+    QR::get()->runSQL("INSERT INTO est_recycler_t VALUES (" + std::to_string(i) + ", " +
+                          std::to_string(i % 2) + ");",
+                      ExecutorDeviceType::CPU);
+  }
+
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    if (skip_tests(dt)) {
+      continue;
+    }
+    estimation_recycler->clearCache();
+    // the pre-flight count(*) sizing the output buffer of a filtered projection is not
+    // cached, so the projection keeps every row after the table changes
+    const auto q = "SELECT x FROM est_recycler_t WHERE y = 1;";
+    ASSERT_EQ(static_cast<size_t>(5), QR::get()->runSQL(q, dt)->rowCount());
+    ASSERT_EQ(static_cast<size_t>(0), num_cached_estimations());
+    QR::get()->runSQL("INSERT INTO est_recycler_t VALUES (10, 1);",
+                      ExecutorDeviceType::CPU);
+    ASSERT_EQ(static_cast<size_t>(6), QR::get()->runSQL(q, dt)->rowCount());
+    QR::get()->runSQL("DELETE FROM est_recycler_t WHERE x = 10;",
+                      ExecutorDeviceType::CPU);
+    ASSERT_EQ(static_cast<size_t>(5), QR::get()->runSQL(q, dt)->rowCount());
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS est_recycler_t;");
+}
+
+TEST(DataRecycler, Estimation_Recycler_Eviction) {
+  const auto max_cached_estimations = g_max_cached_estimations;
+  g_max_cached_estimations = 2;
+  ScopeGuard reset_flag = [max_cached_estimations] {
+    g_max_cached_estimations = max_cached_estimations;
+  };
+  auto estimation_recycler = EstimationRecyclerHolder::getEstimationRecycler();
+  estimation_recycler->clearCache();
+  const EstimationMetaInfo meta_info{{{1, 5}}};
+  auto put = [&](const QueryPlanHash key) {
+    estimation_recycler->putItemToCache(key,
+                                        key * 10,
+                                        CacheItemType::FILTER_SEL,
+                                        ESTIMATION_CACHE_DEVICE_IDENTIFIER,
+                                        sizeof(size_t),
+                                        0,
+                                        meta_info);
+  };
+  auto get = [&](const QueryPlanHash key, const EstimationMetaInfo& meta_info) {
+    return estimation_recycler->getItemFromCache(
+        key, CacheItemType::FILTER_SEL, ESTIMATION_CACHE_DEVICE_IDENTIFIER, meta_info);
+  };
+  put(1);
+  put(2);
+  ASSERT_EQ(size_t(10), *get(1, meta_info));
+  // the least recently used estimation makes room for a new one
+  put(3);
+  ASSERT_EQ(size_t(2),
+            estimation_recycler->getCurrentNumCachedItems(
+                CacheItemType::FILTER_SEL, ESTIMATION_CACHE_DEVICE_IDENTIFIER));
+  ASSERT_FALSE(get(2, meta_info));
+  ASSERT_EQ(size_t(10), *get(1, meta_info));
+  ASSERT_EQ(size_t(30), *get(3, meta_info));
+  // an estimation made before its input table got a new epoch is stale
+  const EstimationMetaInfo next_epoch_meta_info{{{1, 6}}};
+  ASSERT_FALSE(get(1, next_epoch_meta_info));
+  estimation_recycler->clearCache();
+}
+
 int main(int argc, char* argv[]) {
   testing::InitGoogleTest(&argc, argv);
   TestHelpers::init_logger_stderr_only(argc, argv);
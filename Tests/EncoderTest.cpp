@@ -21,17 +21,22 @@
 
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
+#include <numeric>
 
 #include "DataMgr/AbstractBuffer.h"
 #include "DataMgr/Encoder.h"
 #include "DataMgr/MemoryLevel.h"
 #include "Shared/DatumFetchers.h"
+#include "Shared/scope.h"
 #include "TestHelpers.h"
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
 #endif
 
+extern double g_bloom_filter_fp_rate;
+extern size_t g_bloom_filter_max_bytes;
+
 using AbstractBuffer = Data_Namespace::AbstractBuffer;
 using MemoryLevel = Data_Namespace::MemoryLevel;
 
@@ -61,7 +66,7 @@ class TestBuffer : public AbstractBuffer {
               const size_t num_bytes,
               const MemoryLevel src_buffer_type,
               const int device_id) override {
-    UNREACHABLE();
+    size_ += num_bytes;
   }
 
   int8_t* getMemoryPtr() override {
@@ -763,6 +768,152 @@ TYPED_TEST(FixedLengthArrayNoneEncoderUpdateStatsTest, TypedTest) {
   TestFixture::runTest();
 }
 
+class EncoderZoneMapTest : public EncoderTest {
+ protected:
+  template <typename T>
+  std::shared_ptr<ChunkMetadata> appendData(std::vector<T> data,
+                                            const size_t num_rows,
+                                            const bool replicating) {
+    auto src_data = reinterpret_cast<int8_t*>(data.data());
+    return buffer_->getEncoder()->appendData(
+        src_data, num_rows, buffer_->getSqlType(), replicating);
+  }
+
+  static constexpr size_t kMinBlockRows{1 << 16};
+};
+
+TEST_F(EncoderZoneMapTest, AppendedRows) {
+  createEncoder(kINT);
+  constexpr size_t kRows{1 << 20};
+  constexpr size_t kBatchRows{100000};
+  std::vector<int32_t> data(kRows);
+  std::iota(data.begin(), data.end(), 0);
+  data[5] = inline_int_null_value<int32_t>();
+  // Batches don't line up with the blocks.
+  std::shared_ptr<ChunkMetadata> chunk_metadata;
+  for (size_t start = 0; start < kRows; start += kBatchRows) {
+    std::vector<int32_t> batch(data.begin() + start,
+                               data.begin() + std::min(start + kBatchRows, kRows));
+    chunk_metadata = appendData(batch, batch.size(), false);
+  }
+  ASSERT_TRUE(chunk_metadata->zoneMap);
+  const auto& zone_map = *chunk_metadata->zoneMap;
+  EXPECT_EQ(zone_map.num_rows, kRows);
+  EXPECT_EQ(zone_map.block_rows, kMinBlockRows);
+  ASSERT_EQ(zone_map.blocks.size(), kRows / kMinBlockRows);
+  for (size_t i = 0; i < zone_map.blocks.size(); ++i) {
+    const auto& block = zone_map.blocks[i];
+    EXPECT_EQ(block.min, static_cast<int64_t>(i * kMinBlockRows));
+    EXPECT_EQ(block.max, static_cast<int64_t>((i + 1) * kMinBlockRows - 1));
+    EXPECT_EQ(block.has_nulls, i == 0);
+  }
+}
+
+TEST_F(EncoderZoneMapTest, MergedBlocks) {
+  createEncoder(kSMALLINT);
+  // Past 128 blocks, pairs of blocks get merged.
+  constexpr size_t kOnes{64 * kMinBlockRows};
+  constexpr size_t kRows{130 * kMinBlockRows + 10};
+  appendData(std::vector<int16_t>{1}, kOnes, true);
+  appendData(std::vector<int16_t>{inline_int_null_value<int16_t>()}, 10, true);
+  auto chunk_metadata = appendData(std::vector<int16_t>{2}, kRows - kOnes - 10, true);
+  ASSERT_TRUE(chunk_metadata->zoneMap);
+  const auto& zone_map = *chunk_metadata->zoneMap;
+  EXPECT_EQ(zone_map.num_rows, kRows);
+  EXPECT_EQ(zone_map.block_rows, 2 * kMinBlockRows);
+  ASSERT_EQ(zone_map.blocks.size(), size_t(66));
+  EXPECT_EQ(zone_map.blocks[31].max, 1);
+  EXPECT_FALSE(zone_map.blocks[31].has_nulls);
+  EXPECT_EQ(zone_map.blocks[32].min, 2);
+  EXPECT_TRUE(zone_map.blocks[32].has_nulls);
+
+  // Values updated in place leave the chunk without a zone map.
+  buffer_->getEncoder()->updateStats(int64_t(3), false);
+  auto updated_metadata = std::make_shared<ChunkMetadata>();
+  buffer_->getEncoder()->getMetadata(updated_metadata);
+  EXPECT_FALSE(updated_metadata->zoneMap);
+}
+
+TEST_F(EncoderZoneMapTest, NoZoneMapForStrings) {
+  auto sql_type_info = SQLTypeInfo(kTEXT, false, kENCODING_DICT);
+  sql_type_info.set_size(4);
+  createEncoder(sql_type_info);
+  auto chunk_metadata = appendData(std::vector<int32_t>{1, 2, 3}, 3, false);
+  EXPECT_FALSE(chunk_metadata->zoneMap);
+}
+
+TEST_F(EncoderZoneMapTest, BloomFilter) {
+  createEncoder(kBIGINT);
+  std::vector<int64_t> data(1000);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int64_t>(i) * 1000003;
+  }
+  data[7] = inline_int_null_value<int64_t>();
+  appendData(std::vector<int64_t>(data.begin(), data.begin() + 500), 500, false);
+  auto chunk_metadata =
+      appendData(std::vector<int64_t>(data.begin() + 500, data.end()), 500, false);
+  ASSERT_TRUE(chunk_metadata->bloomFilter);
+  const auto& bloom_filter = *chunk_metadata->bloomFilter;
+  EXPECT_EQ(bloom_filter.num_rows, data.size());
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (i != 7) {
+      EXPECT_TRUE(bloom_filter.mayContain(data[i]));
+    }
+  }
+  size_t false_positives{0};
+  for (int64_t value = 1; value <= 1000; ++value) {
+    false_positives += bloom_filter.mayContain(value) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, size_t(100));
+
+  // Values updated in place leave the chunk without a Bloom filter.
+  buffer_->getEncoder()->updateStats(int64_t(3), false);
+  auto updated_metadata = std::make_shared<ChunkMetadata>();
+  buffer_->getEncoder()->getMetadata(updated_metadata);
+  EXPECT_FALSE(updated_metadata->bloomFilter);
+}
+
+TEST_F(EncoderZoneMapTest, BloomFilterForStrings) {
+  auto sql_type_info = SQLTypeInfo(kTEXT, false, kENCODING_DICT);
+  sql_type_info.set_size(2);
+  createEncoder(sql_type_info);
+  auto chunk_metadata = appendData(std::vector<uint16_t>{1, 2, 3}, 3, false);
+  ASSERT_TRUE(chunk_metadata->bloomFilter);
+  EXPECT_TRUE(chunk_metadata->bloomFilter->mayContain(2));
+}
+
+TEST_F(EncoderZoneMapTest, BloomFilterGrowsWithDistinctValues) {
+  createEncoder(kINT);
+  std::vector<int32_t> data(1 << 16);
+  std::iota(data.begin(), data.end(), 0);
+  auto chunk_metadata = appendData(data, data.size(), false);
+  ASSERT_TRUE(chunk_metadata->bloomFilter);
+  const auto& bloom_filter = *chunk_metadata->bloomFilter;
+  EXPECT_GT(bloom_filter.slices.size(), size_t(1));
+  for (const auto value : data) {
+    EXPECT_TRUE(bloom_filter.mayContain(value));
+  }
+  size_t false_positives{0};
+  constexpr int64_t kNumAbsentValues{100000};
+  for (int64_t value = 0; value < kNumAbsentValues; ++value) {
+    false_positives += bloom_filter.mayContain(-1 - value) ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, kNumAbsentValues * g_bloom_filter_fp_rate * 1.5);
+}
+
+TEST_F(EncoderZoneMapTest, NoBloomFilterForManyValues) {
+  const auto max_bytes = g_bloom_filter_max_bytes;
+  ScopeGuard reset_max_bytes = [max_bytes] { g_bloom_filter_max_bytes = max_bytes; };
+  g_bloom_filter_max_bytes = 16 * 1024;
+  createEncoder(kINT);
+  std::vector<int32_t> data(1 << 16);
+  std::iota(data.begin(), data.end(), 0);
+  auto chunk_metadata = appendData(data, data.size(), false);
+  EXPECT_FALSE(chunk_metadata->bloomFilter);
+  // The zone map is still there.
+  EXPECT_TRUE(chunk_metadata->zoneMap);
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
@@ -23,6 +23,7 @@
 #include "../QueryEngine/Descriptors/RelAlgExecutionDescriptor.h"
 #include "../QueryEngine/Execute.h"
 #include "../QueryEngine/ExpressionRange.h"
+#include "../QueryEngine/JoinHashTable/HashJoin.h"
 #include "../QueryEngine/ResultSetReductionJIT.h"
 #include "../QueryRunner/QueryRunner.h"
 #include "../Shared/DateConverters.h"
@@ -65,6 +66,14 @@ extern size_t g_parallel_top_min;
 extern bool g_enable_window_functions;
 extern bool g_enable_calcite_view_optimize;
 extern bool g_enable_bump_allocator;
+extern bool g_enable_count_distinct_hash_set;
+extern bool g_enable_background_cpu_compilation;
+extern bool g_enable_zone_map_row_skipping;
+extern bool g_enable_fragment_skipping;
+extern bool g_enable_chunk_prefetch;
+extern double g_chunk_prefetch_mem_fraction;
+extern bool g_enable_parallel_reduction;
+extern bool g_enable_sorted_key_join;
 extern bool g_enable_interop;
 extern bool g_enable_union;
 
@@ -1705,6 +1714,167 @@ TEST(Select, FilterAndMultipleAggregation) {
   }
 }
 
+TEST(Select, BackgroundCpuCompilation) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto background_compilation_state = g_enable_background_cpu_compilation;
+  ScopeGuard reset = [background_compilation_state] {
+    g_enable_background_cpu_compilation = background_compilation_state;
+  };
+  g_enable_background_cpu_compilation = true;
+  const auto dt = ExecutorDeviceType::CPU;
+  // Shapes no other test compiles, so that they first run on baseline code. The queries
+  // run on a single executor.
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*), SUM(x * 3 + y) FROM test WHERE y - x > 35;",
+      "SELECT z, MIN(x * 5), MAX(y - 2) FROM test GROUP BY z ORDER BY z;",
+      "SELECT x * 11 - y AS k, z FROM test WHERE z > -200 ORDER BY k, z LIMIT 5;"};
+  for (const auto& query : queries) {
+    c(query, dt);
+  }
+  Executor::waitForBackgroundCompilation();
+  const auto num_swaps = Executor::getNumBackgroundCodeSwaps();
+  // the optimized code replaces the baseline code of every query
+  for (const auto& query : queries) {
+    c(query, dt);
+  }
+  const auto num_swaps_after_rerun = Executor::getNumBackgroundCodeSwaps();
+  EXPECT_GE(num_swaps_after_rerun, num_swaps + queries.size());
+  // and only once
+  for (const auto& query : queries) {
+    c(query, dt);
+  }
+  EXPECT_EQ(Executor::getNumBackgroundCodeSwaps(), num_swaps_after_rerun);
+}
+
+TEST(Select, ChunkPrefetch) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto chunk_prefetch_state = g_enable_chunk_prefetch;
+  const auto cpu_threads_override = g_cpu_threads_override;
+  ScopeGuard reset = [chunk_prefetch_state, cpu_threads_override] {
+    g_enable_chunk_prefetch = chunk_prefetch_state;
+    g_cpu_threads_override = cpu_threads_override;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS chunk_prefetch_test;");
+  run_ddl_statement(
+      "CREATE TABLE chunk_prefetch_test (x INT, s TEXT ENCODING DICT(32), t TEXT "
+      "ENCODING NONE) WITH (fragment_size = 100);");
+  {
+    // 40 fragments, so more kernels than the query threads, which starts a prefetcher.
+    const auto data_path =
+        boost::filesystem::path("../../Tests/Import/datafiles/chunk_prefetch_test.csv");
+    std::ofstream out(data_path.string());
+    for (int i = 0; i < 4000; ++i) {
+      out << i << ",s" << i % 13 << ",t" << i % 17 << "\n";
+    }
+    out.close();
+    run_ddl_statement("COPY chunk_prefetch_test FROM '" + data_path.string() +
+                      "' WITH (HEADER='f', THREADS=1);");
+    boost::filesystem::remove(data_path);
+  }
+  g_cpu_threads_override = 1;
+  const std::vector<std::string> queries{
+      "SELECT COUNT(*) FROM chunk_prefetch_test WHERE x % 7 = 3;",
+      "SELECT SUM(x) FROM chunk_prefetch_test WHERE s = 's5';",
+      "SELECT COUNT(*) FROM chunk_prefetch_test WHERE t LIKE '%7';",
+      "SELECT MAX(x) FROM (SELECT s, MAX(x) AS x FROM chunk_prefetch_test GROUP BY s);"};
+  const auto dt = ExecutorDeviceType::CPU;
+  auto& data_mgr = QR::get()->getSession()->getCatalog().getDataMgr();
+  const size_t prefetch_budget =
+      data_mgr.getCpuBufferMgr()->getMaxSize() * g_chunk_prefetch_mem_fraction;
+  for (const auto& query : queries) {
+    g_enable_chunk_prefetch = false;
+    const auto expected = v<int64_t>(run_simple_agg(query, dt));
+    g_enable_chunk_prefetch = true;
+    for (size_t i = 0; i < 2; ++i) {
+      QR::get()->clearCpuMemory();
+      EXPECT_EQ(expected, v<int64_t>(run_simple_agg(query, dt))) << query;
+      // The prefetched chunks are unpinned and their budget is released.
+      EXPECT_TRUE(data_mgr.reservePrefetchMemory(prefetch_budget)) << query;
+      data_mgr.releasePrefetchMemory(prefetch_budget);
+    }
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS chunk_prefetch_test;");
+}
+
+TEST(Select, ParallelReduction) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto parallel_reduction_state = g_enable_parallel_reduction;
+  const auto columnar_output_state = g_enable_columnar_output;
+  ScopeGuard reset = [parallel_reduction_state, columnar_output_state] {
+    g_enable_parallel_reduction = parallel_reduction_state;
+    g_enable_columnar_output = columnar_output_state;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS parallel_reduction_test;");
+  run_ddl_statement(
+      "CREATE TABLE parallel_reduction_test (x INT, y INT, d DOUBLE) WITH "
+      "(fragment_size = 6000);");
+  constexpr int64_t num_rows{60000};
+  constexpr int64_t num_x{30000};
+  {
+    // Ten fragments, so ten kernel results for Executor::reduceMultiDeviceResultSets.
+    const auto data_path = boost::filesystem::path(
+        "../../Tests/Import/datafiles/parallel_reduction_test.csv");
+    std::ofstream out(data_path.string());
+    for (int64_t i = 0; i < num_rows; ++i) {
+      out << i % num_x << "," << i % 7 << "," << i * 0.5 << "\n";
+    }
+    out.close();
+    run_ddl_statement("COPY parallel_reduction_test FROM '" + data_path.string() +
+                      "' WITH (HEADER='f', THREADS=1);");
+    boost::filesystem::remove(data_path);
+  }
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const bool columnar_output : {false, true}) {
+    g_enable_columnar_output = columnar_output;
+    for (const bool parallel_reduction : {true, false}) {
+      g_enable_parallel_reduction = parallel_reduction;
+      const std::string config = std::string(parallel_reduction ? "parallel" : "serial") +
+                                 (columnar_output ? ", columnar" : ", row-wise");
+      // Perfect hash group by with enough entries for the multithreaded reduction.
+      {
+        const auto result = run_multiple_agg(
+            "SELECT x, COUNT(*), SUM(y), MIN(y), MAX(d) FROM parallel_reduction_test "
+            "GROUP BY x ORDER BY x;",
+            dt);
+        ASSERT_EQ(result->rowCount(), size_t(num_x)) << config;
+        for (int64_t x = 0; x < num_x; ++x) {
+          const auto row = result->getNextRow(true, true);
+          ASSERT_EQ(row.size(), size_t(5));
+          const auto y1 = x % 7;
+          const auto y2 = (x + num_x) % 7;
+          ASSERT_EQ(v<int64_t>(row[0]), x) << config;
+          ASSERT_EQ(v<int64_t>(row[1]), 2) << config;
+          ASSERT_EQ(v<int64_t>(row[2]), y1 + y2) << config;
+          ASSERT_EQ(v<int64_t>(row[3]), std::min(y1, y2)) << config;
+          ASSERT_DOUBLE_EQ(v<double>(row[4]), (x + num_x) * 0.5) << config;
+        }
+      }
+      // And with few entries, reduced in the calling thread.
+      {
+        const auto result = run_multiple_agg(
+            "SELECT y, COUNT(*), SUM(x) FROM parallel_reduction_test GROUP BY y ORDER BY "
+            "y;",
+            dt);
+        ASSERT_EQ(result->rowCount(), size_t(7)) << config;
+        for (int64_t y = 0; y < 7; ++y) {
+          int64_t expected_count{0};
+          int64_t expected_sum{0};
+          for (int64_t i = y; i < num_rows; i += 7) {
+            ++expected_count;
+            expected_sum += i % num_x;
+          }
+          const auto row = result->getNextRow(true, true);
+          ASSERT_EQ(row.size(), size_t(3));
+          ASSERT_EQ(v<int64_t>(row[0]), y) << config;
+          ASSERT_EQ(v<int64_t>(row[1]), expected_count) << config;
+          ASSERT_EQ(v<int64_t>(row[2]), expected_sum) << config;
+        }
+      }
+    }
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS parallel_reduction_test;");
+}
+
 TEST(Select, GroupBy) {
   {  // generate dataset to test count distinct rewrite
     run_ddl_statement("DROP TABLE IF EXISTS count_distinct_rewrite;");
@@ -2803,6 +2973,62 @@ TEST(Select, CountDistinct) {
   }
 }
 
+TEST(Select, CountDistinctHashSet) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto watchdog_state = g_enable_watchdog;
+  const auto hash_set_state = g_enable_count_distinct_hash_set;
+  ScopeGuard reset = [watchdog_state, hash_set_state] {
+    g_enable_watchdog = watchdog_state;
+    g_enable_count_distinct_hash_set = hash_set_state;
+  };
+  g_enable_watchdog = false;
+  run_ddl_statement("DROP TABLE IF EXISTS count_distinct_hash_set_test;");
+  run_ddl_statement(
+      "CREATE TABLE count_distinct_hash_set_test(k INT, x BIGINT, arr BIGINT[]);");
+  // Too wide for a bitmap. Every group gets 25 distinct values, enough to promote the
+  // sets from sparse to dense, and a few nulls. The arrays hold x and x + 1.
+  for (int i = 0; i < 210; ++i) {
+    const auto x_val = (i % 100) * 1000000000000LL;
+    const auto x = i < 200 ? std::to_string(x_val) : "NULL";
+    const auto arr = i < 200 ? "{" + x + ", " + std::to_string(x_val + 1) + "}"
+                             : std::string(i % 2 ? "NULL" : "{NULL}");
+    run_multiple_agg("INSERT INTO count_distinct_hash_set_test VALUES (" +
+                         std::to_string(i % 4) + ", " + x + ", " + arr + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const bool use_hash_set : {true, false}) {
+      g_enable_count_distinct_hash_set = use_hash_set;
+      EXPECT_EQ(100,
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(DISTINCT x) FROM count_distinct_hash_set_test;", dt)));
+      EXPECT_EQ(99,
+                v<int64_t>(run_simple_agg("SELECT COUNT(DISTINCT x) FROM "
+                                          "count_distinct_hash_set_test WHERE x > 0;",
+                                          dt)));
+      EXPECT_EQ(200,
+                v<int64_t>(run_simple_agg(
+                    "SELECT COUNT(DISTINCT arr) FROM count_distinct_hash_set_test;",
+                    dt)));
+      const auto rows = run_multiple_agg(
+          "SELECT k, COUNT(DISTINCT x), COUNT(DISTINCT x / 3), COUNT(DISTINCT arr) FROM "
+          "count_distinct_hash_set_test GROUP BY k ORDER BY k;",
+          dt);
+      ASSERT_EQ(size_t(4), rows->rowCount());
+      for (int64_t k = 0; k < 4; ++k) {
+        const auto row = rows->getNextRow(true, true);
+        ASSERT_EQ(size_t(4), row.size());
+        EXPECT_EQ(k, v<int64_t>(row[0]));
+        EXPECT_EQ(25, v<int64_t>(row[1]));
+        EXPECT_EQ(25, v<int64_t>(row[2]));
+        EXPECT_EQ(50, v<int64_t>(row[3]));
+      }
+    }
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS count_distinct_hash_set_test;");
+}
+
 TEST(Select, ApproxCountDistinct) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -9553,6 +9779,131 @@ TEST(Select, Joins_DifferentIntegerTypes) {
   }
 }
 
+TEST(Select, Joins_SortedKey) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto sorted_key_join_state = g_enable_sorted_key_join;
+  ScopeGuard reset = [sorted_key_join_state] {
+    g_enable_sorted_key_join = sorted_key_join_state;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_outer;");
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_inner;");
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_sparse_inner;");
+  run_ddl_statement("CREATE TABLE sorted_key_outer (k INT, b BIGINT, v INT);");
+  // Inner keys are wider than the outer ones. The key range is small enough for the
+  // perfect hash table, which is still built on the sort column of the table.
+  run_ddl_statement(
+      "CREATE TABLE sorted_key_inner (k BIGINT, w INT) WITH (fragment_size = 2, "
+      "sort_column = 'k');");
+  // The range of the keys is too large for a perfect hash table, the sorted key table is
+  // built once the perfect hash table throws TooManyHashEntries.
+  run_ddl_statement(
+      "CREATE TABLE sorted_key_sparse_inner (k BIGINT, w INT) WITH (fragment_size = 2);");
+  const auto dt = ExecutorDeviceType::CPU;
+  for (const auto& row : {"1, 1, 10",
+                          "2, 2, 20",
+                          "2, 2, 21",
+                          "3, 3, 30",
+                          "NULL, NULL, 40",
+                          "7, 7, 70",
+                          "100, 10000000000, 1000"}) {
+    run_multiple_agg("INSERT INTO sorted_key_outer VALUES (" + std::string(row) + ");",
+                     dt);
+  }
+  for (const auto& row :
+       {"2, 1", "2, 2", "3, 3", "1, 4", "5, 5", "7, 6", "7, 7", "NULL, 8"}) {
+    run_multiple_agg("INSERT INTO sorted_key_inner VALUES (" + std::string(row) + ");",
+                     dt);
+  }
+  for (const auto& row : {"1, 1",
+                          "2, 2",
+                          "2, 3",
+                          "10000000000, 4",
+                          "20000000000, 5",
+                          "NULL, 6"}) {
+    run_multiple_agg(
+        "INSERT INTO sorted_key_sparse_inner VALUES (" + std::string(row) + ");", dt);
+  }
+
+  auto get_rows = [dt](const std::string& query) {
+    const auto result = run_multiple_agg(query, dt);
+    std::vector<std::vector<int64_t>> rows;
+    while (true) {
+      const auto row = result->getNextRow(true, true);
+      if (row.empty()) {
+        break;
+      }
+      std::vector<int64_t> values;
+      for (const auto& value : row) {
+        values.push_back(v<int64_t>(value));
+      }
+      rows.push_back(values);
+    }
+    return rows;
+  };
+  // The outer row with a null key, and those without a match, only come out of the
+  // left join.
+  const std::vector<std::pair<std::string, size_t>> queries{
+      {"SELECT o.v, i.w FROM sorted_key_outer o JOIN sorted_key_inner i ON o.k = i.k "
+       "ORDER BY o.v, i.w;",
+       8},
+      {"SELECT o.v, i.w FROM sorted_key_outer o LEFT JOIN sorted_key_inner i ON o.k = "
+       "i.k ORDER BY o.v, i.w;",
+       10},
+      {"SELECT o.v, s.w FROM sorted_key_outer o JOIN sorted_key_sparse_inner s ON o.b = "
+       "s.k ORDER BY o.v, s.w;",
+       6},
+      {"SELECT o.v, s.w FROM sorted_key_outer o LEFT JOIN sorted_key_sparse_inner s ON "
+       "o.b = s.k ORDER BY o.v, s.w;",
+       9},
+      {"SELECT i.k, COUNT(*) FROM sorted_key_outer o JOIN sorted_key_inner i ON o.k = "
+       "i.k GROUP BY i.k ORDER BY i.k;",
+       4}};
+  for (const auto& [query, row_count] : queries) {
+    g_enable_sorted_key_join = false;
+    const auto expected = get_rows(query);
+    ASSERT_EQ(expected.size(), row_count) << query;
+    g_enable_sorted_key_join = true;
+    EXPECT_EQ(expected, get_rows(query)) << query;
+  }
+  g_enable_sorted_key_join = true;
+  auto get_hash_join_type = [](std::string_view outer_column,
+                               std::string_view inner_table) {
+    auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+    executor->setCatalog(QR::get()->getCatalog().get());
+    ColumnCacheMap column_cache;
+    return HashJoin::getSyntheticInstance("sorted_key_outer",
+                                          outer_column,
+                                          inner_table,
+                                          "k",
+                                          Data_Namespace::CPU_LEVEL,
+                                          HashType::OneToOne,
+                                          1,
+                                          column_cache,
+                                          executor.get())
+        ->getHashJoinType();
+  };
+  EXPECT_EQ(get_hash_join_type("k", "sorted_key_inner"), "Perfect");
+  EXPECT_EQ(get_hash_join_type("b", "sorted_key_sparse_inner"), "SortedKey");
+  ASSERT_EQ(int64_t(4),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM sorted_key_outer o JOIN sorted_key_inner i ON o.k "
+                "= i.k WHERE i.k = 2;",
+                dt)));
+  ASSERT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM sorted_key_outer o LEFT JOIN sorted_key_inner i ON "
+                "o.k = i.k WHERE o.k IS NULL;",
+                dt)));
+  ASSERT_EQ(int64_t(1),
+            v<int64_t>(run_simple_agg(
+                "SELECT COUNT(*) FROM sorted_key_outer o JOIN sorted_key_sparse_inner s "
+                "ON o.b = s.k WHERE s.k > 2147483647;",
+                dt)));
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_outer;");
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_inner;");
+  run_ddl_statement("DROP TABLE IF EXISTS sorted_key_sparse_inner;");
+}
+
 TEST(Select, Joins_FilterPushDown) {
   auto default_flag = g_enable_filter_push_down;
   auto default_lower_frac = g_filter_push_down_low_frac;
@@ -20776,6 +21127,266 @@ TEST(Select, SampleRatio) {
   }
 }
 
+TEST(Select, ZoneMapRowSkipping) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto zone_map_state = g_enable_zone_map_row_skipping;
+  ScopeGuard reset = [zone_map_state] {
+    g_enable_zone_map_row_skipping = zone_map_state;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS zone_map_test;");
+  run_ddl_statement(
+      "CREATE TABLE zone_map_test (x BIGINT, y INT ENCODING FIXED(16)) WITH "
+      "(fragment_size = 1000000);");
+  {
+    // Four blocks of 64K rows in a single fragment. x is the row number, with nulls in
+    // the middle of the second block and at the end of the last one. y ranges over
+    // [10 * block, 10 * block + 6].
+    const auto data_path =
+        boost::filesystem::path("../../Tests/Import/datafiles/zone_map_test.csv");
+    std::ofstream out(data_path.string());
+    for (int64_t i = 0; i < 4 * 65536; ++i) {
+      if ((i >= 70000 && i < 70100) || i >= 240000) {
+        out << ",";
+      } else {
+        out << i << ",";
+      }
+      out << (i / 65536) * 10 + i % 7 << "\n";
+    }
+    out.close();
+    run_ddl_statement("COPY zone_map_test FROM '" + data_path.string() +
+                      "' WITH (HEADER='f', THREADS=1);");
+    boost::filesystem::remove(data_path);
+  }
+  const auto check = [](const std::vector<std::pair<std::string, int64_t>>& queries) {
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      for (const bool skip_rows : {true, false}) {
+        g_enable_zone_map_row_skipping = skip_rows;
+        for (const auto& [query, expected] : queries) {
+          EXPECT_EQ(expected, v<int64_t>(run_simple_agg(query, dt)))
+              << query << (skip_rows ? " with" : " without") << " row skipping";
+        }
+      }
+    }
+  };
+  check({{"SELECT COUNT(*) FROM zone_map_test WHERE x >= 200000;", 40000},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x > 239990;", 9},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x < 70050;", 70000},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x = 70050;", 0},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x = 70100;", 1},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x IS NULL;", 22244},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x IS NULL AND y >= 30;", 22144},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE y >= 30;", 65536},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE y < 0;", 0},
+         {"SELECT SUM(x) FROM zone_map_test WHERE y < 10 AND x > 65000;", 34918380},
+         {"SELECT MIN(offset_in_fragment()) FROM zone_map_test WHERE x >= 200000;",
+          200000},
+         {"SELECT MAX(x) FROM zone_map_test WHERE x < 131072 AND x > 65536;", 131071}});
+
+  // Updates and deletes inside a block. A value moved out of the range of its block
+  // must still be found.
+  run_multiple_agg("UPDATE zone_map_test SET x = 500000 WHERE x = 130000;",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("UPDATE zone_map_test SET y = 100 WHERE x = 1;",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("UPDATE zone_map_test SET x = 1000 WHERE x = 70100;",
+                   ExecutorDeviceType::CPU);
+  run_multiple_agg("DELETE FROM zone_map_test WHERE x >= 100 AND x < 200;",
+                   ExecutorDeviceType::CPU);
+  check({{"SELECT COUNT(*) FROM zone_map_test WHERE x >= 400000;", 1},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x = 130000;", 0},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE y >= 100;", 1},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x = 1000;", 2},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x < 1000;", 900},
+         {"SELECT COUNT(*) FROM zone_map_test WHERE x >= 200000;", 40001}});
+
+  run_ddl_statement("DROP TABLE IF EXISTS zone_map_test;");
+}
+
+TEST(Select, FragmentSkippingMatchesUnpruned) {
+  SKIP_ALL_ON_AGGREGATOR();
+  const auto fragment_skipping_state = g_enable_fragment_skipping;
+  ScopeGuard reset = [fragment_skipping_state] {
+    g_enable_fragment_skipping = fragment_skipping_state;
+  };
+  run_ddl_statement("DROP TABLE IF EXISTS fragment_skipping_test;");
+  run_ddl_statement(
+      "CREATE TABLE fragment_skipping_test (i INT, f FLOAT, d DOUBLE, dec DECIMAL(10, "
+      "2), s TEXT ENCODING DICT(32), n INT) WITH (fragment_size = 4);");
+  {
+    // Four rows per fragment. The second fragment has only nulls in n and -0.0 in d, the
+    // third only nulls in i, dec and s, NaN in f and d, the last one NaN in d.
+    const auto data_path = boost::filesystem::path(
+        "../../Tests/Import/datafiles/fragment_skipping_test.csv");
+    std::ofstream out(data_path.string());
+    out << "1,0.5,-0.0,1.25,a,1\n"
+        << "2,1.5,0.0,2.50,b,2\n"
+        << "3,2.5,1.0,3.75,c,3\n"
+        << "4,3.5,2.0,5.00,d,4\n"
+        << "10,-1.5,-0.0,10.01,e,\n"
+        << "11,-0.0,-0.0,10.02,f,\n"
+        << "12,0.0,-0.0,10.03,e,\n"
+        << "13,-2.5,-0.0,10.04,f,\n"
+        << ",-nan,100.0,,,5\n"
+        << ",7.5,-nan,,,6\n"
+        << ",8.5,102.0,,,7\n"
+        << ",9.5,103.0,,,8\n"
+        << "20,100.25,1e10,-1.00,a,\n"
+        << "21,100.5,-nan,-2.00,z,9\n"
+        << "22,100.75,-1e10,-3.00,z,\n"
+        << "23,101.0,5.5,-4.00,z,10\n";
+    out.close();
+    run_ddl_statement("COPY fragment_skipping_test FROM '" + data_path.string() +
+                      "' WITH (HEADER='f', THREADS=1);");
+    boost::filesystem::remove(data_path);
+  }
+  const std::vector<std::string> filters{
+      "f > 2.0",
+      "f = 1.5",
+      "f < -1",
+      "f >= 100.25",
+      "f = 0.0",
+      "f = -0.0",
+      "f <= -0.0",
+      "CAST(f AS DOUBLE) = 1.5",
+      "d = 0.0",
+      "d = -0.0",
+      "d < 0",
+      "d <= 0",
+      "d >= 0",
+      "d > 101",
+      "d >= 1e10",
+      "d < -1e9",
+      "d = 1.0 OR d = 5.5",
+      "dec = 2.5",
+      "dec = 10.03",
+      "dec > 10",
+      "dec < 0",
+      "dec = 3",
+      "dec = 1.255",
+      "dec >= 1.251 AND dec <= 1.259",
+      "dec BETWEEN 3.75 AND 10.01",
+      "f > dec",
+      "i IN (1, 22)",
+      "i IN (5, 6)",
+      "i = 11 OR i = 21",
+      "i = 11 OR f > 100",
+      "i > 100 OR d < 0",
+      "i IS NULL",
+      "i = 3 AND dec = 3.75",
+      "s = 'e'",
+      "s = 'zz'",
+      "s IN ('a', 'f')",
+      "s = 'a' OR s = 'q'",
+      "s = 'z' AND n = 9",
+      "s IS NULL",
+      "s IN (SELECT s FROM fragment_skipping_test WHERE i = 2)",
+      "n = 3",
+      "n = 3 OR n = 9",
+      "n IS NULL",
+      "n > 8",
+      "n IN (9, 10)",
+      "n IS NULL AND d < 0"};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    for (const auto& filter : filters) {
+      const auto query = "SELECT COUNT(*), SUM(i), SUM(n) FROM fragment_skipping_test "
+                         "WHERE " +
+                         filter + ";";
+      g_enable_fragment_skipping = false;
+      const auto unpruned = run_multiple_agg(query, dt);
+      g_enable_fragment_skipping = true;
+      const auto pruned = run_multiple_agg(query, dt);
+      const auto unpruned_row = unpruned->getNextRow(false, false);
+      const auto pruned_row = pruned->getNextRow(false, false);
+      ASSERT_EQ(unpruned_row.size(), size_t(3));
+      ASSERT_EQ(pruned_row.size(), size_t(3));
+      for (size_t i = 0; i < unpruned_row.size(); ++i) {
+        EXPECT_EQ(v<int64_t>(unpruned_row[i]), v<int64_t>(pruned_row[i]))
+            << query << " column " << i;
+      }
+    }
+    // A few results checked against the data, in case both runs agree on a wrong one.
+    for (const auto& [filter, expected] :
+         std::vector<std::pair<std::string, int64_t>>{{"d = 0.0", 6},
+                                                      {"f = -0.0", 2},
+                                                      {"dec = 10.03", 1},
+                                                      {"s = 'e'", 2},
+                                                      {"s = 'zz'", 0},
+                                                      {"n IS NULL", 6},
+                                                      {"n = 3 OR n = 9", 2}}) {
+      EXPECT_EQ(
+          expected,
+          v<int64_t>(run_simple_agg(
+              "SELECT COUNT(*) FROM fragment_skipping_test WHERE " + filter + ";", dt)))
+          << filter;
+    }
+  }
+
+  run_ddl_statement("DROP TABLE IF EXISTS fragment_skipping_test;");
+}
+
+TEST(Select, BloomFilterFragmentSkipping) {
+  SKIP_ALL_ON_AGGREGATOR();
+  run_ddl_statement("DROP TABLE IF EXISTS bloom_filter_test;");
+  run_ddl_statement(
+      "CREATE TABLE bloom_filter_test (x BIGINT) WITH (fragment_size = 1000);");
+  {
+    // Four fragments whose values interleave, fragment f holds f, f + 4, f + 8, ... so
+    // that the min and max of every fragment let all the values through.
+    const auto data_path =
+        boost::filesystem::path("../../Tests/Import/datafiles/bloom_filter_test.csv");
+    std::ofstream out(data_path.string());
+    for (int64_t i = 0; i < 4000; ++i) {
+      out << (i % 1000) * 4 + i / 1000 << "\n";
+    }
+    out.close();
+    run_ddl_statement("COPY bloom_filter_test FROM '" + data_path.string() +
+                      "' WITH (HEADER='f', THREADS=1);");
+    boost::filesystem::remove(data_path);
+  }
+  const auto& cat = QR::get()->getSession()->getCatalog();
+  const auto td = cat.getMetadataForTable("bloom_filter_test");
+  CHECK(td);
+  const auto cd = cat.getMetadataForColumn(td->tableId, "x");
+  CHECK(cd);
+  // Returns the fragments whose chunk of x the query loaded, the skipped ones aren't.
+  const auto get_loaded_fragments = [td, cd](const std::string& query,
+                                             const int64_t expected) {
+    QR::get()->clearCpuMemory();
+    EXPECT_EQ(expected, v<int64_t>(run_simple_agg(query, ExecutorDeviceType::CPU)))
+        << query;
+    std::set<int> fragment_ids;
+    for (const auto& memory_info :
+         QR::get()->getMemoryInfo(Data_Namespace::MemoryLevel::CPU_LEVEL)) {
+      for (const auto& memory_data : memory_info.nodeMemoryData) {
+        const auto& chunk_key = memory_data.chunk_key;
+        if (memory_data.memStatus == Buffer_Namespace::MemStatus::USED &&
+            chunk_key.size() > CHUNK_KEY_FRAGMENT_IDX &&
+            chunk_key[CHUNK_KEY_TABLE_IDX] == td->tableId &&
+            chunk_key[CHUNK_KEY_COLUMN_IDX] == cd->columnId) {
+          fragment_ids.insert(chunk_key[CHUNK_KEY_FRAGMENT_IDX]);
+        }
+      }
+    }
+    return fragment_ids;
+  };
+  EXPECT_EQ(
+      get_loaded_fragments("SELECT COUNT(*) FROM bloom_filter_test WHERE x >= 0;", 4000),
+      (std::set<int>{0, 1, 2, 3}));
+  EXPECT_EQ(
+      get_loaded_fragments("SELECT COUNT(*) FROM bloom_filter_test WHERE x = 2002;", 1),
+      std::set<int>{2});
+  EXPECT_EQ(get_loaded_fragments(
+                "SELECT COUNT(*) FROM bloom_filter_test WHERE x IN (1, 2002, 3);", 3),
+            (std::set<int>{1, 2, 3}));
+  EXPECT_EQ(get_loaded_fragments(
+                "SELECT SUM(x) FROM bloom_filter_test WHERE x = 3 OR x = 1998;", 2001),
+            (std::set<int>{2, 3}));
+
+  run_ddl_statement("DROP TABLE IF EXISTS bloom_filter_test;");
+}
+
 TEST(Select, OffsetInFragment) {
   // Skip test in sharded/distributed situations, as otherwise we have to replicate much
   // of logic of how we shard strings to compute the number rows of test table that will
@@ -20988,6 +21599,180 @@ TEST(Select, UpdatePinnedBuffers) {
   }
 }
 
+TEST(Select, SequenceEncodings) {
+  SKIP_ALL_ON_AGGREGATOR();
+  run_ddl_statement("DROP TABLE IF EXISTS sequence_encodings_test;");
+  run_ddl_statement(
+      "CREATE TABLE sequence_encodings_test(id INT, x INT ENCODING RL, y BIGINT ENCODING "
+      "DIFF, z SMALLINT ENCODING DIFF, d DECIMAL(10, 2) ENCODING RL);");
+  // Long runs, a null and a value widening the differences from one to four bytes.
+  for (int i = 0; i < 30; ++i) {
+    const auto x = i < 10 ? "1" : i < 25 ? "NULL" : "7";
+    const auto y = i == 20 ? std::string("1000000") : std::to_string(1000 + i);
+    const auto z = i == 5 ? std::string("NULL") : std::to_string(i % 3);
+    run_multiple_agg("INSERT INTO sequence_encodings_test VALUES (" + std::to_string(i) +
+                         ", " + x + ", " + y + ", " + z + ", " +
+                         (i < 15 ? "1.25" : "2.50") + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(10,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM sequence_encodings_test WHERE x = 1;", dt)));
+    EXPECT_EQ(15,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM sequence_encodings_test WHERE x IS NULL;", dt)));
+    EXPECT_EQ(45,
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(x) FROM sequence_encodings_test;", dt)));
+    EXPECT_EQ(1000000,
+              v<int64_t>(run_simple_agg(
+                  "SELECT MAX(y) FROM sequence_encodings_test;", dt)));
+    EXPECT_EQ(1000,
+              v<int64_t>(run_simple_agg(
+                  "SELECT MIN(y) FROM sequence_encodings_test;", dt)));
+    EXPECT_EQ(1,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM sequence_encodings_test WHERE z IS NULL;", dt)));
+    EXPECT_EQ(28,
+              v<int64_t>(run_simple_agg(
+                  "SELECT SUM(z) FROM sequence_encodings_test;", dt)));
+    EXPECT_EQ(15,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM sequence_encodings_test WHERE d = 2.5;", dt)));
+    // Projected and lazily fetched.
+    const auto rows = run_multiple_agg(
+        "SELECT id, x, y FROM sequence_encodings_test WHERE id >= 20 ORDER BY id;", dt);
+    ASSERT_EQ(size_t(10), rows->rowCount());
+    for (int i = 20; i < 30; ++i) {
+      const auto row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(3), row.size());
+      EXPECT_EQ(i, v<int64_t>(row[0]));
+      if (i >= 25) {
+        EXPECT_EQ(7, v<int64_t>(row[1]));
+      }
+      EXPECT_EQ(i == 20 ? 1000000 : 1000 + i, v<int64_t>(row[2]));
+    }
+    // Window functions and hash joins read the encoded columns one slot per row.
+    {
+      const auto rows = run_multiple_agg(
+          "SELECT id, ROW_NUMBER() OVER (ORDER BY y) r, LAG(x) OVER (ORDER BY id) "
+          "FROM sequence_encodings_test ORDER BY id;",
+          dt);
+      ASSERT_EQ(size_t(30), rows->rowCount());
+      for (int i = 0; i < 30; ++i) {
+        const auto row = rows->getNextRow(true, true);
+        ASSERT_EQ(size_t(3), row.size());
+        EXPECT_EQ(i < 20 ? i + 1 : i == 20 ? 30 : i, v<int64_t>(row[1]));
+        if (i >= 1 && i <= 10) {
+          EXPECT_EQ(1, v<int64_t>(row[2]));
+        } else if (i >= 26) {
+          EXPECT_EQ(7, v<int64_t>(row[2]));
+        }
+      }
+    }
+    EXPECT_EQ(125,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sequence_encodings_test a "
+                                        "JOIN sequence_encodings_test b ON a.x = b.x;",
+                                        dt)));
+    EXPECT_EQ(30,
+              v<int64_t>(run_simple_agg("SELECT COUNT(*) FROM sequence_encodings_test a "
+                                        "JOIN sequence_encodings_test b ON a.y = b.y;",
+                                        dt)));
+  }
+  EXPECT_ANY_THROW(run_multiple_agg("UPDATE sequence_encodings_test SET x = 2;",
+                                    ExecutorDeviceType::CPU));
+  if (!g_keep_test_data) {
+    run_ddl_statement("DROP TABLE IF EXISTS sequence_encodings_test;");
+  }
+}
+
+TEST(Select, DiffEncodingDecreasingValues) {
+  SKIP_ALL_ON_AGGREGATOR();
+  run_ddl_statement("DROP TABLE IF EXISTS diff_decreasing_test;");
+  run_ddl_statement("CREATE TABLE diff_decreasing_test(y BIGINT ENCODING DIFF);");
+  // Every insert is a new minimum of the chunk.
+  for (int i = 0; i < 100; ++i) {
+    run_multiple_agg("INSERT INTO diff_decreasing_test VALUES (" +
+                         std::to_string(5000 - 37 * i) + ");",
+                     ExecutorDeviceType::CPU);
+  }
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(316850,
+              v<int64_t>(run_simple_agg("SELECT SUM(y) FROM diff_decreasing_test;", dt)));
+    EXPECT_EQ(1337,
+              v<int64_t>(run_simple_agg("SELECT MIN(y) FROM diff_decreasing_test;", dt)));
+    EXPECT_EQ(1,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM diff_decreasing_test WHERE y = 3150;", dt)));
+  }
+  if (!g_keep_test_data) {
+    run_ddl_statement("DROP TABLE IF EXISTS diff_decreasing_test;");
+  }
+}
+
+TEST(Select, DiffEncodingWideDifferences) {
+  SKIP_ALL_ON_AGGREGATOR();
+  run_ddl_statement("DROP TABLE IF EXISTS diff_wide_test;");
+  run_ddl_statement(
+      "CREATE TABLE diff_wide_test(id INT, y BIGINT ENCODING DIFF, z INT ENCODING "
+      "DIFF);");
+  const auto insert = [](const int id, const std::string& y, const std::string& z) {
+    run_multiple_agg("INSERT INTO diff_wide_test VALUES (" + std::to_string(id) + ", " +
+                         y + ", " + z + ");",
+                     ExecutorDeviceType::CPU);
+  };
+  insert(0, "NULL", "NULL");
+  insert(1, "5", "5");
+  insert(2, "6", "6");
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(11, v<int64_t>(run_simple_agg("SELECT SUM(y) FROM diff_wide_test;", dt)));
+  }
+  // Differences overflowing 64 bits, appended after the chunk has been decoded.
+  insert(3, "9223372036854775807", "2147483647");
+  insert(4, "-9223372036854775807", "-2147483647");
+  insert(5, "7", "7");
+  insert(6, "NULL", "NULL");
+  // (y, z) for every id, nulls left out.
+  const std::vector<std::pair<int64_t, int64_t>> expected{
+      {0, 0},
+      {5, 5},
+      {6, 6},
+      {9223372036854775807LL, 2147483647},
+      {-9223372036854775807LL, -2147483647},
+      {7, 7},
+      {0, 0}};
+  for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+    SKIP_NO_GPU();
+    EXPECT_EQ(5, v<int64_t>(run_simple_agg("SELECT COUNT(y) FROM diff_wide_test;", dt)));
+    EXPECT_EQ(-2147483647,
+              v<int64_t>(run_simple_agg("SELECT MIN(z) FROM diff_wide_test;", dt)));
+    EXPECT_EQ(1,
+              v<int64_t>(run_simple_agg(
+                  "SELECT COUNT(*) FROM diff_wide_test WHERE y = 7 AND z = 7;", dt)));
+    const auto rows =
+        run_multiple_agg("SELECT id, y, z FROM diff_wide_test ORDER BY id;", dt);
+    ASSERT_EQ(expected.size(), rows->rowCount());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      const auto row = rows->getNextRow(true, true);
+      ASSERT_EQ(size_t(3), row.size());
+      if (i == 0 || i == 6) {
+        EXPECT_EQ(inline_int_null_val(rows->getColType(1)), v<int64_t>(row[1]));
+        EXPECT_EQ(inline_int_null_val(rows->getColType(2)), v<int64_t>(row[2]));
+      } else {
+        EXPECT_EQ(expected[i].first, v<int64_t>(row[1]));
+        EXPECT_EQ(expected[i].second, v<int64_t>(row[2]));
+      }
+    }
+  }
+  if (!g_keep_test_data) {
+    run_ddl_statement("DROP TABLE IF EXISTS diff_wide_test;");
+  }
+}
+
 namespace {
 int create_sharded_join_table(const std::string& table_name,
                               size_t fragment_size,
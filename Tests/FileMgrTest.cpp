@@ -21,6 +21,8 @@
 #include <gtest/gtest.h>
 #include <boost/filesystem.hpp>
 
+#include <thread>
+
 #include "DataMgr/FileMgr/FileMgr.h"
 #include "DataMgr/FileMgr/GlobalFileMgr.h"
 #include "DataMgr/ForeignStorage/ArrowForeignStorage.h"
@@ -300,6 +302,42 @@ TEST_F(FileMgrTest, buffer_append_and_recovery) {
   }
 }
 
+TEST_F(FileMgrTest, bloom_filter_recovery) {
+  const auto bloom_filter_path =
+      getFileMgr()->getFilePath(File_Namespace::FileMgr::BLOOM_FILTER_DIR_NAME) /
+      "1_1_1_0";
+  {
+    auto file_mgr = getFileMgr();
+    auto file_buffer = file_mgr->getBuffer(TEST_CHUNK_KEY);
+    std::vector<int32_t> data{2, 3};
+    appendData(file_buffer, data);
+    file_mgr->checkpoint();
+    // The Bloom filter is kept out of the metadata page.
+    ASSERT_TRUE(boost::filesystem::exists(bloom_filter_path));
+
+    // Values which aren't checkpointed must not end up in the filter read back.
+    std::vector<int32_t> uncheckpointed_data{4};
+    appendData(file_buffer, uncheckpointed_data);
+    global_file_mgr_->closeFileMgr(TEST_CHUNK_KEY[CHUNK_KEY_DB_IDX],
+                                   TEST_CHUNK_KEY[CHUNK_KEY_TABLE_IDX]);
+  }
+
+  auto file_mgr = getFileMgr();
+  ChunkMetadataVector chunk_metadata_vector;
+  file_mgr->getChunkMetadataVecForKeyPrefix(chunk_metadata_vector, TEST_CHUNK_KEY);
+  ASSERT_EQ(chunk_metadata_vector.size(), static_cast<size_t>(1));
+  const auto& chunk_metadata = chunk_metadata_vector[0].second;
+  ASSERT_EQ(chunk_metadata->numElements, static_cast<size_t>(3));
+  ASSERT_TRUE(chunk_metadata->bloomFilter);
+  for (const int64_t value : {1, 2, 3}) {
+    EXPECT_TRUE(chunk_metadata->bloomFilter->mayContain(value));
+  }
+  EXPECT_FALSE(chunk_metadata->bloomFilter->mayContain(4));
+
+  file_mgr->deleteBuffer(TEST_CHUNK_KEY);
+  EXPECT_FALSE(boost::filesystem::exists(bloom_filter_path));
+}
+
 TEST_F(FileMgrTest, buffer_update_and_recovery) {
   std::vector<int32_t> data_v1 = {
       2,
@@ -1120,6 +1158,40 @@ TEST_F(FileMgrUnitTest, InitializeWithUncheckpointedAppendPages) {
   ASSERT_EQ(buffer->pageCount(), 1U);
 }
 
+TEST_F(FileMgrUnitTest, ConcurrentReads) {
+  auto fsi = std::make_shared<ForeignStorageInterface>();
+  File_Namespace::GlobalFileMgr gfm(0, fsi, file_mgr_path, 0, page_size_);
+  auto fm = dynamic_cast<File_Namespace::FileMgr*>(gfm.getFileMgr(1, 1));
+  auto buffer = fm->createBuffer({1, 1, 1, 1});
+  auto page_data_size = page_size_ - buffer->reservedHeaderSize();
+  std::vector<int8_t> data(page_data_size * 16 + 5);
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<int8_t>(i % 127);
+  }
+  buffer->append(data.data(), data.size());
+  gfm.checkpoint(1, 1);
+
+  // Each thread reads a different range, starting and ending within pages.
+  constexpr size_t num_threads{8};
+  std::vector<std::vector<int8_t>> read_data(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.emplace_back([&, i] {
+      const auto offset = i * 7;
+      read_data[i].resize(data.size() - 2 * offset);
+      buffer->read(read_data[i].data(), read_data[i].size(), offset);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t i = 0; i < num_threads; ++i) {
+    const auto offset = i * 7;
+    ASSERT_EQ(read_data[i],
+              std::vector<int8_t>(data.begin() + offset, data.end() - offset));
+  }
+}
+
 int main(int argc, char** argv) {
   TestHelpers::init_logger_stderr_only(argc, argv);
   testing::InitGoogleTest(&argc, argv);
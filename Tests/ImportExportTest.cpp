@@ -17,6 +17,8 @@
 #include <Tests/TestHelpers.h>
 
 #include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <limits>
 #include <string>
 
@@ -124,6 +126,56 @@ TEST(Detect, Numeric) {
   d(kTIME, "1.22.22");
 }
 
+TEST(DelimitedParser, GetRowLongFields) {
+  import_export::CopyParams copy_params;
+  const std::string field_b = std::string(40, 'b') + "\"q\", " + std::string(30, 'c');
+  const std::string buffer = std::string(100, 'a') + ",\"" + std::string(40, 'b') +
+                             "\"\"q\"\", " + std::string(30, 'c') + "\",  " +
+                             std::string(70, 'd') + "  \r\nnext,row\n";
+  std::vector<std::string_view> row;
+  std::vector<std::unique_ptr<char[]>> tmp_buffers;
+  bool try_single_thread{false};
+  const char* buffer_end = buffer.data() + buffer.size();
+  const auto p = import_export::delimited_parser::get_row(buffer.data(),
+                                                          buffer_end,
+                                                          buffer_end,
+                                                          copy_params,
+                                                          nullptr,
+                                                          row,
+                                                          tmp_buffers,
+                                                          try_single_thread,
+                                                          false);
+  ASSERT_EQ(row.size(), size_t(3));
+  EXPECT_EQ(row[0], std::string(100, 'a'));
+  EXPECT_EQ(row[1], field_b);
+  EXPECT_EQ(row[2], std::string(70, 'd'));
+  EXPECT_FALSE(try_single_thread);
+  EXPECT_EQ(std::string(p + 1, buffer_end), "next,row\n");
+}
+
+TEST(DelimitedParser, FindRowEndPosQuotedLineDelims) {
+  import_export::CopyParams copy_params;
+  std::string rows;
+  for (size_t i = 0; i < 10; ++i) {
+    rows += std::to_string(i) + ",\"" + std::string(i * 13, 'x') + "\n\"\"" +
+            std::string(50, 'y') + "\"\"\"," + std::string(i * 5, 'z') + "\n";
+  }
+  const std::string partial_row = "10,\"" + std::string(70, 'x') + "\n";
+  size_t buffer_size = rows.size() + partial_row.size();
+  size_t alloc_size = buffer_size;
+  auto buffer = std::make_unique<char[]>(alloc_size);
+  memcpy(buffer.get(), rows.data(), rows.size());
+  memcpy(buffer.get() + rows.size(), partial_row.data(), partial_row.size());
+  unsigned int num_rows{0};
+  // The file is only read from if no end of row is found in the buffer.
+  auto file = std::tmpfile();
+  ScopeGuard close_file = [file] { fclose(file); };
+  const auto end_pos = import_export::delimited_parser::find_row_end_pos(
+      alloc_size, buffer, buffer_size, copy_params, 0, num_rows, file);
+  EXPECT_EQ(end_pos, rows.size());
+  EXPECT_EQ(num_rows, 10U);
+}
+
 class ImportExportTestBase : public DBHandlerTestFixture {
  protected:
   void SetUp() override { DBHandlerTestFixture::SetUp(); }
@@ -485,6 +537,135 @@ TEST_F(ImportTestInt, ImportGoodInt) {
   // clang-format on
 }
 
+// Imports files spanning many small blocks, which the reader hands to the parser threads.
+class DelimitedImportPipelineTest : public ImportExportTestBase {
+ protected:
+  void SetUp() override {
+    ImportExportTestBase::SetUp();
+    sql("DROP TABLE IF EXISTS import_pipeline;");
+    sql("CREATE TABLE import_pipeline (i INT, s TEXT ENCODING DICT(32));");
+  }
+
+  void TearDown() override {
+    sql("DROP TABLE IF EXISTS import_pipeline;");
+    boost::filesystem::remove(file_path_);
+    ImportExportTestBase::TearDown();
+  }
+
+  void writeRows(const std::vector<std::string>& rows) {
+    std::ofstream out(file_path_.string());
+    for (const auto& row : rows) {
+      out << row << "\n";
+    }
+  }
+
+  // Returns the message of the COPY.
+  std::string copy(const std::string& options) {
+    TQueryResult result;
+    sql(result,
+        "COPY import_pipeline FROM '" + file_path_.string() +
+            "' WITH (header='false', threads=4, " + options + ");");
+    return result.row_set.columns[0].data.str_col[0];
+  }
+
+  const boost::filesystem::path file_path_{
+      "../../Tests/Import/datafiles/import_pipeline_test.csv"};
+};
+
+TEST_F(DelimitedImportPipelineTest, QuotedRecordsAcrossBlocks) {
+  // Quoted fields with delimiters, escaped quotes and line breaks, of varying length so
+  // that the blocks end at different places in them.
+  const auto quoted_string = [](const int i) {
+    return "row " + std::to_string(i) + ", with \"quotes\" and a\nline break" +
+           std::string(i % 50, 'x');
+  };
+  std::vector<std::string> rows;
+  for (int i = 0; i < 500; ++i) {
+    rows.push_back(std::to_string(i) + ",\"" +
+                   boost::replace_all_copy(quoted_string(i), "\"", "\"\"") + "\"");
+  }
+  writeRows(rows);
+  for (const auto buffer_size : {64, 100, 333}) {
+    sql("TRUNCATE TABLE import_pipeline;");
+    copy("quoted='true', buffer_size=" + std::to_string(buffer_size));
+    sqlAndCompareResult(
+        "SELECT COUNT(*), SUM(i), COUNT(DISTINCT s) FROM import_pipeline;",
+        {{i(500), i(124750), i(500)}});
+    for (const int row : {0, 1, 123, 499}) {
+      sqlAndCompareResult(
+          "SELECT s FROM import_pipeline WHERE i = " + std::to_string(row) + ";",
+          {{quoted_string(row)}});
+    }
+  }
+}
+
+TEST_F(DelimitedImportPipelineTest, MaxRejectHaltsLoad) {
+  // Rows with too many columns are rejected by the parser threads, the reader halts the
+  // load once it has collected more of them than max_reject.
+  std::vector<std::string> rows;
+  for (int i = 0; i < 20; ++i) {
+    rows.push_back(std::to_string(i) + ",a,extra");
+  }
+  for (int i = 0; i < 5000; ++i) {
+    rows.push_back(std::to_string(i) + ",a");
+  }
+  writeRows(rows);
+  const auto message = copy("max_reject=10, buffer_size=128");
+  EXPECT_NE(message.find("Maximum rows rejected exceeded. Halting load"),
+            std::string::npos)
+      << message;
+  // The rows loaded before the halt are rolled back.
+  sqlAndCompareResult("SELECT COUNT(*) FROM import_pipeline;", {{i(0)}});
+}
+
+namespace {
+
+// Throws from the load of the third block, an error which isn't about a row.
+class ThrowingLoader : public import_export::Loader {
+ public:
+  using import_export::Loader::Loader;
+
+  bool loadNoCheckpoint(
+      const std::vector<std::unique_ptr<import_export::TypedImportBuffer>>&
+          import_buffers,
+      const size_t row_count,
+      const Catalog_Namespace::SessionInfo* session_info) override {
+    if (++num_loads_ == 3) {
+      throw std::runtime_error("Could not load the block");
+    }
+    return import_export::Loader::loadNoCheckpoint(
+        import_buffers, row_count, session_info);
+  }
+
+ private:
+  std::atomic<size_t> num_loads_{0};
+};
+
+}  // namespace
+
+TEST_F(DelimitedImportPipelineTest, ParserThreadException) {
+  std::vector<std::string> rows;
+  for (int i = 0; i < 2000; ++i) {
+    rows.push_back(std::to_string(i) + ",a");
+  }
+  writeRows(rows);
+  import_export::CopyParams copy_params;
+  copy_params.threads = 4;
+  copy_params.buffer_size = 128;
+  auto& cat = getCatalog();
+  import_export::Importer importer(
+      new ThrowingLoader(cat, cat.getMetadataForTable("import_pipeline", false)),
+      file_path_.string(),
+      copy_params);
+  // The error reaches the reading thread, after the parser threads have stopped.
+  try {
+    importer.importDelimited(file_path_.string(), false, nullptr);
+    FAIL() << "Expected the error of the parser thread.";
+  } catch (const std::runtime_error& e) {
+    EXPECT_EQ(std::string(e.what()), "Could not load the block");
+  }
+}
+
 class ImportTestLegacyDate : public ImportTestDate {
  protected:
   void SetUp() override {
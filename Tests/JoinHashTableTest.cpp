@@ -34,6 +34,7 @@
 #include "QueryEngine/JoinHashTable/OverlapsJoinHashTable.h"
 #include "QueryEngine/ResultSet.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 #include "Shared/thread_count.h"
 #include "TestHelpers.h"
 
@@ -41,6 +42,10 @@
 #define BASE_PATH "./tmp"
 #endif
 
+extern bool g_enable_partitioned_hash_join_build;
+extern size_t g_partitioned_hash_join_build_min_bytes;
+extern bool g_enable_sorted_key_join;
+
 using namespace Catalog_Namespace;
 using namespace TestHelpers;
 
@@ -577,6 +582,136 @@ TEST(Build, KeyedOneToMany) {
   }
 }
 
+TEST(Build, KeyedPartitioned) {
+  auto catalog = QR::get()->getCatalog();
+  CHECK(catalog);
+
+  auto executor = Executor::getExecutor(catalog->getCurrentDB().dbId);
+  CHECK(executor);
+  executor->setCatalog(catalog.get());
+
+  g_device_type = ExecutorDeviceType::CPU;
+  const auto enable_partitioned_build = g_enable_partitioned_hash_join_build;
+  const auto partitioned_build_min_bytes = g_partitioned_hash_join_build_min_bytes;
+  ScopeGuard reset_partitioned_build = [enable_partitioned_build,
+                                        partitioned_build_min_bytes] {
+    g_enable_partitioned_hash_join_build = enable_partitioned_build;
+    g_partitioned_hash_join_build_min_bytes = partitioned_build_min_bytes;
+  };
+
+  // The table of 2^16 distinct keys spans several partitions.
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+
+    create table table1 (a1 integer, a2 integer);
+    create table table2 (b integer);
+
+    insert into table1 values (1, 1);
+    insert into table2 values (0);
+  )");
+  for (int i = 0; i < 16; ++i) {
+    sql("insert into table2 select b + " + std::to_string(1 << i) + " from table2;");
+  }
+
+  for (const auto layout : {HashType::OneToOne, HashType::OneToMany}) {
+    if (layout == HashType::OneToMany) {
+      // A duplicate key makes the one-to-one build fail and fall back to one-to-many.
+      sql("insert into table2 values (3);");
+    }
+
+    auto a1 = getSyntheticColumnVar("table1", "a1", 0, executor.get());
+    auto a2 = getSyntheticColumnVar("table1", "a2", 0, executor.get());
+    auto b = getSyntheticColumnVar("table2", "b", 1, executor.get());
+
+    using VE = std::vector<std::shared_ptr<Analyzer::Expr>>;
+    auto et1 = std::make_shared<Analyzer::ExpressionTuple>(VE{a1, a2});
+    auto et2 = std::make_shared<Analyzer::ExpressionTuple>(VE{b, b});
+
+    // a1 = b and a2 = b
+    auto op = std::make_shared<Analyzer::BinOper>(kBOOLEAN, kEQ, kONE, et1, et2);
+
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    g_enable_partitioned_hash_join_build = false;
+    auto hash_table = buildKeyed(op);
+    EXPECT_EQ(hash_table->getHashType(), layout);
+    const auto s1 = hash_table->toSet(g_device_type, 0);
+
+    JoinHashTableCacheInvalidator::invalidateCaches();
+    g_enable_partitioned_hash_join_build = true;
+    g_partitioned_hash_join_build_min_bytes = 0;
+    auto partitioned_hash_table = buildKeyed(op);
+    EXPECT_EQ(partitioned_hash_table->getHashType(), layout);
+    EXPECT_EQ(s1, partitioned_hash_table->toSet(g_device_type, 0));
+  }
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+  )");
+}
+
+TEST(Build, SortedKey) {
+  g_device_type = ExecutorDeviceType::CPU;
+  const auto enable_sorted_key_join = g_enable_sorted_key_join;
+  ScopeGuard reset_sorted_key_join = [enable_sorted_key_join] {
+    g_enable_sorted_key_join = enable_sorted_key_join;
+  };
+
+  // Fragments of two rows with overlapping key ranges, duplicate keys and a null. The
+  // key range is too large for a perfect hash table.
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+
+    create table table1 (nums1 bigint);
+    create table table2 (nums2 bigint) with (fragment_size=2, sort_column='nums2');
+
+    insert into table1 values (1);
+    insert into table2 values (1);
+    insert into table2 values (2);
+    insert into table2 values (40000000000);
+    insert into table2 values (6);
+    insert into table2 values (5);
+    insert into table2 values (null);
+    insert into table2 values (9);
+    insert into table2 values (2);
+  )");
+
+  JoinHashTableCacheInvalidator::invalidateCaches();
+  g_enable_sorted_key_join = false;
+  EXPECT_EQ(buildPerfect("table1", "nums1", "table2", "nums2")->getHashJoinType(),
+            "Baseline");
+
+  g_enable_sorted_key_join = true;
+  auto sorted_key_table = buildPerfect("table1", "nums1", "table2", "nums2");
+  EXPECT_EQ(sorted_key_table->getHashJoinType(), "SortedKey");
+  EXPECT_EQ(sorted_key_table->getHashType(), HashType::OneToMany);
+  const DecodedJoinHashBufferSet s1{{{1}, {0}},
+                                    {{2}, {1, 7}},
+                                    {{5}, {4}},
+                                    {{6}, {3}},
+                                    {{9}, {6}},
+                                    {{40000000000}, {2}}};
+  EXPECT_EQ(s1, sorted_key_table->toSet(g_device_type, 0));
+
+  // A key range small enough for a perfect hash table still gets one.
+  sql(R"(
+    drop table if exists table2;
+    create table table2 (nums2 bigint) with (fragment_size=2, sort_column='nums2');
+    insert into table2 values (1);
+    insert into table2 values (2);
+  )");
+  JoinHashTableCacheInvalidator::invalidateCaches();
+  EXPECT_EQ(buildPerfect("table1", "nums1", "table2", "nums2")->getHashJoinType(),
+            "Perfect");
+
+  sql(R"(
+    drop table if exists table1;
+    drop table if exists table2;
+  )");
+}
+
 TEST(Build, GeoOneToMany1) {
   auto catalog = QR::get()->getCatalog();
   CHECK(catalog);
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Logger/Logger.h"
+#include "QueryEngine/QueryDispatchQueue.h"
+#include "TestHelpers.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Priority = QueryDispatchQueue::Priority;
+
+// Records the order in which the tasks of a test run.
+class DispatchLog {
+ public:
+  std::shared_ptr<QueryDispatchQueue::Task> makeTask(const std::string& name) {
+    return std::make_shared<QueryDispatchQueue::Task>([this, name](size_t) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      names_.push_back(name);
+    });
+  }
+
+  std::vector<std::string> names() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> names_;
+};
+
+// A task which runs until it is released, to keep a worker busy while tasks queue up.
+class BlockingTask {
+ public:
+  BlockingTask()
+      : task_(std::make_shared<QueryDispatchQueue::Task>([this](size_t) {
+        started_.set_value();
+        release_future_.wait();
+      }))
+      , started_future_(started_.get_future())
+      , release_future_(release_.get_future()) {}
+
+  std::shared_ptr<QueryDispatchQueue::Task> task() const { return task_; }
+
+  void waitUntilStarted() { started_future_.wait(); }
+
+  void release() {
+    release_.set_value();
+    task_->get_future().wait();
+  }
+
+ private:
+  std::shared_ptr<QueryDispatchQueue::Task> task_;
+  std::promise<void> started_;
+  std::future<void> started_future_;
+  std::promise<void> release_;
+  std::shared_future<void> release_future_;
+};
+
+void submit_and_wait_all(
+    QueryDispatchQueue& queue,
+    BlockingTask& blocker,
+    const std::vector<std::pair<std::shared_ptr<QueryDispatchQueue::Task>,
+                                QueryDispatchQueue::TaskInfo>>& tasks) {
+  std::vector<std::future<void>> futures;
+  for (const auto& [task, task_info] : tasks) {
+    futures.push_back(task->get_future());
+    queue.submit(task, false, task_info);
+  }
+  blocker.release();
+  for (auto& future : futures) {
+    future.get();
+  }
+}
+
+}  // namespace
+
+TEST(QueryDispatchQueue, InteractiveFirstAndSessionsTakeTurns) {
+  QueryDispatchQueue queue(1);
+  BlockingTask blocker;
+  queue.submit(blocker.task(), false);
+  blocker.waitUntilStarted();
+
+  DispatchLog log;
+  submit_and_wait_all(queue,
+                      blocker,
+                      {{log.makeTask("heavy"), {"c", Priority::kHeavy}},
+                       {log.makeTask("a1"), {"a", Priority::kInteractive}},
+                       {log.makeTask("a2"), {"a", Priority::kInteractive}},
+                       {log.makeTask("a3"), {"a", Priority::kInteractive}},
+                       {log.makeTask("b1"), {"b", Priority::kInteractive}}});
+  EXPECT_EQ(log.names(), (std::vector<std::string>{"a1", "b1", "a2", "a3", "heavy"}));
+}
+
+TEST(QueryDispatchQueue, HeavyTaskAges) {
+  QueryDispatchQueue queue(1, /*max_heavy_task_bypasses=*/2);
+  BlockingTask blocker;
+  queue.submit(blocker.task(), false);
+  blocker.waitUntilStarted();
+
+  DispatchLog log;
+  submit_and_wait_all(queue,
+                      blocker,
+                      {{log.makeTask("heavy1"), {"b", Priority::kHeavy}},
+                       {log.makeTask("heavy2"), {"b", Priority::kHeavy}},
+                       {log.makeTask("i1"), {"a", Priority::kInteractive}},
+                       {log.makeTask("i2"), {"a", Priority::kInteractive}},
+                       {log.makeTask("i3"), {"a", Priority::kInteractive}},
+                       {log.makeTask("i4"), {"a", Priority::kInteractive}},
+                       {log.makeTask("i5"), {"a", Priority::kInteractive}}});
+  EXPECT_EQ(log.names(),
+            (std::vector<std::string>{
+                "i1", "i2", "heavy1", "i3", "i4", "heavy2", "i5"}));
+}
+
+TEST(QueryDispatchQueue, HeavyCap) {
+  // with two workers, at most one runs a heavy task
+  QueryDispatchQueue queue(2);
+  EXPECT_TRUE(queue.hasIdleWorker(Priority::kHeavy));
+
+  BlockingTask heavy1;
+  queue.submit(heavy1.task(), false, {"a", Priority::kHeavy});
+  heavy1.waitUntilStarted();
+  EXPECT_TRUE(queue.hasIdleWorker(Priority::kInteractive));
+  EXPECT_FALSE(queue.hasIdleWorker(Priority::kHeavy));
+
+  std::atomic<bool> heavy2_started{false};
+  auto heavy2 = std::make_shared<QueryDispatchQueue::Task>(
+      [&heavy2_started](size_t) { heavy2_started = true; });
+  auto heavy2_future = heavy2->get_future();
+  queue.submit(heavy2, false, {"b", Priority::kHeavy});
+
+  // the idle worker takes the interactive task, submitted after the held back heavy one
+  auto interactive = std::make_shared<QueryDispatchQueue::Task>([](size_t) {});
+  auto interactive_future = interactive->get_future();
+  queue.submit(interactive, false, {"c", Priority::kInteractive});
+  EXPECT_EQ(interactive_future.wait_for(std::chrono::seconds(30)),
+            std::future_status::ready);
+  EXPECT_FALSE(heavy2_started);
+
+  heavy1.release();
+  EXPECT_EQ(heavy2_future.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+  EXPECT_TRUE(heavy2_started);
+}
+
+int main(int argc, char* argv[]) {
+  TestHelpers::init_logger_stderr_only(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+
+  int err{0};
+  try {
+    err = RUN_ALL_TESTS();
+  } catch (const std::exception& e) {
+    LOG(ERROR) << e.what();
+  }
+  return err;
+}
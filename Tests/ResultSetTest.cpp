@@ -29,6 +29,7 @@
 #include "QueryEngine/ResultSetReductionJIT.h"
 #include "QueryEngine/RuntimeFunctions.h"
 #include "QueryRunner/QueryRunner.h"
+#include "Shared/scope.h"
 #include "StringDictionary/StringDictionary.h"
 #include "Tests/TestHelpers.h"
 
@@ -44,6 +45,10 @@
 using QR = QueryRunner::QueryRunner;
 
 extern bool g_is_test_env;
+extern bool g_enable_normalized_key_sort;
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_threshold;
+extern size_t g_external_sort_run_size;
 
 bool skip_tests(const ExecutorDeviceType device_type) {
 #ifdef HAVE_CUDA
@@ -1129,6 +1134,155 @@ void test_reduce(const std::vector<TargetInfo>& target_infos,
   }
 }
 
+// Reduces `result_set_count` result sets which hold the value i at every other entry i.
+void test_reduce_many(const std::vector<TargetInfo>& target_infos,
+                      const QueryMemoryDescriptor& query_mem_desc,
+                      const size_t result_set_count) {
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  std::vector<std::unique_ptr<ResultSet>> result_sets;
+  std::vector<ResultSet*> storage_set;
+  for (size_t i = 0; i < result_set_count; ++i) {
+    result_sets.emplace_back(std::make_unique<ResultSet>(target_infos,
+                                                         ExecutorDeviceType::CPU,
+                                                         query_mem_desc,
+                                                         row_set_mem_owner,
+                                                         nullptr,
+                                                         0,
+                                                         0));
+    const auto storage = result_sets.back()->allocateStorage();
+    EvenNumberGenerator generator;
+    fill_storage_buffer(
+        storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+    storage_set.push_back(result_sets.back().get());
+  }
+  ResultSetManager rs_manager;
+  auto result_rs = rs_manager.reduce(storage_set);
+
+  SQLTypeInfo double_ti(kDOUBLE, false);
+  const auto row_count = result_rs->rowCount();
+  for (size_t row_idx = 0; row_idx < row_count; ++row_idx) {
+    const auto row = result_rs->getRowAtNoTranslations(row_idx);
+    if (row.empty()) {
+      continue;
+    }
+    ASSERT_EQ(target_infos.size(), row.size());
+    for (size_t i = 0; i < target_infos.size(); ++i) {
+      const auto& target_info = target_infos[i];
+      const auto& ti = target_info.agg_kind == kAVG ? double_ti : target_info.sql_type;
+      const int64_t ref = (target_info.agg_kind == kSUM || target_info.agg_kind == kCOUNT)
+                              ? result_set_count * row_idx
+                              : row_idx;
+      switch (ti.get_type()) {
+        case kTINYINT:
+        case kSMALLINT:
+        case kINT:
+        case kBIGINT:
+          ASSERT_EQ(ref, v<int64_t>(row[i]));
+          break;
+        case kDOUBLE:
+          ASSERT_DOUBLE_EQ(static_cast<double>(ref), v<double>(row[i]));
+          break;
+        case kTEXT:
+          break;
+        default:
+          CHECK(false);
+      }
+    }
+  }
+}
+
+std::vector<std::vector<int64_t>> get_sorted_rows(
+    const ResultSet& rs,
+    const std::vector<TargetInfo>& target_infos) {
+  SQLTypeInfo double_ti(kDOUBLE, false);
+  std::vector<std::vector<int64_t>> rows;
+  for (size_t entry_idx = 0; entry_idx < rs.entryCount(); ++entry_idx) {
+    const auto row = rs.getRowAtNoTranslations(entry_idx);
+    if (row.empty()) {
+      continue;
+    }
+    CHECK_EQ(target_infos.size(), row.size());
+    std::vector<int64_t> values;
+    for (size_t i = 0; i < target_infos.size(); ++i) {
+      const auto& target_info = target_infos[i];
+      const auto& ti = target_info.agg_kind == kAVG ? double_ti : target_info.sql_type;
+      switch (ti.get_type()) {
+        case kTINYINT:
+        case kSMALLINT:
+        case kINT:
+        case kBIGINT:
+          values.push_back(v<int64_t>(row[i]));
+          break;
+        case kDOUBLE:
+          values.push_back(static_cast<int64_t>(v<double>(row[i])));
+          break;
+        case kTEXT:
+          break;
+        default:
+          CHECK(false);
+      }
+    }
+    rows.push_back(values);
+  }
+  std::sort(rows.begin(), rows.end());
+  return rows;
+}
+
+// Reduces the same baseline hash results one after the other and by partitions, the
+// groups must come out the same.
+void test_reduce_partitioned(const std::vector<TargetInfo>& target_infos,
+                             const QueryMemoryDescriptor& query_mem_desc,
+                             const size_t result_set_count) {
+  const auto row_set_mem_owner =
+      std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize());
+  row_set_mem_owner->addStringDict(g_sd, 1, g_sd->storageEntryCount());
+  std::vector<std::unique_ptr<ResultSet>> result_sets;
+  std::vector<ResultSet*> serial_set;
+  std::vector<ResultSet*> partitioned_set;
+  for (size_t i = 0; i < 2 * result_set_count; ++i) {
+    result_sets.emplace_back(std::make_unique<ResultSet>(target_infos,
+                                                         ExecutorDeviceType::CPU,
+                                                         query_mem_desc,
+                                                         row_set_mem_owner,
+                                                         nullptr,
+                                                         0,
+                                                         0));
+    const auto storage = result_sets.back()->allocateStorage();
+    // Half of the results share the same groups, the other half counts down from an odd
+    // or an even group.
+    const auto input_idx = i % result_set_count;
+    if (input_idx % 2) {
+      ReverseOddOrEvenNumberGenerator generator(2 * query_mem_desc.getEntryCount() -
+                                                1 - (input_idx % 4) / 2);
+      fill_storage_buffer(
+          storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+    } else {
+      EvenNumberGenerator generator;
+      fill_storage_buffer(
+          storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 2);
+    }
+    (i < result_set_count ? serial_set : partitioned_set)
+        .push_back(result_sets.back().get());
+  }
+  ResultSetManager serial_rs_manager;
+  const auto serial_rs = serial_rs_manager.reduce(serial_set);
+
+  const auto first_rs = partitioned_set.front();
+  ResultSetReductionJIT reduction_jit(first_rs->getQueryMemDesc(),
+                                      first_rs->getTargetInfos(),
+                                      first_rs->getTargetInitVals());
+  const auto reduction_code = reduction_jit.codegen();
+  ResultSetManager partitioned_rs_manager;
+  const auto partitioned_rs =
+      partitioned_rs_manager.reducePartitioned(partitioned_set, reduction_code, 0, 0);
+
+  const auto serial_rows = get_sorted_rows(*serial_rs, target_infos);
+  ASSERT_FALSE(serial_rows.empty());
+  ASSERT_EQ(serial_rows, get_sorted_rows(*partitioned_rs, target_infos));
+}
+
 void test_reduce_random_groups(const std::vector<TargetInfo>& target_infos,
                                const QueryMemoryDescriptor& query_mem_desc,
                                NumberGenerator& generator1,
@@ -1847,6 +2001,26 @@ TEST(Reduce, BaselineHashColumnar) {
   test_reduce(target_infos, query_mem_desc, generator1, generator2, 1, true);
 }
 
+TEST(Reduce, PerfectHashOneColManyResultSets) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 49999);
+  test_reduce_many(target_infos, query_mem_desc, 8);
+}
+
+TEST(Reduce, PerfectHashOneColColumnarManyResultSets) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 49999);
+  query_mem_desc.setOutputColumnar(true);
+  test_reduce_many(target_infos, query_mem_desc, 8);
+}
+
+TEST(Reduce, BaselineHashPartitioned) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  query_mem_desc.setEntryCount(20000);
+  test_reduce_partitioned(target_infos, query_mem_desc, 8);
+}
+
 #ifndef HAVE_TSAN
 // The large buffers tests allocate too much memory to instrument under TSAN
 TEST(ReduceLargeBuffers, PerfectHashOne_Overflow32) {
@@ -3145,6 +3319,231 @@ TEST(ResultsetConversion, EnforceParallelColumnarConversion) {
   }
 }
 
+namespace {
+
+// Produces values in [-8, 8] in a scrambled order, so that sort keys contain
+// duplicates and negative numbers.
+class ScrambledNumberGenerator : public NumberGenerator {
+ public:
+  ScrambledNumberGenerator() : crt_(0) {}
+
+  int64_t getNextValue() override { return (crt_++ * 37) % 17 - 8; }
+
+  void reset() override { crt_ = 0; }
+
+ private:
+  int64_t crt_;
+};
+
+std::vector<OneRow> get_rows_sorted(const std::vector<TargetInfo>& target_infos,
+                                    const QueryMemoryDescriptor& query_mem_desc,
+                                    const std::list<Analyzer::OrderEntry>& order_entries,
+                                    const size_t top_n,
+                                    const bool normalized_key_sort,
+                                    const bool external_sort = false,
+                                    const bool random_access = false) {
+  ScopeGuard reset_flags = [orig_normalized_key_sort = g_enable_normalized_key_sort,
+                            orig_threshold = g_external_sort_threshold,
+                            orig_run_size = g_external_sort_run_size] {
+    g_enable_normalized_key_sort = orig_normalized_key_sort;
+    g_external_sort_threshold = orig_threshold;
+    g_external_sort_run_size = orig_run_size;
+  };
+  g_enable_normalized_key_sort = normalized_key_sort;
+  if (external_sort) {
+    // Force several small runs to exercise the merge.
+    g_external_sort_threshold = 0;
+    g_external_sort_run_size = 16;
+  }
+  ResultSet rs(target_infos,
+               ExecutorDeviceType::CPU,
+               query_mem_desc,
+               std::make_shared<RowSetMemoryOwner>(Executor::getArenaBlockSize()),
+               nullptr,
+               0,
+               0);
+  const auto storage = rs.allocateStorage();
+  ScrambledNumberGenerator generator;
+  fill_storage_buffer(
+      storage->getUnderlyingBuffer(), target_infos, query_mem_desc, generator, 1);
+  rs.sort(order_entries, top_n, nullptr);
+  std::vector<OneRow> result;
+  if (random_access) {
+    // Read the rows the way ColumnarResults and CTAS do.
+    for (size_t i = 0; i < rs.entryCount(); ++i) {
+      if (!rs.isRowAtEmpty(i)) {
+        result.push_back(rs.getRowAtNoTranslations(i));
+      }
+    }
+    return result;
+  }
+  while (true) {
+    const auto row = rs.getNextRow(false, false);
+    if (row.empty()) {
+      break;
+    }
+    result.push_back(row);
+  }
+  return result;
+}
+
+void test_normalized_key_sort(const std::vector<TargetInfo>& target_infos,
+                              const QueryMemoryDescriptor& query_mem_desc,
+                              const bool external_sort = false) {
+  // Only full sorts, or limits covering every entry, use normalized keys.
+  for (const bool is_desc : {false, true}) {
+    for (const size_t top_n : {size_t(0), query_mem_desc.getEntryCount()}) {
+      std::list<Analyzer::OrderEntry> order_entries;
+      order_entries.emplace_back(4, is_desc, is_desc);
+      order_entries.emplace_back(1, !is_desc, is_desc);
+      order_entries.emplace_back(2, false, false);
+      const auto expected =
+          get_rows_sorted(target_infos, query_mem_desc, order_entries, top_n, false);
+      for (const bool random_access : {false, true}) {
+        const auto actual = get_rows_sorted(target_infos,
+                                            query_mem_desc,
+                                            order_entries,
+                                            top_n,
+                                            true,
+                                            external_sort,
+                                            random_access);
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+          ASSERT_EQ(expected[i].size(), actual[i].size());
+          for (size_t j = 0; j < expected[i].size(); ++j) {
+            const auto expected_val = boost::get<ScalarTargetValue>(&expected[i][j]);
+            const auto actual_val = boost::get<ScalarTargetValue>(&actual[i][j]);
+            ASSERT_TRUE(expected_val && actual_val);
+            ASSERT_TRUE(*expected_val == *actual_val)
+                << "row " << i << ", column " << j << ", random access " << random_access;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST(Sort, NormalizedKeyPerfectHash) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  test_normalized_key_sort(target_infos, query_mem_desc);
+}
+
+TEST(Sort, NormalizedKeyPerfectHashColumnar) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  query_mem_desc.setOutputColumnar(true);
+  test_normalized_key_sort(target_infos, query_mem_desc);
+}
+
+TEST(Sort, NormalizedKeyBaselineHash) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  test_normalized_key_sort(target_infos, query_mem_desc);
+}
+
+TEST(Sort, ExternalPerfectHash) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  test_normalized_key_sort(target_infos, query_mem_desc, true);
+}
+
+// Columnar results can't be sorted externally and are sorted in memory instead.
+TEST(Sort, ExternalPerfectHashColumnar) {
+  const auto target_infos = generate_test_target_infos();
+  auto query_mem_desc = perfect_hash_one_col_desc(target_infos, 8, 0, 99);
+  query_mem_desc.setOutputColumnar(true);
+  test_normalized_key_sort(target_infos, query_mem_desc, true);
+}
+
+TEST(Sort, ExternalDisabled) {
+  ScopeGuard reset_flag = [orig = g_enable_external_sort] {
+    g_enable_external_sort = orig;
+  };
+  g_enable_external_sort = false;
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  test_normalized_key_sort(target_infos, query_mem_desc, true);
+}
+
+TEST(Sort, ExternalBaselineHash) {
+  const auto target_infos = generate_test_target_infos();
+  const auto query_mem_desc = baseline_hash_two_col_desc(target_infos, 8);
+  test_normalized_key_sort(target_infos, query_mem_desc, true);
+}
+
+// Sorts queries with nulls, floating point and dictionary encoded keys fully, which is
+// where normalized keys are used, and checks them against the comparator based sort.
+TEST(Sort, NormalizedKeyQueries) {
+  ScopeGuard reset_flag = [orig = g_enable_normalized_key_sort] {
+    g_enable_normalized_key_sort = orig;
+  };
+  QR::get()->runDDLStatement("DROP TABLE IF EXISTS normalized_key_sort_test;");
+  QR::get()->runDDLStatement(
+      "CREATE TABLE normalized_key_sort_test (id INT, i INT, f FLOAT, d DOUBLE, s TEXT "
+      "ENCODING DICT(32));");
+  // Inserted out of order, so that string ids don't follow the string order.
+  const std::vector<std::string> fruits{
+      "kiwi", "apple", "mango", "banana", "cherry", "fig", "date", "lime", "grape"};
+  for (int id = 0; id < 40; ++id) {
+    const auto i = id % 7 == 0 ? "NULL" : std::to_string((id * 37) % 17 - 8);
+    const auto f = id % 5 == 0 ? "NULL" : std::to_string(((id * 13) % 11 - 5) * 0.5);
+    const auto d = id % 6 == 0 ? "NULL" : std::to_string(((id * 29) % 23 - 11) / 4.0);
+    const auto s = id % 4 == 0 ? "NULL" : "'" + fruits[(id * 7) % 9] + "'";
+    QR::get()->runSQL("INSERT INTO normalized_key_sort_test VALUES (" +
+                          std::to_string(id) + ", " + i + ", " + f + ", " + d + ", " +
+                          s + ");",
+                      ExecutorDeviceType::CPU,
+                      false);
+  }
+  // The last keys make the order total.
+  const std::vector<std::string> queries{
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY i NULLS FIRST, id;",
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY i DESC NULLS FIRST, "
+      "id;",
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY f DESC NULLS LAST, "
+      "id;",
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY d NULLS FIRST, id "
+      "DESC;",
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY s DESC NULLS FIRST, "
+      "d, id;",
+      "SELECT id, i, f, d, s FROM normalized_key_sort_test ORDER BY s NULLS LAST, f DESC "
+      "NULLS FIRST, id;",
+      "SELECT s, AVG(d) a, COUNT(*) n FROM normalized_key_sort_test GROUP BY s ORDER BY "
+      "a DESC NULLS FIRST, s NULLS FIRST;"};
+  const auto get_rows = [](const std::string& query, const bool normalized_key_sort) {
+    g_enable_normalized_key_sort = normalized_key_sort;
+    const auto rows = QR::get()->runSQL(query, ExecutorDeviceType::CPU, false);
+    std::vector<std::vector<TargetValue>> result;
+    while (true) {
+      const auto row = rows->getNextRow(true, true);
+      if (row.empty()) {
+        break;
+      }
+      result.push_back(row);
+    }
+    return result;
+  };
+  for (const auto& query : queries) {
+    const auto expected = get_rows(query, false);
+    const auto actual = get_rows(query, true);
+    ASSERT_EQ(expected.size(), actual.size()) << query;
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected[i].size(), actual[i].size());
+      for (size_t j = 0; j < expected[i].size(); ++j) {
+        const auto expected_val = boost::get<ScalarTargetValue>(&expected[i][j]);
+        const auto actual_val = boost::get<ScalarTargetValue>(&actual[i][j]);
+        ASSERT_TRUE(expected_val && actual_val);
+        ASSERT_TRUE(*expected_val == *actual_val)
+            << query << ": row " << i << ", column " << j;
+      }
+    }
+  }
+  QR::get()->runDDLStatement("DROP TABLE IF EXISTS normalized_key_sort_test;");
+}
+
 TEST(Util, ReinterpretBits) {
   uint64_t const u64 = 0x0123456789abcdef;
   uint32_t const u32 = 0x89abcdef;
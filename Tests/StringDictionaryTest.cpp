@@ -16,10 +16,16 @@
 
 #include "TestHelpers.h"
 
+#include "../Shared/scope.h"
 #include "../StringDictionary/StringDictionary.h"
+#include "../StringDictionary/TrigramIndex.h"
 
+#include <boost/filesystem.hpp>
+
+#include <atomic>
 #include <cstdlib>
 #include <limits>
+#include <thread>
 
 #ifndef BASE_PATH
 #define BASE_PATH "./tmp"
@@ -101,6 +107,119 @@ TEST(StringDictionary, RecoverMany) {
   }
 }
 
+TEST(StringDictionary, ConcurrentBulkAddsAndGets) {
+  const auto enable_stringdict_parallel = g_enable_stringdict_parallel;
+  ScopeGuard reset_flag = [enable_stringdict_parallel] {
+    g_enable_stringdict_parallel = enable_stringdict_parallel;
+  };
+  g_enable_stringdict_parallel = true;
+  StringDictionary string_dict("", true, false, g_cache_string_hash);
+  const int writer_count{4};
+  const int batch_size{10000};
+  // The batches of consecutive writers overlap by half, so every string but the first
+  // and last half batches is added by two writers racing each other.
+  std::vector<std::vector<int32_t>> writer_ids(writer_count);
+  std::atomic<bool> writers_done{false};
+  std::thread reader([&string_dict, &writers_done] {
+    while (!writers_done) {
+      const auto str_count = string_dict.storageEntryCount();
+      for (size_t i = 0; i < str_count; i += 97) {
+        const auto str = string_dict.getString(i);
+        CHECK_EQ(static_cast<int32_t>(i), string_dict.getIdOfString(str));
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int writer_idx = 0; writer_idx < writer_count; ++writer_idx) {
+    writers.emplace_back([&string_dict, &writer_ids, writer_idx] {
+      std::vector<std::string> strings;
+      for (int i = 0; i < batch_size; ++i) {
+        strings.push_back(std::to_string(writer_idx * batch_size / 2 + i));
+      }
+      writer_ids[writer_idx].resize(strings.size());
+      string_dict.getOrAddBulk(strings, writer_ids[writer_idx].data());
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  writers_done = true;
+  reader.join();
+  ASSERT_EQ(static_cast<size_t>((writer_count + 1) * batch_size / 2),
+            string_dict.storageEntryCount());
+  for (int writer_idx = 0; writer_idx < writer_count; ++writer_idx) {
+    for (int i = 0; i < batch_size; ++i) {
+      const auto str = std::to_string(writer_idx * batch_size / 2 + i);
+      ASSERT_EQ(str, string_dict.getString(writer_ids[writer_idx][i]));
+      ASSERT_EQ(writer_ids[writer_idx][i], string_dict.getIdOfString(str));
+    }
+  }
+}
+
+TEST(StringDictionary, TrigramIndexLiterals) {
+  using Literals = std::vector<std::string>;
+  ASSERT_EQ(Literals{"foo"}, TrigramIndex::getLikeLiterals("foo", true, '\\'));
+  ASSERT_EQ((Literals{"foo", "bar"}),
+            TrigramIndex::getLikeLiterals("%foo_bar%", false, '\\'));
+  ASSERT_EQ(Literals{"50%off"}, TrigramIndex::getLikeLiterals("%50\\%off%", false, '\\'));
+  ASSERT_EQ((Literals{"ab", "c"}), TrigramIndex::getRegexpLiterals("ab+c"));
+  ASSERT_EQ((Literals{"a", "cde"}), TrigramIndex::getRegexpLiterals("ab?cde"));
+  ASSERT_EQ((Literals{"x", "y.z"}), TrigramIndex::getRegexpLiterals("^x[0-9]*y\\.z$"));
+  ASSERT_EQ(Literals{}, TrigramIndex::getRegexpLiterals("foo|bar"));
+}
+
+TEST(StringDictionary, TrigramIndexLikeAndRegexp) {
+  const auto enable_trigram_index = g_enable_stringdict_trigram_index;
+  const auto dict_path = boost::filesystem::path(BASE_PATH) / "trigram_dict";
+  ScopeGuard cleanup = [enable_trigram_index, dict_path] {
+    g_enable_stringdict_trigram_index = enable_trigram_index;
+    boost::filesystem::remove_all(dict_path);
+  };
+  g_enable_stringdict_trigram_index = true;
+  boost::filesystem::remove_all(dict_path);
+  boost::filesystem::create_directories(dict_path);
+  const int str_count{3000};
+  auto make_string = [](const int i) {
+    return "host" + std::to_string(i) + (i % 3 ? "/bar" : "/FOO");
+  };
+  auto check_searches = [&make_string](const StringDictionary& string_dict,
+                                       const int generation) {
+    std::vector<int32_t> expected_ids;
+    for (int i = 0; i < generation; i += 3) {
+      expected_ids.push_back(i);
+    }
+    auto sorted = [](std::vector<int32_t> ids) {
+      std::sort(ids.begin(), ids.end());
+      return ids;
+    };
+    ASSERT_EQ(expected_ids,
+              sorted(string_dict.getLike("foo", true, true, '\\', generation)));
+    ASSERT_EQ(expected_ids,
+              sorted(string_dict.getLike("%t%/fo_%", true, false, '\\', generation)));
+    ASSERT_TRUE(string_dict.getLike("foo", false, true, '\\', generation).empty());
+    ASSERT_EQ(expected_ids,
+              sorted(string_dict.getRegexpLike("host[0-9]+/FOO", '\\', generation)));
+    ASSERT_EQ(std::vector<int32_t>{1},
+              string_dict.getLike(make_string(1), false, true, '\\', generation));
+  };
+  {
+    StringDictionary string_dict(dict_path.string(), false, false, g_cache_string_hash);
+    for (int i = 0; i < str_count; ++i) {
+      ASSERT_EQ(i, string_dict.getOrAdd(make_string(i)));
+    }
+    check_searches(string_dict, str_count);
+    ASSERT_TRUE(string_dict.checkpoint());
+  }
+  ASSERT_TRUE(boost::filesystem::exists(dict_path / "DictTrigrams"));
+  StringDictionary string_dict(dict_path.string(), false, true, g_cache_string_hash);
+  check_searches(string_dict, str_count);
+  // Strings added after a search are indexed by the next one.
+  for (int i = str_count; i < 2 * str_count; ++i) {
+    ASSERT_EQ(i, string_dict.getOrAdd(make_string(i)));
+  }
+  check_searches(string_dict, 2 * str_count);
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
 
@@ -521,6 +521,50 @@ TEST_F(TableFunctions, ConstantCasts) {
   }
 }
 
+TEST_F(TableFunctions, SequenceEncodedInput) {
+  // One fragment is read directly from the chunk, several are columnarized first.
+  for (const auto fragment_size : {32000000, 4}) {
+    run_ddl_statement("DROP TABLE IF EXISTS tf_seq_test;");
+    run_ddl_statement(
+        "CREATE TABLE tf_seq_test (x INT ENCODING RL, y BIGINT ENCODING DIFF) WITH "
+        "(FRAGMENT_SIZE=" +
+        std::to_string(fragment_size) + ");");
+    TestHelpers::ValuesGenerator gen("tf_seq_test");
+    const std::vector<int64_t> xs{3, 3, 3, 1, 1, 5};
+    for (size_t i = 0; i < xs.size(); ++i) {
+      run_multiple_agg(gen(xs[i], 100 - 10 * static_cast<int64_t>(i)),
+                       ExecutorDeviceType::CPU);
+    }
+    for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
+      SKIP_NO_GPU();
+      {
+        const auto rows = run_multiple_agg(
+            "SELECT out0 FROM TABLE(sort_column_limit(CURSOR(SELECT x FROM "
+            "tf_seq_test), 6, true, true)) ORDER BY out0;",
+            dt);
+        ASSERT_EQ(rows->rowCount(), size_t(6));
+        const std::vector<int64_t> expected_result_set{1, 1, 3, 3, 3, 5};
+        for (size_t i = 0; i < expected_result_set.size(); i++) {
+          auto row = rows->getNextRow(true, false);
+          ASSERT_EQ(TestHelpers::v<int64_t>(row[0]), expected_result_set[i]);
+        }
+      }
+      {
+        const auto rows = run_multiple_agg(
+            "SELECT out0 FROM TABLE(sort_column_limit(CURSOR(SELECT y FROM "
+            "tf_seq_test), 6, true, true)) ORDER BY out0;",
+            dt);
+        ASSERT_EQ(rows->rowCount(), size_t(6));
+        for (int64_t i = 0; i < 6; i++) {
+          auto row = rows->getNextRow(true, false);
+          ASSERT_EQ(TestHelpers::v<int64_t>(row[0]), 50 + 10 * i);
+        }
+      }
+    }
+  }
+  run_ddl_statement("DROP TABLE IF EXISTS tf_seq_test;");
+}
+
 TEST_F(TableFunctions, Template) {
   for (auto dt : {ExecutorDeviceType::CPU, ExecutorDeviceType::GPU}) {
     SKIP_NO_GPU();
@@ -19,6 +19,7 @@
 #include <sys/types.h>
 
 #include <iostream>
+#include <limits>
 
 #include "CommandLineOptions.h"
 #include "LeafHostInfo.h"
@@ -36,7 +37,12 @@ bool g_enable_thrift_logs{false};
 
 extern bool g_use_table_device_offset;
 extern float g_fraction_code_cache_to_evict;
+extern bool g_enable_persistent_jit_cache;
+extern size_t g_persistent_jit_cache_max_bytes;
+extern bool g_enable_background_cpu_compilation;
+extern size_t g_background_compilation_max_rows;
 extern bool g_cache_string_hash;
+extern bool g_enable_stringdict_trigram_index;
 extern bool g_enable_idp_temporary_users;
 extern bool g_enable_left_join_filter_hoisting;
 extern int64_t g_large_ndv_threshold;
@@ -48,6 +54,12 @@ extern size_t g_approx_quantile_buffer;
 extern size_t g_approx_quantile_centroids;
 extern size_t g_parallel_top_min;
 extern size_t g_parallel_top_max;
+extern bool g_enable_normalized_key_sort;
+extern size_t g_normalized_key_sort_parallel_min;
+extern bool g_enable_external_sort;
+extern size_t g_external_sort_threshold;
+extern size_t g_external_sort_run_size;
+extern size_t g_external_sort_merge_buffer_bytes;
 extern size_t g_estimator_failure_max_groupby_size;
 extern bool g_enable_system_tables;
 
@@ -159,6 +171,25 @@ void CommandLineOptions::fillOptions() {
                               ->implicit_value(2147483648),
                           "The maximum size of hashtable that is available to cache, in "
                           "bytes (default: 2GB).");
+  help_desc.add_options()("use-query-resultset-cache",
+                          po::value<bool>(&use_query_resultset_cache)
+                              ->default_value(use_query_resultset_cache)
+                              ->implicit_value(true),
+                          "Recycle the result sets of repeated queries on unchanged "
+                          "tables.");
+  help_desc.add_options()(
+      "query-resultset-cache-total-bytes",
+      po::value<size_t>(&query_resultset_cache_total_bytes)
+          ->default_value(query_resultset_cache_total_bytes)
+          ->implicit_value(4294967296),
+      "Size of total memory space for query resultset cache, in bytes (default: 4GB).");
+  help_desc.add_options()(
+      "max-cacheable-query-resultset-size-bytes",
+      po::value<size_t>(&max_cacheable_query_resultset_size_bytes)
+          ->default_value(max_cacheable_query_resultset_size_bytes)
+          ->implicit_value(2147483648),
+      "The maximum size of query resultset that is available to cache, in bytes "
+      "(default: 2GB).");
   help_desc.add_options()("enable-debug-timer",
                           po::value<bool>(&g_enable_debug_timer)
                               ->default_value(g_enable_debug_timer)
@@ -186,6 +217,25 @@ void CommandLineOptions::fillOptions() {
                               ->implicit_value(true),
                           "Enable the overlaps hash join framework allowing for range "
                           "join (e.g. spatial overlaps) computation using a hash table.");
+  help_desc.add_options()(
+      "enable-partitioned-hash-join-build",
+      po::value<bool>(&g_enable_partitioned_hash_join_build)
+          ->default_value(g_enable_partitioned_hash_join_build)
+          ->implicit_value(true),
+      "Fill large baseline join hash tables on CPU one cache sized range of slots at a "
+      "time, after partitioning the rows of the build side by their key hash.");
+  help_desc.add_options()(
+      "partitioned-hash-join-build-min-bytes",
+      po::value<size_t>(&g_partitioned_hash_join_build_min_bytes)
+          ->default_value(g_partitioned_hash_join_build_min_bytes),
+      "Size in bytes of the join hash tables from which the partitioned build is used.");
+  help_desc.add_options()(
+      "enable-sorted-key-join",
+      po::value<bool>(&g_enable_sorted_key_join)
+          ->default_value(g_enable_sorted_key_join)
+          ->implicit_value(true),
+      "Join on a single integer key by binary search in the sorted inner column when "
+      "the key range is too large for a perfect hash table.");
   help_desc.add_options()("enable-distance-rangejoin",
                           po::value<bool>(&g_enable_distance_rangejoin)
                               ->default_value(g_enable_distance_rangejoin)
@@ -220,6 +270,12 @@ void CommandLineOptions::fillOptions() {
                               ->default_value(use_estimator_result_cache)
                               ->implicit_value(true),
                           "Use estimator result cache.");
+  help_desc.add_options()(
+      "max-cached-estimations",
+      po::value<size_t>(&g_max_cached_estimations)
+          ->default_value(g_max_cached_estimations),
+      "Maximum number of cached estimator results of each kind, the least recently "
+      "used ones are evicted first.");
   if (!dist_v5_) {
     help_desc.add_options()(
         "enable-string-dict-hash-cache",
@@ -227,6 +283,13 @@ void CommandLineOptions::fillOptions() {
             ->default_value(g_cache_string_hash)
             ->implicit_value(true),
         "Cache string hash values in the string dictionary server during import.");
+    help_desc.add_options()(
+        "enable-string-dict-trigram-index",
+        po::value<bool>(&g_enable_stringdict_trigram_index)
+            ->default_value(g_enable_stringdict_trigram_index)
+            ->implicit_value(true),
+        "Maintain a trigram index of the string dictionaries to speed up LIKE and REGEXP "
+        "searches.");
   }
   help_desc.add_options()(
       "enable-thrift-logs",
@@ -475,6 +538,56 @@ void CommandLineOptions::fillOptions() {
                               ->implicit_value(true),
                           "Enable use of system tables.");
   help_desc.add_options()("pmem-size", po::value<size_t>(&g_pmem_size)->default_value(0));
+  help_desc.add_options()(
+      "buffer-pool-eviction-policy",
+      po::value<std::string>(&g_buffer_pool_eviction_policy)
+          ->default_value(g_buffer_pool_eviction_policy),
+      "Eviction policy of the CPU and GPU buffer pools: lru (default), or lru2 which "
+      "keeps chunks that are used again and again over the chunks read once by scans.");
+  developer_desc.add_options()(
+      "buffer-pool-correlated-period",
+      po::value<size_t>(&g_buffer_pool_correlated_period)
+          ->default_value(g_buffer_pool_correlated_period),
+      "Number of buffer accesses within which a chunk referenced again counts as "
+      "referenced once by the lru2 eviction policy.");
+  developer_desc.add_options()(
+      "buffer-pool-retained-period",
+      po::value<size_t>(&g_buffer_pool_retained_period)
+          ->default_value(g_buffer_pool_retained_period),
+      "Number of buffer accesses after which the lru2 eviction policy forgets the "
+      "previous reference to a chunk.");
+  help_desc.add_options()(
+      "enable-chunk-prefetch",
+      po::value<bool>(&g_enable_chunk_prefetch)
+          ->default_value(g_enable_chunk_prefetch)
+          ->implicit_value(true),
+      "Load the chunks of the fragments of a query into the CPU buffer pool ahead of the "
+      "kernels which process them, so disk reads overlap query execution.");
+  help_desc.add_options()(
+      "chunk-prefetch-threads",
+      po::value<size_t>(&g_chunk_prefetch_threads)
+          ->default_value(g_chunk_prefetch_threads),
+      "Number of threads which load chunks ahead of the kernels, shared by all queries.");
+  help_desc.add_options()(
+      "chunk-prefetch-mem-fraction",
+      po::value<double>(&g_chunk_prefetch_mem_fraction)
+          ->default_value(g_chunk_prefetch_mem_fraction),
+      "Fraction of the CPU buffer pool which chunks loaded ahead of the kernels keep "
+      "pinned until the kernels are done with them.");
+  help_desc.add_options()(
+      "enable-parallel-reduction",
+      po::value<bool>(&g_enable_parallel_reduction)
+          ->default_value(g_enable_parallel_reduction)
+          ->implicit_value(true),
+      "Reduce the perfect hash group by results of many kernels in one parallel pass, "
+      "with each thread reducing a range of the groups across all the results.");
+  help_desc.add_options()(
+      "enable-partitioned-reduction",
+      po::value<bool>(&g_enable_partitioned_reduction)
+          ->default_value(g_enable_partitioned_reduction)
+          ->implicit_value(true),
+      "Reduce the baseline hash group by results of many kernels by radix partitioning "
+      "their groups, with each partition reduced into its own cache sized hash table.");
 
   help_desc.add(log_options_.get_options());
 }
@@ -531,6 +644,14 @@ void CommandLineOptions::fillAdvancedOptions() {
                                po::value<int>(&system_parameters.num_executors)
                                    ->default_value(system_parameters.num_executors),
                                "Number of executors to run in parallel.");
+  developer_desc.add_options()(
+      "heavy-query-min-rows",
+      po::value<size_t>(&system_parameters.heavy_query_min_rows)
+          ->default_value(system_parameters.heavy_query_min_rows),
+      "Minimum number of rows in the tables a query reads for it to be dispatched as a "
+      "heavy query. Heavy queries run on at most num-executors - 1 executors and after "
+      "pending interactive queries, unless they have been passed over by 16 of them. 0 "
+      "(default) disables this.");
   developer_desc.add_options()(
       "gpu-shared-mem-threshold",
       po::value<size_t>(&g_gpu_smem_threshold)->default_value(g_gpu_smem_threshold),
@@ -672,6 +793,33 @@ void CommandLineOptions::fillAdvancedOptions() {
           ->default_value(g_fraction_code_cache_to_evict),
       "Percentage of the GPU code cache to evict if an out of memory error is "
       "encountered while attempting to place generated code on the GPU.");
+  developer_desc.add_options()(
+      "enable-persistent-jit-cache",
+      po::value<bool>(&g_enable_persistent_jit_cache)
+          ->default_value(g_enable_persistent_jit_cache)
+          ->implicit_value(true),
+      "Keep the code compiled for CPU queries in the data directory, to reuse it across "
+      "server restarts.");
+  developer_desc.add_options()(
+      "persistent-jit-cache-max-bytes",
+      po::value<size_t>(&g_persistent_jit_cache_max_bytes)
+          ->default_value(g_persistent_jit_cache_max_bytes),
+      "Maximum size of the code kept in the data directory by the persistent JIT "
+      "cache. The least recently used code is evicted past it.");
+  developer_desc.add_options()(
+      "enable-background-cpu-compilation",
+      po::value<bool>(&g_enable_background_cpu_compilation)
+          ->default_value(g_enable_background_cpu_compilation)
+          ->implicit_value(true),
+      "Run queries over few rows on quickly compiled, unoptimized CPU code the first "
+      "time they are seen, and compile the optimized code in the background for the "
+      "next runs.");
+  developer_desc.add_options()(
+      "background-compilation-max-rows",
+      po::value<size_t>(&g_background_compilation_max_rows)
+          ->default_value(g_background_compilation_max_rows),
+      "Maximum number of input rows for a query to run on unoptimized code while its "
+      "optimized code is compiled in the background.");
 
   developer_desc.add_options()("ssl-cert",
                                po::value<std::string>(&system_parameters.ssl_cert_file)
@@ -752,6 +900,38 @@ void CommandLineOptions::fillAdvancedOptions() {
   developer_desc.add_options()("approx_quantile_centroids",
                                po::value<size_t>(&g_approx_quantile_centroids)
                                    ->default_value(g_approx_quantile_centroids));
+  developer_desc.add_options()(
+      "enable-count-distinct-hash-set",
+      po::value<bool>(&g_enable_count_distinct_hash_set)
+          ->default_value(g_enable_count_distinct_hash_set)
+          ->implicit_value(true),
+      "Use an open addressing hash set instead of std::set for COUNT(DISTINCT) on "
+      "arguments whose range is too wide for a bitmap.");
+  developer_desc.add_options()(
+      "enable-fragment-skipping",
+      po::value<bool>(&g_enable_fragment_skipping)
+          ->default_value(g_enable_fragment_skipping)
+          ->implicit_value(true),
+      "Skip the fragments of the outer table whose chunk metadata shows that none of "
+      "their rows can pass the filters of a query.");
+  developer_desc.add_options()(
+      "enable-zone-map-row-skipping",
+      po::value<bool>(&g_enable_zone_map_row_skipping)
+          ->default_value(g_enable_zone_map_row_skipping)
+          ->implicit_value(true),
+      "Use the zone maps of integer and time chunks to skip the row ranges of a fragment "
+      "which can't pass the filters of CPU queries on a single table.");
+  developer_desc.add_options()(
+      "bloom-filter-fp-rate",
+      po::value<double>(&g_bloom_filter_fp_rate)->default_value(g_bloom_filter_fp_rate),
+      "Target false positive rate of the Bloom filters of integer, time and dictionary "
+      "encoded string chunks, which grow with the number of distinct values.");
+  developer_desc.add_options()(
+      "bloom-filter-max-bytes",
+      po::value<size_t>(&g_bloom_filter_max_bytes)
+          ->default_value(g_bloom_filter_max_bytes),
+      "Size past which the Bloom filter of a chunk is dropped. Bloom filters are kept "
+      "with the chunk metadata, in memory and on disk.");
   developer_desc.add_options()(
       "bitmap-memory-limit",
       po::value<int64_t>(&g_bitmap_memory_limit)->default_value(g_bitmap_memory_limit),
@@ -800,6 +980,45 @@ void CommandLineOptions::fillAdvancedOptions() {
       po::value<size_t>(&g_parallel_top_max)->default_value(g_parallel_top_max),
       "For ResultSets requiring a heap sort, the maximum number of rows allowed by "
       "watchdog.");
+  developer_desc.add_options()(
+      "enable-normalized-key-sort",
+      po::value<bool>(&g_enable_normalized_key_sort)
+          ->default_value(g_enable_normalized_key_sort)
+          ->implicit_value(true),
+      "Sort CPU result sets by radix sorting fixed-width keys built from all ORDER BY "
+      "entries instead of comparing rows one order entry at a time.");
+  developer_desc.add_options()(
+      "normalized-key-sort-parallel-min",
+      po::value<size_t>(&g_normalized_key_sort_parallel_min)
+          ->default_value(g_normalized_key_sort_parallel_min),
+      "Number of rows from which the normalized key sort partitions the rows with all "
+      "CPU threads, smaller result sets are radix sorted on a single thread.");
+  developer_desc.add_options()(
+      "enable-external-sort",
+      po::value<bool>(&g_enable_external_sort)
+          ->default_value(g_enable_external_sort)
+          ->implicit_value(true),
+      "Sort row-wise result sets above external-sort-threshold entries in "
+      "bounded-memory runs spilled to the data directory, and keep the merged rows "
+      "in a spill file mapped back into memory. Other result sets are sorted in "
+      "memory.");
+  developer_desc.add_options()(
+      "external-sort-threshold",
+      po::value<size_t>(&g_external_sort_threshold)
+          ->default_value(g_external_sort_threshold),
+      "Number of result set entries above which sorting is done externally. Result "
+      "sets with more than 4B entries can only be sorted externally.");
+  developer_desc.add_options()(
+      "external-sort-run-size",
+      po::value<size_t>(&g_external_sort_run_size)
+          ->default_value(g_external_sort_run_size),
+      "Maximum number of entries sorted in memory at once by the external sort.");
+  developer_desc.add_options()(
+      "external-sort-merge-buffer-bytes",
+      po::value<size_t>(&g_external_sort_merge_buffer_bytes)
+          ->default_value(g_external_sort_merge_buffer_bytes),
+      "Total size of the read buffers used to merge externally sorted runs, and of "
+      "the write buffer of the merged rows.");
   developer_desc.add_options()("vacuum-min-selectivity",
                                po::value<float>(&g_vacuum_min_selectivity)
                                    ->default_value(g_vacuum_min_selectivity),
@@ -809,6 +1028,23 @@ void CommandLineOptions::fillAdvancedOptions() {
                                "deleted rows in a fragment at which to perform "
                                "automatic vacuuming. A number greater than 1 can "
                                "be used to disable automatic vacuuming.");
+  developer_desc.add_options()(
+      "table-clustering-interval",
+      po::value<size_t>(&g_table_clustering_interval)
+          ->default_value(g_table_clustering_interval),
+      "Number of seconds between the runs of the scheduler which clusters the rows of "
+      "tables with a sort column on it. 0 disables the scheduler.");
+  developer_desc.add_options()(
+      "cluster-min-overlap",
+      po::value<float>(&g_cluster_min_overlap)->default_value(g_cluster_min_overlap),
+      "Minimum fraction of the fragments of a table whose sort column ranges overlap "
+      "other fragments at which the scheduler clusters the table.");
+  developer_desc.add_options()(
+      "cluster-max-batch-rows",
+      po::value<size_t>(&g_cluster_max_batch_rows)
+          ->default_value(g_cluster_max_batch_rows),
+      "Maximum number of rows clustered under one table write lock. Batches have at "
+      "least one fragment.");
   developer_desc.add_options()("enable-automatic-ir-metadata",
                                po::value<bool>(&g_enable_automatic_ir_metadata)
                                    ->default_value(g_enable_automatic_ir_metadata)
@@ -913,6 +1149,9 @@ void CommandLineOptions::validate() {
       throw std::runtime_error(err);
     }
   }
+  if (g_bloom_filter_fp_rate <= 0 || g_bloom_filter_fp_rate >= 1) {
+    throw std::runtime_error("bloom-filter-fp-rate must be between 0 and 1.");
+  }
   boost::algorithm::trim_if(db_query_file, boost::is_any_of("\"'"));
   if (db_query_file.length() > 0 && !boost::filesystem::exists(db_query_file)) {
     throw std::runtime_error("File containing DB queries " + db_query_file +
@@ -1037,6 +1276,24 @@ void CommandLineOptions::validate() {
   }
   LOG(INFO) << "Vacuum Min Selectivity: " << g_vacuum_min_selectivity;
 
+  if (g_buffer_pool_eviction_policy != "lru" && g_buffer_pool_eviction_policy != "lru2") {
+    throw std::runtime_error{"buffer-pool-eviction-policy must be lru or lru2."};
+  }
+  if (g_buffer_pool_correlated_period > std::numeric_limits<uint32_t>::max() ||
+      g_buffer_pool_retained_period > std::numeric_limits<uint32_t>::max()) {
+    throw std::runtime_error{
+        "buffer-pool-correlated-period and buffer-pool-retained-period must fit in 32 "
+        "bits."};
+  }
+
+  if (g_chunk_prefetch_mem_fraction < 0 || g_chunk_prefetch_mem_fraction > 1) {
+    throw std::runtime_error{"chunk-prefetch-mem-fraction must be between 0 and 1."};
+  }
+
+  if (g_cluster_min_overlap < 0) {
+    throw std::runtime_error{"cluster-min-overlap cannot be less than 0."};
+  }
+
   LOG(INFO) << "Enable system tables is set to " << g_enable_system_tables;
   if (g_enable_system_tables) {
     // System tables currently reuse FSI infrastructure and therefore, require FSI to be
@@ -1130,6 +1387,9 @@ boost::optional<int> CommandLineOptions::parse_command_line(
     g_use_hashtable_cache = use_hashtable_cache;
     g_max_cacheable_hashtable_size_bytes = max_cacheable_hashtable_size_bytes;
     g_hashtable_cache_total_bytes = hashtable_cache_total_bytes;
+    g_use_query_resultset_cache = use_query_resultset_cache;
+    g_query_resultset_cache_total_bytes = query_resultset_cache_total_bytes;
+    g_max_cacheable_query_resultset_size_bytes = max_cacheable_query_resultset_size_bytes;
 
   } catch (po::error& e) {
     std::cerr << "Usage Error: " << e.what() << std::endl;
@@ -1249,6 +1509,14 @@ boost::optional<int> CommandLineOptions::parse_command_line(
       LOG(INFO) << " \t\t Per-hashtable size limit: "
                 << g_max_cacheable_hashtable_size_bytes / (1024 * 1024) << " MB.";
     }
+    LOG(INFO) << " \t Use query resultset cache: "
+              << (g_use_query_resultset_cache ? "enabled" : "disabled");
+    if (g_use_query_resultset_cache) {
+      LOG(INFO) << " \t\t Total amount of bytes that query resultset cache keeps: "
+                << g_query_resultset_cache_total_bytes / (1024 * 1024) << " MB.";
+      LOG(INFO) << " \t\t Per-query resultset size limit: "
+                << g_max_cacheable_query_resultset_size_bytes / (1024 * 1024) << " MB.";
+    }
   }
 
   boost::algorithm::trim_if(authMetadata.distinguishedName, boost::is_any_of("\"'"));
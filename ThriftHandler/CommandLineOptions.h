@@ -86,6 +86,9 @@ class CommandLineOptions {
   bool use_hashtable_cache = true;
   size_t hashtable_cache_total_bytes = 4294967296;         // 4GB
   size_t max_cacheable_hashtable_size_bytes = 2147483648;  // 2GB
+  bool use_query_resultset_cache = false;
+  size_t query_resultset_cache_total_bytes = 4294967296;         // 4GB
+  size_t max_cacheable_query_resultset_size_bytes = 2147483648;  // 2GB
 
   /**
    * Number of threads used when loading data
@@ -159,7 +162,12 @@ extern bool g_allow_query_step_cpu_retry;
 extern bool g_inf_div_by_zero;
 extern bool g_null_div_by_zero;
 extern bool g_bigint_count;
+extern bool g_enable_count_distinct_hash_set;
 extern bool g_inner_join_fragment_skipping;
+extern bool g_enable_fragment_skipping;
+extern bool g_enable_zone_map_row_skipping;
+extern double g_bloom_filter_fp_rate;
+extern size_t g_bloom_filter_max_bytes;
 extern float g_filter_push_down_low_frac;
 extern float g_filter_push_down_high_frac;
 extern size_t g_filter_push_down_passing_row_ubound;
@@ -167,6 +175,9 @@ extern bool g_enable_columnar_output;
 extern bool g_optimize_row_initialization;
 extern bool g_enable_overlaps_hashjoin;
 extern bool g_enable_hashjoin_many_to_many;
+extern bool g_enable_partitioned_hash_join_build;
+extern size_t g_partitioned_hash_join_build_min_bytes;
+extern bool g_enable_sorted_key_join;
 extern bool g_enable_distance_rangejoin;
 extern size_t g_overlaps_max_table_size_bytes;
 extern double g_overlaps_target_entries_per_bin;
@@ -186,6 +197,7 @@ extern size_t g_gpu_smem_threshold;
 extern bool g_enable_smem_non_grouped_agg;
 extern bool g_enable_smem_grouped_non_count_agg;
 extern bool g_use_estimator_result_cache;
+extern size_t g_max_cached_estimations;
 extern bool g_enable_lazy_fetch;
 extern bool g_enable_multifrag_rs;
 
@@ -212,12 +224,26 @@ extern size_t g_max_import_threads;
 extern bool g_enable_auto_metadata_update;
 extern bool g_allow_s3_server_privileges;
 extern float g_vacuum_min_selectivity;
+extern float g_cluster_min_overlap;
+extern size_t g_cluster_max_batch_rows;
+extern size_t g_table_clustering_interval;
 extern bool g_read_only;
 extern bool g_enable_automatic_ir_metadata;
 extern size_t g_enable_parallel_linearization;
 extern bool g_enable_tiered_cpu_mem;
 extern size_t g_pmem_size;
+extern std::string g_buffer_pool_eviction_policy;
+extern size_t g_buffer_pool_correlated_period;
+extern size_t g_buffer_pool_retained_period;
+extern bool g_enable_chunk_prefetch;
+extern size_t g_chunk_prefetch_threads;
+extern double g_chunk_prefetch_mem_fraction;
+extern bool g_enable_parallel_reduction;
+extern bool g_enable_partitioned_reduction;
 extern bool g_enable_data_recycler;
 extern bool g_use_hashtable_cache;
 extern size_t g_hashtable_cache_total_bytes;
 extern size_t g_max_cacheable_hashtable_size_bytes;
+extern bool g_use_query_resultset_cache;
+extern size_t g_query_resultset_cache_total_bytes;
+extern size_t g_max_cacheable_query_resultset_size_bytes;
@@ -1314,6 +1314,10 @@ void DBHandler::sql_execute(TQueryResult& _return,
         _return.execution_time_ms,
         "total_time_ms",  // BE-3420 - Redundant with duration field
         stdlog.duration<std::chrono::milliseconds>());
+    if (query_state->getQueueWaitTimeMs() >= 0) {
+      stdlog.appendNameValuePairs("queue_wait_time_ms",
+                                  query_state->getQueueWaitTimeMs());
+    }
     VLOG(1) << "Table Schema Locks:\n" << lockmgr::TableSchemaLockMgr::instance();
     VLOG(1) << "Table Data Locks:\n" << lockmgr::TableDataLockMgr::instance();
   } catch (const std::exception& e) {
@@ -2755,6 +2759,9 @@ void DBHandler::get_memory(std::vector<TNodeMemoryInfo>& _return,
     nodeInfo.max_num_pages = memInfo.maxNumPages;
     nodeInfo.num_pages_allocated = memInfo.numPageAllocated;
     nodeInfo.is_allocation_capped = memInfo.isAllocationCapped;
+    nodeInfo.num_hits = memInfo.bufferPoolStats.num_hits;
+    nodeInfo.num_misses = memInfo.bufferPoolStats.num_misses;
+    nodeInfo.num_evicted_buffers = memInfo.bufferPoolStats.num_evicted_buffers;
     for (auto gpu : memInfo.nodeMemoryData) {
       TMemoryData md;
       md.slab = gpu.slabNum;
@@ -6030,6 +6037,44 @@ void DBHandler::check_and_invalidate_sessions(Parser::DDLStmt* ddl) {
   }
 }
 
+namespace {
+
+// Classifies a query for the dispatch queue from the number of rows in the tables it
+// locked, an upper bound of what it scans known before planning. This is only a row
+// count heuristic: the plan isn't known yet, so a selective filter or a LIMIT over a
+// large table still makes a heavy query, and an expensive join of small tables doesn't.
+QueryDispatchQueue::TaskInfo get_dispatch_task_info(
+    const Catalog_Namespace::Catalog& cat,
+    const std::string& session_id,
+    const lockmgr::LockedTableDescriptors& locks,
+    const size_t heavy_query_min_rows) {
+  QueryDispatchQueue::TaskInfo task_info{session_id,
+                                         QueryDispatchQueue::Priority::kInteractive};
+  if (heavy_query_min_rows == 0) {
+    return task_info;
+  }
+  // tables hold both a schema and a data lock
+  std::set<int> table_ids;
+  size_t num_rows{0};
+  for (const auto& lock : locks) {
+    const auto td = (*lock)();
+    if (!td || td->isView || !table_ids.insert(td->tableId).second) {
+      continue;
+    }
+    for (const auto physical_td : cat.getPhysicalTablesDescriptors(td)) {
+      if (physical_td->fragmenter) {
+        num_rows += physical_td->fragmenter->getNumRows();
+      }
+    }
+  }
+  if (num_rows >= heavy_query_min_rows) {
+    task_info.priority = QueryDispatchQueue::Priority::kHeavy;
+  }
+  return task_info;
+}
+
+}  // namespace
+
 void DBHandler::sql_execute_impl(ExecutionResult& _return,
                                  QueryStateProxy query_state_proxy,
                                  const bool column_format,
@@ -6243,6 +6288,7 @@ void DBHandler::sql_execute_impl(ExecutionResult& _return,
     std::vector<PushedDownFilterInfo> filter_push_down_requests;
     auto submitted_time_str = query_state_proxy.getQueryState().getQuerySubmittedTime();
     auto query_session = session_ptr ? session_ptr->get_session_id() : "";
+    std::chrono::steady_clock::time_point queue_wait_timer;
     auto execute_rel_alg_task = std::make_shared<QueryDispatchQueue::Task>(
         [this,
          &filter_push_down_requests,
@@ -6253,10 +6299,13 @@ void DBHandler::sql_execute_impl(ExecutionResult& _return,
          &query_ra,
          &query_str,
          &locks,
+         &queue_wait_timer,
          column_format,
          executor_device_type,
          first_n,
          at_most_n](const size_t executor_index) {
+          query_state_proxy.getQueryState().setQueueWaitTimeMs(
+              timer_stop(queue_wait_timer));
           // if we find proper filters we need to "re-execute" the query
           // with a modified query plan (i.e., which has pushdowned filter)
           // otherwise this trial just executes the query and keeps corresponding query
@@ -6314,13 +6363,15 @@ void DBHandler::sql_execute_impl(ExecutionResult& _return,
         });
     CHECK(dispatch_queue_);
     auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+    const auto task_info = get_dispatch_task_info(
+        cat, query_session, locks, system_parameters_.heavy_query_min_rows);
     if (g_enable_runtime_query_interrupt && !query_session.empty()) {
       executor->enrollQuerySession(query_session,
                                    query_str,
                                    submitted_time_str,
                                    Executor::UNITARY_EXECUTOR_ID,
                                    QuerySessionStatus::QueryStatus::PENDING_QUEUE);
-      while (!dispatch_queue_->hasIdleWorker()) {
+      while (!dispatch_queue_->hasIdleWorker(task_info.priority)) {
         try {
           executor->checkPendingQueryStatus(query_session);
         } catch (QueryExecutionError& e) {
@@ -6334,9 +6385,11 @@ void DBHandler::sql_execute_impl(ExecutionResult& _return,
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
       }
     }
+    queue_wait_timer = timer_start();
     dispatch_queue_->submit(execute_rel_alg_task,
                             pw.getDMLType() == ParserWrapper::DMLType::Update ||
-                                pw.getDMLType() == ParserWrapper::DMLType::Delete);
+                                pw.getDMLType() == ParserWrapper::DMLType::Delete,
+                            task_info);
     auto result_future = execute_rel_alg_task->get_future();
     result_future.get();
     return;
@@ -6370,6 +6423,10 @@ void DBHandler::sql_execute_impl(ExecutionResult& _return,
         if (optimize_stmt->shouldVacuumDeletedRows()) {
           optimizer.vacuumDeletedRows();
         }
+        if (optimize_stmt->shouldClusterRows()) {
+          optimizer.clusterRows(optimize_stmt->getClusterColumnNames(),
+                                optimize_stmt->shouldClusterInZOrder());
+        }
         optimizer.recomputeMetadata();
       }));
       return;
@@ -7043,6 +7100,8 @@ void DBHandler::get_license_claims(TLicenseInfo& _return,
 void DBHandler::shutdown() {
   emergency_shutdown();
 
+  Executor::shutdownBackgroundCompilation();
+
   if (render_handler_) {
     render_handler_->shutdown();
   }
@@ -63,7 +63,8 @@ QueryState::QueryState(
                                  : boost::none)
     , query_str_(std::move(query_str))
     , logged_(false)
-    , submitted_(::toString(std::chrono::system_clock::now())) {}
+    , submitted_(::toString(std::chrono::system_clock::now()))
+    , queue_wait_time_ms_(-1) {}
 
 QueryStateProxy QueryState::createQueryStateProxy() {
   return createQueryStateProxy(events_.end());
@@ -134,6 +134,8 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   mutable std::mutex events_mutex_;
   std::atomic<bool> logged_;
   std::string submitted_;
+  // Time spent in the QueryDispatchQueue waiting for an executor, -1 until dispatched.
+  std::atomic<int64_t> queue_wait_time_ms_;
   void logCallStack(std::stringstream&, unsigned const depth, Events::iterator parent);
 
   // Only shared_ptr instances are allowed due to call to shared_from_this().
@@ -164,6 +166,8 @@ class QueryState : public std::enable_shared_from_this<QueryState> {
   logger::QidScopeGuard setThreadLocalQueryId() const;
   void setQuerySubmittedTime(const std::string& t);
   const std::string getQuerySubmittedTime() const;
+  inline void setQueueWaitTimeMs(int64_t ms) { queue_wait_time_ms_.store(ms); }
+  inline int64_t getQueueWaitTimeMs() const { return queue_wait_time_ms_.load(); }
   inline void setLogged(bool logged) { logged_.store(logged); }
   friend class QueryStates;
 };
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TableClusteringScheduler.h"
+
+#include "Catalog/SysCatalog.h"
+#include "LockMgr/LockMgr.h"
+#include "QueryEngine/Execute.h"
+#include "QueryEngine/ExternalCacheInvalidators.h"
+#include "QueryEngine/TableOptimizer.h"
+
+// Seconds between the runs of the table clustering scheduler, 0 disables it
+size_t g_table_clustering_interval{0};
+
+namespace {
+bool is_clustering_candidate(const TableDescriptor* td) {
+  return !td->isView && !td->isForeignTable() && td->shard < 0 &&
+         td->persistenceLevel == Data_Namespace::MemoryLevel::DISK_LEVEL &&
+         td->sortedColumnId != 0;
+}
+}  // namespace
+
+void TableClusteringScheduler::invalidateQueryEngineCaches() {
+  auto execute_write_lock = mapd_unique_lock<mapd_shared_mutex>(
+      *legacylockmgr::LockMgr<mapd_shared_mutex, bool>::getMutex(
+          legacylockmgr::ExecutorOuterLock, true));
+  UpdateTriggeredCacheInvalidator::invalidateCaches();
+}
+
+void TableClusteringScheduler::start(std::atomic<bool>& is_program_running) {
+  if (is_program_running && !is_scheduler_running_) {
+    is_scheduler_running_ = true;
+    scheduler_thread_ = std::thread([&is_program_running]() {
+      while (is_program_running && is_scheduler_running_) {
+        // The tables are left alone for a full interval after startup.
+        {
+          std::unique_lock<std::mutex> wait_lock(wait_mutex_);
+          wait_condition_.wait_for(wait_lock, thread_wait_duration_, [&] {
+            return !is_program_running || !is_scheduler_running_;
+          });
+        }
+        if (!is_program_running || !is_scheduler_running_) {
+          return;
+        }
+        auto& sys_catalog = Catalog_Namespace::SysCatalog::instance();
+        bool at_least_one_table_clustered = false;
+        for (const auto& catalog : sys_catalog.getCatalogsForAllDbs()) {
+          for (const auto td : catalog->getAllTableMetadata()) {
+            // Exit if scheduler has been stopped asynchronously
+            if (!is_program_running || !is_scheduler_running_) {
+              return;
+            }
+            if (!is_clustering_candidate(td)) {
+              continue;
+            }
+            try {
+              const auto td_with_lock =
+                  lockmgr::TableSchemaLockContainer<lockmgr::ReadLock>::
+                      acquireTableDescriptor(*catalog, td->tableName);
+              const auto table_key =
+                  std::make_pair(catalog->getDatabaseId(), td_with_lock()->tableId);
+              const auto it = checked_table_epochs_.find(table_key);
+              if (it != checked_table_epochs_.end() &&
+                  it->second ==
+                      catalog->getTableEpoch(table_key.first, table_key.second)) {
+                continue;
+              }
+              auto executor = Executor::getExecutor(Executor::UNITARY_EXECUTOR_ID);
+              const TableOptimizer optimizer(td_with_lock(), executor.get(), *catalog);
+              if (optimizer.shouldClusterRows()) {
+                optimizer.clusterRows({}, false);
+                at_least_one_table_clustered = true;
+              }
+              checked_table_epochs_[table_key] =
+                  catalog->getTableEpoch(table_key.first, table_key.second);
+            } catch (std::exception& e) {
+              LOG(ERROR) << "Scheduled clustering for table \"" << td->tableName
+                         << "\" resulted in an error. " << e.what();
+            }
+          }
+        }
+        if (at_least_one_table_clustered) {
+          invalidateQueryEngineCaches();
+        }
+      }
+    });
+  }
+}
+
+void TableClusteringScheduler::stop() {
+  if (is_scheduler_running_) {
+    is_scheduler_running_ = false;
+    wait_condition_.notify_one();
+    scheduler_thread_.join();
+  }
+}
+
+void TableClusteringScheduler::setWaitDuration(int64_t duration_in_seconds) {
+  thread_wait_duration_ = std::chrono::seconds{duration_in_seconds};
+}
+
+bool TableClusteringScheduler::isRunning() {
+  return is_scheduler_running_;
+}
+
+std::atomic<bool> TableClusteringScheduler::is_scheduler_running_{false};
+std::chrono::seconds TableClusteringScheduler::thread_wait_duration_{60};
+std::thread TableClusteringScheduler::scheduler_thread_;
+std::mutex TableClusteringScheduler::wait_mutex_;
+std::condition_variable TableClusteringScheduler::wait_condition_;
+std::map<std::pair<int32_t, int32_t>, int32_t>
+    TableClusteringScheduler::checked_table_epochs_;
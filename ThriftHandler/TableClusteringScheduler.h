@@ -0,0 +1,51 @@
+/*
+ * Copyright 2021 OmniSci, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+/**
+ * Periodically clusters the rows of the tables with a sort column on it, for the tables
+ * TableOptimizer::shouldClusterRows picks. A table is only checked again once its epoch
+ * moved past the one of the last check, i.e. after it got new data, since clustering
+ * orders the rows per batch of fragments and can leave overlapping fragments behind.
+ */
+class TableClusteringScheduler {
+ public:
+  static void start(std::atomic<bool>& is_program_running);
+  static void stop();
+
+  // The following methods are for testing purposes only
+  static void setWaitDuration(int64_t duration_in_seconds);
+  static bool isRunning();
+
+ private:
+  static void invalidateQueryEngineCaches();
+  static std::atomic<bool> is_scheduler_running_;
+  static std::chrono::seconds thread_wait_duration_;
+  static std::thread scheduler_thread_;
+  static std::mutex wait_mutex_;
+  static std::condition_variable wait_condition_;
+  // (database id, table id) -> epoch of the table after its last check
+  static std::map<std::pair<int32_t, int32_t>, int32_t> checked_table_epochs_;
+};
@@ -428,6 +428,23 @@ void validate_and_set_date_encoding(ColumnDescriptor& cd, int encoding_size) {
   cd.columnType.set_comp_param((encoding_size == 16) ? 16 : 0);
 }
 
+void validate_and_set_sequence_encoding(ColumnDescriptor& cd,
+                                        const EncodingType encoding_type,
+                                        const std::string& encoding_name) {
+  const auto type = cd.columnType.get_type();
+  if (type == kARRAY) {
+    throw std::runtime_error(cd.columnName + ": Cannot apply " + encoding_name +
+                             " encoding to arrays.");
+  }
+  if (!IS_INTEGER(type) && !is_datetime(type) &&
+      !(type == kDECIMAL || type == kNUMERIC)) {
+    throw std::runtime_error(cd.columnName + ": " + encoding_name +
+                             " encoding is only supported for integer or time columns.");
+  }
+  cd.columnType.set_compression(encoding_type);
+  cd.columnType.set_comp_param(0);
+}
+
 void validate_and_set_encoding(ColumnDescriptor& cd,
                                const Encoding* encoding,
                                const SqlType* column_type) {
@@ -439,14 +456,10 @@ void validate_and_set_encoding(ColumnDescriptor& cd,
       validate_and_set_fixed_encoding(cd, encoding->get_encoding_param(), column_type);
     } else if (boost::iequals(comp, "rl")) {
       // run length encoding
-      cd.columnType.set_compression(kENCODING_RL);
-      cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("RL(Run Length) encoding not supported yet.");
+      validate_and_set_sequence_encoding(cd, kENCODING_RL, "RL");
     } else if (boost::iequals(comp, "diff")) {
       // differential encoding
-      cd.columnType.set_compression(kENCODING_DIFF);
-      cd.columnType.set_comp_param(0);
-      // throw std::runtime_error("DIFF(differential) encoding not supported yet.");
+      validate_and_set_sequence_encoding(cd, kENCODING_DIFF, "DIFF");
     } else if (boost::iequals(comp, "dict")) {
       validate_and_set_dictionary_encoding(cd, encoding->get_encoding_param());
     } else if (boost::iequals(comp, "NONE")) {
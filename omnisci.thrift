@@ -292,6 +292,9 @@ struct TNodeMemoryInfo {
   4: i64 num_pages_allocated;
   5: bool is_allocation_capped;
   6: list<TMemoryData> node_memory_data;
+  7: i64 num_hits;
+  8: i64 num_misses;
+  9: i64 num_evicted_buffers;
 }
 
 struct TTableMeta {
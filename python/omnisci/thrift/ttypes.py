@@ -3166,17 +3166,23 @@ class TNodeMemoryInfo(object):
      - num_pages_allocated
      - is_allocation_capped
      - node_memory_data
+     - num_hits
+     - num_misses
+     - num_evicted_buffers
 
     """
 
 
-    def __init__(self, host_name=None, page_size=None, max_num_pages=None, num_pages_allocated=None, is_allocation_capped=None, node_memory_data=None,):
+    def __init__(self, host_name=None, page_size=None, max_num_pages=None, num_pages_allocated=None, is_allocation_capped=None, node_memory_data=None, num_hits=None, num_misses=None, num_evicted_buffers=None,):
         self.host_name = host_name
         self.page_size = page_size
         self.max_num_pages = max_num_pages
         self.num_pages_allocated = num_pages_allocated
         self.is_allocation_capped = is_allocation_capped
         self.node_memory_data = node_memory_data
+        self.num_hits = num_hits
+        self.num_misses = num_misses
+        self.num_evicted_buffers = num_evicted_buffers
 
     def read(self, iprot):
         if iprot._fast_decode is not None and isinstance(iprot.trans, TTransport.CReadableTransport) and self.thrift_spec is not None:
@@ -3223,6 +3229,21 @@ class TNodeMemoryInfo(object):
                     iprot.readListEnd()
                 else:
                     iprot.skip(ftype)
+            elif fid == 7:
+                if ftype == TType.I64:
+                    self.num_hits = iprot.readI64()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 8:
+                if ftype == TType.I64:
+                    self.num_misses = iprot.readI64()
+                else:
+                    iprot.skip(ftype)
+            elif fid == 9:
+                if ftype == TType.I64:
+                    self.num_evicted_buffers = iprot.readI64()
+                else:
+                    iprot.skip(ftype)
             else:
                 iprot.skip(ftype)
             iprot.readFieldEnd()
@@ -3260,6 +3281,18 @@ class TNodeMemoryInfo(object):
                 iter125.write(oprot)
             oprot.writeListEnd()
             oprot.writeFieldEnd()
+        if self.num_hits is not None:
+            oprot.writeFieldBegin('num_hits', TType.I64, 7)
+            oprot.writeI64(self.num_hits)
+            oprot.writeFieldEnd()
+        if self.num_misses is not None:
+            oprot.writeFieldBegin('num_misses', TType.I64, 8)
+            oprot.writeI64(self.num_misses)
+            oprot.writeFieldEnd()
+        if self.num_evicted_buffers is not None:
+            oprot.writeFieldBegin('num_evicted_buffers', TType.I64, 9)
+            oprot.writeI64(self.num_evicted_buffers)
+            oprot.writeFieldEnd()
         oprot.writeFieldStop()
         oprot.writeStructEnd()
 
@@ -6553,6 +6586,9 @@ TNodeMemoryInfo.thrift_spec = (
     (4, TType.I64, 'num_pages_allocated', None, None, ),  # 4
     (5, TType.BOOL, 'is_allocation_capped', None, None, ),  # 5
     (6, TType.LIST, 'node_memory_data', (TType.STRUCT, [TMemoryData, None], False), None, ),  # 6
+    (7, TType.I64, 'num_hits', None, None, ),  # 7
+    (8, TType.I64, 'num_misses', None, None, ),  # 8
+    (9, TType.I64, 'num_evicted_buffers', None, None, ),  # 9
 )
 all_structs.append(TTableMeta)
 TTableMeta.thrift_spec = (